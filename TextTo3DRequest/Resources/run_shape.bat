@@ -132,6 +132,6 @@ if %errorlevel% neq 0 (
 :: --- Core Execution ---
 :: With the environment active, run the Python script.
 :: The -u flag ensures unbuffered output, allowing UE to read it in real-time.
-:: %* forwards all arguments passed to this batch script (e.g., --ue, --params-base64)
+:: %* forwards all arguments passed to this batch script (e.g., --ue, --worker, --params-base64)
 :: directly to the Python script.
 python -u "%PYTHON_SCRIPT_PATH%" %*
\ No newline at end of file
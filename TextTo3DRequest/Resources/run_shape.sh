@@ -0,0 +1,34 @@
+#!/bin/sh
+# ==============================================================================
+# Shap-E Plugin Execution Script (Linux / macOS)
+#
+# POSIX counterpart of run_shape.bat's Unreal mode: reads shape_config.txt,
+# picks the Conda environment's interpreter and runs the Python interface
+# script with all arguments forwarded. SHAPE_PYTHON overrides the interpreter,
+# and without a config file python3 from PATH is used (enough for --synthetic).
+# ==============================================================================
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+CONFIG_FILE="$SCRIPT_DIR/shape_config.txt"
+PYTHON_SCRIPT_PATH="$SCRIPT_DIR/ue_shape_interface.py"
+
+if [ -z "$SHAPE_PYTHON" ] && [ -f "$CONFIG_FILE" ]; then
+    while IFS='=' read -r KEY VALUE; do
+        VALUE=$(printf '%s' "$VALUE" | tr -d '\r')
+        case "$KEY" in
+            ANACONDA_BASE) ANACONDA_BASE=$VALUE ;;
+            CONDA_ENV_NAME) CONDA_ENV_NAME=$VALUE ;;
+        esac
+    done < "$CONFIG_FILE"
+
+    if [ -n "$ANACONDA_BASE" ] && [ -n "$CONDA_ENV_NAME" ]; then
+        SHAPE_PYTHON="$ANACONDA_BASE/envs/$CONDA_ENV_NAME/bin/python"
+        if [ ! -x "$SHAPE_PYTHON" ]; then
+            echo "{\"type\":\"error\", \"error_type\":\"EnvActivationFailed\", \"message\":\"No interpreter at '$SHAPE_PYTHON'. Please verify settings in the config file.\"}"
+            exit 1
+        fi
+    fi
+fi
+
+# -u keeps stdout unbuffered so UE reads messages as they are printed
+exec "${SHAPE_PYTHON:-python3}" -u "$PYTHON_SCRIPT_PATH" "$@"
@@ -4,63 +4,318 @@
 # receiving parameters via a Base64-encoded JSON string and sending progress
 # and results back via JSON messages printed to stdout.
 #
+# With --worker the script stays alive instead: the models are loaded once and
+# newline-delimited JSON jobs are read from stdin. Every message produced while
+# a job is running carries that job's "job_id", and a "ready" message is sent
+# whenever the worker is idle and waiting for the next job. stdin is drained on
+# a thread of its own, so jobs of any size (e.g. batches with thousands of
+# prompts) can be written while another job runs; they queue up in order.
+#
+# A {"type": "cancel", "job_id": ...} line cancels that job without restarting
+# the worker: a queued job is dropped, a running one stops at its next sampling
+# step (or before decoding), and either answers with a "cancelled" message that
+# carries "cancel_ms", the time from reading the cancel to giving up the job.
+# A cancel for a job that already finished is answered with "cancel_ms": 0.
+#
+# Jobs with "transport": "shm" hand the mesh back through a named shared-memory
+# segment instead of files: the "complete" message carries the segment name and
+# the array layout, and the segment stays alive until the editor sends a
+# {"type": "release", "shm_name": ...} line. Writing PLY/OBJ files is then
+# optional ("export_files").
+#
+# Every sampled latent is saved next to the outputs as fp16 .npy ("latent_file" in
+# the result). A {"type": "decode", "latent_file": ...} job decodes such a file
+# again without sampling, e.g. to re-export with different settings.
+#
+# With "preview_every": N a low-resolution render of the current denoised latent
+# is streamed every N Karras steps as a "preview" message (base64 rgb8 pixels),
+# as long as previews stay under "preview_max_overhead" of the sampling time.
+#
+# Every pipeline stage (model load, sampling, decode, file/shared-memory export) is
+# bracketed by {"type": "stage", "stage": ..., "phase": "begin"|"end", "t": ...}
+# messages, where "t" is time.perf_counter(); the editor maps them onto its own
+# clock and records them as timing spans.
+#
+# --synthetic replaces the Shap-E models with a stand-in that turns every prompt
+# into a vertex-colored sphere, so the pipeline can be exercised without a GPU.
+# --synthetic-load-ms/-step-ms/-decode-ms give it the pacing of a real run, and
+# --synthetic-log-lines makes it print third-party-style noise on every job.
+#
+# With --record-fd N (--worker only) the messages go to file descriptor N as
+# length-prefixed binary records instead (see encode_record), leaving stdout to
+# tqdm and library output. The first record is a hello naming the protocol
+# version picked from --record-versions; version 0 means none of them is spoken
+# here and the messages stay JSON lines on stdout.
+#
+# --serve turns the script into a small HTTP inference server (see run_server):
+# jobs are POSTed as JSON, their messages stream back as newline-delimited JSON in
+# the same format as above, and the meshes are downloaded from the server as
+# binary files. Together with --synthetic it stands in for a real inference box.
+#
 
 import sys
+import time
 import json
 import os
 import traceback
-import torch
 import argparse
 import base64
+import re
+import queue
+import shutil
+import struct
+import tempfile
+import threading
 import warnings
+import zlib
+from collections import OrderedDict
+from contextlib import contextmanager
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from multiprocessing import shared_memory
+from urllib.parse import quote, unquote
+
+import numpy as np
 
 # Suppress a specific FutureWarning from a dependency.
 warnings.filterwarnings("ignore", category=FutureWarning)
 
-from shap_e.diffusion.sample import sample_latents
-from shap_e.diffusion.gaussian_diffusion import diffusion_from_config
-from shap_e.models.download import load_model, load_config
-from shap_e.util.notebooks import decode_latent_mesh
+# torch and shap_e are imported where they are used, so --synthetic runs without them.
+
+# Id of the job currently being processed in worker mode, echoed in every message.
+_active_job_id = None
+# Set by run_worker; shared-memory results only outlive the job inside a persistent worker.
+_worker_mode = False
+
+# Shared-memory segments handed to the editor and not released yet, oldest first.
+# Releases arrive on the stdin thread while jobs add segments, hence the lock.
+_shared_segments = OrderedDict()
+_shared_segments_lock = threading.RLock()
+# Segments the editor never released (e.g. it crashed mid-import) are dropped beyond this count.
+MAX_SHARED_SEGMENTS = 16
+
+# Text-conditional model loaded by load_models; jobs name the version they expect.
+MODEL_VERSION = 'text300M'
+
+# CUDA device set by --device; pool workers get one each, -1 keeps torch's default.
+_device_index = -1
+
+# Under --serve every request thread streams its job's output to its own client (a JobStream).
+_request_context = threading.local()
+
+# Keeps the lines of concurrent writers (the job, the stdin thread) whole.
+_stdout_lock = threading.Lock()
+
+# Jobs read from stdin and not finished yet, and when a cancel arrived for any of them (perf_counter).
+# The stdin thread fills both while the job checks them between sampling steps.
+_pending_job_ids = set()
+_cancel_requests = {}
+_cancel_lock = threading.Lock()
+
+class JobCancelled(BaseException):
+    """Unwinds a cancelled job; not an Exception, so per-item error handling does not swallow it."""
+
+def check_cancelled():
+    """Raises JobCancelled if the editor cancelled the running job; called between sampling steps."""
+    job_id = _active_job_id
+    if job_id is not None and job_id in _cancel_requests:
+        raise JobCancelled()
+
+def request_cancel(job_id):
+    """Marks a job read earlier as cancelled; returns False if it already finished."""
+    with _cancel_lock:
+        if job_id not in _pending_job_ids:
+            return False
+        _cancel_requests.setdefault(job_id, time.perf_counter())
+        return True
+
+def finish_job_id(job_id):
+    """Forgets a job once it ended; returns when it was cancelled, or None."""
+    with _cancel_lock:
+        _pending_job_ids.discard(job_id)
+        return _cancel_requests.pop(job_id, None)
+
+# Binary records (--record-fd): uint32 length of what follows, uint8 record type, then the body, little-endian.
+# The version goes up whenever a layout below changes.
+RECORD_PROTOCOL_VERSION = 1
+RECORD_MAGIC = b"SHPE"
+(RECORD_HELLO, RECORD_READY, RECORD_STATUS, RECORD_INFO, RECORD_PROGRESS, RECORD_STAGE, RECORD_ERROR, RECORD_COMPLETE,
+ RECORD_ITEM_COMPLETE, RECORD_ITEM_ERROR, RECORD_CANCELLED, RECORD_PREVIEW, RECORD_JSON) = range(1, 14)
+# Every body starts with the job id, followed by these fields in order (s: string, b: bytes, both with a uint32
+# length; otherwise a struct code). Messages with a field outside their layout are sent whole as a RECORD_JSON.
+RECORD_LAYOUTS = {
+    "ready": (RECORD_READY, ()),
+    "status": (RECORD_STATUS, (("message", "s"),)),
+    "info": (RECORD_INFO, (("message", "s"),)),
+    "debug": (RECORD_INFO, (("message", "s"),)),
+    "progress": (RECORD_PROGRESS, (("step", "I"), ("total_steps", "I"), ("rate", "f"))),
+    "stage": (RECORD_STAGE, (("stage", "s"), ("phase", "s"), ("t", "d"), ("steps", "I"), ("batch", "I"))),
+    "error": (RECORD_ERROR, (("message", "s"), ("error_type", "s"))),
+    "complete": (RECORD_COMPLETE, (("message", "s"), ("ply_file", "s"), ("obj_file", "s"), ("latent_file", "s"),
+                                   ("shm_name", "s"), ("shm_size", "Q"), ("positions_offset", "q"), ("colors_offset", "q"),
+                                   ("indices_offset", "q"), ("vertex_count", "I"), ("face_count", "I"))),
+    "item_complete": (RECORD_ITEM_COMPLETE, (("item_index", "I"), ("item_count", "I"), ("prompt", "s"),
+                                             ("ply_file", "s"), ("obj_file", "s"), ("latent_file", "s"))),
+    "item_error": (RECORD_ITEM_ERROR, (("item_index", "I"), ("prompt", "s"), ("message", "s"), ("error_type", "s"))),
+    "cancelled": (RECORD_CANCELLED, (("message", "s"), ("cancel_ms", "d"))),
+    # raw rgb8 pixels instead of base64
+    "preview": (RECORD_PREVIEW, (("step", "I"), ("total_steps", "I"), ("width", "I"), ("height", "I"),
+                                 ("render_ms", "d"), ("pixels", "b"))),
+}
+RECORD_LAYOUT_KEYS = {name: {"type", "job_id"} | {key for key, _ in fields} for name, (_, fields) in RECORD_LAYOUTS.items()}
+
+# Set by open_record_channel once the editor and the worker agreed on a protocol version.
+_record_stream = None
+
+def pack_record_bytes(value):
+    return struct.pack("<I", len(value)) + value
+
+def encode_record(data):
+    """Frames one message as a binary record; raises struct.error for values outside their field's range."""
+    message_type = data.get("type")
+    layout = RECORD_LAYOUTS.get(message_type)
+    if layout is not None and RECORD_LAYOUT_KEYS[message_type].issuperset(data):
+        record_type, fields = layout
+        parts = [pack_record_bytes(str(data.get("job_id") or "").encode("utf-8"))]
+        for key, code in fields:
+            value = data.get(key)
+            if code == "s":
+                parts.append(pack_record_bytes(str(value if value is not None else "").encode("utf-8")))
+            elif code == "b":
+                parts.append(pack_record_bytes(bytes(value or b"")))
+            else:
+                parts.append(struct.pack("<" + code, value if value is not None else 0))
+        body = b"".join(parts)
+        return struct.pack("<IB", len(body) + 1, record_type) + body
+    return encode_json_record(data)
+
+def encode_json_record(data):
+    body = json.dumps(data, separators=(',', ':')).encode("utf-8")
+    return struct.pack("<IB", len(body) + 1, RECORD_JSON) + body
+
+def open_record_channel(fd, offered_versions):
+    """Answers the editor's offer on the record channel with a hello; without a common version it is closed
+    again and the messages stay JSON lines on stdout."""
+    global _record_stream
+    stream = os.fdopen(fd, "wb")
+    version = RECORD_PROTOCOL_VERSION if RECORD_PROTOCOL_VERSION in offered_versions else 0
+    hello = RECORD_MAGIC + struct.pack("<HH", version, 0)
+    stream.write(struct.pack("<IB", len(hello) + 1, RECORD_HELLO) + hello)
+    stream.flush()
+    if version == 0:
+        stream.close()
+        send_json_message({"type": "info", "message": f"No common record protocol version in {offered_versions}, staying on JSON lines."})
+        return
+    _record_stream = stream
+
+def send_progress(step, total_steps, start_time):
+    """Reports a sampling step as a record; JSON-lines editors read tqdm's bar instead."""
+    if _record_stream is None:
+        return
+    elapsed = time.perf_counter() - start_time
+    send_json_message({"type": "progress", "step": step, "total_steps": total_steps, "rate": step / elapsed if elapsed > 0.0 else 0.0})
 
 def send_json_message(data):
-    """Sends a JSON-formatted message to stdout for the calling process."""
+    """Sends a message to the calling process: a JSON line on stdout, or a record once the record channel is open."""
+    stream = getattr(_request_context, "stream", None)
+    if stream is not None:
+        # a client that went away raises ClientDisconnected here, which ends its job
+        stream.send_message(data)
+        return
+    if _active_job_id is not None and "job_id" not in data:
+        data["job_id"] = _active_job_id
+    if _record_stream is not None:
+        try:
+            try:
+                record = encode_record(data)
+            except struct.error:
+                # a value outside its field's range still gets through as JSON
+                record = encode_json_record(data)
+        except Exception as e:
+            record = encode_json_record({"type": "internal_error", "message": f"send_json_message failed: {str(e)}"})
+        with _stdout_lock:
+            _record_stream.write(record)
+            _record_stream.flush()
+        return
     try:
         json_string = json.dumps(data, separators=(',', ':'))
-        print(json_string, flush=True)
     except Exception as e:
         # Failsafe in case the data itself can't be serialized.
-        error_msg = {"type": "internal_error", "message": f"send_json_message failed: {str(e)}"}
-        print(json.dumps(error_msg), flush=True)
+        json_string = json.dumps({"type": "internal_error", "message": f"send_json_message failed: {str(e)}"})
+    with _stdout_lock:
+        sys.stdout.write(json_string + "\n")
+        sys.stdout.flush()
 
-def run_generation(params):
-    """Handles the core logic of model loading, generation, and file saving."""
-    prompt = params.get("prompt")
-    output_dir = params.get("output_dir")
-    guidance_scale = float(params.get("guidance_scale", 15.0))
-    karras_steps = int(params.get("karras_steps", 64))
-    use_fp16 = bool(params.get("use_fp16", True))
+def write_raw_output(text, stream):
+    """Writes non-JSON output (tqdm bars, library noise) to stream, or to the HTTP client under --serve."""
+    job_stream = getattr(_request_context, "stream", None)
+    if job_stream is not None:
+        job_stream.send_text(text)
+        return
+    stream.write(text)
+    stream.flush()
 
-    os.makedirs(output_dir, exist_ok=True)
-    
+@contextmanager
+def timed_stage(stage, **fields):
+    """Brackets a pipeline stage with "stage" begin/end messages; usable as a decorator too."""
+    send_json_message({"type": "stage", "stage": stage, "phase": "begin", "t": time.perf_counter(), **fields})
+    try:
+        yield
+    finally:
+        send_json_message({"type": "stage", "stage": stage, "phase": "end", "t": time.perf_counter()})
+
+@timed_stage("device_setup")
+def setup_device():
+    """Selects the CUDA device the models are loaded onto."""
+    import torch
     send_json_message({"type": "status", "message": "Setting up device..."})
     device = torch.device('cuda' if torch.cuda.is_available() else 'cpu')
     if not torch.cuda.is_available():
         raise RuntimeError("CUDA is not available. This script requires a GPU.")
+    if _device_index >= 0:
+        if _device_index >= torch.cuda.device_count():
+            raise RuntimeError(f"CUDA device {_device_index} requested, but only {torch.cuda.device_count()} are available.")
+        device = torch.device('cuda', _device_index)
+        torch.cuda.set_device(device)
     send_json_message({"type": "status", "message": f"Device set to: {device}"})
+    return device
+
+@timed_stage("model_load")
+def load_models(device):
+    """Loads the transmitter, text model and diffusion config onto the device."""
+    from shap_e.diffusion.gaussian_diffusion import diffusion_from_config
+    from shap_e.models.download import load_model, load_config
 
     send_json_message({"type": "status", "message": "Loading models..."})
     xm = load_model('transmitter', device=device)
-    model = load_model('text300M', device=device)
+    model = load_model(MODEL_VERSION, device=device)
     diffusion = diffusion_from_config(load_config('diffusion'))
     send_json_message({"type": "status", "message": "Models loaded."})
+    return xm, model, diffusion
 
-    send_json_message({"type": "status", "message": f"Generating latents for prompt: '{prompt}'..."})
-    latents = sample_latents(
-        batch_size=1,
+def sample_prompt_latents(models, prompts, guidance_scale, karras_steps, use_fp16, preview=None):
+    """Samples one latent per prompt in a single batched diffusion run.
+
+    With a PreviewStreamer the first prompt's denoised estimate is previewed while sampling.
+    """
+    with timed_stage("sample", steps=karras_steps, batch=len(prompts)):
+        if isinstance(models, SyntheticModels):
+            return models.sample(prompts, karras_steps, preview)
+        if (preview is not None and preview.enabled) or _worker_mode:
+            # stepping by hand lets a worker give up a cancelled job between steps
+            return sample_latents_stepped(models, prompts, guidance_scale, karras_steps, use_fp16, preview)
+        return sample_latents_batched(models, prompts, guidance_scale, karras_steps, use_fp16)
+
+def sample_latents_batched(models, prompts, guidance_scale, karras_steps, use_fp16):
+    """shap_e's sample_latents for a list of prompts."""
+    from shap_e.diffusion.sample import sample_latents
+
+    xm, model, diffusion = models
+    return sample_latents(
+        batch_size=len(prompts),
         model=model,
         diffusion=diffusion,
         guidance_scale=guidance_scale,
-        model_kwargs=dict(texts=[prompt]),
+        model_kwargs=dict(texts=list(prompts)),
         progress=True,
         clip_denoised=True,
         use_fp16=use_fp16,
@@ -70,18 +325,309 @@ def run_generation(params):
         sigma_max=160,
         s_churn=0,
     )
-    
-    send_json_message({"type": "status", "message": "Latents generation complete. Decoding to mesh..."})
-    
-    decoded_output = decode_latent_mesh(xm, latents[0])
-    
-    # The raw decoded output must be converted to a TriMesh object to be saved.
-    final_mesh_to_save = decoded_output.tri_mesh()
 
-    # Sanitize the prompt to create a safe filename.
+def sample_latents_stepped(models, prompts, guidance_scale, karras_steps, use_fp16, preview=None):
+    """sample_latents, stepping the Karras sampler by hand to check for cancels and preview intermediate estimates."""
+    import torch
+    from shap_e.diffusion.k_diffusion import karras_sample_progressive
+
+    xm, model, diffusion = models
+    device = next(model.parameters()).device
+    batch_size = len(prompts)
+    model_kwargs = dict(texts=list(prompts))
+    if hasattr(model, "cached_model_kwargs"):
+        model_kwargs = model.cached_model_kwargs(batch_size, model_kwargs)
+    if guidance_scale != 1.0 and guidance_scale != 0.0:
+        for k, v in model_kwargs.copy().items():
+            model_kwargs[k] = torch.cat([v, torch.zeros_like(v)], dim=0)
+
+    samples = None
+    with torch.autocast(device_type=device.type, enabled=use_fp16):
+        steps = karras_sample_progressive(
+            diffusion=diffusion,
+            model=model,
+            shape=(batch_size, model.d_latent),
+            steps=karras_steps,
+            clip_denoised=True,
+            model_kwargs=model_kwargs,
+            device=device,
+            sigma_min=1e-3,
+            sigma_max=160,
+            s_churn=0,
+            guidance_scale=guidance_scale,
+            progress=True,
+        )
+        start_time = time.perf_counter()
+        for step, sample in enumerate(steps, start=1):
+            samples = sample["x"]
+            check_cancelled()
+            send_progress(step, karras_steps, start_time)
+            if preview is not None:
+                preview.maybe_send(step, karras_steps, lambda: sample["pred_xstart"][0])
+    return samples
+
+def render_preview(models, latent, size):
+    """Renders one view of a latent as an (size, size, 3) uint8 array."""
+    if isinstance(models, SyntheticModels):
+        return models.render(latent, size)
+
+    import torch
+    from shap_e.models.nn.camera import DifferentiableCameraBatch, DifferentiableProjectiveCamera
+    from shap_e.util.notebooks import decode_latent_images
+
+    # the first of create_pan_cameras' views, without rendering the other nineteen
+    theta = np.pi / 4.0
+    z = np.array([np.sin(theta), np.cos(theta), -0.5])
+    z /= np.sqrt(np.sum(z ** 2))
+    x = np.array([np.cos(theta), -np.sin(theta), 0.0])
+    y = np.cross(z, x)
+    as_tensor = lambda v: torch.from_numpy(np.stack([v], axis=0)).float().to(latent.device)
+    cameras = DifferentiableCameraBatch(
+        shape=(1, 1),
+        flat_camera=DifferentiableProjectiveCamera(
+            origin=as_tensor(-z * 4), x=as_tensor(x), y=as_tensor(y), z=as_tensor(z),
+            width=size, height=size, x_fov=0.7, y_fov=0.7,
+        ),
+    )
+    with torch.no_grad():
+        image = decode_latent_images(models[0], latent, cameras, rendering_mode='stf')[0]
+    return np.asarray(image.convert("RGB"), dtype=np.uint8)
+
+class PreviewStreamer:
+    """Sends a preview render every `every` steps, skipping any that would push the time spent on
+    previews above max_overhead of the time spent sampling."""
+
+    def __init__(self, models, every, size, max_overhead):
+        self.models = models
+        self.every = max(0, int(every))
+        self.size = min(max(16, int(size)), 256)
+        self.max_overhead = max(0.0, float(max_overhead))
+        self.start = time.perf_counter()
+        self.seconds = 0.0
+        self.count = 0
+        self.skipped = 0
+
+    @property
+    def enabled(self):
+        return self.every > 0
+
+    def maybe_send(self, step, total_steps, latent_fn):
+        # the final step is followed by the real decode, so it is never previewed
+        if not self.enabled or step % self.every != 0 or step >= total_steps:
+            return
+        sampling_seconds = time.perf_counter() - self.start - self.seconds
+        if self.seconds > self.max_overhead * sampling_seconds:
+            self.skipped += 1
+            return
+
+        preview_start = time.perf_counter()
+        pixels = render_preview(self.models, latent_fn(), self.size)
+        elapsed = time.perf_counter() - preview_start
+        self.seconds += elapsed
+        self.count += 1
+        message = {
+            "type": "preview",
+            "step": step,
+            "total_steps": total_steps,
+            "width": int(pixels.shape[1]),
+            "height": int(pixels.shape[0]),
+            "render_ms": round(elapsed * 1000.0, 2),
+        }
+        pixel_bytes = np.ascontiguousarray(pixels).tobytes()
+        if _record_stream is not None:
+            message["pixels"] = pixel_bytes
+        else:
+            message["format"] = "rgb8"
+            message["data"] = base64.b64encode(pixel_bytes).decode("ascii")
+        send_json_message(message)
+
+    def summary(self):
+        return {
+            "preview_count": self.count,
+            "preview_skipped": self.skipped,
+            "preview_seconds": round(self.seconds, 4),
+            "sampling_seconds": round(time.perf_counter() - self.start - self.seconds, 4),
+        }
+
+def mesh_filename_for_prompt(prompt):
+    """Sanitizes the prompt to create a safe filename."""
     safe_prompt_portion = "".join(c if c.isalnum() or c in (' ', '_') else '_' for c in prompt[:50]).rstrip()
-    mesh_filename_base = "_".join(safe_prompt_portion.split()).lower() or "generated_model"
+    return "_".join(safe_prompt_portion.split()).lower() or "generated_model"
+
+class SyntheticTriMesh:
+    """The subset of Shap-E's TriMesh used here: verts, faces, vertex_channels, write_ply and write_obj."""
+
+    def __init__(self, verts, faces, vertex_channels):
+        self.verts = verts
+        self.faces = faces
+        self.vertex_channels = vertex_channels
+
+    def write_ply(self, f):
+        # Same binary layout as shap_e.rendering.ply_util.write_ply.
+        header = (
+            "ply\nformat binary_little_endian 1.0\n"
+            f"element vertex {len(self.verts)}\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+            f"element face {len(self.faces)}\n"
+            "property list uchar int vertex_index\nend_header\n"
+        )
+        f.write(header.encode("ascii"))
+
+        vertices = np.empty(len(self.verts), dtype=[("pos", "<f4", 3), ("rgb", "u1", 3)])
+        vertices["pos"] = self.verts
+        vertices["rgb"] = mesh_colors_u8(self)
+        f.write(vertices.tobytes())
+
+        faces = np.empty(len(self.faces), dtype=[("count", "u1"), ("idx", "<i4", 3)])
+        faces["count"] = 3
+        faces["idx"] = self.faces
+        f.write(faces.tobytes())
+
+    def write_obj(self, f):
+        colors = mesh_colors_u8(self) / 255.0
+        for (x, y, z), (r, g, b) in zip(self.verts, colors):
+            f.write(f"v {x:.6f} {y:.6f} {z:.6f} {r:.4f} {g:.4f} {b:.4f}\n")
+        for a, b, c in self.faces + 1:
+            f.write(f"f {a} {b} {c}\n")
+
+
+class SyntheticModels:
+    """Stand-in for the Shap-E models (--synthetic): every prompt decodes to a UV sphere tinted by the prompt."""
+
+    def __init__(self, segments, load_ms=0.0, step_ms=0.0, decode_ms=0.0, log_lines=0):
+        self.segments = max(3, int(segments))
+        self.load_seconds = max(0.0, load_ms) / 1000.0
+        self.step_seconds = max(0.0, step_ms) / 1000.0
+        self.decode_seconds = max(0.0, decode_ms) / 1000.0
+        self.log_lines = max(0, int(log_lines))
+
+    @timed_stage("model_load")
+    def load(self):
+        send_json_message({"type": "status", "message": "Loading models..."})
+        time.sleep(self.load_seconds)
+        send_json_message({"type": "status", "message": "Models loaded."})
+        return self
+
+    def sample(self, prompts, karras_steps, preview=None):
+        # the "latent" of a synthetic prompt is just its tint
+        latents = []
+        for prompt in prompts:
+            tint = zlib.crc32(prompt.encode("utf-8"))
+            latents.append(np.array([(tint & 0xFF) / 255.0, ((tint >> 8) & 0xFF) / 255.0, ((tint >> 16) & 0xFF) / 255.0], dtype=np.float32))
+
+        # tqdm-style progress on stderr, like sample_latents, so the editor's progress path is exercised too.
+        rng = np.random.default_rng(0)
+        for line in range(self.log_lines):
+            write_raw_output(f"synthetic library output {line}: nothing to see here\n", sys.stdout)
+        start_time = time.perf_counter()
+        for step in range(1, karras_steps + 1):
+            if self.step_seconds > 0.0:
+                time.sleep(self.step_seconds)
+            check_cancelled()
+            send_progress(step, karras_steps, start_time)
+            percent = step * 100 // karras_steps
+            bar = "#" * (percent // 10)
+            write_raw_output(f"\r{percent:3d}%|{bar:<10}| {step}/{karras_steps} [00:00<00:00, 1000.00it/s]", sys.stderr)
+            if preview is not None:
+                # the estimate sharpens towards the final tint as sampling goes on
+                noise = 1.0 - step / karras_steps
+                preview.maybe_send(step, karras_steps, lambda: np.clip(latents[0] + rng.normal(0.0, noise, 3), 0.0, 1.0).astype(np.float32))
+        write_raw_output("\n", sys.stderr)
+        return latents
+
+    def render(self, latent, size):
+        """A shaded disc in the latent's tint, standing in for a rendered view."""
+        coords = (np.arange(size, dtype=np.float32) + 0.5) / size * 2.0 - 1.0
+        x, y = np.meshgrid(coords, coords)
+        radius = np.sqrt(x * x + y * y)
+        shade = np.clip(1.0 - radius, 0.0, 1.0)[..., None] * 0.7 + 0.3
+        tint = np.asarray(latent, dtype=np.float32)[:3]
+        image = np.where((radius <= 0.9)[..., None], shade * tint, 0.1)
+        return np.round(np.clip(image, 0.0, 1.0) * 255.0).astype(np.uint8)
 
+    def decode(self, latent):
+        if self.decode_seconds > 0.0:
+            time.sleep(self.decode_seconds)
+        rings = self.segments
+        segments = self.segments
+        theta = np.linspace(0.0, np.pi, rings + 1, dtype=np.float32)[:, None]
+        phi = np.linspace(0.0, 2.0 * np.pi, segments, endpoint=False, dtype=np.float32)[None, :]
+        verts = np.stack([
+            np.sin(theta) * np.cos(phi),
+            np.sin(theta) * np.sin(phi),
+            np.broadcast_to(np.cos(theta), (rings + 1, segments)),
+        ], axis=-1).reshape(-1, 3).astype(np.float32)
+
+        ring = np.arange(rings)[:, None]
+        segment = np.arange(segments)[None, :]
+        a = ring * segments + segment
+        b = ring * segments + (segment + 1) % segments
+        c = a + segments
+        d = b + segments
+        faces = np.concatenate([
+            np.stack([a, c, b], axis=-1).reshape(-1, 3),
+            np.stack([b, c, d], axis=-1).reshape(-1, 3),
+        ]).astype(np.int32)
+        # Triangles with two corners on a pole row have no area; real Shap-E output has none, so drop them.
+        pole = (np.arange(len(verts)) < segments) | (np.arange(len(verts)) >= rings * segments)
+        faces = faces[pole[faces].sum(axis=1) < 2]
+
+        tint = np.asarray(latent, dtype=np.float32)
+        height = (verts[:, 2] + 1.0) * 0.5
+        vertex_channels = {
+            "R": height * tint[0],
+            "G": height * tint[1],
+            "B": 1.0 - height * tint[2],
+        }
+        return SyntheticTriMesh(verts, faces, vertex_channels)
+
+
+def mesh_colors_u8(mesh):
+    """Vertex colors as an (N, 3) uint8 array, or None when the mesh has no color channels."""
+    channels = mesh.vertex_channels or {}
+    if not all(name in channels for name in ("R", "G", "B")):
+        return None
+    colors = np.stack([np.asarray(channels[name], dtype=np.float32) for name in ("R", "G", "B")], axis=1)
+    return np.round(np.clip(colors, 0.0, 1.0) * 255.0).astype(np.uint8)
+
+@timed_stage("decode")
+def decode_mesh(models, latent):
+    """Decodes a latent to a TriMesh."""
+    if isinstance(models, SyntheticModels):
+        return models.decode(latent)
+
+    from shap_e.util.notebooks import decode_latent_mesh
+
+    # The raw decoded output must be converted to a TriMesh object to be saved.
+    return decode_latent_mesh(models[0], latent).tri_mesh()
+
+def latent_filename(mesh_filename_base):
+    return f"{mesh_filename_base}.latent.npy"
+
+@timed_stage("latent_save")
+def save_latent(latent, output_dir, mesh_filename_base):
+    """Writes a latent as fp16 .npy next to the mesh files and returns its absolute path."""
+    if hasattr(latent, "detach"):
+        latent = latent.detach().float().cpu().numpy()
+    latent_filepath = os.path.abspath(os.path.join(output_dir, latent_filename(mesh_filename_base)))
+    os.makedirs(output_dir, exist_ok=True)
+    with open(latent_filepath, 'wb') as f:
+        np.save(f, np.asarray(latent, dtype=np.float16))
+    return latent_filepath
+
+def load_latent(models, latent_filepath):
+    """Reads a latent written by save_latent, ready for decode_mesh."""
+    latent = np.load(latent_filepath).astype(np.float32)
+    if isinstance(models, SyntheticModels):
+        return latent
+
+    import torch
+    return torch.from_numpy(latent).to(next(models[0].parameters()).device)
+
+@timed_stage("export_files")
+def save_mesh_files(final_mesh_to_save, output_dir, mesh_filename_base):
+    """Saves a mesh as PLY and OBJ, returning the absolute paths (None on failure)."""
     ply_filepath = os.path.join(output_dir, f'{mesh_filename_base}.ply')
     obj_filepath = os.path.join(output_dir, f'{mesh_filename_base}.obj')
 
@@ -102,13 +648,570 @@ def run_generation(params):
         send_json_message({"type": "error", "message": f"Failed to save OBJ file: {str(e)}"})
         obj_filepath = None
 
+    return (
+        os.path.abspath(ply_filepath) if ply_filepath and os.path.exists(ply_filepath) else None,
+        os.path.abspath(obj_filepath) if obj_filepath and os.path.exists(obj_filepath) else None,
+    )
+
+def align_offset(offset, alignment=16):
+    return (offset + alignment - 1) // alignment * alignment
+
+@timed_stage("export_shm")
+def export_shared_mesh(mesh):
+    """Copies positions (float32 xyz), colors (uint8 rgb) and triangle indices (int32) into a new
+    shared-memory segment and returns the fields describing it for the "complete" message."""
+    positions = np.ascontiguousarray(mesh.verts, dtype=np.float32)
+    indices = np.ascontiguousarray(mesh.faces, dtype=np.int32)
+    colors = mesh_colors_u8(mesh)
+
+    positions_offset = 0
+    colors_offset = -1
+    cursor = positions.nbytes
+    if colors is not None:
+        colors_offset = align_offset(cursor)
+        cursor = colors_offset + colors.nbytes
+    indices_offset = align_offset(cursor)
+    size = max(1, indices_offset + indices.nbytes)
+
+    segment = shared_memory.SharedMemory(create=True, size=size)
+    buffer = np.ndarray((size,), dtype=np.uint8, buffer=segment.buf)
+    buffer[positions_offset:positions_offset + positions.nbytes] = positions.view(np.uint8).reshape(-1)
+    if colors is not None:
+        buffer[colors_offset:colors_offset + colors.nbytes] = colors.reshape(-1)
+    buffer[indices_offset:indices_offset + indices.nbytes] = indices.view(np.uint8).reshape(-1)
+    del buffer
+
+    with _shared_segments_lock:
+        _shared_segments[segment.name] = segment
+        while len(_shared_segments) > MAX_SHARED_SEGMENTS:
+            stale_name, _ = next(iter(_shared_segments.items()))
+            send_json_message({"type": "info", "message": f"Dropping unreleased shared mesh {stale_name}."})
+            release_shared_mesh(stale_name)
+
+    return {
+        "shm_name": segment.name,
+        "shm_size": size,
+        "vertex_count": len(positions),
+        "face_count": len(indices),
+        "positions_offset": positions_offset,
+        "colors_offset": colors_offset,
+        "indices_offset": indices_offset,
+    }
+
+def release_shared_mesh(name):
+    """Closes and unlinks a segment once the editor has imported it."""
+    with _shared_segments_lock:
+        segment = _shared_segments.pop(name, None)
+    if segment is None:
+        return
+    segment.close()
+    try:
+        segment.unlink()
+    except FileNotFoundError:
+        pass
+
+def run_generation(params, models=None):
+    """Handles the core logic of generation and file saving.
+
+    If models is None they are loaded for this call only (single-shot mode).
+    """
+    prompt = params.get("prompt")
+    output_dir = params.get("output_dir")
+    guidance_scale = float(params.get("guidance_scale", 15.0))
+    karras_steps = int(params.get("karras_steps", 64))
+    use_fp16 = bool(params.get("use_fp16", True))
+    seed = int(params.get("seed", -1))
+    model_version = params.get("model_version", MODEL_VERSION)
+    # The editor names cached results after their cache key.
+    output_name = params.get("output_name") or mesh_filename_for_prompt(prompt)
+    transport = params.get("transport", "file")
+    export_files = bool(params.get("export_files", True))
+    save_latents = bool(params.get("save_latent", True))
+    preview_every = int(params.get("preview_every", 0))
+    preview_size = int(params.get("preview_size", 64))
+    preview_max_overhead = float(params.get("preview_max_overhead", 0.15))
+
+    if model_version != MODEL_VERSION:
+        raise ValueError(f"Model version '{model_version}' requested, but this worker runs '{MODEL_VERSION}'.")
+
+    if models is None:
+        models = load_models(setup_device())
+    transport, export_files = resolve_transport(transport, export_files)
+
+    if seed >= 0 and not isinstance(models, SyntheticModels):
+        import torch
+        torch.manual_seed(seed)
+
+    send_json_message({"type": "status", "message": f"Generating latents for prompt: '{prompt}'..."})
+    preview = PreviewStreamer(models, preview_every, preview_size, preview_max_overhead)
+    latents = sample_prompt_latents(models, [prompt], guidance_scale, karras_steps, use_fp16, preview)
+
+    # saved before decoding, so a failed decode can be retried without sampling again
+    latent_filepath = save_latent(latents[0], output_dir, output_name) if save_latents else None
+
+    check_cancelled()
+    send_json_message({"type": "status", "message": "Latents generation complete. Decoding to mesh..."})
+    deliver_mesh(decode_mesh(models, latents[0]), output_dir, output_name, transport, export_files, latent_filepath,
+                 preview.summary() if preview.enabled else None)
+
+def resolve_transport(transport, export_files):
+    """Falls back to files where shared memory cannot work; files are always written for the file transport."""
+    if transport == "shm" and not _worker_mode:
+        # the segment would die with this process before the editor could map it
+        send_json_message({"type": "info", "message": "Shared-memory transport needs --worker, writing files instead."})
+        transport = "file"
+    if transport != "shm":
+        export_files = True
+    return transport, export_files
+
+def deliver_mesh(mesh, output_dir, output_name, transport, export_files, latent_filepath, extra=None):
+    """Writes the mesh files and/or the shared-memory segment and sends the "complete" message."""
+    ply_filepath, obj_filepath = None, None
+    if export_files:
+        os.makedirs(output_dir, exist_ok=True)
+        ply_filepath, obj_filepath = save_mesh_files(mesh, output_dir, output_name)
+
+    message = {
+        "type": "complete",
+        "message": "Generation Complete! Files saved." if transport != "shm" else "Generation Complete! Mesh is in shared memory.",
+        "ply_file": ply_filepath,
+        "obj_file": obj_filepath,
+        "latent_file": latent_filepath
+    }
+    if transport == "shm":
+        message.update(export_shared_mesh(mesh))
+    if extra:
+        message.update(extra)
+    send_json_message(message)
+
+def run_decode(params, models=None):
+    """Decodes a latent saved by an earlier job, skipping sampling entirely."""
+    latent_filepath = params.get("latent_file")
+    if not latent_filepath or not os.path.isfile(latent_filepath):
+        raise FileNotFoundError(f"Latent file not found: {latent_filepath}")
+
+    output_dir = params.get("output_dir") or os.path.dirname(latent_filepath)
+    default_name = os.path.basename(latent_filepath)
+    if default_name.endswith(".latent.npy"):
+        default_name = default_name[:-len(".latent.npy")]
+    output_name = params.get("output_name") or default_name
+    transport, export_files = resolve_transport(params.get("transport", "file"), bool(params.get("export_files", True)))
+
+    if models is None:
+        models = load_models(setup_device())
+
+    check_cancelled()
+    send_json_message({"type": "status", "message": "Decoding latents from stored file..."})
+    mesh = decode_mesh(models, load_latent(models, latent_filepath))
+    deliver_mesh(mesh, output_dir, output_name, transport, export_files, os.path.abspath(latent_filepath))
+
+def run_batch_generation(params, models):
+    """Generates a list of prompts with shared settings, sampling batch_size prompts per diffusion run.
+
+    Each finished item is reported with an "item_complete" message; a final "complete"
+    message summarizes the whole batch.
+    """
+    prompts = [str(p) for p in params.get("prompts", [])]
+    output_dir = params.get("output_dir")
+    guidance_scale = float(params.get("guidance_scale", 15.0))
+    karras_steps = int(params.get("karras_steps", 64))
+    use_fp16 = bool(params.get("use_fp16", True))
+    batch_size = max(1, int(params.get("batch_size", 4)))
+    save_latents = bool(params.get("save_latent", True))
+    # The editor may send a long batch in slices; item indices stay relative to the whole batch.
+    item_offset = int(params.get("item_offset", 0))
+    item_count = int(params.get("item_count", item_offset + len(prompts)))
+
+    if not prompts:
+        raise ValueError("Batch request contains no prompts.")
+
+    os.makedirs(output_dir, exist_ok=True)
+
+    total = len(prompts)
+    failed = 0
+    for group_start in range(0, total, batch_size):
+        group = prompts[group_start:group_start + batch_size]
+        first_item = item_offset + group_start
+        send_json_message({"type": "status", "message": f"Generating latents for items {first_item + 1}-{first_item + len(group)} of {item_count}..."})
+        latents = sample_prompt_latents(models, group, guidance_scale, karras_steps, use_fp16)
+
+        send_json_message({"type": "status", "message": "Latents generation complete. Decoding to mesh..."})
+        for offset, prompt in enumerate(group):
+            check_cancelled()
+            item_index = first_item + offset
+            # Prefix with the item index so repeated prompts in one batch never overwrite each other.
+            mesh_filename_base = f"{item_index:03d}_{mesh_filename_for_prompt(prompt)}"
+            try:
+                latent_filepath = save_latent(latents[offset], output_dir, mesh_filename_base) if save_latents else None
+                ply_filepath, obj_filepath = save_mesh_files(decode_mesh(models, latents[offset]), output_dir, mesh_filename_base)
+            except Exception as e:
+                failed += 1
+                send_json_message({
+                    "type": "item_error",
+                    "item_index": item_index,
+                    "prompt": prompt,
+                    "message": f"Failed to decode item: {str(e)}",
+                    "error_type": e.__class__.__name__
+                })
+                continue
+
+            send_json_message({
+                "type": "item_complete",
+                "item_index": item_index,
+                "item_count": item_count,
+                "prompt": prompt,
+                "ply_file": ply_filepath,
+                "obj_file": obj_filepath,
+                "latent_file": latent_filepath
+            })
+
     send_json_message({
         "type": "complete",
-        "message": "Generation Complete! Files saved.",
-        "ply_file": os.path.abspath(ply_filepath) if ply_filepath and os.path.exists(ply_filepath) else None,
-        "obj_file": os.path.abspath(obj_filepath) if obj_filepath and os.path.exists(obj_filepath) else None
+        "message": f"Batch Complete! {total - failed} of {total} items saved.",
+        "item_count": total,
+        "failed_count": failed
+    })
+
+def send_critical_error(e):
+    """Reports an unhandled exception back to the calling process."""
+    send_json_message({
+        "type": "error",
+        "message": f"A critical error occurred: {str(e)}",
+        "error_type": e.__class__.__name__,
+        "traceback": traceback.format_exc()
     })
 
+def read_job_lines(jobs):
+    """Drains stdin into jobs, so the editor's writes never wait for the running job to finish.
+
+    Releases and cancels are bookkeeping rather than jobs and take effect right away. Anything else is queued as parsed,
+    or as the ValueError it raised; None marks the end of stdin.
+    """
+    try:
+        for raw_line in sys.stdin:
+            line = raw_line.strip()
+            if not line:
+                continue
+            try:
+                job = json.loads(line)
+            except ValueError as e:
+                jobs.put(e)
+                continue
+            if isinstance(job, dict) and job.get("type") == "release":
+                release_shared_mesh(job.get("shm_name", ""))
+                continue
+            if isinstance(job, dict) and job.get("type") == "cancel":
+                if not request_cancel(job.get("job_id")):
+                    # answered anyway, so the editor knows the worker is alive and stops waiting for the cancel
+                    send_json_message({"type": "cancelled", "job_id": job.get("job_id"), "message": "Job had already finished.", "cancel_ms": 0.0})
+                continue
+            if isinstance(job, dict) and job.get("job_id") is not None:
+                with _cancel_lock:
+                    _pending_job_ids.add(job.get("job_id"))
+            jobs.put(job)
+            if isinstance(job, dict) and job.get("type") == "shutdown":
+                return
+    finally:
+        jobs.put(None)
+
+def start_job_reader():
+    """Starts draining stdin before the models load, so jobs written meanwhile do not back up in the pipe."""
+    # Jobs are UTF-8 JSON regardless of the console code page.
+    sys.stdin.reconfigure(encoding='utf-8')
+
+    jobs = queue.Queue()
+    threading.Thread(target=read_job_lines, args=(jobs,), name="stdin-reader", daemon=True).start()
+    return jobs
+
+def run_worker(models, jobs):
+    """Keeps the models resident and processes the JSON jobs start_job_reader queues, in order."""
+    global _active_job_id, _worker_mode
+    _worker_mode = True
+
+    send_json_message({"type": "ready"})
+
+    while True:
+        job = jobs.get()
+        if job is None:
+            break
+        if isinstance(job, ValueError):
+            send_json_message({"type": "error", "message": f"Malformed job line: {str(job)}", "error_type": "BadRequest"})
+            continue
+        if not isinstance(job, dict):
+            send_json_message({"type": "error", "message": "Job line is not a JSON object.", "error_type": "BadRequest"})
+            continue
+
+        job_type = job.get("type", "generate")
+        if job_type == "shutdown":
+            break
+
+        _active_job_id = job.get("job_id")
+        try:
+            # a job cancelled while it waited in the queue is dropped without starting
+            check_cancelled()
+            if job_type == "generate":
+                run_generation(job, models)
+            elif job_type == "batch":
+                run_batch_generation(job, models)
+            elif job_type == "decode":
+                run_decode(job, models)
+            else:
+                send_json_message({"type": "error", "message": f"Unknown job type: {job_type}", "error_type": "BadRequest"})
+        except JobCancelled:
+            cancel_time = _cancel_requests.get(_active_job_id, time.perf_counter())
+            send_json_message({"type": "cancelled", "message": "Job cancelled.",
+                               "cancel_ms": round((time.perf_counter() - cancel_time) * 1000.0, 3)})
+        except Exception as e:
+            send_critical_error(e)
+        finally:
+            finish_job_id(_active_job_id)
+            _active_job_id = None
+
+        send_json_message({"type": "ready"})
+
+    with _shared_segments_lock:
+        names = list(_shared_segments)
+    for name in names:
+        release_shared_mesh(name)
+    send_json_message({"type": "info", "message": "Worker shutting down."})
+
+class ClientDisconnected(Exception):
+    """The HTTP client of a job went away (e.g. the editor cancelled it)."""
+
+class JobStream:
+    """Streams one job's messages to its HTTP client as chunked newline-delimited JSON.
+
+    Paths of files written under the server root are given a matching "*_url" the client downloads them from.
+    """
+
+    def __init__(self, handler, job_id):
+        self.handler = handler
+        self.job_id = job_id
+
+    def send_message(self, data):
+        if "job_id" not in data:
+            data["job_id"] = self.job_id
+        for key in ("ply_file", "obj_file", "latent_file"):
+            url = self.handler.server.file_url(data.get(key))
+            if url:
+                data[key[:-len("_file")] + "_url"] = url
+        self.send_text(json.dumps(data, separators=(',', ':')) + "\n")
+
+    def send_text(self, text):
+        payload = text.encode("utf-8")
+        if payload:
+            self.write(b"%x\r\n%s\r\n" % (len(payload), payload))
+
+    def finish(self):
+        self.write(b"0\r\n\r\n")
+
+    def write(self, data):
+        try:
+            self.handler.wfile.write(data)
+            self.handler.wfile.flush()
+        except OSError as e:
+            raise ClientDisconnected(str(e)) from e
+
+class InferenceRequestHandler(BaseHTTPRequestHandler):
+    """POST /v1/jobs runs a job and streams its messages, GET /v1/files/... downloads a file it wrote and
+    GET /v1/health reports the server's load."""
+
+    # keep-alive, so clients reuse their connections from one job to the next
+    protocol_version = "HTTP/1.1"
+    server_version = "ShapEInference/1.0"
+
+    def do_GET(self):
+        if self.path == "/v1/health":
+            self.send_json(200, self.server.health())
+        elif self.path.startswith("/v1/files/"):
+            self.send_file(unquote(self.path[len("/v1/files/"):]))
+        else:
+            self.send_json(404, {"type": "error", "message": f"Unknown path: {self.path}", "error_type": "NotFound"})
+
+    def do_POST(self):
+        if self.path != "/v1/jobs":
+            self.send_json(404, {"type": "error", "message": f"Unknown path: {self.path}", "error_type": "NotFound"})
+            return
+        try:
+            job = json.loads(self.rfile.read(int(self.headers.get("Content-Length", 0))).decode("utf-8"))
+            if not isinstance(job, dict):
+                raise ValueError("the job must be a JSON object")
+            # files are written into the job's own directory; a name may not lead out of it
+            output_name = str(job.get("output_name") or "")
+            if "/" in output_name or "\\" in output_name or ".." in output_name:
+                raise ValueError(f"invalid output_name {output_name!r}")
+        except ValueError as e:
+            self.send_json(400, {"type": "error", "message": f"Malformed job: {str(e)}", "error_type": "BadRequest"})
+            return
+        self.server.run_job(job, self)
+
+    def send_json(self, status, data):
+        body = json.dumps(data, separators=(',', ':')).encode("utf-8")
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_file(self, relative_path):
+        path = self.server.resolve_file(relative_path)
+        if path is None:
+            self.send_json(404, {"type": "error", "message": f"File not found: {relative_path}", "error_type": "FileNotFound"})
+            return
+        self.send_response(200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(os.path.getsize(path)))
+        self.end_headers()
+        with open(path, "rb") as f:
+            shutil.copyfileobj(f, self.wfile, 1024 * 1024)
+
+    def log_message(self, format, *args):
+        # stdout is reserved for JSON messages
+        sys.stderr.write(f"{self.address_string()} {format % args}\n")
+
+class InferenceServer(ThreadingHTTPServer):
+    """Runs up to max_jobs jobs at once on the resident models; further requests wait for a slot with their
+    stream already open. Every job writes to a directory of its own under root, the last keep_jobs are kept."""
+
+    daemon_threads = True
+
+    def __init__(self, address, models, root, max_jobs, keep_jobs):
+        super().__init__(address, InferenceRequestHandler)
+        self.models = models
+        self.root = os.path.realpath(root)
+        self.max_jobs = max(1, int(max_jobs))
+        self.keep_jobs = max(1, int(keep_jobs))
+        self.job_slots = threading.Semaphore(self.max_jobs)
+        self.lock = threading.Lock()
+        self.active_jobs = 0
+        self.served_jobs = 0
+        self.job_dirs = OrderedDict()
+        os.makedirs(self.root, exist_ok=True)
+
+    def health(self):
+        with self.lock:
+            return {
+                "type": "health",
+                "status": "ok",
+                "model_version": MODEL_VERSION,
+                "synthetic": isinstance(self.models, SyntheticModels),
+                "active_jobs": self.active_jobs,
+                "max_jobs": self.max_jobs,
+                "served_jobs": self.served_jobs,
+            }
+
+    def file_url(self, path):
+        if not path:
+            return None
+        path = os.path.realpath(path)
+        if os.path.commonpath([path, self.root]) != self.root:
+            return None
+        return "/v1/files/" + quote(os.path.relpath(path, self.root).replace(os.sep, "/"))
+
+    def resolve_file(self, relative_path):
+        path = os.path.realpath(os.path.join(self.root, relative_path))
+        if os.path.commonpath([path, self.root]) != self.root or not os.path.isfile(path):
+            return None
+        return path
+
+    def make_job_dir(self, job_id):
+        name = re.sub(r"[^A-Za-z0-9_.-]", "_", job_id)
+        job_dir = os.path.join(self.root, name if name.strip(".") else "job")
+        with self.lock:
+            self.job_dirs[job_dir] = True
+            self.job_dirs.move_to_end(job_dir)
+            stale = []
+            while len(self.job_dirs) > self.keep_jobs:
+                stale.append(self.job_dirs.popitem(last=False)[0])
+        for path in stale:
+            shutil.rmtree(path, ignore_errors=True)
+        os.makedirs(job_dir, exist_ok=True)
+        return job_dir
+
+    def run_job(self, job, handler):
+        with self.lock:
+            self.active_jobs += 1
+            self.served_jobs += 1
+            job_id = str(job.get("job_id") or f"job_{self.served_jobs}")
+
+        stream = JobStream(handler, job_id)
+        handler.send_response(200)
+        handler.send_header("Content-Type", "application/x-ndjson")
+        handler.send_header("Transfer-Encoding", "chunked")
+        handler.end_headers()
+
+        _request_context.stream = stream
+        try:
+            with self.job_slots:
+                # output_dir names a directory on the client's machine; the client downloads the files instead
+                job["output_dir"] = self.make_job_dir(job_id)
+                job_type = job.get("type", "generate")
+                try:
+                    if job_type == "generate":
+                        run_generation(job, self.models)
+                    elif job_type == "batch":
+                        run_batch_generation(job, self.models)
+                    elif job_type == "decode":
+                        # the latent lives on the client's machine, so it comes along with the job
+                        latent_filepath = os.path.join(job["output_dir"], os.path.basename(str(job.get("latent_file") or "uploaded.latent.npy")))
+                        with open(latent_filepath, "wb") as f:
+                            f.write(base64.b64decode(job.pop("latent_data", "")))
+                        job["latent_file"] = latent_filepath
+                        run_decode(job, self.models)
+                    else:
+                        send_json_message({"type": "error", "message": f"Unknown job type: {job_type}", "error_type": "BadRequest"})
+                except ClientDisconnected:
+                    raise
+                except Exception as e:
+                    send_critical_error(e)
+            stream.finish()
+        except ClientDisconnected:
+            sys.stderr.write(f"Client of job {job_id} disconnected, job abandoned.\n")
+            handler.close_connection = True
+        finally:
+            _request_context.stream = None
+            with self.lock:
+                self.active_jobs -= 1
+
+def run_server(models, host, port, root, max_jobs, keep_jobs):
+    """Serves jobs over HTTP until interrupted; see InferenceRequestHandler for the endpoints."""
+    server = InferenceServer((host, port), models, root, max_jobs, keep_jobs)
+    send_json_message({"type": "info", "message": f"Serving on http://{host}:{server.server_address[1]} ({server.max_jobs} concurrent jobs, files under {server.root})."})
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+
+def parse_core_list(spec):
+    """Parses a core list such as "0-3,8,10-11" into a set of core indices."""
+    cores = set()
+    for part in spec.split(","):
+        part = part.strip()
+        if not part:
+            continue
+        first, _, last = part.partition("-")
+        cores.update(range(int(first), int(last or first) + 1))
+    return cores
+
+def pin_to_cores(spec):
+    """Restricts this process to the cores of --cores so pool workers do not compete for the same ones."""
+    cores = parse_core_list(spec)
+    if not cores:
+        return
+    if not hasattr(os, "sched_setaffinity"):
+        send_json_message({"type": "info", "message": "--cores is not supported on this platform; running unpinned."})
+        return
+    try:
+        os.sched_setaffinity(0, cores)
+    except OSError as e:
+        send_json_message({"type": "info", "message": f"Could not pin to cores {spec}: {e}"})
+        return
+    # torch is imported later and sizes its OpenMP pool from this instead of every core of the machine
+    os.environ.setdefault("OMP_NUM_THREADS", str(len(cores)))
+    send_json_message({"type": "info", "message": f"Pinned to cores {spec}."})
+
 def main():
     """Parses command-line arguments and initiates the generation process."""
     try:
@@ -116,22 +1219,65 @@ def main():
         
         parser = argparse.ArgumentParser()
         parser.add_argument("--ue", action="store_true", help="Flag for Unreal Engine specific behavior (if any).")
-        parser.add_argument("--params-base64", type=str, required=True, help="Base64 encoded JSON string of parameters.")
+        parser.add_argument("--worker", action="store_true", help="Stay alive and read JSON jobs from stdin, one per line.")
+        parser.add_argument("--params-base64", type=str, help="Base64 encoded JSON string of parameters.")
+        parser.add_argument("--synthetic", action="store_true", help="Replace the Shap-E models with a synthetic sphere generator (no GPU needed).")
+        parser.add_argument("--synthetic-segments", type=int, default=256, help="Sphere resolution used by --synthetic.")
+        parser.add_argument("--synthetic-load-ms", type=float, default=0.0, help="Simulated model load time of --synthetic.")
+        parser.add_argument("--synthetic-step-ms", type=float, default=0.0, help="Simulated time per Karras step of --synthetic.")
+        parser.add_argument("--synthetic-decode-ms", type=float, default=0.0, help="Simulated decode time per mesh of --synthetic.")
+        parser.add_argument("--synthetic-log-lines", type=int, default=0, help="Non-JSON lines --synthetic prints per sampling run.")
+        parser.add_argument("--serve", action="store_true", help="Serve jobs over HTTP instead of reading them from stdin.")
+        parser.add_argument("--host", type=str, default="127.0.0.1", help="Address --serve listens on.")
+        parser.add_argument("--port", type=int, default=8765, help="Port --serve listens on (0 picks a free one).")
+        parser.add_argument("--serve-root", type=str, default=os.path.join(tempfile.gettempdir(), "shape_serve"), help="Directory --serve writes job outputs to.")
+        parser.add_argument("--serve-max-jobs", type=int, default=0, help="Jobs --serve runs at once (default: 4 with --synthetic, 1 otherwise).")
+        parser.add_argument("--serve-keep-jobs", type=int, default=64, help="Job output directories --serve keeps for download.")
+        parser.add_argument("--device", type=int, default=-1, help="CUDA device index to load the models onto.")
+        parser.add_argument("--cores", type=str, default="", help="CPU cores to run on, e.g. 0-3 or 0,2,4 (Linux only).")
+        parser.add_argument("--record-fd", type=int, default=-1, help="File descriptor to send binary records to instead of JSON lines (with --worker).")
+        parser.add_argument("--record-versions", type=str, default="", help="Record protocol versions the editor speaks, e.g. 1,2.")
         args = parser.parse_args(sys.argv[1:])
-        
+
+        if args.worker and args.record_fd >= 0:
+            open_record_channel(args.record_fd, [int(v) for v in args.record_versions.split(",") if v.strip().isdigit()])
+
+        global _device_index
+        _device_index = args.device
+        if args.cores:
+            pin_to_cores(args.cores)
+
+        # a worker drains stdin from the start, also while the models load
+        jobs = start_job_reader() if args.worker else None
+
+        models = None
+        if args.synthetic:
+            models = SyntheticModels(args.synthetic_segments, args.synthetic_load_ms, args.synthetic_step_ms,
+                                     args.synthetic_decode_ms, args.synthetic_log_lines).load()
+
+        if args.serve:
+            max_jobs = args.serve_max_jobs or (4 if args.synthetic else 1)
+            run_server(models or load_models(setup_device()), args.host, args.port, args.serve_root, max_jobs, args.serve_keep_jobs)
+            return
+
+        if args.worker:
+            run_worker(models or load_models(setup_device()), jobs)
+            return
+
+        if not args.params_base64:
+            parser.error("--params-base64 is required unless --worker or --serve is given.")
+
         # Decode the parameters from the command line argument.
         json_string = base64.urlsafe_b64decode(args.params_base64).decode('utf-8')
         params = json.loads(json_string)
         
-        run_generation(params)
+        if params.get("type") == "decode":
+            run_decode(params, models)
+        else:
+            run_generation(params, models)
     except Exception as e:
         # Catch any critical error and report it back to the calling process.
-        send_json_message({
-            "type": "error",
-            "message": f"A critical error occurred: {str(e)}",
-            "error_type": e.__class__.__name__,
-            "traceback": traceback.format_exc()
-        })
+        send_critical_error(e)
 
 if __name__ == '__main__':
     main()
\ No newline at end of file
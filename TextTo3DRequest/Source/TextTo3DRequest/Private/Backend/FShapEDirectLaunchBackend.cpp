@@ -0,0 +1,396 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEDirectLaunchBackend.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_UNIX
+#include <spawn.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
+
+namespace ShapEDirectLaunchBackend
+{
+    struct FInterpreter
+    {
+        FString Path;
+        // Where it came from, for the log
+        FString Source;
+        // The worker's whole environment, "KEY=VALUE"
+        TArray<FString> Environment;
+    };
+
+    // Per launcher directory, shared by every backend (a pool starts several)
+    static FCriticalSection CacheCS;
+    static TMap<FString, FInterpreter> Cache;
+
+    static void SetVariable(TArray<FString>& Environment, const FString& Name, const FString& Value)
+    {
+        const FString Prefix = Name + TEXT("=");
+        Environment.RemoveAll([&Prefix](const FString& Entry) { return Entry.StartsWith(Prefix, ESearchCase::CaseSensitive); });
+        Environment.Add(Prefix + Value);
+    }
+
+    static FString GetVariable(const TArray<FString>& Environment, const FString& Name)
+    {
+        const FString Prefix = Name + TEXT("=");
+        for (const FString& Entry : Environment)
+        {
+            if (Entry.StartsWith(Prefix, ESearchCase::CaseSensitive))
+            {
+                return Entry.RightChop(Prefix.Len());
+            }
+        }
+        return FString();
+    }
+
+    // Splits the worker arguments on whitespace; double quotes keep a path with spaces together
+    static TArray<FString> SplitArguments(const FString& Arguments)
+    {
+        TArray<FString> Result;
+        FString Current;
+        bool bInQuotes = false;
+        bool bHasToken = false;
+        for (const TCHAR Char : Arguments)
+        {
+            if (Char == TCHAR('"'))
+            {
+                bInQuotes = !bInQuotes;
+                bHasToken = true;
+            }
+            else if (!bInQuotes && FChar::IsWhitespace(Char))
+            {
+                if (bHasToken)
+                {
+                    Result.Add(MoveTemp(Current));
+                    Current.Reset();
+                    bHasToken = false;
+                }
+            }
+            else
+            {
+                Current.AppendChar(Char);
+                bHasToken = true;
+            }
+        }
+        if (bHasToken)
+        {
+            Result.Add(MoveTemp(Current));
+        }
+        return Result;
+    }
+
+#if PLATFORM_UNIX
+    static bool IsExecutable(const FString& Path)
+    {
+        return !Path.IsEmpty() && access(TCHAR_TO_UTF8(*Path), X_OK) == 0;
+    }
+
+    static FString FindOnPath(const FString& Name)
+    {
+        TArray<FString> Directories;
+        FPlatformMisc::GetEnvironmentVariable(TEXT("PATH")).ParseIntoArray(Directories, TEXT(":"));
+        for (const FString& Directory : Directories)
+        {
+            const FString Candidate = FPaths::Combine(Directory, Name);
+            if (IsExecutable(Candidate))
+            {
+                return Candidate;
+            }
+        }
+        return FString();
+    }
+
+    // Does what run_shape.sh does on every start, once: SHAPE_PYTHON, else the Conda environment named in
+    // shape_config.txt, else python3 from PATH. The environment is the editor's, without the Python paths of its
+    // embedded interpreter, plus the variables Conda activation would have set
+    static bool Resolve(const FString& Directory, const FString& Override, FInterpreter& OutInterpreter, FString& OutError, FString& OutErrorType)
+    {
+        FInterpreter Interpreter;
+        for (char** Variable = environ; Variable && *Variable; ++Variable)
+        {
+            Interpreter.Environment.Add(UTF8_TO_TCHAR(*Variable));
+        }
+        Interpreter.Environment.RemoveAll([](const FString& Entry)
+        {
+            return Entry.StartsWith(TEXT("PYTHONHOME="), ESearchCase::CaseSensitive) || Entry.StartsWith(TEXT("PYTHONPATH="), ESearchCase::CaseSensitive);
+        });
+
+        FString EnvironmentPrefix;
+        FString EnvironmentName;
+        if (!Override.IsEmpty())
+        {
+            Interpreter.Path = Override;
+            Interpreter.Source = TEXT("settings");
+        }
+        else if (!FPlatformMisc::GetEnvironmentVariable(TEXT("SHAPE_PYTHON")).IsEmpty())
+        {
+            Interpreter.Path = FPlatformMisc::GetEnvironmentVariable(TEXT("SHAPE_PYTHON"));
+            Interpreter.Source = TEXT("SHAPE_PYTHON");
+        }
+        else
+        {
+            TArray<FString> ConfigLines;
+            FFileHelper::LoadFileToStringArray(ConfigLines, *FPaths::Combine(Directory, TEXT("shape_config.txt")));
+            FString AnacondaBase;
+            for (const FString& Line : ConfigLines)
+            {
+                FString Key, Value;
+                if (Line.Split(TEXT("="), &Key, &Value))
+                {
+                    if (Key == TEXT("ANACONDA_BASE"))
+                    {
+                        AnacondaBase = Value.TrimStartAndEnd();
+                    }
+                    else if (Key == TEXT("CONDA_ENV_NAME"))
+                    {
+                        EnvironmentName = Value.TrimStartAndEnd();
+                    }
+                }
+            }
+
+            if (!AnacondaBase.IsEmpty() && !EnvironmentName.IsEmpty())
+            {
+                EnvironmentPrefix = FPaths::Combine(AnacondaBase, TEXT("envs"), EnvironmentName);
+                Interpreter.Path = FPaths::Combine(EnvironmentPrefix, TEXT("bin"), TEXT("python"));
+                Interpreter.Source = TEXT("shape_config.txt");
+            }
+            else
+            {
+                Interpreter.Path = FindOnPath(TEXT("python3"));
+                Interpreter.Source = TEXT("PATH");
+            }
+        }
+
+        if (!IsExecutable(Interpreter.Path))
+        {
+            OutError = Interpreter.Path.IsEmpty()
+                ? FString(TEXT("No python3 on PATH; set SHAPE_PYTHON or configure shape_config.txt."))
+                : FString::Printf(TEXT("No interpreter at '%s' (from %s). Please verify settings in the config file."), *Interpreter.Path, *Interpreter.Source);
+            OutErrorType = TEXT("EnvActivationFailed");
+            return false;
+        }
+
+        if (!EnvironmentPrefix.IsEmpty())
+        {
+            const FString Path = GetVariable(Interpreter.Environment, TEXT("PATH"));
+            SetVariable(Interpreter.Environment, TEXT("PATH"), FPaths::Combine(EnvironmentPrefix, TEXT("bin")) + (Path.IsEmpty() ? FString() : TEXT(":") + Path));
+            SetVariable(Interpreter.Environment, TEXT("CONDA_PREFIX"), EnvironmentPrefix);
+            SetVariable(Interpreter.Environment, TEXT("CONDA_DEFAULT_ENV"), EnvironmentName);
+        }
+        // -u on the command line already unbuffers stdout; these keep the pipes unbuffered and UTF-8 for anything it starts
+        SetVariable(Interpreter.Environment, TEXT("PYTHONUNBUFFERED"), TEXT("1"));
+        SetVariable(Interpreter.Environment, TEXT("PYTHONIOENCODING"), TEXT("utf-8"));
+
+        OutInterpreter = MoveTemp(Interpreter);
+        return true;
+    }
+
+    // posix_spawn takes null-terminated arrays of narrow strings; Storage owns them
+    static void ToCStrings(const TArray<FString>& Strings, TArray<TArray<ANSICHAR>>& Storage, TArray<char*>& OutPointers)
+    {
+        Storage.Reset(Strings.Num());
+        OutPointers.Reset(Strings.Num() + 1);
+        for (const FString& String : Strings)
+        {
+            FTCHARToUTF8 Utf8(*String);
+            TArray<ANSICHAR>& Entry = Storage.AddDefaulted_GetRef();
+            Entry.Append(Utf8.Get(), Utf8.Length());
+            Entry.Add('\0');
+        }
+        for (TArray<ANSICHAR>& Entry : Storage)
+        {
+            OutPointers.Add(Entry.GetData());
+        }
+        OutPointers.Add(nullptr);
+    }
+#endif
+}
+
+FShapEDirectLaunchBackend::FShapEDirectLaunchBackend(const FShapEDirectLaunchSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+FShapEDirectLaunchBackend::~FShapEDirectLaunchBackend()
+{
+    // the base destructor would only reach its own KillWorkerProcess
+    Stop();
+}
+
+void FShapEDirectLaunchBackend::ResetInterpreterCache()
+{
+    FScopeLock Lock(&ShapEDirectLaunchBackend::CacheCS);
+    ShapEDirectLaunchBackend::Cache.Reset();
+}
+
+bool FShapEDirectLaunchBackend::LaunchWorker(const FString& ScriptPath, const FString& Arguments, FString& OutError, FString& OutErrorType)
+{
+#if PLATFORM_UNIX
+    using namespace ShapEDirectLaunchBackend;
+
+    const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::GetPath(ScriptPath));
+    const FString PythonScriptPath = FPaths::Combine(Directory, TEXT("ue_shape_interface.py"));
+    if (!FPaths::FileExists(PythonScriptPath))
+    {
+        OutError = FString::Printf(TEXT("Worker script not found: %s"), *PythonScriptPath);
+        OutErrorType = TEXT("FileNotFound");
+        return false;
+    }
+
+    FInterpreter Interpreter;
+    {
+        FScopeLock Lock(&CacheCS);
+        const FString CacheKey = Directory + TEXT("|") + Settings.Interpreter;
+        if (const FInterpreter* Cached = Cache.Find(CacheKey))
+        {
+            Interpreter = *Cached;
+        }
+        else
+        {
+            if (!Resolve(Directory, Settings.Interpreter, Interpreter, OutError, OutErrorType))
+            {
+                return false;
+            }
+            UE_LOG(LogTemp, Log, TEXT("FShapEDirectLaunchBackend: Resolved interpreter %s (from %s) for %s"), *Interpreter.Path, *Interpreter.Source, *Directory);
+            Cache.Add(CacheKey, Interpreter);
+        }
+    }
+
+    TArray<FString> Argv = { Interpreter.Path, TEXT("-u"), PythonScriptPath };
+    Argv.Append(SplitArguments(Arguments));
+    TArray<FString> Envp = MoveTemp(Interpreter.Environment);
+    for (const TPair<FString, FString>& Variable : Settings.Environment)
+    {
+        SetVariable(Envp, Variable.Key, Variable.Value);
+    }
+
+    TArray<TArray<ANSICHAR>> ArgStorage, EnvStorage;
+    TArray<char*> ArgPointers, EnvPointers;
+    ToCStrings(Argv, ArgStorage, ArgPointers);
+    ToCStrings(Envp, EnvStorage, EnvPointers);
+
+    const int ChildStdOut = static_cast<FPipeHandle*>(WritePipe)->GetHandle();
+    const int ChildStdIn = static_cast<FPipeHandle*>(StdInReadPipe)->GetHandle();
+    const int ChildRecords = RecordWritePipe ? static_cast<FPipeHandle*>(RecordWritePipe)->GetHandle() : -1;
+    // the child's ends become ordinary blocking stdio; ours must not survive into it, or it never sees EOF on stdin
+    for (const int Fd : { ChildStdOut, ChildStdIn, ChildRecords })
+    {
+        if (Fd >= 0)
+        {
+            fcntl(Fd, F_SETFL, fcntl(Fd, F_GETFL) & ~O_NONBLOCK);
+        }
+    }
+    for (void* ParentPipe : { ReadPipe, StdInWritePipe, RecordReadPipe })
+    {
+        if (ParentPipe)
+        {
+            const int Fd = static_cast<FPipeHandle*>(ParentPipe)->GetHandle();
+            fcntl(Fd, F_SETFD, fcntl(Fd, F_GETFD) | FD_CLOEXEC);
+        }
+    }
+
+    posix_spawn_file_actions_t FileActions;
+    posix_spawn_file_actions_init(&FileActions);
+    posix_spawn_file_actions_adddup2(&FileActions, ChildStdIn, STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&FileActions, ChildStdOut, STDOUT_FILENO);
+    // tqdm and tracebacks go to stderr; the parser takes them like the launcher's merged output
+    posix_spawn_file_actions_adddup2(&FileActions, ChildStdOut, STDERR_FILENO);
+    // after stdio, in case one of its pipes was the descriptor the records take over
+    if (ChildRecords >= 0)
+    {
+        posix_spawn_file_actions_adddup2(&FileActions, ChildRecords, ShapEWorkerRecords::WorkerFd);
+    }
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+    // same working directory as the launcher script gets
+    posix_spawn_file_actions_addchdir_np(&FileActions, TCHAR_TO_UTF8(*Directory));
+#endif
+
+    // own process group, so a kill reaches anything the worker starts; default signals, as the editor ignores SIGPIPE
+    posix_spawnattr_t Attributes;
+    posix_spawnattr_init(&Attributes);
+    sigset_t EmptyMask, DefaultSignals;
+    sigemptyset(&EmptyMask);
+    sigemptyset(&DefaultSignals);
+    sigaddset(&DefaultSignals, SIGPIPE);
+    sigaddset(&DefaultSignals, SIGINT);
+    sigaddset(&DefaultSignals, SIGTERM);
+    posix_spawnattr_setsigmask(&Attributes, &EmptyMask);
+    posix_spawnattr_setsigdefault(&Attributes, &DefaultSignals);
+    posix_spawnattr_setpgroup(&Attributes, 0);
+    posix_spawnattr_setflags(&Attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP);
+
+    pid_t Pid = -1;
+    const int Result = posix_spawn(&Pid, ArgStorage[0].GetData(), &FileActions, &Attributes, ArgPointers.GetData(), EnvPointers.GetData());
+    posix_spawnattr_destroy(&Attributes);
+    posix_spawn_file_actions_destroy(&FileActions);
+
+    if (Result != 0)
+    {
+        OutError = FString::Printf(TEXT("Failed to spawn %s: %s"), *Interpreter.Path, UTF8_TO_TCHAR(strerror(Result)));
+        OutErrorType = TEXT("ProcessLaunchError");
+        return false;
+    }
+
+    ChildPid = Pid;
+    return true;
+#else
+    UE_LOG(LogTemp, Warning, TEXT("FShapEDirectLaunchBackend: Direct launch is Linux only; starting the worker through the launcher script"));
+    return FShapEProcessBackend::LaunchWorker(ScriptPath, Arguments, OutError, OutErrorType);
+#endif
+}
+
+bool FShapEDirectLaunchBackend::WantsRecordChannel() const
+{
+#if PLATFORM_UNIX
+    return Settings.bBinaryRecords;
+#else
+    // the launcher script does not pass extra descriptors on
+    return false;
+#endif
+}
+
+bool FShapEDirectLaunchBackend::IsWorkerProcessRunning()
+{
+#if PLATFORM_UNIX
+    if (ChildPid <= 0)
+    {
+        return false;
+    }
+
+    int Status = 0;
+    if (waitpid(ChildPid, &Status, WNOHANG) == 0)
+    {
+        return true;
+    }
+    // exited and reaped (or not ours to wait for); either way its pid must not be signalled again
+    ChildPid = -1;
+    return false;
+#else
+    return FShapEProcessBackend::IsWorkerProcessRunning();
+#endif
+}
+
+void FShapEDirectLaunchBackend::KillWorkerProcess()
+{
+#if PLATFORM_UNIX
+    if (IsWorkerProcessRunning())
+    {
+        kill(-ChildPid, SIGKILL);
+        int Status = 0;
+        while (waitpid(ChildPid, &Status, 0) < 0 && errno == EINTR)
+        {
+        }
+        ChildPid = -1;
+    }
+#else
+    FShapEProcessBackend::KillWorkerProcess();
+#endif
+}
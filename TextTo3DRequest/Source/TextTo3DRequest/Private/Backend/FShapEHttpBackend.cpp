@@ -0,0 +1,901 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEHttpBackend.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Async/Async.h"
+#include "Misc/Base64.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+
+FShapEHttpBackend::FShapEHttpBackend(const FShapEHttpBackendSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.MaxConnectionsPerEndpoint = FMath::Max(1, Settings.MaxConnectionsPerEndpoint);
+    for (const FString& Url : Settings.Endpoints)
+    {
+        FString BaseUrl = Url.TrimStartAndEnd();
+        while (BaseUrl.RemoveFromEnd(TEXT("/")))
+        {
+        }
+        if (!BaseUrl.IsEmpty())
+        {
+            Endpoints.AddDefaulted_GetRef().Stats.BaseUrl = BaseUrl;
+        }
+    }
+    WaitingStreams.SetNum(Endpoints.Num());
+}
+
+FShapEHttpBackend::~FShapEHttpBackend()
+{
+    Stop();
+}
+
+bool FShapEHttpBackend::Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType)
+{
+    Stop();
+
+    if (Endpoints.Num() == 0)
+    {
+        OutError = TEXT("No inference server endpoints configured.");
+        OutErrorType = TEXT("ConfigurationError");
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    {
+        FScopeLock Lock(&StateCS);
+        ++Generation;
+        bIsRunning = true;
+        bAnnouncedReady = false;
+        for (FEndpoint& Endpoint : Endpoints)
+        {
+            Endpoint.RetryTime = 0.0;
+            Endpoint.LastHealthTime = -1.0;
+            Endpoint.bHealthCheckPending = false;
+        }
+    }
+
+    // nothing to launch; "ready" follows once the first server answers its health check
+    for (int32 EndpointIndex = 0; EndpointIndex < Endpoints.Num(); ++EndpointIndex)
+    {
+        SendHealthCheck(EndpointIndex);
+    }
+    StartSpan = FShapETimingSpan{ ShapEStages::WorkerSpawn, StartTime, FPlatformTime::Seconds() };
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEHttpBackend: Connecting to %d inference server(s), %d connection(s) each"), Endpoints.Num(), Settings.MaxConnectionsPerEndpoint);
+    return true;
+}
+
+void FShapEHttpBackend::Stop()
+{
+    TArray<FHttpRequestPtr> Requests;
+    {
+        FScopeLock Lock(&StateCS);
+        bIsRunning = false;
+
+        for (TPair<FString, TSharedPtr<FJobState, ESPMode::ThreadSafe>>& Pair : Jobs)
+        {
+            FJobState& Job = *Pair.Value;
+            Job.bCancelled = true;
+            for (const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream : Job.Streams)
+            {
+                Requests.Add(Stream->Request);
+            }
+            Requests.Append(Job.Downloads);
+            Job.Streams.Empty();
+        }
+        Jobs.Empty();
+
+        for (int32 EndpointIndex = 0; EndpointIndex < Endpoints.Num(); ++EndpointIndex)
+        {
+            WaitingStreams[EndpointIndex].Empty();
+            Endpoints[EndpointIndex].Stats.QueuedRequests = 0;
+        }
+    }
+
+    // completions of these still arrive and give their connections back
+    for (const FHttpRequestPtr& Request : Requests)
+    {
+        if (Request.IsValid())
+        {
+            Request->CancelRequest();
+        }
+    }
+}
+
+bool FShapEHttpBackend::IsRunning()
+{
+    FScopeLock Lock(&StateCS);
+    return bIsRunning;
+}
+
+TArray<FShapEHttpBackend::FEndpointStats> FShapEHttpBackend::GetEndpointStats()
+{
+    FScopeLock Lock(&StateCS);
+
+    TArray<FEndpointStats> Stats;
+    Stats.Reserve(Endpoints.Num());
+    for (const FEndpoint& Endpoint : Endpoints)
+    {
+        Stats.Add(Endpoint.Stats);
+    }
+    return Stats;
+}
+
+bool FShapEHttpBackend::Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage)
+{
+    TSharedRef<FJobState, ESPMode::ThreadSafe> Job = MakeShared<FJobState, ESPMode::ThreadSafe>();
+    Job->JobId = JobId;
+    Job->Type = JobMessage->GetStringField(TEXT("type"));
+    JobMessage->TryGetStringField(TEXT("output_dir"), Job->OutputDirectory);
+
+    // the manager's message stays untouched; the servers get a copy
+    TSharedRef<FJsonObject> Message = MakeShared<FJsonObject>();
+    Message->Values = JobMessage->Values;
+
+    if (Job->Type == TEXT("decode"))
+    {
+        // the latent lives on this machine, so it travels with the job
+        FString LatentPath;
+        TArray<uint8> LatentBytes;
+        JobMessage->TryGetStringField(TEXT("latent_file"), LatentPath);
+        if (!FFileHelper::LoadFileToArray(LatentBytes, *LatentPath))
+        {
+            FScopeLock Lock(&StateCS);
+            if (!bIsRunning)
+            {
+                return false;
+            }
+            Job->Generation = Generation;
+            FShapEWorkerEvent Error = MakeEvent(EShapEWorkerEventType::Error, *Job);
+            Error.Message = FString::Printf(TEXT("Latent file not found: %s"), *LatentPath);
+            Error.ErrorType = TEXT("FileNotFoundError");
+            Emit(MoveTemp(Error));
+
+            FShapEWorkerEvent Ready = MakeEvent(EShapEWorkerEventType::Ready, *Job);
+            Ready.JobId.Reset();
+            Emit(MoveTemp(Ready));
+            return true;
+        }
+        Message->SetStringField(TEXT("latent_data"), FBase64::Encode(LatentBytes));
+        Job->LocalLatentPath = LatentPath;
+        if (Job->OutputDirectory.IsEmpty())
+        {
+            Job->OutputDirectory = FPaths::GetPath(LatentPath);
+        }
+    }
+    if (Job->OutputDirectory.IsEmpty())
+    {
+        Job->OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEDownloads"));
+    }
+
+    TArray<int32> UsedEndpoints;
+    TArray<int32> StaleHealthChecks;
+    {
+        FScopeLock Lock(&StateCS);
+        if (!bIsRunning)
+        {
+            return false;
+        }
+        Job->Generation = Generation;
+        Jobs.Add(JobId, Job);
+
+        auto AddStream = [this, &Job, &UsedEndpoints](const TSharedRef<FJsonObject>& StreamMessage, int32 EndpointIndex, int32 FirstItem, int32 NumItems)
+        {
+            TSharedRef<FStream, ESPMode::ThreadSafe> Stream = MakeShared<FStream, ESPMode::ThreadSafe>();
+            Stream->Job = Job;
+            Stream->FirstItem = FirstItem;
+            Stream->NumItems = NumItems;
+
+            FTCHARToUTF8 Utf8Body(*ShapEJson::ToCondensedString(StreamMessage));
+            Stream->Body.Append(reinterpret_cast<const uint8*>(Utf8Body.Get()), Utf8Body.Length());
+
+            Job->Streams.Add(Stream);
+            ++Job->OpenStreams;
+            QueueStream(Stream, EndpointIndex);
+            UsedEndpoints.AddUnique(EndpointIndex);
+        };
+
+        const TArray<TSharedPtr<FJsonValue>>* Prompts = nullptr;
+        int32 ItemOffset = 0;
+        if (Job->Type == TEXT("batch") && Message->TryGetArrayField(TEXT("prompts"), Prompts))
+        {
+            Message->TryGetNumberField(TEXT("item_offset"), ItemOffset);
+            Job->ItemCount = Prompts->Num();
+
+            // one share per endpoint that is up, in order of load; item indices stay relative to the whole batch
+            TArray<int32> ShareEndpoints;
+            const int32 MaxShares = Settings.bFanOutBatches ? FMath::Min(Prompts->Num(), Endpoints.Num()) : 1;
+            const double Now = FPlatformTime::Seconds();
+            while (ShareEndpoints.Num() < MaxShares)
+            {
+                const int32 EndpointIndex = PickEndpoint(ShareEndpoints);
+                if (EndpointIndex == INDEX_NONE || (ShareEndpoints.Num() > 0 && Endpoints[EndpointIndex].RetryTime > Now))
+                {
+                    break;
+                }
+                ShareEndpoints.Add(EndpointIndex);
+            }
+
+            int32 FirstItem = 0;
+            for (int32 Share = 0; Share < ShareEndpoints.Num(); ++Share)
+            {
+                const int32 NumItems = Prompts->Num() / ShareEndpoints.Num() + (Share < Prompts->Num() % ShareEndpoints.Num() ? 1 : 0);
+
+                TSharedRef<FJsonObject> ShareMessage = MakeShared<FJsonObject>();
+                ShareMessage->Values = Message->Values;
+                ShareMessage->SetArrayField(TEXT("prompts"), TArray<TSharedPtr<FJsonValue>>(Prompts->GetData() + FirstItem, NumItems));
+                ShareMessage->SetNumberField(TEXT("item_offset"), ItemOffset + FirstItem);
+                AddStream(ShareMessage, ShareEndpoints[Share], ItemOffset + FirstItem, NumItems);
+                FirstItem += NumItems;
+            }
+        }
+        else
+        {
+            AddStream(Message, PickEndpoint(TArray<int32>()), 0, 0);
+        }
+
+        // keep the reported load fresh for the next pick
+        const double Now = FPlatformTime::Seconds();
+        for (int32 EndpointIndex = 0; EndpointIndex < Endpoints.Num(); ++EndpointIndex)
+        {
+            if (!Endpoints[EndpointIndex].bHealthCheckPending && Now - Endpoints[EndpointIndex].LastHealthTime > Settings.HealthRefreshSeconds)
+            {
+                StaleHealthChecks.Add(EndpointIndex);
+            }
+        }
+    }
+
+    if (UsedEndpoints.Num() > 1)
+    {
+        UE_LOG(LogTemp, Log, TEXT("FShapEHttpBackend: Batch %s fanned out to %d servers"), *JobId, UsedEndpoints.Num());
+    }
+    for (const int32 EndpointIndex : UsedEndpoints)
+    {
+        SendWaitingStreams(EndpointIndex);
+    }
+    for (const int32 EndpointIndex : StaleHealthChecks)
+    {
+        SendHealthCheck(EndpointIndex);
+    }
+    return true;
+}
+
+void FShapEHttpBackend::Cancel(const FString& JobId)
+{
+    TArray<FHttpRequestPtr> Requests;
+    {
+        FScopeLock Lock(&StateCS);
+
+        TSharedPtr<FJobState, ESPMode::ThreadSafe> Job;
+        if (!Jobs.RemoveAndCopyValue(JobId, Job))
+        {
+            return;
+        }
+        Job->bCancelled = true;
+
+        for (const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream : Job->Streams)
+        {
+            if (Stream->Request.IsValid())
+            {
+                Requests.Add(Stream->Request);
+            }
+            else if (WaitingStreams.IsValidIndex(Stream->EndpointIndex) && WaitingStreams[Stream->EndpointIndex].Remove(Stream) > 0)
+            {
+                --Endpoints[Stream->EndpointIndex].Stats.QueuedRequests;
+            }
+        }
+        Requests.Append(Job->Downloads);
+        Job->Streams.Empty();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEHttpBackend: Closing %d request(s) to cancel job %s"), Requests.Num(), *JobId);
+    for (const FHttpRequestPtr& Request : Requests)
+    {
+        Request->CancelRequest();
+    }
+}
+
+int32 FShapEHttpBackend::PickEndpoint(const TArray<int32>& Excluded) const
+{
+    const double Now = FPlatformTime::Seconds();
+
+    int32 BestIndex = INDEX_NONE;
+    bool bBestAvailable = false;
+    double BestLoad = 0.0;
+    for (int32 EndpointIndex = 0; EndpointIndex < Endpoints.Num(); ++EndpointIndex)
+    {
+        if (Excluded.Contains(EndpointIndex))
+        {
+            continue;
+        }
+
+        const FEndpoint& Endpoint = Endpoints[EndpointIndex];
+        const bool bAvailable = Endpoint.RetryTime <= Now;
+        const int32 OpenJobs = Endpoint.Stats.OpenRequests + Endpoint.Stats.QueuedRequests + Endpoint.ExternalJobs;
+        const double Load = double(OpenJobs) / FMath::Max(1, Endpoint.Stats.ReportedMaxJobs);
+
+        bool bBetter = BestIndex == INDEX_NONE || (bAvailable && !bBestAvailable);
+        if (!bBetter && bAvailable == bBestAvailable)
+        {
+            // equally loaded servers: the one that answers faster
+            bBetter = Load < BestLoad || (Load == BestLoad && Endpoint.Stats.FirstByteSeconds < Endpoints[BestIndex].Stats.FirstByteSeconds);
+        }
+        if (bBetter)
+        {
+            BestIndex = EndpointIndex;
+            bBestAvailable = bAvailable;
+            BestLoad = Load;
+        }
+    }
+    return BestIndex;
+}
+
+void FShapEHttpBackend::SendHealthCheck(int32 EndpointIndex)
+{
+    FString Url;
+    uint32 CheckGeneration = 0;
+    {
+        FScopeLock Lock(&StateCS);
+        FEndpoint& Endpoint = Endpoints[EndpointIndex];
+        if (Endpoint.bHealthCheckPending)
+        {
+            return;
+        }
+        Endpoint.bHealthCheckPending = true;
+        Url = Endpoint.Stats.BaseUrl + TEXT("/v1/health");
+        CheckGeneration = Generation;
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Url);
+    Request->SetVerb(TEXT("GET"));
+    Request->SetHeader(TEXT("Connection"), TEXT("keep-alive"));
+    Request->SetTimeout(5.f);
+    Request->OnProcessRequestComplete().BindSP(this, &FShapEHttpBackend::OnHealthCheckComplete, EndpointIndex, CheckGeneration);
+    Request->ProcessRequest();
+}
+
+void FShapEHttpBackend::OnHealthCheckComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 EndpointIndex, uint32 CheckGeneration)
+{
+    TSharedPtr<FJsonObject> Health;
+    if (bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+    {
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+        FJsonSerializer::Deserialize(Reader, Health);
+    }
+
+    FString ModelVersion;
+    bool bAnnounce = false;
+    {
+        FScopeLock Lock(&StateCS);
+        FEndpoint& Endpoint = Endpoints[EndpointIndex];
+        Endpoint.bHealthCheckPending = false;
+        Endpoint.LastHealthTime = FPlatformTime::Seconds();
+
+        if (!Health.IsValid())
+        {
+            if (Endpoint.Stats.bReachable || Endpoint.RetryTime == 0.0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("FShapEHttpBackend: %s is not reachable (HTTP %d)"), *Endpoint.Stats.BaseUrl, Response.IsValid() ? Response->GetResponseCode() : 0);
+            }
+            Endpoint.Stats.bReachable = false;
+            Endpoint.RetryTime = Endpoint.LastHealthTime + Settings.RetryDelaySeconds;
+            return;
+        }
+
+        int32 ActiveJobs = 0;
+        int32 MaxJobs = 1;
+        Health->TryGetNumberField(TEXT("active_jobs"), ActiveJobs);
+        Health->TryGetNumberField(TEXT("max_jobs"), MaxJobs);
+        Health->TryGetStringField(TEXT("model_version"), ModelVersion);
+
+        Endpoint.Stats.bReachable = true;
+        Endpoint.RetryTime = 0.0;
+        Endpoint.Stats.ReportedActiveJobs = ActiveJobs;
+        Endpoint.Stats.ReportedMaxJobs = FMath::Max(1, MaxJobs);
+        // our own open requests are part of what the server reported
+        Endpoint.ExternalJobs = FMath::Max(0, ActiveJobs - Endpoint.Stats.OpenRequests);
+
+        bAnnounce = bIsRunning && CheckGeneration == Generation && !bAnnouncedReady;
+        bAnnouncedReady |= bAnnounce;
+    }
+
+    if (bAnnounce)
+    {
+        FShapEWorkerEvent Ready;
+        Ready.Type = EShapEWorkerEventType::Ready;
+        Ready.WorkerGeneration = CheckGeneration;
+        Ready.ReceiveTime = FPlatformTime::Seconds();
+        Ready.Message = FString::Printf(TEXT("Connected to %s (%s)"), *Request->GetURL(), *ModelVersion);
+        Emit(MoveTemp(Ready));
+    }
+}
+
+void FShapEHttpBackend::QueueStream(const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream, int32 EndpointIndex)
+{
+    // called with StateCS held
+    Stream->EndpointIndex = EndpointIndex;
+    Stream->TriedEndpoints.AddUnique(EndpointIndex);
+    WaitingStreams[EndpointIndex].Add(Stream);
+    ++Endpoints[EndpointIndex].Stats.QueuedRequests;
+}
+
+void FShapEHttpBackend::SendWaitingStreams(int32 EndpointIndex)
+{
+    TArray<TSharedRef<FStream, ESPMode::ThreadSafe>> ToSend;
+    {
+        FScopeLock Lock(&StateCS);
+        FEndpoint& Endpoint = Endpoints[EndpointIndex];
+        TArray<TSharedRef<FStream, ESPMode::ThreadSafe>>& Waiting = WaitingStreams[EndpointIndex];
+        while (Waiting.Num() > 0 && Endpoint.Stats.OpenRequests < Settings.MaxConnectionsPerEndpoint)
+        {
+            ToSend.Add(Waiting[0]);
+            Waiting.RemoveAt(0);
+            --Endpoint.Stats.QueuedRequests;
+            ++Endpoint.Stats.OpenRequests;
+        }
+    }
+
+    for (const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream : ToSend)
+    {
+        SendStream(Stream);
+    }
+}
+
+void FShapEHttpBackend::SendStream(const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    {
+        FScopeLock Lock(&StateCS);
+        Request->SetURL(Endpoints[Stream->EndpointIndex].Stats.BaseUrl + TEXT("/v1/jobs"));
+        Stream->Request = Request;
+        Stream->SendTime = FPlatformTime::Seconds();
+        Stream->bReceivedData = false;
+    }
+
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/x-ndjson"));
+    // the connection goes back to the pool after the job and carries the next one
+    Request->SetHeader(TEXT("Connection"), TEXT("keep-alive"));
+    Request->SetContent(Stream->Body);
+    Request->SetActivityTimeout(Settings.ActivityTimeoutSeconds);
+    // lines are handled as they arrive instead of once the whole job is done
+    Request->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateSP(this, &FShapEHttpBackend::OnStreamData, Stream));
+    Request->OnProcessRequestComplete().BindSP(this, &FShapEHttpBackend::OnStreamComplete, Stream);
+    Request->ProcessRequest();
+}
+
+void FShapEHttpBackend::OnStreamData(void* Data, int64& Length, TSharedRef<FStream, ESPMode::ThreadSafe> Stream)
+{
+    // HTTP thread
+    if (!Stream->bReceivedData)
+    {
+        FScopeLock Lock(&StateCS);
+        Stream->bReceivedData = true;
+        FEndpointStats& Stats = Endpoints[Stream->EndpointIndex].Stats;
+        const double FirstByteSeconds = FPlatformTime::Seconds() - Stream->SendTime;
+        Stats.FirstByteSeconds = Stats.FirstByteSeconds > 0.0 ? 0.8 * Stats.FirstByteSeconds + 0.2 * FirstByteSeconds : FirstByteSeconds;
+    }
+
+    Stream->Framer.Append(static_cast<const uint8*>(Data), static_cast<int32>(Length), [this, &Stream](const UTF8CHAR* Line, int32 LineLength)
+    {
+        HandleStreamLine(*Stream, FUtf8StringView(Line, LineLength));
+    });
+}
+
+void FShapEHttpBackend::HandleStreamLine(FStream& Stream, FUtf8StringView Line)
+{
+    FShapEParsedLine Parsed;
+    FShapEOutputParser::Parse(Line, Parsed);
+
+    TSharedRef<FJobState, ESPMode::ThreadSafe> Job = Stream.Job.ToSharedRef();
+    FShapEWorkerEvent Event;
+    if (!Stream.LineDecoder.Decode(Line, Parsed, Job->Generation, Event) || Event.Type == EShapEWorkerEventType::Ready)
+    {
+        return;
+    }
+    if (Event.JobId.IsEmpty())
+    {
+        Event.JobId = Job->JobId;
+    }
+
+    const bool bBatch = Job->Type == TEXT("batch");
+    FScopeLock Lock(&StateCS);
+    if (Job->bCancelled)
+    {
+        return;
+    }
+
+    switch (Event.Type)
+    {
+    case EShapEWorkerEventType::Stage:
+    {
+        // every server has a clock of its own; map its timestamps onto ours so the manager sees one clock
+        FEndpoint& Endpoint = Endpoints[Stream.EndpointIndex];
+        const double ClockOffset = Event.ReceiveTime - Event.WorkerTimestamp;
+        if (!Endpoint.bHasClockOffset || ClockOffset < Endpoint.ClockOffset)
+        {
+            Endpoint.ClockOffset = ClockOffset;
+            Endpoint.bHasClockOffset = true;
+        }
+        Event.WorkerTimestamp += Endpoint.ClockOffset;
+        break;
+    }
+    case EShapEWorkerEventType::Complete:
+    case EShapEWorkerEventType::ItemComplete:
+    {
+        if (Event.Type == EShapEWorkerEventType::Complete && bBatch)
+        {
+            // a share's summary; the batch's own follows once every share is done
+            return;
+        }
+
+        FString PlyUrl, ObjUrl, LatentUrl;
+        Parsed.TryGetString(UTF8TEXTVIEW("ply_url"), PlyUrl);
+        Parsed.TryGetString(UTF8TEXTVIEW("obj_url"), ObjUrl);
+        Parsed.TryGetString(UTF8TEXTVIEW("latent_url"), LatentUrl);
+
+        const bool bFinal = Event.Type == EShapEWorkerEventType::Complete;
+        Job->bHasResult |= bFinal;
+        if (!bFinal)
+        {
+            Job->ReportedItems.Add(Event.ItemIndex);
+        }
+        // counted now, so the stream ending first cannot finish the job before the files are here
+        ++Job->PendingDownloads;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis = AsWeak(), Job, EndpointIndex = Stream.EndpointIndex, Event = MoveTemp(Event), PlyUrl, ObjUrl, LatentUrl, bFinal]() mutable
+        {
+            if (TSharedPtr<FShapEHttpBackend, ESPMode::ThreadSafe> This = WeakThis.Pin())
+            {
+                This->DownloadResult(Job, EndpointIndex, MoveTemp(Event), PlyUrl, ObjUrl, LatentUrl, bFinal);
+            }
+        });
+        return;
+    }
+    case EShapEWorkerEventType::ItemError:
+        Job->ReportedItems.Add(Event.ItemIndex);
+        ++Job->FailedItems;
+        break;
+    case EShapEWorkerEventType::Error:
+        if (bBatch)
+        {
+            Stream.ErrorMessage = Event.Message;
+            Stream.ErrorType = Event.ErrorType;
+        }
+        else if (!Job->FinalEvent.IsSet())
+        {
+            Job->FinalEvent = MoveTemp(Event);
+        }
+        return;
+    default:
+        break;
+    }
+
+    Emit(MoveTemp(Event));
+}
+
+void FShapEHttpBackend::OnStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, TSharedRef<FStream, ESPMode::ThreadSafe> Stream)
+{
+    // the body has been streamed in full; a last line without a terminator is still in the framer
+    Stream->Framer.Flush([this, &Stream](const UTF8CHAR* Line, int32 LineLength)
+    {
+        HandleStreamLine(*Stream, FUtf8StringView(Line, LineLength));
+    });
+
+    const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+    const bool bSucceeded = bConnectedSuccessfully && EHttpResponseCodes::IsOk(ResponseCode);
+    TSharedRef<FJobState, ESPMode::ThreadSafe> Job = Stream->Job.ToSharedRef();
+    const int32 EndpointIndex = Stream->EndpointIndex;
+    int32 RetryEndpointIndex = INDEX_NONE;
+    {
+        FScopeLock Lock(&StateCS);
+        FEndpoint& Endpoint = Endpoints[EndpointIndex];
+        --Endpoint.Stats.OpenRequests;
+        if (bSucceeded)
+        {
+            ++Endpoint.Stats.CompletedRequests;
+        }
+        else
+        {
+            ++Endpoint.Stats.FailedRequests;
+        }
+
+        if (Job->bCancelled)
+        {
+            Stream->Request.Reset();
+        }
+        else
+        {
+            if (!bConnectedSuccessfully && !Stream->bReceivedData)
+            {
+                // never got through: take the server out of rotation for a while and try another one
+                UE_LOG(LogTemp, Warning, TEXT("FShapEHttpBackend: Could not reach %s for job %s"), *Endpoint.Stats.BaseUrl, *Job->JobId);
+                Endpoint.Stats.bReachable = false;
+                Endpoint.RetryTime = FPlatformTime::Seconds() + Settings.RetryDelaySeconds;
+
+                const int32 NextIndex = PickEndpoint(Stream->TriedEndpoints);
+                if (NextIndex != INDEX_NONE && Endpoints[NextIndex].RetryTime <= FPlatformTime::Seconds())
+                {
+                    RetryEndpointIndex = NextIndex;
+                    Stream->Request.Reset();
+                    QueueStream(Stream, NextIndex);
+                }
+            }
+
+            if (RetryEndpointIndex == INDEX_NONE)
+            {
+                --Job->OpenStreams;
+
+                FString ErrorMessage = Stream->ErrorMessage;
+                FString ErrorType = Stream->ErrorType;
+                if (!bSucceeded)
+                {
+                    ErrorMessage = ResponseCode != 0
+                        ? FString::Printf(TEXT("Inference server %s answered HTTP %d."), *Endpoint.Stats.BaseUrl, ResponseCode)
+                        : FString::Printf(TEXT("Lost the connection to inference server %s."), *Endpoint.Stats.BaseUrl);
+                    ErrorType = TEXT("ConnectionError");
+                }
+
+                if (Job->Type == TEXT("batch"))
+                {
+                    // items of this share that never reported back fail with it
+                    for (int32 ItemIndex = Stream->FirstItem; ItemIndex < Stream->FirstItem + Stream->NumItems; ++ItemIndex)
+                    {
+                        if (Job->ReportedItems.Contains(ItemIndex))
+                        {
+                            continue;
+                        }
+                        Job->ReportedItems.Add(ItemIndex);
+                        ++Job->FailedItems;
+
+                        FShapEWorkerEvent ItemError = MakeEvent(EShapEWorkerEventType::ItemError, *Job);
+                        ItemError.ItemIndex = ItemIndex;
+                        ItemError.Message = ErrorMessage.IsEmpty() ? TEXT("The inference server did not report this item.") : ErrorMessage;
+                        ItemError.ErrorType = ErrorType;
+                        Emit(MoveTemp(ItemError));
+                    }
+                }
+                else if (!Job->bHasResult && !Job->FinalEvent.IsSet())
+                {
+                    FShapEWorkerEvent Error = MakeEvent(EShapEWorkerEventType::Error, *Job);
+                    Error.Message = ErrorMessage.IsEmpty() ? TEXT("The inference server closed the stream without a result.") : ErrorMessage;
+                    Error.ErrorType = ErrorType.IsEmpty() ? TEXT("ConnectionError") : ErrorType;
+                    Job->FinalEvent = MoveTemp(Error);
+                }
+            }
+        }
+    }
+
+    SendWaitingStreams(EndpointIndex);
+    if (RetryEndpointIndex != INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Log, TEXT("FShapEHttpBackend: Retrying job %s on %s"), *Job->JobId, *Endpoints[RetryEndpointIndex].Stats.BaseUrl);
+        SendWaitingStreams(RetryEndpointIndex);
+        return;
+    }
+    FinishJobIfDone(Job);
+}
+
+void FShapEHttpBackend::DownloadResult(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job, int32 EndpointIndex, FShapEWorkerEvent Event, const FString& PlyUrl, const FString& ObjUrl, const FString& LatentUrl, bool bFinal)
+{
+    TSharedRef<FPendingResult, ESPMode::ThreadSafe> Result = MakeShared<FPendingResult, ESPMode::ThreadSafe>();
+    Result->Event = MoveTemp(Event);
+    Result->bFinal = bFinal;
+    // the server's paths mean nothing on this machine; only what was downloaded is reported
+    Result->Event.PlyPath.Reset();
+    Result->Event.ObjPath.Reset();
+    Result->Event.LatentPath = Job->LocalLatentPath;
+
+    TArray<TPair<EResultFile, FString>> Files;
+    if (!PlyUrl.IsEmpty())
+    {
+        Files.Emplace(EResultFile::Ply, PlyUrl);
+    }
+    else
+    {
+        Result->bFailed = true;
+    }
+    if (Settings.bDownloadObj && !ObjUrl.IsEmpty())
+    {
+        Files.Emplace(EResultFile::Obj, ObjUrl);
+    }
+    if (Settings.bDownloadLatent && !LatentUrl.IsEmpty() && Job->LocalLatentPath.IsEmpty())
+    {
+        Files.Emplace(EResultFile::Latent, LatentUrl);
+    }
+
+    TArray<TSharedRef<IHttpRequest, ESPMode::ThreadSafe>> Requests;
+    {
+        FScopeLock Lock(&StateCS);
+        if (Job->bCancelled)
+        {
+            return;
+        }
+
+        Result->PendingFiles = Files.Num();
+        for (const TPair<EResultFile, FString>& File : Files)
+        {
+            TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+            Request->SetURL(Endpoints[EndpointIndex].Stats.BaseUrl + File.Value);
+            Request->SetVerb(TEXT("GET"));
+            Request->SetHeader(TEXT("Accept"), TEXT("application/octet-stream"));
+            Request->SetHeader(TEXT("Connection"), TEXT("keep-alive"));
+            Request->OnProcessRequestComplete().BindSP(this, &FShapEHttpBackend::OnDownloadComplete, Job, Result, File.Key, EndpointIndex);
+            Job->Downloads.Add(Request);
+            Requests.Add(Request);
+        }
+    }
+
+    if (Requests.Num() == 0)
+    {
+        CompleteResult(Job, Result);
+        return;
+    }
+    for (const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request : Requests)
+    {
+        Request->ProcessRequest();
+    }
+}
+
+void FShapEHttpBackend::OnDownloadComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, TSharedRef<FJobState, ESPMode::ThreadSafe> Job, TSharedRef<FPendingResult, ESPMode::ThreadSafe> Result, EResultFile File, int32 EndpointIndex)
+{
+    FString LocalPath;
+    int64 Bytes = 0;
+    if (!Job->bCancelled && bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+    {
+        // same file name as on the server, next to where the worker would have written it
+        const FString FileName = FPaths::GetCleanFilename(FGenericPlatformHttp::UrlDecode(Request->GetURL()));
+        LocalPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(Job->OutputDirectory, FileName));
+        Bytes = Response->GetContent().Num();
+        if (!FFileHelper::SaveArrayToFile(Response->GetContent(), *LocalPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FShapEHttpBackend: Could not write %s"), *LocalPath);
+            LocalPath.Reset();
+        }
+    }
+    else if (!Job->bCancelled)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEHttpBackend: Download of %s failed (HTTP %d)"), *Request->GetURL(), Response.IsValid() ? Response->GetResponseCode() : 0);
+    }
+
+    {
+        FScopeLock Lock(&StateCS);
+        Job->Downloads.Remove(Request);
+        if (Job->bCancelled)
+        {
+            return;
+        }
+
+        Endpoints[EndpointIndex].Stats.DownloadedBytes += Bytes;
+
+        switch (File)
+        {
+        case EResultFile::Ply:
+            Result->Event.PlyPath = LocalPath;
+            Result->bFailed |= LocalPath.IsEmpty();
+            break;
+        case EResultFile::Obj:
+            Result->Event.ObjPath = LocalPath;
+            break;
+        case EResultFile::Latent:
+            Result->Event.LatentPath = LocalPath;
+            break;
+        }
+
+        if (--Result->PendingFiles > 0)
+        {
+            return;
+        }
+    }
+
+    CompleteResult(Job, Result);
+}
+
+void FShapEHttpBackend::CompleteResult(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job, const TSharedRef<FPendingResult, ESPMode::ThreadSafe>& Result)
+{
+    {
+        FScopeLock Lock(&StateCS);
+        if (Job->bCancelled)
+        {
+            return;
+        }
+        --Job->PendingDownloads;
+
+        FShapEWorkerEvent Event = MoveTemp(Result->Event);
+        Event.ReceiveTime = FPlatformTime::Seconds();
+        if (Result->bFailed)
+        {
+            const FString Message = TEXT("Could not download the mesh from the inference server.");
+            if (Result->bFinal)
+            {
+                Event = MakeEvent(EShapEWorkerEventType::Error, *Job);
+                Event.Message = Message;
+            }
+            else
+            {
+                Event.Type = EShapEWorkerEventType::ItemError;
+                Event.Message = Message;
+                ++Job->FailedItems;
+            }
+            Event.ErrorType = TEXT("DownloadError");
+        }
+
+        if (Result->bFinal)
+        {
+            Job->FinalEvent = MoveTemp(Event);
+        }
+        else
+        {
+            Emit(MoveTemp(Event));
+        }
+    }
+
+    FinishJobIfDone(Job);
+}
+
+void FShapEHttpBackend::FinishJobIfDone(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job)
+{
+    FScopeLock Lock(&StateCS);
+    // batch slices are dispatched under the same id, so make sure this is still the job registered for it
+    if (Job->bCancelled || Job->OpenStreams > 0 || Job->PendingDownloads > 0 || Jobs.FindRef(Job->JobId) != Job)
+    {
+        return;
+    }
+    Jobs.Remove(Job->JobId);
+    Job->Streams.Empty();
+
+    FShapEWorkerEvent FinalEvent;
+    if (Job->Type == TEXT("batch"))
+    {
+        // the summary the worker would have sent for the whole dispatch
+        TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+        Summary->SetStringField(TEXT("type"), TEXT("complete"));
+        Summary->SetStringField(TEXT("message"), FString::Printf(TEXT("Batch Complete! %d of %d items saved."), Job->ItemCount - Job->FailedItems, Job->ItemCount));
+        Summary->SetNumberField(TEXT("item_count"), Job->ItemCount);
+        Summary->SetNumberField(TEXT("failed_count"), Job->FailedItems);
+        Summary->SetStringField(TEXT("job_id"), Job->JobId);
+
+        FinalEvent = MakeEvent(EShapEWorkerEventType::Complete, *Job);
+        FinalEvent.Message = Summary->GetStringField(TEXT("message"));
+        FinalEvent.RawMessage = ShapEJson::ToCondensedString(Summary);
+    }
+    else if (Job->FinalEvent.IsSet())
+    {
+        FinalEvent = MoveTemp(Job->FinalEvent.GetValue());
+    }
+    else
+    {
+        FinalEvent = MakeEvent(EShapEWorkerEventType::Error, *Job);
+        FinalEvent.Message = TEXT("The inference server closed the stream without a result.");
+        FinalEvent.ErrorType = TEXT("ConnectionError");
+    }
+
+    Emit(MoveTemp(FinalEvent));
+
+    FShapEWorkerEvent Ready = MakeEvent(EShapEWorkerEventType::Ready, *Job);
+    Ready.JobId.Reset();
+    Emit(MoveTemp(Ready));
+}
+
+void FShapEHttpBackend::Emit(FShapEWorkerEvent&& Event)
+{
+    EventQueue.Enqueue(MoveTemp(Event));
+}
+
+FShapEWorkerEvent FShapEHttpBackend::MakeEvent(EShapEWorkerEventType Type, const FJobState& Job) const
+{
+    FShapEWorkerEvent Event;
+    Event.Type = Type;
+    Event.WorkerGeneration = Job.Generation;
+    Event.JobId = Job.JobId;
+    Event.ReceiveTime = FPlatformTime::Seconds();
+    return Event;
+}
@@ -0,0 +1,422 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEMockBackend.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace ShapEMockBackend
+{
+    // Same file names as the worker's mesh_filename_for_prompt
+    static FString MakeMeshName(const FString& Prompt)
+    {
+        FString Safe;
+        for (TCHAR Char : Prompt.Left(50))
+        {
+            Safe.AppendChar(FChar::IsAlnum(Char) || Char == TEXT(' ') || Char == TEXT('_') ? Char : TEXT('_'));
+        }
+        TArray<FString> Words;
+        Safe.TrimEnd().ParseIntoArrayWS(Words);
+        const FString Name = FString::Join(Words, TEXT("_")).ToLower();
+        return Name.IsEmpty() ? FString(TEXT("generated_model")) : Name;
+    }
+
+    static uint32 GetTint(const FString& Prompt)
+    {
+        const FTCHARToUTF8 Utf8Prompt(*Prompt);
+        return FCrc::MemCrc32(Utf8Prompt.Get(), Utf8Prompt.Length());
+    }
+}
+
+FShapEMockBackend::FShapEMockBackend(const FShapEMockBackendSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.Segments = FMath::Clamp(Settings.Segments, 3, 4096);
+}
+
+FShapEMockBackend::~FShapEMockBackend()
+{
+    Stop();
+}
+
+bool FShapEMockBackend::Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType)
+{
+    Stop();
+
+    if (SpherePositions.IsEmpty())
+    {
+        BuildSphere();
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    ++Generation;
+    bIsRunning = true;
+    StartSpan = FShapETimingSpan{ ShapEStages::WorkerSpawn, Now, Now };
+
+    // the model load of a real worker, then "ready"
+    ScheduleStage(Now, FString(), ShapEStages::ModelLoad, true);
+    Schedule(Now, EShapEWorkerEventType::Status, FString()).Event.Message = TEXT("Loading models...");
+    Schedule(Now + Settings.StartupSeconds, EShapEWorkerEventType::Status, FString()).Event.Message = TEXT("Models loaded.");
+    ScheduleStage(Now + Settings.StartupSeconds, FString(), ShapEStages::ModelLoad, false);
+    Schedule(Now + Settings.StartupSeconds, EShapEWorkerEventType::Ready, FString());
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+    {
+        Tick();
+        return true;
+    }));
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEMockBackend: Started (%d segments, %.0f ms startup, %.1f ms per step, %.1f ms decode)"),
+        Settings.Segments, Settings.StartupSeconds * 1000.0, Settings.SecondsPerStep * 1000.0, Settings.DecodeSeconds * 1000.0);
+    return true;
+}
+
+void FShapEMockBackend::Stop()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+    Timeline.Reset();
+    EventQueue.Empty();
+    bIsRunning = false;
+}
+
+bool FShapEMockBackend::Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage)
+{
+    if (!bIsRunning)
+    {
+        return false;
+    }
+
+    FString Type;
+    JobMessage->TryGetStringField(TEXT("type"), Type);
+    FString OutputDirectory;
+    JobMessage->TryGetStringField(TEXT("output_dir"), OutputDirectory);
+    int32 Steps = 64;
+    JobMessage->TryGetNumberField(TEXT("karras_steps"), Steps);
+    Steps = FMath::Max(1, Steps);
+
+    ++SubmittedJobs;
+    double Time = FMath::Max(GetTimelineEnd(), FPlatformTime::Seconds());
+
+    if (Type == TEXT("generate"))
+    {
+        FString Prompt, OutputName;
+        JobMessage->TryGetStringField(TEXT("prompt"), Prompt);
+        if (!JobMessage->TryGetStringField(TEXT("output_name"), OutputName) || OutputName.IsEmpty())
+        {
+            OutputName = ShapEMockBackend::MakeMeshName(Prompt);
+        }
+
+        Time = ScheduleSampling(Time, JobId, Steps);
+        if (ShouldFailNextItem())
+        {
+            FScheduledEvent& Error = Schedule(Time, EShapEWorkerEventType::Error, JobId);
+            Error.Event.Message = FString::Printf(TEXT("Mock failure of '%s'"), *Prompt);
+            Error.Event.ErrorType = TEXT("MockFailure");
+        }
+        else
+        {
+            Time = ScheduleDecode(Time, JobId);
+            FScheduledEvent& Complete = Schedule(Time, EShapEWorkerEventType::Complete, JobId);
+            Complete.Event.Message = TEXT("Generation complete.");
+            Complete.MeshDirectory = OutputDirectory;
+            Complete.MeshName = OutputName;
+            Complete.MeshTint = ShapEMockBackend::GetTint(Prompt);
+        }
+    }
+    else if (Type == TEXT("batch"))
+    {
+        const TArray<TSharedPtr<FJsonValue>>* PromptValues = nullptr;
+        JobMessage->TryGetArrayField(TEXT("prompts"), PromptValues);
+        int32 ItemOffset = 0, ItemCount = 0, BatchSize = 4;
+        JobMessage->TryGetNumberField(TEXT("item_offset"), ItemOffset);
+        JobMessage->TryGetNumberField(TEXT("batch_size"), BatchSize);
+        const int32 NumPrompts = PromptValues ? PromptValues->Num() : 0;
+        if (!JobMessage->TryGetNumberField(TEXT("item_count"), ItemCount))
+        {
+            // same default as the worker: a slice without a count ends the batch
+            ItemCount = ItemOffset + NumPrompts;
+        }
+        BatchSize = FMath::Max(1, BatchSize);
+
+        // one sampling run per BatchSize prompts, then every item of the run is decoded
+        for (int32 RunStart = 0; RunStart < NumPrompts; RunStart += BatchSize)
+        {
+            Time = ScheduleSampling(Time, JobId, Steps);
+            for (int32 Index = RunStart; Index < FMath::Min(NumPrompts, RunStart + BatchSize); ++Index)
+            {
+                const FString Prompt = (*PromptValues)[Index]->AsString();
+                const int32 ItemIndex = ItemOffset + Index;
+                if (ShouldFailNextItem())
+                {
+                    FScheduledEvent& ItemError = Schedule(Time, EShapEWorkerEventType::ItemError, JobId);
+                    ItemError.Event.ItemIndex = ItemIndex;
+                    ItemError.Event.Prompt = Prompt;
+                    ItemError.Event.Message = FString::Printf(TEXT("Mock failure of '%s'"), *Prompt);
+                    ItemError.Event.ErrorType = TEXT("MockFailure");
+                    continue;
+                }
+
+                Time = ScheduleDecode(Time, JobId);
+                FScheduledEvent& ItemComplete = Schedule(Time, EShapEWorkerEventType::ItemComplete, JobId);
+                ItemComplete.Event.ItemIndex = ItemIndex;
+                ItemComplete.Event.ItemCount = ItemCount;
+                ItemComplete.Event.Prompt = Prompt;
+                ItemComplete.MeshDirectory = OutputDirectory;
+                ItemComplete.MeshName = FString::Printf(TEXT("%03d_%s"), ItemIndex, *ShapEMockBackend::MakeMeshName(Prompt));
+                ItemComplete.MeshTint = ShapEMockBackend::GetTint(Prompt);
+            }
+        }
+        Schedule(Time, EShapEWorkerEventType::Complete, JobId).Event.Message = TEXT("Batch complete.");
+    }
+    else if (Type == TEXT("decode"))
+    {
+        FString LatentPath, OutputName;
+        JobMessage->TryGetStringField(TEXT("latent_file"), LatentPath);
+        if (OutputDirectory.IsEmpty())
+        {
+            OutputDirectory = FPaths::GetPath(LatentPath);
+        }
+        if (!JobMessage->TryGetStringField(TEXT("output_name"), OutputName) || OutputName.IsEmpty())
+        {
+            OutputName = FPaths::GetBaseFilename(LatentPath).Replace(TEXT(".latent"), TEXT(""));
+        }
+
+        Time = ScheduleDecode(Time, JobId);
+        FScheduledEvent& Complete = Schedule(Time, EShapEWorkerEventType::Complete, JobId);
+        Complete.Event.Message = TEXT("Decode complete.");
+        Complete.Event.LatentPath = LatentPath;
+        Complete.MeshDirectory = OutputDirectory;
+        Complete.MeshName = OutputName;
+        Complete.MeshTint = ShapEMockBackend::GetTint(OutputName);
+    }
+    else
+    {
+        FScheduledEvent& Error = Schedule(Time, EShapEWorkerEventType::Error, JobId);
+        Error.Event.Message = FString::Printf(TEXT("Unknown job type: %s"), *Type);
+        Error.Event.ErrorType = TEXT("BadRequest");
+    }
+
+    Schedule(Time, EShapEWorkerEventType::Ready, FString());
+    return true;
+}
+
+void FShapEMockBackend::Cancel(const FString& JobId)
+{
+    // like the worker, the job gives up at its next event and answers "cancelled"; one that already finished is
+    // answered right away. Its remaining events go; the "ready" behind them stays, like a worker that stopped early
+    const double Now = FPlatformTime::Seconds();
+    const int32 NextIndex = Timeline.IndexOfByPredicate([&JobId](const FScheduledEvent& Scheduled) { return Scheduled.Event.JobId == JobId; });
+    const bool bPending = NextIndex != INDEX_NONE;
+
+    FScheduledEvent Cancelled;
+    Cancelled.DueTime = bPending ? FMath::Max(Now, Timeline[NextIndex].DueTime) : Now;
+    Cancelled.Event.Type = EShapEWorkerEventType::Cancelled;
+    Cancelled.Event.JobId = JobId;
+    Cancelled.Event.Message = bPending ? TEXT("Job cancelled.") : TEXT("Job had already finished.");
+    Cancelled.Event.CancelMilliseconds = bPending ? (Cancelled.DueTime - Now) * 1000.0 : 0.0;
+
+    Timeline.RemoveAll([&JobId](const FScheduledEvent& Scheduled) { return Scheduled.Event.JobId == JobId; });
+    const int32 InsertIndex = Timeline.IndexOfByPredicate([&Cancelled](const FScheduledEvent& Scheduled) { return Scheduled.DueTime > Cancelled.DueTime; });
+    Timeline.Insert(MoveTemp(Cancelled), InsertIndex != INDEX_NONE ? InsertIndex : Timeline.Num());
+}
+
+void FShapEMockBackend::Tick()
+{
+    const double Now = FPlatformTime::Seconds();
+
+    int32 NumDue = 0;
+    while (NumDue < Timeline.Num() && Timeline[NumDue].DueTime <= Now)
+    {
+        FScheduledEvent& Scheduled = Timeline[NumDue++];
+        FShapEWorkerEvent& Event = Scheduled.Event;
+
+        if (!Scheduled.MeshName.IsEmpty() && Settings.bWriteFiles)
+        {
+            FString Error;
+            if (!WriteMesh(Scheduled.MeshDirectory, Scheduled.MeshName, Scheduled.MeshTint, Event.PlyPath, Event.ObjPath, Error))
+            {
+                Event.Type = Event.Type == EShapEWorkerEventType::ItemComplete ? EShapEWorkerEventType::ItemError : EShapEWorkerEventType::Error;
+                Event.Message = Error;
+                Event.ErrorType = TEXT("ExportError");
+            }
+        }
+
+        Event.WorkerGeneration = Generation;
+        Event.ReceiveTime = FPlatformTime::Seconds();
+        if (Event.Type == EShapEWorkerEventType::Stage)
+        {
+            // the mock's "worker clock" is the editor's own, so spans land where they were scheduled
+            Event.WorkerTimestamp = Scheduled.DueTime;
+        }
+        EventQueue.Enqueue(MoveTemp(Event));
+    }
+    Timeline.RemoveAt(0, NumDue, EAllowShrinking::No);
+}
+
+double FShapEMockBackend::GetTimelineEnd() const
+{
+    return Timeline.IsEmpty() ? 0.0 : Timeline.Last().DueTime;
+}
+
+FShapEMockBackend::FScheduledEvent& FShapEMockBackend::Schedule(double DueTime, EShapEWorkerEventType Type, const FString& JobId)
+{
+    FScheduledEvent& Scheduled = Timeline.AddDefaulted_GetRef();
+    Scheduled.DueTime = FMath::Max(DueTime, GetTimelineEnd());
+    Scheduled.Event.Type = Type;
+    Scheduled.Event.JobId = JobId;
+    return Scheduled;
+}
+
+void FShapEMockBackend::ScheduleStage(double DueTime, const FString& JobId, const TCHAR* Stage, bool bBegin, int32 Steps)
+{
+    FShapEWorkerEvent& Event = Schedule(DueTime, EShapEWorkerEventType::Stage, JobId).Event;
+    Event.Stage = Stage;
+    Event.bStageBegin = bBegin;
+    Event.TotalSteps = Steps;
+}
+
+double FShapEMockBackend::ScheduleSampling(double StartTime, const FString& JobId, int32 Steps)
+{
+    ScheduleStage(StartTime, JobId, ShapEStages::Sample, true, Steps);
+    double Time = StartTime;
+    for (int32 Step = 1; Step <= Steps; ++Step)
+    {
+        Time += Settings.SecondsPerStep;
+        FShapEWorkerEvent& Event = Schedule(Time, EShapEWorkerEventType::Progress, JobId).Event;
+        const int32 Percent = Step * 100 / Steps;
+        // same mapping the manager applies to the worker's tqdm output
+        Event.Percentage = 10.f + (Percent / 100.f) * 85.f;
+        Event.Step = Step;
+        Event.TotalSteps = Steps;
+        Event.RawMessage = FString::Printf(TEXT("%3d%%| %d/%d [mock]"), Percent, Step, Steps);
+    }
+    ScheduleStage(Time, JobId, ShapEStages::Sample, false);
+    return Time;
+}
+
+double FShapEMockBackend::ScheduleDecode(double StartTime, const FString& JobId)
+{
+    ScheduleStage(StartTime, JobId, ShapEStages::Decode, true);
+    const double Time = StartTime + Settings.DecodeSeconds;
+    ScheduleStage(Time, JobId, ShapEStages::Decode, false);
+    return Time;
+}
+
+bool FShapEMockBackend::ShouldFailNextItem()
+{
+    ++SubmittedItems;
+    return Settings.FailEveryNthJob > 0 && SubmittedItems % Settings.FailEveryNthJob == 0;
+}
+
+void FShapEMockBackend::BuildSphere()
+{
+    // the --synthetic worker's sphere: Segments rings of Segments vertices between the poles
+    const int32 Rings = Settings.Segments;
+    const int32 Segments = Settings.Segments;
+
+    SpherePositions.Reset((Rings + 1) * Segments);
+    for (int32 Ring = 0; Ring <= Rings; ++Ring)
+    {
+        const float Theta = PI * Ring / Rings;
+        for (int32 Segment = 0; Segment < Segments; ++Segment)
+        {
+            const float Phi = 2.0f * PI * Segment / Segments;
+            SpherePositions.Add(FVector3f(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta)));
+        }
+    }
+
+    // triangles with two corners on a pole row have no area, so they are left out
+    auto IsPole = [Rings, Segments](int32 Vertex) { return Vertex < Segments || Vertex >= Rings * Segments; };
+    auto AddTriangle = [this, &IsPole](int32 A, int32 B, int32 C)
+    {
+        if (int32(IsPole(A)) + int32(IsPole(B)) + int32(IsPole(C)) < 2)
+        {
+            SphereIndices.Append({ A, B, C });
+        }
+    };
+
+    SphereIndices.Reset(Rings * Segments * 6);
+    for (int32 Ring = 0; Ring < Rings; ++Ring)
+    {
+        for (int32 Segment = 0; Segment < Segments; ++Segment)
+        {
+            const int32 A = Ring * Segments + Segment;
+            const int32 B = Ring * Segments + (Segment + 1) % Segments;
+            AddTriangle(A, A + Segments, B);
+            AddTriangle(B, A + Segments, B + Segments);
+        }
+    }
+}
+
+bool FShapEMockBackend::WriteMesh(const FString& Directory, const FString& Name, uint32 Tint, FString& OutPlyPath, FString& OutObjPath, FString& OutError) const
+{
+    IFileManager::Get().MakeDirectory(*Directory, true);
+    OutPlyPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(Directory, Name + TEXT(".ply")));
+
+    const FVector3f TintColor((Tint & 0xFF) / 255.0f, ((Tint >> 8) & 0xFF) / 255.0f, ((Tint >> 16) & 0xFF) / 255.0f);
+    TArray<FColor> Colors;
+    Colors.Reserve(SpherePositions.Num());
+    for (const FVector3f& Position : SpherePositions)
+    {
+        const float Height = (Position.Z + 1.0f) * 0.5f;
+        Colors.Add(FColor(
+            (uint8)FMath::RoundToInt(FMath::Clamp(Height * TintColor.X, 0.0f, 1.0f) * 255.0f),
+            (uint8)FMath::RoundToInt(FMath::Clamp(Height * TintColor.Y, 0.0f, 1.0f) * 255.0f),
+            (uint8)FMath::RoundToInt(FMath::Clamp(1.0f - Height * TintColor.Z, 0.0f, 1.0f) * 255.0f)));
+    }
+
+    // binary little-endian PLY with the layout Shap-E's write_ply produces
+    const int32 NumTriangles = SphereIndices.Num() / 3;
+    const FString Header = FString::Printf(TEXT("ply\nformat binary_little_endian 1.0\nelement vertex %d\n")
+        TEXT("property float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\n")
+        TEXT("element face %d\nproperty list uchar int vertex_index\nend_header\n"), SpherePositions.Num(), NumTriangles);
+    const FTCHARToUTF8 HeaderUtf8(*Header);
+
+    TArray<uint8> Bytes;
+    Bytes.Reserve(HeaderUtf8.Length() + SpherePositions.Num() * 15 + NumTriangles * 13);
+    Bytes.Append(reinterpret_cast<const uint8*>(HeaderUtf8.Get()), HeaderUtf8.Length());
+    for (int32 Vertex = 0; Vertex < SpherePositions.Num(); ++Vertex)
+    {
+        Bytes.Append(reinterpret_cast<const uint8*>(&SpherePositions[Vertex]), sizeof(FVector3f));
+        Bytes.Append({ Colors[Vertex].R, Colors[Vertex].G, Colors[Vertex].B });
+    }
+    for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+    {
+        Bytes.Add(3);
+        Bytes.Append(reinterpret_cast<const uint8*>(&SphereIndices[Triangle * 3]), sizeof(int32) * 3);
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Bytes, *OutPlyPath))
+    {
+        OutError = FString::Printf(TEXT("Failed to save PLY file: %s"), *OutPlyPath);
+        return false;
+    }
+
+    if (Settings.bWriteObj)
+    {
+        OutObjPath = FPaths::ChangeExtension(OutPlyPath, TEXT("obj"));
+        FString Obj;
+        Obj.Reserve(SpherePositions.Num() * 64 + NumTriangles * 24);
+        for (int32 Vertex = 0; Vertex < SpherePositions.Num(); ++Vertex)
+        {
+            const FVector3f& Position = SpherePositions[Vertex];
+            const FLinearColor Color = Colors[Vertex].ReinterpretAsLinear();
+            Obj += FString::Printf(TEXT("v %.6f %.6f %.6f %.4f %.4f %.4f\n"), Position.X, Position.Y, Position.Z, Color.R, Color.G, Color.B);
+        }
+        for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+        {
+            Obj += FString::Printf(TEXT("f %d %d %d\n"), SphereIndices[Triangle * 3] + 1, SphereIndices[Triangle * 3 + 1] + 1, SphereIndices[Triangle * 3 + 2] + 1);
+        }
+        if (!FFileHelper::SaveStringToFile(Obj, *OutObjPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+        {
+            OutError = FString::Printf(TEXT("Failed to save OBJ file: %s"), *OutObjPath);
+            return false;
+        }
+    }
+    return true;
+}
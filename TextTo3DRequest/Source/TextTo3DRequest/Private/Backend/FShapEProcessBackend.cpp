@@ -0,0 +1,608 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEProcessBackend.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Manager/FShapELineFramer.h"
+#include "Manager/ShapEPipeIO.h"
+#include "HAL/IConsoleManager.h"
+
+// Sampling steps take well under a second, but a decode that already began runs to its end
+static TAutoConsoleVariable<float> CVarShapECancelTimeout(
+    TEXT("ShapE.Cancel.Timeout"),
+    10.f,
+    TEXT("Seconds the worker has to give up a cancelled job before it is terminated. 0 terminates it right away, as before cancels were cooperative"));
+
+FShapEProcessBackend::~FShapEProcessBackend()
+{
+    Stop();
+    CleanupProcessHandles();
+}
+
+bool FShapEProcessBackend::Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType)
+{
+    Stop();
+
+    FScopeLock Lock(&ProcessCS);
+
+    CleanupProcessHandles();
+
+    if (!FPlatformProcess::CreatePipe(ReadPipe, WritePipe))
+    {
+        OutError = TEXT("Failed to create stdout pipe for batch process.");
+        OutErrorType = TEXT("PipeError");
+        return false;
+    }
+
+    if (!FPlatformProcess::CreatePipe(StdInReadPipe, StdInWritePipe, true))
+    {
+        ClosePipesAfterFailedStart();
+        OutError = TEXT("Failed to create stdin pipe for batch process.");
+        OutErrorType = TEXT("PipeError");
+        return false;
+    }
+
+    // without a record pipe the worker simply stays on JSON lines
+    if (WantsRecordChannel() && !bRecordChannelBroken && !FPlatformProcess::CreatePipe(RecordReadPipe, RecordWritePipe))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEProcessBackend: Failed to create the record pipe, the worker reports on stdout"));
+        RecordReadPipe = nullptr;
+        RecordWritePipe = nullptr;
+    }
+
+    // ue flag to skip batch file to skip directory setting process, worker flag to keep the models resident
+    FString CommandLineArgs = WorkerArguments.IsEmpty() ? FString(TEXT("--ue --worker")) : FString::Printf(TEXT("--ue --worker %s"), *WorkerArguments);
+    if (RecordWritePipe)
+    {
+        CommandLineArgs += FString::Printf(TEXT(" --record-fd %d --record-versions %d"), ShapEWorkerRecords::WorkerFd, ShapEWorkerRecords::ProtocolVersion);
+    }
+
+    const double SpawnStartTime = FPlatformTime::Seconds();
+    if (!LaunchWorker(ScriptPath, CommandLineArgs, OutError, OutErrorType))
+    {
+        ClosePipesAfterFailedStart();
+        return false;
+    }
+
+    WorkerSpawnSpan = FShapETimingSpan{ ShapEStages::WorkerSpawn, SpawnStartTime, FPlatformTime::Seconds() };
+
+    // The child holds its own copies now. Dropping ours lets the reader see EOF the moment the worker exits.
+    FPlatformProcess::ClosePipe(nullptr, WritePipe);
+    FPlatformProcess::ClosePipe(StdInReadPipe, nullptr);
+    WritePipe = nullptr;
+    StdInReadPipe = nullptr;
+    if (RecordWritePipe)
+    {
+        FPlatformProcess::ClosePipe(nullptr, RecordWritePipe);
+        RecordWritePipe = nullptr;
+    }
+
+    bIsWorkerRunning = true;
+    WorkerScriptPath = ScriptPath;
+    ++WorkerGeneration;
+    PendingCancels.Reset();
+    LinesSinceCancel.Reset();
+    WorkerReadyTime = 0.0;
+    RecordDecoder.Reset();
+    bRecordsOpen = false;
+
+    TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> OpenReaders = MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>(RecordReadPipe ? 2 : 1);
+
+    // stdout, start read thread
+    OutputReaderRunnable = MakeShared<FShapEOutputReaderRunnable>(ReadPipe, AsShared(), WorkerGeneration, false, OpenReaders);
+    ReadPipe = nullptr; // owned by the runnable from here on
+    ReaderThread = FRunnableThread::Create(OutputReaderRunnable.Get(), TEXT("ShapEOutputReaderThread"));
+    if (RecordReadPipe)
+    {
+        RecordReaderRunnable = MakeShared<FShapEOutputReaderRunnable>(RecordReadPipe, AsShared(), WorkerGeneration, true, OpenReaders);
+        RecordReadPipe = nullptr;
+        RecordReaderThread = FRunnableThread::Create(RecordReaderRunnable.Get(), TEXT("ShapERecordReaderThread"));
+    }
+    // an unread record pipe would block the worker as soon as it fills
+    if (!ReaderThread || (RecordReaderRunnable.IsValid() && !RecordReaderThread))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FShapEProcessBackend: Failed to create output reader thread."));
+        TerminateWorker();
+        OutError = TEXT("Failed to create reader thread.");
+        OutErrorType = TEXT("ThreadError");
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessBackend: Worker launched successfully with args: %s"), *CommandLineArgs);
+    return true;
+}
+
+bool FShapEProcessBackend::LaunchWorker(const FString& ScriptPath, const FString& Arguments, FString& OutError, FString& OutErrorType)
+{
+#if PLATFORM_WINDOWS
+    const FString BatPath = FPaths::Combine(FPaths::GetPath(ScriptPath), TEXT("run_shape.bat"));
+#else
+    // POSIX counterpart of the batch file, so the worker (and --synthetic runs) also work on Linux and macOS
+    const FString BatPath = FPaths::Combine(FPaths::GetPath(ScriptPath), TEXT("run_shape.sh"));
+#endif
+    if (!FPaths::FileExists(BatPath))
+    {
+        OutError = FString::Printf(TEXT("Launcher script not found: %s"), *BatPath);
+        OutErrorType = TEXT("FileNotFound");
+        return false;
+    }
+
+    const FString WorkingDirectory = FPaths::GetPath(BatPath);
+
+    PythonProcessHandle = FPlatformProcess::CreateProc(
+        *BatPath,
+        *Arguments,
+        false,    // bLaunchDetached
+        true,     // bLaunchHidden
+        true,     // bLaunchReallyHidden
+        nullptr,  // OutProcessID
+        0,        // PriorityModifier
+        *WorkingDirectory,
+        WritePipe,    // Process's StdOut
+        StdInReadPipe // Process's StdIn -> job stream
+    );
+
+    if (!PythonProcessHandle.IsValid())
+    {
+        OutError = TEXT("Failed to launch batch file. Check permissions and paths.");
+        OutErrorType = TEXT("ProcessLaunchError");
+        return false;
+    }
+    return true;
+}
+
+bool FShapEProcessBackend::IsWorkerProcessRunning()
+{
+    return PythonProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(PythonProcessHandle);
+}
+
+void FShapEProcessBackend::KillWorkerProcess()
+{
+    if (PythonProcessHandle.IsValid())
+    {
+        if (FPlatformProcess::IsProcRunning(PythonProcessHandle))
+        {
+            FPlatformProcess::TerminateProc(PythonProcessHandle, true);
+        }
+        FPlatformProcess::CloseProc(PythonProcessHandle);
+        PythonProcessHandle.Reset();
+    }
+}
+
+void FShapEProcessBackend::Stop()
+{
+    bool bShutdownSent = false;
+    {
+        FScopeLock Lock(&ProcessCS);
+        // Give the worker a chance to exit cleanly before the process tree is killed
+        bShutdownSent = IsWorkerProcessRunning() && WriteJobLine(TEXT("{\"type\":\"shutdown\"}"));
+    }
+
+    // polled without holding the lock, so Submit, IsRunning and the reader threads are not stalled meanwhile
+    const double Deadline = FPlatformTime::Seconds() + 2.0;
+    while (bShutdownSent && FPlatformTime::Seconds() < Deadline)
+    {
+        {
+            FScopeLock Lock(&ProcessCS);
+            if (!IsWorkerProcessRunning())
+            {
+                break;
+            }
+        }
+        FPlatformProcess::Sleep(0.05f);
+    }
+
+    TerminateWorker();
+
+    if (ReaderThread)
+    {
+        ReaderThread->WaitForCompletion();
+        delete ReaderThread;
+        ReaderThread = nullptr;
+    }
+    if (RecordReaderThread)
+    {
+        RecordReaderThread->WaitForCompletion();
+        delete RecordReaderThread;
+        RecordReaderThread = nullptr;
+    }
+    OutputReaderRunnable.Reset();
+    RecordReaderRunnable.Reset();
+}
+
+bool FShapEProcessBackend::IsRunning()
+{
+    FScopeLock Lock(&ProcessCS);
+    return bIsWorkerRunning && IsWorkerProcessRunning();
+}
+
+bool FShapEProcessBackend::IsStartedFor(const FString& ScriptPath)
+{
+    // a different launcher needs a worker of its own
+    FScopeLock Lock(&ProcessCS);
+    return WorkerScriptPath == ScriptPath;
+}
+
+void FShapEProcessBackend::SetWorkerArguments(const FString& Arguments)
+{
+    FScopeLock Lock(&ProcessCS);
+    WorkerArguments = Arguments;
+}
+
+bool FShapEProcessBackend::Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage)
+{
+    FScopeLock Lock(&ProcessCS);
+    const FString JobLine = ShapEJson::ToCondensedString(JobMessage);
+    if (!WriteJobLine(JobLine))
+    {
+        return false;
+    }
+    // a worker that ignores the cancel is replaced, and the replacement needs these jobs too
+    if (PendingCancels.Num() > 0)
+    {
+        LinesSinceCancel.Add(JobLine);
+    }
+    return true;
+}
+
+void FShapEProcessBackend::Cancel(const FString& JobId)
+{
+    if (CVarShapECancelTimeout.GetValueOnAnyThread() > 0.f)
+    {
+        TSharedRef<FJsonObject> CancelObject = MakeShared<FJsonObject>();
+        CancelObject->SetStringField(TEXT("type"), TEXT("cancel"));
+        CancelObject->SetStringField(TEXT("job_id"), JobId);
+
+        FScopeLock Lock(&ProcessCS);
+        if (WriteJobLine(ShapEJson::ToCondensedString(CancelObject)))
+        {
+            PendingCancels.Add(JobId, FPlatformTime::Seconds());
+            UE_LOG(LogTemp, Log, TEXT("FShapEProcessBackend: Asked the worker to cancel job %s"), *JobId);
+            return;
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessBackend: Terminating the worker to cancel job %s"), *JobId);
+    TerminateWorker();
+}
+
+bool FShapEProcessBackend::DequeueEvent(FShapEWorkerEvent& OutEvent)
+{
+    CheckPendingCancels();
+
+    if (!EventQueue.Dequeue(OutEvent))
+    {
+        return false;
+    }
+
+    FScopeLock Lock(&ProcessCS);
+    if (OutEvent.WorkerGeneration == WorkerGeneration)
+    {
+        if (OutEvent.Type == EShapEWorkerEventType::Ready && WorkerReadyTime == 0.0)
+        {
+            WorkerReadyTime = FPlatformTime::Seconds();
+        }
+        else if (OutEvent.Type == EShapEWorkerEventType::Cancelled && PendingCancels.Remove(OutEvent.JobId) > 0 && PendingCancels.Num() == 0)
+        {
+            LinesSinceCancel.Reset();
+        }
+        else if (OutEvent.Type == EShapEWorkerEventType::WorkerExited)
+        {
+            // the manager fails whatever was running; nothing is left to restart
+            PendingCancels.Reset();
+            LinesSinceCancel.Reset();
+        }
+    }
+    return true;
+}
+
+void FShapEProcessBackend::CheckPendingCancels()
+{
+    FString ScriptPath;
+    TArray<FString> LinesToResend;
+    {
+        FScopeLock Lock(&ProcessCS);
+        if (PendingCancels.Num() == 0 || WorkerReadyTime == 0.0)
+        {
+            return;
+        }
+
+        const double TimeoutSeconds = FMath::Max(0.f, CVarShapECancelTimeout.GetValueOnAnyThread());
+        const double Now = FPlatformTime::Seconds();
+        const TPair<FString, double>* Expired = nullptr;
+        for (const TPair<FString, double>& PendingCancel : PendingCancels)
+        {
+            // a cancel sent during the model load is only read once the worker is up
+            if (Now - FMath::Max(PendingCancel.Value, WorkerReadyTime) >= TimeoutSeconds)
+            {
+                Expired = &PendingCancel;
+                break;
+            }
+        }
+        if (!Expired)
+        {
+            return;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("FShapEProcessBackend: The worker did not give up job %s within %.1fs, terminating it"), *Expired->Key, TimeoutSeconds);
+        ScriptPath = WorkerScriptPath;
+        LinesToResend = MoveTemp(LinesSinceCancel);
+        LinesSinceCancel.Reset();
+        PendingCancels.Reset();
+    }
+
+    TerminateWorker();
+    if (LinesToResend.Num() == 0)
+    {
+        // the next job starts a fresh worker on demand
+        return;
+    }
+
+    // the old worker's exit is queued under its generation, so the manager does not fail the resent jobs
+    FString Error, ErrorType;
+    if (!Start(ScriptPath, Error, ErrorType))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FShapEProcessBackend: Could not restart the worker after a cancel timed out: %s"), *Error);
+        return;
+    }
+
+    FScopeLock Lock(&ProcessCS);
+    // the manager times the new worker's boot and warm-up as if it had started it
+    FShapEWorkerEvent Restarted;
+    Restarted.Type = EShapEWorkerEventType::Restarted;
+    Restarted.WorkerGeneration = WorkerGeneration;
+    Restarted.Message = TEXT("Worker restarted after a cancel timed out.");
+    EventQueue.Enqueue(MoveTemp(Restarted));
+
+    for (const FString& Line : LinesToResend)
+    {
+        if (!WriteJobLine(Line))
+        {
+            UE_LOG(LogTemp, Error, TEXT("FShapEProcessBackend: Could not resend a job to the restarted worker"));
+            break;
+        }
+    }
+}
+
+void FShapEProcessBackend::TerminateWorker()
+{
+    FScopeLock Lock(&ProcessCS);
+
+    if (OutputReaderRunnable.IsValid())
+    {
+        OutputReaderRunnable->Stop();
+    }
+    if (RecordReaderRunnable.IsValid())
+    {
+        RecordReaderRunnable->Stop();
+    }
+
+    KillWorkerProcess();
+
+    CleanupProcessHandles();
+
+    bIsWorkerRunning = false;
+}
+
+void FShapEProcessBackend::CleanupProcessHandles()
+{
+    // closes write pipe (used by child process) - read pipe closing is handled by OutputReaderRunnable
+    if (WritePipe)
+    {
+        FPlatformProcess::ClosePipe(0, WritePipe);
+        WritePipe = nullptr;
+    }
+    if (StdInReadPipe || StdInWritePipe)
+    {
+        FPlatformProcess::ClosePipe(StdInReadPipe, StdInWritePipe);
+        StdInReadPipe = nullptr;
+        StdInWritePipe = nullptr;
+    }
+    if (RecordWritePipe)
+    {
+        FPlatformProcess::ClosePipe(0, RecordWritePipe);
+        RecordWritePipe = nullptr;
+    }
+}
+
+void FShapEProcessBackend::ClosePipesAfterFailedStart()
+{
+    // no runnable took the read ends over yet
+    if (ReadPipe)
+    {
+        FPlatformProcess::ClosePipe(ReadPipe, nullptr);
+        ReadPipe = nullptr;
+    }
+    if (RecordReadPipe)
+    {
+        FPlatformProcess::ClosePipe(RecordReadPipe, nullptr);
+        RecordReadPipe = nullptr;
+    }
+    CleanupProcessHandles();
+}
+
+bool FShapEProcessBackend::WriteJobLine(const FString& JsonLine)
+{
+    if (!StdInWritePipe)
+    {
+        return false;
+    }
+
+    // FPlatformProcess::WritePipe(FString) narrows each TCHAR, so convert to UTF-8 ourselves
+    FTCHARToUTF8 Utf8Line(*JsonLine);
+    TArray<uint8> Payload;
+    Payload.Reserve(Utf8Line.Length() + 1);
+    Payload.Append(reinterpret_cast<const uint8*>(Utf8Line.Get()), Utf8Line.Length());
+    Payload.Add('\n');
+
+    // the worker drains stdin on a thread of its own, even mid-job, so only a hung worker leaves a big job unwritten
+    return ShapEPipeIO::WriteAll(StdInWritePipe, Payload.GetData(), Payload.Num(), StdInWriteTimeoutSeconds);
+}
+
+void FShapEProcessBackend::ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh)
+{
+    if (!SharedMesh.IsValid())
+    {
+        return;
+    }
+
+    TSharedRef<FJsonObject> ReleaseObject = MakeShared<FJsonObject>();
+    ReleaseObject->SetStringField(TEXT("type"), TEXT("release"));
+    ReleaseObject->SetStringField(TEXT("shm_name"), SharedMesh.SegmentName);
+
+    FScopeLock Lock(&ProcessCS);
+    if (!WriteJobLine(ShapEJson::ToCondensedString(ReleaseObject)))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEProcessBackend: Could not release shared mesh %s, the worker is gone"), *SharedMesh.SegmentName);
+    }
+}
+
+void FShapEProcessBackend::HandlePythonOutputLine(FUtf8StringView OutputLine, uint32 Generation)
+{
+    FShapEParsedLine Parsed;
+    FShapEOutputParser::Parse(OutputLine, Parsed);
+
+    // the worker's progress records are exact; its tqdm bar still reaches stdout for anyone reading the log
+    if (bRecordsOpen && Parsed.Kind == EShapELineKind::Tqdm)
+    {
+        return;
+    }
+
+    FShapEWorkerEvent Event;
+    if (LineDecoder.Decode(OutputLine, Parsed, Generation, Event))
+    {
+        EventQueue.Enqueue(MoveTemp(Event));
+    }
+}
+
+bool FShapEProcessBackend::HandleWorkerRecords(const uint8* Data, int32 Length, uint32 Generation)
+{
+    const bool bDecoded = RecordDecoder.Append(Data, Length, Generation, [this](FShapEWorkerEvent&& Event)
+    {
+        EventQueue.Enqueue(MoveTemp(Event));
+    });
+    if (RecordDecoder.GetState() == FShapEWorkerRecordDecoder::EState::Open)
+    {
+        bRecordsOpen = true;
+    }
+    if (bDecoded)
+    {
+        return true;
+    }
+
+    // the rest of the stream cannot be trusted, and the worker blocks once nobody reads it
+    FScopeLock Lock(&ProcessCS);
+    bRecordChannelBroken = true;
+    UE_LOG(LogTemp, Error, TEXT("FShapEProcessBackend: Worker record stream failed: %s"), *RecordDecoder.GetError());
+    if (Generation == WorkerGeneration && bIsWorkerRunning)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FShapEProcessBackend: Terminating the worker, its next start reports on stdout"));
+        TerminateWorker();
+    }
+    return false;
+}
+
+//=====================================================================================================\\
+// --- FShapEOutputReaderRunnable Implementation ---
+
+FShapEOutputReaderRunnable::FShapEOutputReaderRunnable(void* InReadPipe, TSharedRef<FShapEProcessBackend, ESPMode::ThreadSafe> InBackend, uint32 InWorkerGeneration,
+    bool bInReadsRecords, TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> InOpenReaders)
+    : ReadPipe(InReadPipe)
+    , BackendPtr(InBackend)
+    , WorkerGeneration(InWorkerGeneration)
+    , bReadsRecords(bInReadsRecords)
+    , OpenReaders(InOpenReaders)
+    , bStopRequested(false)
+    , bFinished(false)
+{
+}
+
+FShapEOutputReaderRunnable::~FShapEOutputReaderRunnable()
+{
+    if (ReadPipe)
+    {
+        FPlatformProcess::ClosePipe(ReadPipe, nullptr);
+        ReadPipe = nullptr;
+    }
+}
+
+bool FShapEOutputReaderRunnable::Init()
+{
+    bFinished = false;
+    return ReadPipe != nullptr;
+}
+
+uint32 FShapEOutputReaderRunnable::Run()
+{
+    if (!ReadPipe)
+    {
+        bFinished = true;
+        return 1;
+    }
+
+    FShapELineFramer Framer;
+    TArray<uint8> ReadBuffer;
+    ReadBuffer.Reserve(ReadChunkSize);
+
+    auto DispatchRecord = [this](const UTF8CHAR* Data, int32 Length)
+    {
+        if (TSharedPtr<FShapEProcessBackend, ESPMode::ThreadSafe> Backend = BackendPtr.Pin())
+        {
+            Backend->HandlePythonOutputLine(FUtf8StringView(Data, Length), WorkerGeneration);
+        }
+        else
+        {
+            bStopRequested = true;
+        }
+    };
+
+    // Sleeps in the read until output arrives; the read fails as soon as the worker exits and its end of the pipe closes
+    while (!bStopRequested && ShapEPipeIO::ReadBlocking(ReadPipe, ReadBuffer, ReadChunkSize, bStopRequested))
+    {
+        if (!bReadsRecords)
+        {
+            Framer.Append(ReadBuffer.GetData(), ReadBuffer.Num(), DispatchRecord);
+        }
+        else
+        {
+            // nothing after a malformed record can be decoded, and the worker it came from is terminated
+            TSharedPtr<FShapEProcessBackend, ESPMode::ThreadSafe> Backend = BackendPtr.Pin();
+            if (!Backend.IsValid() || !Backend->HandleWorkerRecords(ReadBuffer.GetData(), ReadBuffer.Num(), WorkerGeneration))
+            {
+                bStopRequested = true;
+            }
+        }
+    }
+
+    if (!bStopRequested && !bReadsRecords)
+    {
+        Framer.Flush(DispatchRecord);
+    }
+
+    bFinished = true;
+
+    TSharedPtr<FShapEProcessBackend, ESPMode::ThreadSafe> Backend = BackendPtr.Pin();
+    if (OpenReaders->Decrement() == 0 && Backend.IsValid())
+    {
+        // queued behind the worker's last messages, so they are dispatched first
+        FShapEWorkerEvent ExitEvent;
+        ExitEvent.Type = EShapEWorkerEventType::WorkerExited;
+        ExitEvent.WorkerGeneration = WorkerGeneration;
+        Backend->EventQueue.Enqueue(MoveTemp(ExitEvent));
+    }
+
+    if (ReadPipe)
+    {
+        FPlatformProcess::ClosePipe(ReadPipe, nullptr);
+        ReadPipe = nullptr;
+    }
+
+    return 0;
+}
+
+void FShapEOutputReaderRunnable::Stop()
+{
+    // A read already in progress returns once the worker is terminated and the pipe breaks
+    bStopRequested = true;
+}
+
@@ -0,0 +1,176 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEWorkerLineDecoder.h"
+#include "Misc/Base64.h"
+
+
+bool FShapEWorkerLineDecoder::Decode(FUtf8StringView OutputLine, const FShapEParsedLine& Parsed, uint32 Generation, FShapEWorkerEvent& Event)
+{
+    switch (Parsed.Kind)
+    {
+    case EShapELineKind::Empty:
+        return false;
+    case EShapELineKind::Json:
+    {
+        if (Parsed.TypeEquals(UTF8TEXTVIEW("ready")))
+        {
+            Event.Type = EShapEWorkerEventType::Ready;
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("status")))
+        {
+            Event.Type = EShapEWorkerEventType::Status;
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("preview")))
+        {
+            Event.Type = EShapEWorkerEventType::Preview;
+            FShapEPreviewImage& Preview = Event.Preview;
+            Parsed.TryGetInt(UTF8TEXTVIEW("step"), Preview.Step);
+            Parsed.TryGetInt(UTF8TEXTVIEW("total_steps"), Preview.TotalSteps);
+            Parsed.TryGetInt(UTF8TEXTVIEW("width"), Preview.Width);
+            Parsed.TryGetInt(UTF8TEXTVIEW("height"), Preview.Height);
+            Parsed.TryGetDouble(UTF8TEXTVIEW("render_ms"), Preview.RenderMilliseconds);
+
+            FString Format, Data;
+            TArray<uint8> Bytes;
+            Parsed.TryGetString(UTF8TEXTVIEW("format"), Format);
+            Parsed.TryGetString(UTF8TEXTVIEW("data"), Data);
+            if (!Format.Equals(TEXT("rgb8"), ESearchCase::CaseSensitive) || !FBase64::Decode(Data, Bytes)
+                || Preview.Width <= 0 || Preview.Height <= 0 || Bytes.Num() != Preview.Width * Preview.Height * 3)
+            {
+                int32 Suppressed = 0;
+                if (PreviewLogLimiter.ShouldLog(FPlatformTime::Seconds(), Suppressed))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s: Dropping malformed preview (%dx%d, format '%s', %d bytes) [%d not logged]"), LogName, Preview.Width, Preview.Height, *Format, Bytes.Num(), Suppressed);
+                }
+                return false;
+            }
+            Preview.Pixels.SetNumUninitialized(Preview.Width * Preview.Height);
+            for (int32 Pixel = 0; Pixel < Preview.Pixels.Num(); ++Pixel)
+            {
+                Preview.Pixels[Pixel] = FColor(Bytes[Pixel * 3 + 0], Bytes[Pixel * 3 + 1], Bytes[Pixel * 3 + 2], 255);
+            }
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("stage")))
+        {
+            Event.Type = EShapEWorkerEventType::Stage;
+            FString Phase;
+            Parsed.TryGetString(UTF8TEXTVIEW("stage"), Event.Stage);
+            Parsed.TryGetString(UTF8TEXTVIEW("phase"), Phase);
+            Parsed.TryGetDouble(UTF8TEXTVIEW("t"), Event.WorkerTimestamp);
+            Parsed.TryGetInt(UTF8TEXTVIEW("steps"), Event.TotalSteps);
+            Event.bStageBegin = Phase.Equals(TEXT("begin"), ESearchCase::CaseSensitive);
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("item_complete")))
+        {
+            Event.Type = EShapEWorkerEventType::ItemComplete;
+            Parsed.TryGetInt(UTF8TEXTVIEW("item_index"), Event.ItemIndex);
+            Parsed.TryGetInt(UTF8TEXTVIEW("item_count"), Event.ItemCount);
+            Parsed.TryGetString(UTF8TEXTVIEW("prompt"), Event.Prompt);
+            Parsed.TryGetString(UTF8TEXTVIEW("ply_file"), Event.PlyPath);
+            Parsed.TryGetString(UTF8TEXTVIEW("obj_file"), Event.ObjPath);
+            Parsed.TryGetString(UTF8TEXTVIEW("latent_file"), Event.LatentPath);
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("item_error")))
+        {
+            Event.Type = EShapEWorkerEventType::ItemError;
+            Parsed.TryGetInt(UTF8TEXTVIEW("item_index"), Event.ItemIndex);
+            Parsed.TryGetString(UTF8TEXTVIEW("prompt"), Event.Prompt);
+            Parsed.TryGetString(UTF8TEXTVIEW("error_type"), Event.ErrorType);
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("complete")))
+        {
+            // batch summaries carry no file paths, shared-memory results only carry them when files were exported too
+            Event.Type = EShapEWorkerEventType::Complete;
+            Parsed.TryGetString(UTF8TEXTVIEW("ply_file"), Event.PlyPath);
+            Parsed.TryGetString(UTF8TEXTVIEW("obj_file"), Event.ObjPath);
+            Parsed.TryGetString(UTF8TEXTVIEW("latent_file"), Event.LatentPath);
+
+            int32 PreviewCount = 0;
+            if (Parsed.TryGetInt(UTF8TEXTVIEW("preview_count"), PreviewCount))
+            {
+                int32 PreviewSkipped = 0;
+                double PreviewSeconds = 0.0, SamplingSeconds = 0.0;
+                Parsed.TryGetInt(UTF8TEXTVIEW("preview_skipped"), PreviewSkipped);
+                Parsed.TryGetDouble(UTF8TEXTVIEW("preview_seconds"), PreviewSeconds);
+                Parsed.TryGetDouble(UTF8TEXTVIEW("sampling_seconds"), SamplingSeconds);
+                UE_LOG(LogTemp, Log, TEXT("%s: %d previews (%d skipped) took %.2fs, %.1f%% on top of %.2fs sampling"),
+                    LogName, PreviewCount, PreviewSkipped, PreviewSeconds, SamplingSeconds > 0.0 ? 100.0 * PreviewSeconds / SamplingSeconds : 0.0, SamplingSeconds);
+            }
+
+            if (Parsed.TryGetString(UTF8TEXTVIEW("shm_name"), Event.SharedMesh.SegmentName))
+            {
+                // sizes and offsets can exceed int32 for large meshes; doubles hold them exactly
+                auto GetInt64 = [&Parsed](FUtf8StringView Key, int64& OutValue)
+                {
+                    double Value = 0.0;
+                    if (Parsed.TryGetDouble(Key, Value))
+                    {
+                        OutValue = (int64)Value;
+                    }
+                };
+                GetInt64(UTF8TEXTVIEW("shm_size"), Event.SharedMesh.SegmentSize);
+                GetInt64(UTF8TEXTVIEW("positions_offset"), Event.SharedMesh.PositionsOffset);
+                GetInt64(UTF8TEXTVIEW("colors_offset"), Event.SharedMesh.ColorsOffset);
+                GetInt64(UTF8TEXTVIEW("indices_offset"), Event.SharedMesh.IndicesOffset);
+                Parsed.TryGetInt(UTF8TEXTVIEW("vertex_count"), Event.SharedMesh.NumVertices);
+                Parsed.TryGetInt(UTF8TEXTVIEW("face_count"), Event.SharedMesh.NumTriangles);
+            }
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("cancelled")))
+        {
+            Event.Type = EShapEWorkerEventType::Cancelled;
+            Parsed.TryGetDouble(UTF8TEXTVIEW("cancel_ms"), Event.CancelMilliseconds);
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("error")))
+        {
+            Event.Type = EShapEWorkerEventType::Error;
+            Parsed.TryGetString(UTF8TEXTVIEW("error_type"), Event.ErrorType);
+        }
+        else if (Parsed.TypeEquals(UTF8TEXTVIEW("info")) || Parsed.TypeEquals(UTF8TEXTVIEW("debug")))
+        {
+            Event.Type = EShapEWorkerEventType::Info;
+        }
+        else
+        {
+            return false;
+        }
+
+        Event.WorkerGeneration = Generation;
+        Event.ReceiveTime = FPlatformTime::Seconds();
+        Parsed.TryGetString(UTF8TEXTVIEW("job_id"), Event.JobId);
+        Parsed.TryGetString(UTF8TEXTVIEW("message"), Event.Message);
+        Event.RawMessage = FString(OutputLine.Len(), OutputLine.GetData());
+        return true;
+    }
+    case EShapELineKind::Tqdm:
+    {
+        const float MappedPercentage = 10.f + (Parsed.Percent / 100.f) * 85.f;
+
+        int32 Suppressed = 0;
+        if (TqdmLogLimiter.ShouldLog(FPlatformTime::Seconds(), Suppressed))
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("%s: tqdm %d%% (%d/%d, %.2f %s) -> %.2f%% [%d updates not logged]"),
+                LogName, Parsed.Percent, Parsed.Step, Parsed.TotalSteps, Parsed.Rate, Parsed.bSecondsPerIteration ? TEXT("s/it") : TEXT("it/s"), MappedPercentage, Suppressed);
+        }
+
+        Event.Type = EShapEWorkerEventType::Progress;
+        Event.WorkerGeneration = Generation;
+        Event.ReceiveTime = FPlatformTime::Seconds();
+        Event.Percentage = MappedPercentage;
+        Event.Step = FMath::Max(Parsed.Step, 0);
+        Event.TotalSteps = FMath::Max(Parsed.TotalSteps, 0);
+        Event.RawMessage = FString(OutputLine.Len(), OutputLine.GetData()).TrimStartAndEnd();
+        return true;
+    }
+    case EShapELineKind::Other:
+    {
+        // third-party libraries can print a lot; keep the log readable
+        int32 Suppressed = 0;
+        if (UnparsedLogLimiter.ShouldLog(FPlatformTime::Seconds(), Suppressed))
+        {
+            UE_LOG(LogTemp, Log, TEXT("%s: Received non-JSON, non-tqdm output: %s [%d lines not logged]"), LogName, *FString(OutputLine.Len(), OutputLine.GetData()), Suppressed);
+        }
+        return false;
+    }
+    }
+    return false;
+}
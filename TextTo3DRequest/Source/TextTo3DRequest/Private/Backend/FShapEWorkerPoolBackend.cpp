@@ -0,0 +1,656 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEWorkerPoolBackend.h"
+#include "Backend/FShapEProcessBackend.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformMisc.h"
+
+
+FShapEWorkerPoolBackend::FShapEWorkerPoolBackend(const FShapEWorkerPoolSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.NumWorkers = FMath::Max(1, Settings.NumWorkers);
+    const int32 CoresPerWorker = FPlatformMisc::NumberOfCoresIncludingHyperthreads() / Settings.NumWorkers;
+
+    for (int32 Index = 0; Index < Settings.NumWorkers; ++Index)
+    {
+        FWorker& Worker = Workers.AddDefaulted_GetRef();
+        Worker.Index = Index;
+        if (Settings.MakeWorker)
+        {
+            Worker.Backend = Settings.MakeWorker(Index);
+        }
+        else
+        {
+            Worker.Backend = MakeShared<FShapEProcessBackend, ESPMode::ThreadSafe>();
+        }
+
+        TArray<FString> PinArguments, Placement;
+        if (Settings.Devices.IsValidIndex(Index) && Settings.Devices[Index] >= 0)
+        {
+            PinArguments.Add(FString::Printf(TEXT("--device %d"), Settings.Devices[Index]));
+            Placement.Add(FString::Printf(TEXT("device %d"), Settings.Devices[Index]));
+        }
+
+        FString Cores;
+        if (Settings.CoreSets.IsValidIndex(Index))
+        {
+            Cores = Settings.CoreSets[Index].TrimStartAndEnd();
+        }
+        else if (Settings.CoreSets.IsEmpty() && Settings.bSplitCores && CoresPerWorker > 0)
+        {
+            Cores = FString::Printf(TEXT("%d-%d"), Index * CoresPerWorker, (Index + 1) * CoresPerWorker - 1);
+        }
+        if (!Cores.IsEmpty())
+        {
+            PinArguments.Add(FString::Printf(TEXT("--cores %s"), *Cores));
+            Placement.Add(FString::Printf(TEXT("cores %s"), *Cores));
+        }
+
+        Worker.PinArguments = FString::Join(PinArguments, TEXT(" "));
+        Worker.Label = Placement.IsEmpty()
+            ? FString::Printf(TEXT("worker %d"), Index)
+            : FString::Printf(TEXT("worker %d (%s)"), Index, *FString::Join(Placement, TEXT(", ")));
+        Worker.Stats.Label = Worker.Label;
+    }
+}
+
+FShapEWorkerPoolBackend::~FShapEWorkerPoolBackend()
+{
+    Stop();
+}
+
+bool FShapEWorkerPoolBackend::Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType)
+{
+    Stop();
+
+    const double StartTime = FPlatformTime::Seconds();
+    ++Generation;
+    StartedScriptPath = ScriptPath;
+
+    int32 NumStarted = 0;
+    FString FirstError, FirstErrorType;
+    for (FWorker& Worker : Workers)
+    {
+        FString WorkerError, WorkerErrorType;
+        if (StartWorker(Worker, WorkerError, WorkerErrorType))
+        {
+            ++NumStarted;
+            continue;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("FShapEWorkerPoolBackend: %s failed to start: %s"), *Worker.Label, *WorkerError);
+        Worker.bDisabled = true;
+        if (FirstError.IsEmpty())
+        {
+            FirstError = WorkerError;
+            FirstErrorType = WorkerErrorType;
+        }
+    }
+
+    if (NumStarted == 0)
+    {
+        OutError = FirstError;
+        OutErrorType = FirstErrorType;
+        return false;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    StartSpan = FShapETimingSpan{ ShapEStages::WorkerSpawn, StartTime, Now };
+    StatsStartTime = Now;
+    bIsRunning = true;
+    UE_LOG(LogTemp, Log, TEXT("FShapEWorkerPoolBackend: Started %d of %d workers"), NumStarted, Workers.Num());
+    return true;
+}
+
+void FShapEWorkerPoolBackend::Stop()
+{
+    for (FWorker& Worker : Workers)
+    {
+        Worker.Backend->Stop();
+        if (Worker.RunningTask.IsSet())
+        {
+            EndTask(Worker);
+        }
+        Worker.Tasks.Reset();
+        Worker.bDisabled = false;
+
+        FShapEWorkerEvent DroppedEvent;
+        while (Worker.Backend->DequeueEvent(DroppedEvent))
+        {
+        }
+    }
+
+    Jobs.Reset();
+    SegmentOwners.Reset();
+    EventQueue.Empty();
+    bIsRunning = false;
+    bAnnouncedReady = false;
+}
+
+bool FShapEWorkerPoolBackend::StartWorker(FWorker& Worker, FString& OutError, FString& OutErrorType)
+{
+    Worker.Backend->SetWorkerArguments(FString::Printf(TEXT("%s %s"), *BaseArguments, *Worker.PinArguments).TrimStartAndEnd());
+    return Worker.Backend->Start(StartedScriptPath, OutError, OutErrorType);
+}
+
+int32 FShapEWorkerPoolBackend::PickWorker() const
+{
+    int32 BestIndex = INDEX_NONE;
+    int32 BestLoad = MAX_int32;
+    for (const FWorker& Worker : Workers)
+    {
+        const int32 Load = Worker.Tasks.Num() + (Worker.RunningTask.IsSet() ? 1 : 0);
+        if (!Worker.bDisabled && Load < BestLoad)
+        {
+            BestIndex = Worker.Index;
+            BestLoad = Load;
+        }
+    }
+    return BestIndex;
+}
+
+void FShapEWorkerPoolBackend::QueueTask(FTask&& Task, bool bFront)
+{
+    const int32 WorkerIndex = PickWorker();
+    if (WorkerIndex == INDEX_NONE)
+    {
+        FailTask(Task, TEXT("None of the pool's workers could be started."), TEXT("WorkerExited"));
+        return;
+    }
+
+    if (bFront)
+    {
+        Workers[WorkerIndex].Tasks.PushFirst(MoveTemp(Task));
+    }
+    else
+    {
+        Workers[WorkerIndex].Tasks.PushLast(MoveTemp(Task));
+    }
+}
+
+bool FShapEWorkerPoolBackend::Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage)
+{
+    if (!bIsRunning || PickWorker() == INDEX_NONE)
+    {
+        return false;
+    }
+
+    FPoolJob& Job = Jobs.Add(JobId);
+    JobMessage->TryGetStringField(TEXT("type"), Job.Type);
+
+    const TArray<TSharedPtr<FJsonValue>>* PromptValues = nullptr;
+    if (Job.Type == TEXT("batch") && Settings.bSplitBatches && JobMessage->TryGetArrayField(TEXT("prompts"), PromptValues) && PromptValues->Num() > 0)
+    {
+        int32 ItemOffset = 0, ItemCount = 0, BatchSize = 4;
+        JobMessage->TryGetNumberField(TEXT("item_offset"), ItemOffset);
+        JobMessage->TryGetNumberField(TEXT("batch_size"), BatchSize);
+        if (!JobMessage->TryGetNumberField(TEXT("item_count"), ItemCount))
+        {
+            ItemCount = ItemOffset + PromptValues->Num();
+        }
+        BatchSize = FMath::Max(1, BatchSize);
+        Job.ItemCount = PromptValues->Num();
+
+        // one task per sampling run, so splitting costs no GPU batching
+        for (int32 First = 0; First < PromptValues->Num(); First += BatchSize)
+        {
+            const int32 NumItems = FMath::Min(BatchSize, PromptValues->Num() - First);
+
+            FTask Task;
+            Task.JobId = JobId;
+            Task.TaskId = FString::Printf(TEXT("%s.%d"), *JobId, NextTaskIndex++);
+            Task.FirstItem = ItemOffset + First;
+            Task.NumItems = NumItems;
+            Task.Message = MakeShared<FJsonObject>(*JobMessage);
+            Task.Message->SetArrayField(TEXT("prompts"), TArray<TSharedPtr<FJsonValue>>(PromptValues->GetData() + First, NumItems));
+            Task.Message->SetNumberField(TEXT("item_offset"), Task.FirstItem);
+            Task.Message->SetNumberField(TEXT("item_count"), ItemCount);
+            Task.Message->SetStringField(TEXT("job_id"), Task.TaskId);
+
+            ++Job.OpenTasks;
+            QueueTask(MoveTemp(Task), false);
+        }
+        UE_LOG(LogTemp, Log, TEXT("FShapEWorkerPoolBackend: Batch %s split into %d tasks of up to %d items"), *JobId, Job.OpenTasks, BatchSize);
+    }
+    else
+    {
+        FTask Task;
+        Task.JobId = JobId;
+        Task.TaskId = FString::Printf(TEXT("%s.%d"), *JobId, NextTaskIndex++);
+        Task.Message = MakeShared<FJsonObject>(*JobMessage);
+        Task.Message->SetStringField(TEXT("job_id"), Task.TaskId);
+
+        ++Job.OpenTasks;
+        // someone is usually waiting on a single job; it goes ahead of batch items, like the manager's interactive queue
+        QueueTask(MoveTemp(Task), Job.Type != TEXT("batch"));
+    }
+
+    ScheduleTasks();
+    return true;
+}
+
+void FShapEWorkerPoolBackend::Cancel(const FString& JobId)
+{
+    if (Jobs.Remove(JobId) == 0)
+    {
+        return;
+    }
+
+    for (FWorker& Worker : Workers)
+    {
+        // rotate the deque once, keeping the order of the other jobs' tasks
+        const int32 NumQueued = Worker.Tasks.Num();
+        for (int32 Index = 0; Index < NumQueued; ++Index)
+        {
+            FTask Task;
+            Worker.Tasks.TryPopFirst(Task);
+            if (Task.JobId != JobId)
+            {
+                Worker.Tasks.PushLast(MoveTemp(Task));
+            }
+        }
+
+        // the worker stays busy until it answers, so nothing it still says about the task lands on its next one
+        if (Worker.RunningTask.IsSet() && Worker.RunningTask->JobId == JobId && !Worker.bCancelling)
+        {
+            Worker.bCancelling = true;
+            Worker.Backend->Cancel(Worker.RunningTask->TaskId);
+        }
+    }
+
+    ScheduleTasks();
+}
+
+void FShapEWorkerPoolBackend::ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh)
+{
+    int32 WorkerIndex = INDEX_NONE;
+    if (SegmentOwners.RemoveAndCopyValue(SharedMesh.SegmentName, WorkerIndex) && Workers.IsValidIndex(WorkerIndex))
+    {
+        Workers[WorkerIndex].Backend->ReleaseSharedMesh(SharedMesh);
+    }
+}
+
+bool FShapEWorkerPoolBackend::DequeueEvent(FShapEWorkerEvent& OutEvent)
+{
+    if (EventQueue.IsEmpty())
+    {
+        PollWorkers();
+    }
+    return EventQueue.Dequeue(OutEvent);
+}
+
+void FShapEWorkerPoolBackend::PollWorkers()
+{
+    if (!bIsRunning)
+    {
+        return;
+    }
+
+    for (FWorker& Worker : Workers)
+    {
+        FShapEWorkerEvent Event;
+        while (Worker.Backend->DequeueEvent(Event))
+        {
+            HandleWorkerEvent(Worker, MoveTemp(Event));
+        }
+    }
+    ScheduleTasks();
+}
+
+void FShapEWorkerPoolBackend::ScheduleTasks()
+{
+    for (FWorker& Worker : Workers)
+    {
+        if (Worker.bDisabled || Worker.RunningTask.IsSet())
+        {
+            continue;
+        }
+
+        FTask Task;
+        if (!Worker.Tasks.TryPopFirst(Task))
+        {
+            // nothing of its own left: take the newest task of the worker with the most waiting
+            FWorker* Victim = nullptr;
+            for (FWorker& Other : Workers)
+            {
+                if (&Other != &Worker && Other.Tasks.Num() > 0 && (!Victim || Other.Tasks.Num() > Victim->Tasks.Num()))
+                {
+                    Victim = &Other;
+                }
+            }
+            if (!Victim || !Victim->Tasks.TryPopLast(Task))
+            {
+                continue;
+            }
+
+            ++Worker.Stats.StolenTasks;
+            UE_LOG(LogTemp, Verbose, TEXT("FShapEWorkerPoolBackend: %s took task %s from %s"), *Worker.Label, *Task.TaskId, *Victim->Label);
+        }
+
+        RunTask(Worker, MoveTemp(Task));
+    }
+}
+
+void FShapEWorkerPoolBackend::RunTask(FWorker& Worker, FTask&& Task)
+{
+    // a worker that died (or was terminated to cancel a task) comes back when it has work again
+    if (!Worker.Backend->IsRunning())
+    {
+        ++Worker.Stats.Restarts;
+        FString Error, ErrorType;
+        if (!StartWorker(Worker, Error, ErrorType))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FShapEWorkerPoolBackend: %s could not be restarted, its tasks move to the other workers: %s"), *Worker.Label, *Error);
+            Worker.bDisabled = true;
+
+            TArray<FTask> Orphans;
+            Orphans.Add(MoveTemp(Task));
+            FTask Queued;
+            while (Worker.Tasks.TryPopFirst(Queued))
+            {
+                Orphans.Add(MoveTemp(Queued));
+            }
+            for (FTask& Orphan : Orphans)
+            {
+                QueueTask(MoveTemp(Orphan), false);
+            }
+            return;
+        }
+    }
+
+    if (!Worker.Backend->Submit(Task.TaskId, Task.Message.ToSharedRef()))
+    {
+        ++Worker.Stats.FailedTasks;
+        FailTask(Task, FString::Printf(TEXT("Failed to send the job to %s."), *Worker.Label), TEXT("PipeError"));
+        return;
+    }
+
+    Worker.BusySince = FPlatformTime::Seconds();
+    Worker.RunningTask = MoveTemp(Task);
+}
+
+void FShapEWorkerPoolBackend::HandleWorkerEvent(FWorker& Worker, FShapEWorkerEvent&& Event)
+{
+    if (Event.WorkerGeneration != Worker.Backend->GetGeneration())
+    {
+        return;
+    }
+
+    if (Event.Type == EShapEWorkerEventType::Ready)
+    {
+        // the pool is ready with its first worker; the others are idle until they have work
+        if (!bAnnouncedReady)
+        {
+            bAnnouncedReady = true;
+            FShapEWorkerEvent Ready = MakeEvent(EShapEWorkerEventType::Ready, FString());
+            Ready.Message = Event.Message;
+            Emit(MoveTemp(Ready));
+        }
+        return;
+    }
+
+    if (Event.Type == EShapEWorkerEventType::WorkerExited)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEWorkerPoolBackend: %s exited"), *Worker.Label);
+        if (Worker.RunningTask.IsSet() && Worker.bCancelling)
+        {
+            // terminated because it did not give the task up in time; the cancel is over all the same
+            EndTask(Worker);
+            Emit(MakeEvent(EShapEWorkerEventType::Ready, FString()));
+        }
+        else if (Worker.RunningTask.IsSet())
+        {
+            const FTask Lost = EndTask(Worker);
+            ++Worker.Stats.FailedTasks;
+            FailTask(Lost, FString::Printf(TEXT("Worker process exited unexpectedly (%s)."), *Worker.Label), TEXT("WorkerExited"));
+        }
+        return;
+    }
+
+    if (Worker.bCancelling)
+    {
+        // a task that finished before the cancel reached the worker is answered with cancel_ms 0 after its result
+        if (Event.Type == EShapEWorkerEventType::Cancelled && (Event.JobId.IsEmpty() || Event.JobId == Worker.RunningTask->TaskId))
+        {
+            const FTask Cancelled = EndTask(Worker);
+            Event.JobId = Cancelled.JobId;
+            Event.WorkerGeneration = Generation;
+            Emit(MoveTemp(Event));
+            // the slot is free again, which is when the manager considers the cancel done
+            Emit(MakeEvent(EShapEWorkerEventType::Ready, FString()));
+        }
+        // anything else is output of the cancelled task
+        return;
+    }
+
+    // untagged lines (tqdm bars, launcher output) belong to whatever the worker is running
+    if (!Worker.RunningTask.IsSet() || (!Event.JobId.IsEmpty() && Event.JobId != Worker.RunningTask->TaskId))
+    {
+        // an idle worker's model load is worth a status line; output of cancelled tasks is dropped
+        if (Event.JobId.IsEmpty() && (Event.Type == EShapEWorkerEventType::Status || Event.Type == EShapEWorkerEventType::Info))
+        {
+            Event.WorkerGeneration = Generation;
+            Event.Message = FString::Printf(TEXT("[%s] %s"), *Worker.Label, *Event.Message);
+            Emit(MoveTemp(Event));
+        }
+        return;
+    }
+
+    const FString JobId = Worker.RunningTask->JobId;
+    const bool bBatchTask = Worker.RunningTask->NumItems > 0;
+    FPoolJob* Job = Jobs.Find(JobId);
+    if (!Job)
+    {
+        return;
+    }
+    Event.JobId = JobId;
+    Event.WorkerGeneration = Generation;
+
+    switch (Event.Type)
+    {
+    case EShapEWorkerEventType::Progress:
+    case EShapEWorkerEventType::Preview:
+        // several workers sample parts of a split batch at once; its bar follows the finished items instead
+        if (!bBatchTask)
+        {
+            Emit(MoveTemp(Event));
+        }
+        break;
+    case EShapEWorkerEventType::Stage:
+        if (bBatchTask)
+        {
+            HandleStageEvent(*Job, MoveTemp(Event));
+        }
+        else
+        {
+            Emit(MoveTemp(Event));
+        }
+        break;
+    case EShapEWorkerEventType::ItemComplete:
+    case EShapEWorkerEventType::ItemError:
+        Job->ReportedItems.Add(Event.ItemIndex);
+        if (Event.Type == EShapEWorkerEventType::ItemError)
+        {
+            ++Job->FailedItems;
+        }
+        Emit(MoveTemp(Event));
+        break;
+    case EShapEWorkerEventType::Complete:
+    {
+        EndTask(Worker);
+        ++Worker.Stats.CompletedTasks;
+        if (Event.SharedMesh.IsValid())
+        {
+            SegmentOwners.Add(Event.SharedMesh.SegmentName, Worker.Index);
+        }
+
+        // a batch task's summary only covers its own items; the batch gets one summary at the end
+        if (bBatchTask)
+        {
+            FinishBatchTask(JobId);
+        }
+        else
+        {
+            Emit(MoveTemp(Event));
+            FinishJob(JobId);
+        }
+        break;
+    }
+    case EShapEWorkerEventType::Error:
+    {
+        const FTask Failed = EndTask(Worker);
+        ++Worker.Stats.FailedTasks;
+        if (bBatchTask)
+        {
+            FailTask(Failed, Event.Message, Event.ErrorType);
+        }
+        else
+        {
+            Emit(MoveTemp(Event));
+            FinishJob(JobId);
+        }
+        break;
+    }
+    default:
+        Emit(MoveTemp(Event));
+        break;
+    }
+}
+
+void FShapEWorkerPoolBackend::HandleStageEvent(FPoolJob& Job, FShapEWorkerEvent&& Event)
+{
+    // the job's workers overlap, so a stage spans from the first of them entering it to the last one leaving it
+    int32& NumOpen = Job.OpenStages.FindOrAdd(Event.Stage);
+    if (Event.bStageBegin ? NumOpen++ == 0 : (NumOpen > 0 && --NumOpen == 0))
+    {
+        Emit(MoveTemp(Event));
+    }
+}
+
+FShapEWorkerPoolBackend::FTask FShapEWorkerPoolBackend::EndTask(FWorker& Worker)
+{
+    FTask Task = MoveTemp(Worker.RunningTask.GetValue());
+    Worker.RunningTask.Reset();
+    Worker.bCancelling = false;
+    Worker.Stats.BusySeconds += FPlatformTime::Seconds() - Worker.BusySince;
+    return Task;
+}
+
+void FShapEWorkerPoolBackend::FailTask(const FTask& Task, const FString& Message, const FString& ErrorType)
+{
+    FPoolJob* Job = Jobs.Find(Task.JobId);
+    if (!Job)
+    {
+        return;
+    }
+
+    if (Task.NumItems == 0)
+    {
+        FShapEWorkerEvent Error = MakeEvent(EShapEWorkerEventType::Error, Task.JobId);
+        Error.Message = Message;
+        Error.ErrorType = ErrorType;
+        Emit(MoveTemp(Error));
+        FinishJob(Task.JobId);
+        return;
+    }
+
+    // the items the worker did not get to report fail with the task
+    const TArray<TSharedPtr<FJsonValue>>* PromptValues = nullptr;
+    Task.Message->TryGetArrayField(TEXT("prompts"), PromptValues);
+    for (int32 Offset = 0; Offset < Task.NumItems; ++Offset)
+    {
+        const int32 ItemIndex = Task.FirstItem + Offset;
+        if (Job->ReportedItems.Contains(ItemIndex))
+        {
+            continue;
+        }
+        Job->ReportedItems.Add(ItemIndex);
+        ++Job->FailedItems;
+
+        FShapEWorkerEvent ItemError = MakeEvent(EShapEWorkerEventType::ItemError, Task.JobId);
+        ItemError.ItemIndex = ItemIndex;
+        ItemError.Prompt = PromptValues && PromptValues->IsValidIndex(Offset) ? (*PromptValues)[Offset]->AsString() : FString();
+        ItemError.Message = Message;
+        ItemError.ErrorType = ErrorType;
+        Emit(MoveTemp(ItemError));
+    }
+    FinishBatchTask(Task.JobId);
+}
+
+void FShapEWorkerPoolBackend::FinishBatchTask(const FString& JobId)
+{
+    FPoolJob* Job = Jobs.Find(JobId);
+    if (!Job || --Job->OpenTasks > 0)
+    {
+        return;
+    }
+
+    // the summary the worker would have sent for the whole dispatch
+    TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+    Summary->SetStringField(TEXT("type"), TEXT("complete"));
+    Summary->SetStringField(TEXT("message"), FString::Printf(TEXT("Batch Complete! %d of %d items saved."), Job->ItemCount - Job->FailedItems, Job->ItemCount));
+    Summary->SetNumberField(TEXT("item_count"), Job->ItemCount);
+    Summary->SetNumberField(TEXT("failed_count"), Job->FailedItems);
+    Summary->SetStringField(TEXT("job_id"), JobId);
+
+    FShapEWorkerEvent Complete = MakeEvent(EShapEWorkerEventType::Complete, JobId);
+    Complete.Message = Summary->GetStringField(TEXT("message"));
+    Complete.RawMessage = ShapEJson::ToCondensedString(Summary);
+    Emit(MoveTemp(Complete));
+    FinishJob(JobId);
+}
+
+void FShapEWorkerPoolBackend::FinishJob(const FString& JobId)
+{
+    Jobs.Remove(JobId);
+    Emit(MakeEvent(EShapEWorkerEventType::Ready, FString()));
+}
+
+TArray<FShapEWorkerPoolBackend::FWorkerStats> FShapEWorkerPoolBackend::GetWorkerStats() const
+{
+    const double Now = FPlatformTime::Seconds();
+    const double Elapsed = Now - StatsStartTime;
+
+    TArray<FWorkerStats> Result;
+    Result.Reserve(Workers.Num());
+    for (const FWorker& Worker : Workers)
+    {
+        FWorkerStats& Stats = Result.Add_GetRef(Worker.Stats);
+        Stats.bRunning = !Worker.bDisabled && Worker.Backend->IsRunning();
+        Stats.bBusy = Worker.RunningTask.IsSet();
+        Stats.QueuedTasks = Worker.Tasks.Num();
+        if (Stats.bBusy)
+        {
+            Stats.BusySeconds += Now - Worker.BusySince;
+        }
+        Stats.Utilization = bIsRunning && Elapsed > 0.0 ? FMath::Min(1.0, Stats.BusySeconds / Elapsed) : 0.0;
+    }
+    return Result;
+}
+
+void FShapEWorkerPoolBackend::ResetWorkerStats()
+{
+    const double Now = FPlatformTime::Seconds();
+    for (FWorker& Worker : Workers)
+    {
+        Worker.Stats = FWorkerStats();
+        Worker.Stats.Label = Worker.Label;
+        Worker.BusySince = Now;
+    }
+    StatsStartTime = Now;
+}
+
+void FShapEWorkerPoolBackend::Emit(FShapEWorkerEvent&& Event)
+{
+    EventQueue.Enqueue(MoveTemp(Event));
+}
+
+FShapEWorkerEvent FShapEWorkerPoolBackend::MakeEvent(EShapEWorkerEventType Type, const FString& JobId) const
+{
+    FShapEWorkerEvent Event;
+    Event.Type = Type;
+    Event.WorkerGeneration = Generation;
+    Event.JobId = JobId;
+    Event.ReceiveTime = FPlatformTime::Seconds();
+    return Event;
+}
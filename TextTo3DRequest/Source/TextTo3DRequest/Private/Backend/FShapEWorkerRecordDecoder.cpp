@@ -0,0 +1,413 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Backend/FShapEWorkerRecordDecoder.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Worker records are little-endian and read in place");
+
+namespace ShapEWorkerRecordDecoder
+{
+    constexpr int32 HeaderBytes = 5;
+    constexpr uint8 Magic[4] = { 'S', 'H', 'P', 'E' };
+    // The previews the worker renders are at most 256 pixels wide
+    constexpr uint32 MaxPreviewSize = 256;
+
+    // Bounds-checked reads from one record body
+    struct FBodyReader
+    {
+        const uint8* Data = nullptr;
+        int32 Length = 0;
+        int32 Offset = 0;
+
+        bool Take(int64 Count, const uint8*& OutData)
+        {
+            if (Count < 0 || Count > Length - Offset)
+            {
+                return false;
+            }
+            OutData = Data + Offset;
+            Offset += static_cast<int32>(Count);
+            return true;
+        }
+
+        template <typename T>
+        bool Read(T& OutValue)
+        {
+            const uint8* Bytes = nullptr;
+            if (!Take(sizeof(T), Bytes))
+            {
+                return false;
+            }
+            FMemory::Memcpy(&OutValue, Bytes, sizeof(T));
+            return true;
+        }
+
+        bool ReadBytes(const uint8*& OutData, int32& OutLength)
+        {
+            uint32 Count = 0;
+            if (!Read(Count) || !Take(Count, OutData))
+            {
+                return false;
+            }
+            OutLength = static_cast<int32>(Count);
+            return true;
+        }
+
+        bool ReadString(FString& OutValue)
+        {
+            const uint8* Bytes = nullptr;
+            int32 Count = 0;
+            if (!ReadBytes(Bytes, Count))
+            {
+                return false;
+            }
+            OutValue = FString(Count, reinterpret_cast<const UTF8CHAR*>(Bytes));
+            return true;
+        }
+
+        bool IsAtEnd() const { return Offset == Length; }
+    };
+
+    static int32 ToInt32(uint32 Value)
+    {
+        return static_cast<int32>(FMath::Min<uint32>(Value, MAX_int32));
+    }
+
+    static void AppendLittleEndian(TArray<uint8>& Buffer, const void* Value, int32 Size)
+    {
+        Buffer.Append(static_cast<const uint8*>(Value), Size);
+    }
+}
+
+//=====================================================================================================\\
+// --- ShapEWorkerRecords::FWriter ---
+
+void ShapEWorkerRecords::FWriter::BeginRecord(ERecordType Type)
+{
+    RecordStart = Buffer.Num();
+    WriteU32(0);
+    WriteU8(static_cast<uint8>(Type));
+}
+
+void ShapEWorkerRecords::FWriter::EndRecord()
+{
+    check(RecordStart != INDEX_NONE);
+    const uint32 RecordLength = static_cast<uint32>(Buffer.Num() - RecordStart - sizeof(uint32));
+    FMemory::Memcpy(Buffer.GetData() + RecordStart, &RecordLength, sizeof(RecordLength));
+    RecordStart = INDEX_NONE;
+}
+
+void ShapEWorkerRecords::FWriter::WriteU16(uint16 Value)
+{
+    ShapEWorkerRecordDecoder::AppendLittleEndian(Buffer, &Value, sizeof(Value));
+}
+
+void ShapEWorkerRecords::FWriter::WriteU32(uint32 Value)
+{
+    ShapEWorkerRecordDecoder::AppendLittleEndian(Buffer, &Value, sizeof(Value));
+}
+
+void ShapEWorkerRecords::FWriter::WriteI64(int64 Value)
+{
+    ShapEWorkerRecordDecoder::AppendLittleEndian(Buffer, &Value, sizeof(Value));
+}
+
+void ShapEWorkerRecords::FWriter::WriteF32(float Value)
+{
+    ShapEWorkerRecordDecoder::AppendLittleEndian(Buffer, &Value, sizeof(Value));
+}
+
+void ShapEWorkerRecords::FWriter::WriteF64(double Value)
+{
+    ShapEWorkerRecordDecoder::AppendLittleEndian(Buffer, &Value, sizeof(Value));
+}
+
+void ShapEWorkerRecords::FWriter::WriteString(const FString& Value)
+{
+    FTCHARToUTF8 Utf8Value(*Value);
+    WriteBytes(reinterpret_cast<const uint8*>(Utf8Value.Get()), Utf8Value.Length());
+}
+
+void ShapEWorkerRecords::FWriter::WriteBytes(const uint8* Data, int32 Length)
+{
+    WriteU32(static_cast<uint32>(Length));
+    Buffer.Append(Data, Length);
+}
+
+void ShapEWorkerRecords::FWriter::WriteHello(uint16 Version)
+{
+    BeginRecord(ERecordType::Hello);
+    Buffer.Append(ShapEWorkerRecordDecoder::Magic, UE_ARRAY_COUNT(ShapEWorkerRecordDecoder::Magic));
+    WriteU16(Version);
+    WriteU16(0);
+    EndRecord();
+}
+
+//=====================================================================================================\\
+// --- FShapEWorkerRecordDecoder ---
+
+bool FShapEWorkerRecordDecoder::Append(const uint8* Data, int32 Length, uint32 Generation, TFunctionRef<void(FShapEWorkerEvent&&)> OnEvent)
+{
+    using namespace ShapEWorkerRecords;
+    using namespace ShapEWorkerRecordDecoder;
+
+    // a declined channel is closed by the worker right after its hello
+    if (State == EState::Failed || State == EState::Declined || Length <= 0)
+    {
+        return State != EState::Failed;
+    }
+
+    // Drop the consumed prefix before growing, so the buffer only ever holds one partial record
+    if (ConsumedBytes > 0)
+    {
+        Buffer.RemoveAt(0, ConsumedBytes, EAllowShrinking::No);
+        ConsumedBytes = 0;
+    }
+    Buffer.Append(Data, Length);
+
+    while (Buffer.Num() - ConsumedBytes >= HeaderBytes)
+    {
+        const uint8* Header = Buffer.GetData() + ConsumedBytes;
+        uint32 RecordLength = 0;
+        FMemory::Memcpy(&RecordLength, Header, sizeof(RecordLength));
+        if (RecordLength < 1 || RecordLength > static_cast<uint32>(MaxRecordBytes))
+        {
+            return Fail(FString::Printf(TEXT("Record length %u is out of range"), RecordLength));
+        }
+        if (static_cast<int64>(Buffer.Num() - ConsumedBytes) - static_cast<int64>(sizeof(uint32)) < RecordLength)
+        {
+            break;
+        }
+
+        const ERecordType Type = static_cast<ERecordType>(Header[sizeof(uint32)]);
+        const uint8* Body = Header + HeaderBytes;
+        const int32 BodyLength = static_cast<int32>(RecordLength) - 1;
+        ConsumedBytes += sizeof(uint32) + RecordLength;
+
+        if (State == EState::AwaitingHello)
+        {
+            if (Type != ERecordType::Hello)
+            {
+                return Fail(FString::Printf(TEXT("Expected a hello, got a record of type %d"), static_cast<int32>(Type)));
+            }
+            if (!DecodeHello(Body, BodyLength))
+            {
+                return false;
+            }
+            if (State == EState::Declined)
+            {
+                return true;
+            }
+            continue;
+        }
+
+        FShapEWorkerEvent Event;
+        bool bHasEvent = false;
+        if (!DecodeRecord(Type, Body, BodyLength, Generation, Event, bHasEvent))
+        {
+            return Fail(FString::Printf(TEXT("Malformed record of type %d (%d bytes)"), static_cast<int32>(Type), BodyLength));
+        }
+        if (bHasEvent)
+        {
+            OnEvent(MoveTemp(Event));
+        }
+    }
+    return true;
+}
+
+void FShapEWorkerRecordDecoder::Reset()
+{
+    Buffer.Reset();
+    ConsumedBytes = 0;
+    State = EState::AwaitingHello;
+    Version = 0;
+    Error.Reset();
+}
+
+bool FShapEWorkerRecordDecoder::DecodeHello(const uint8* Body, int32 Length)
+{
+    using namespace ShapEWorkerRecordDecoder;
+
+    FBodyReader Reader{ Body, Length };
+    const uint8* ReadMagic = nullptr;
+    uint16 Flags = 0;
+    if (!Reader.Take(UE_ARRAY_COUNT(Magic), ReadMagic) || FMemory::Memcmp(ReadMagic, Magic, UE_ARRAY_COUNT(Magic)) != 0
+        || !Reader.Read(Version) || !Reader.Read(Flags) || !Reader.IsAtEnd())
+    {
+        return Fail(TEXT("Malformed hello"));
+    }
+
+    // the worker says so on stdout itself
+    if (Version == 0)
+    {
+        State = EState::Declined;
+        return true;
+    }
+    if (Version != ShapEWorkerRecords::ProtocolVersion)
+    {
+        return Fail(FString::Printf(TEXT("The worker picked record protocol version %d, which was not offered"), Version));
+    }
+
+    State = EState::Open;
+    return true;
+}
+
+bool FShapEWorkerRecordDecoder::DecodeRecord(ShapEWorkerRecords::ERecordType Type, const uint8* Body, int32 Length, uint32 Generation, FShapEWorkerEvent& OutEvent, bool& bOutHasEvent)
+{
+    using namespace ShapEWorkerRecords;
+    using namespace ShapEWorkerRecordDecoder;
+
+    bOutHasEvent = false;
+
+    if (Type == ERecordType::Json)
+    {
+        const FUtf8StringView Line(reinterpret_cast<const UTF8CHAR*>(Body), Length);
+        FShapEParsedLine Parsed;
+        FShapEOutputParser::Parse(Line, Parsed);
+        if (Parsed.Kind != EShapELineKind::Json)
+        {
+            return false;
+        }
+        bOutHasEvent = JsonDecoder.Decode(Line, Parsed, Generation, OutEvent);
+        return true;
+    }
+
+    FBodyReader Reader{ Body, Length };
+    if (!Reader.ReadString(OutEvent.JobId))
+    {
+        return false;
+    }
+    OutEvent.WorkerGeneration = Generation;
+    OutEvent.ReceiveTime = FPlatformTime::Seconds();
+
+    bool bRead = false;
+    switch (Type)
+    {
+    case ERecordType::Ready:
+        OutEvent.Type = EShapEWorkerEventType::Ready;
+        bRead = true;
+        break;
+    case ERecordType::Status:
+        OutEvent.Type = EShapEWorkerEventType::Status;
+        bRead = Reader.ReadString(OutEvent.Message);
+        break;
+    case ERecordType::Info:
+        OutEvent.Type = EShapEWorkerEventType::Info;
+        bRead = Reader.ReadString(OutEvent.Message);
+        break;
+    case ERecordType::Progress:
+    {
+        uint32 Step = 0, TotalSteps = 0;
+        float Rate = 0.f;
+        bRead = Reader.Read(Step) && Reader.Read(TotalSteps) && Reader.Read(Rate);
+        // the same mapping as tqdm's bar: sampling fills 10% to 95%
+        OutEvent.Type = EShapEWorkerEventType::Progress;
+        OutEvent.Step = ToInt32(Step);
+        OutEvent.TotalSteps = ToInt32(TotalSteps);
+        OutEvent.Percentage = 10.f + (TotalSteps > 0 ? static_cast<float>(FMath::Min(Step, TotalSteps)) / TotalSteps : 0.f) * 85.f;
+        break;
+    }
+    case ERecordType::Stage:
+    {
+        FString Phase;
+        uint32 Steps = 0, Batch = 0;
+        bRead = Reader.ReadString(OutEvent.Stage) && Reader.ReadString(Phase) && Reader.Read(OutEvent.WorkerTimestamp)
+            && Reader.Read(Steps) && Reader.Read(Batch);
+        OutEvent.Type = EShapEWorkerEventType::Stage;
+        OutEvent.bStageBegin = Phase.Equals(TEXT("begin"), ESearchCase::CaseSensitive);
+        OutEvent.TotalSteps = ToInt32(Steps);
+        break;
+    }
+    case ERecordType::Error:
+        OutEvent.Type = EShapEWorkerEventType::Error;
+        bRead = Reader.ReadString(OutEvent.Message) && Reader.ReadString(OutEvent.ErrorType);
+        break;
+    case ERecordType::Complete:
+    {
+        FShapESharedMeshLayout SharedMesh;
+        uint32 NumVertices = 0, NumTriangles = 0;
+        OutEvent.Type = EShapEWorkerEventType::Complete;
+        bRead = Reader.ReadString(OutEvent.Message) && Reader.ReadString(OutEvent.PlyPath) && Reader.ReadString(OutEvent.ObjPath)
+            && Reader.ReadString(OutEvent.LatentPath) && Reader.ReadString(SharedMesh.SegmentName) && Reader.Read(SharedMesh.SegmentSize)
+            && Reader.Read(SharedMesh.PositionsOffset) && Reader.Read(SharedMesh.ColorsOffset) && Reader.Read(SharedMesh.IndicesOffset)
+            && Reader.Read(NumVertices) && Reader.Read(NumTriangles);
+        // file results leave the segment fields empty
+        if (!SharedMesh.SegmentName.IsEmpty())
+        {
+            SharedMesh.NumVertices = ToInt32(NumVertices);
+            SharedMesh.NumTriangles = ToInt32(NumTriangles);
+            OutEvent.SharedMesh = MoveTemp(SharedMesh);
+        }
+        break;
+    }
+    case ERecordType::ItemComplete:
+    {
+        uint32 ItemIndex = 0, ItemCount = 0;
+        OutEvent.Type = EShapEWorkerEventType::ItemComplete;
+        bRead = Reader.Read(ItemIndex) && Reader.Read(ItemCount) && Reader.ReadString(OutEvent.Prompt)
+            && Reader.ReadString(OutEvent.PlyPath) && Reader.ReadString(OutEvent.ObjPath) && Reader.ReadString(OutEvent.LatentPath);
+        OutEvent.ItemIndex = ToInt32(ItemIndex);
+        OutEvent.ItemCount = ToInt32(ItemCount);
+        break;
+    }
+    case ERecordType::ItemError:
+    {
+        uint32 ItemIndex = 0;
+        OutEvent.Type = EShapEWorkerEventType::ItemError;
+        bRead = Reader.Read(ItemIndex) && Reader.ReadString(OutEvent.Prompt) && Reader.ReadString(OutEvent.Message) && Reader.ReadString(OutEvent.ErrorType);
+        OutEvent.ItemIndex = ToInt32(ItemIndex);
+        break;
+    }
+    case ERecordType::Cancelled:
+        OutEvent.Type = EShapEWorkerEventType::Cancelled;
+        bRead = Reader.ReadString(OutEvent.Message) && Reader.Read(OutEvent.CancelMilliseconds);
+        break;
+    case ERecordType::Preview:
+    {
+        FShapEPreviewImage& Preview = OutEvent.Preview;
+        uint32 Step = 0, TotalSteps = 0, Width = 0, Height = 0;
+        const uint8* Pixels = nullptr;
+        int32 NumBytes = 0;
+        OutEvent.Type = EShapEWorkerEventType::Preview;
+        bRead = Reader.Read(Step) && Reader.Read(TotalSteps) && Reader.Read(Width) && Reader.Read(Height)
+            && Reader.Read(Preview.RenderMilliseconds) && Reader.ReadBytes(Pixels, NumBytes);
+        if (!bRead)
+        {
+            break;
+        }
+        // well framed but unusable: dropped like a malformed JSON preview, the stream itself is fine
+        if (Width == 0 || Height == 0 || Width > MaxPreviewSize || Height > MaxPreviewSize || static_cast<int64>(NumBytes) != static_cast<int64>(Width) * Height * 3)
+        {
+            int32 Suppressed = 0;
+            if (PreviewLogLimiter.ShouldLog(FPlatformTime::Seconds(), Suppressed))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("%s: Dropping malformed preview (%ux%u, %d bytes) [%d not logged]"), LogName, Width, Height, NumBytes, Suppressed);
+            }
+            return Reader.IsAtEnd();
+        }
+        Preview.Step = ToInt32(Step);
+        Preview.TotalSteps = ToInt32(TotalSteps);
+        Preview.Width = static_cast<int32>(Width);
+        Preview.Height = static_cast<int32>(Height);
+        Preview.Pixels.SetNumUninitialized(Preview.Width * Preview.Height);
+        for (int32 Pixel = 0; Pixel < Preview.Pixels.Num(); ++Pixel)
+        {
+            Preview.Pixels[Pixel] = FColor(Pixels[Pixel * 3 + 0], Pixels[Pixel * 3 + 1], Pixels[Pixel * 3 + 2], 255);
+        }
+        break;
+    }
+    default:
+        // a second hello, or a type from a protocol version that was not negotiated
+        return false;
+    }
+
+    bOutHasEvent = bRead && Reader.IsAtEnd();
+    return bOutHasEvent;
+}
+
+bool FShapEWorkerRecordDecoder::Fail(const FString& Reason)
+{
+    Error = Reason;
+    State = EState::Failed;
+    Buffer.Reset();
+    ConsumedBytes = 0;
+    return false;
+}
@@ -0,0 +1,608 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Benchmark/ShapEBenchmarkCommandlet.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "MeshDescription.h"
+#include "Manager/FShapEProcessManager.h"
+#include "Import/FShapEPlyImporter.h"
+#include "Backend/FShapEMockBackend.h"
+#include "Backend/FShapEDirectLaunchBackend.h"
+#include "Backend/FShapEHttpBackend.h"
+#include "Backend/FShapEWorkerPoolBackend.h"
+
+namespace ShapEBenchmarkCommandlet
+{
+    struct FRunState
+    {
+        bool bSharedMemory = false;
+        bool bImport = true;
+        int32 Submitted = 0;
+        int32 Completed = 0;
+        int32 Failures = 0;
+        TArray<double> SubmitTimes;
+        TArray<double> LatencySeconds;
+        double TotalImportSeconds = 0.0;
+        int32 NumVertices = 0;
+        // filled by OnSharedMeshReady, which fires just before OnGenerationComplete
+        bool bSharedMeshImported = false;
+        FShapEPlyImportStats SharedMeshStats;
+
+        int32 GetInFlight() const { return Submitted - Completed; }
+    };
+
+    static FString GetDefaultScriptPath()
+    {
+        TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("TextTo3DRequest"));
+        return Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("ue_shape_interface.py")) : FString();
+    }
+
+    static double GetPercentile(TArray<double> Values, double Percentile)
+    {
+        if (Values.IsEmpty())
+        {
+            return 0.0;
+        }
+        Values.Sort();
+        return Values[FMath::Clamp(FMath::CeilToInt32(Percentile * Values.Num()) - 1, 0, Values.Num() - 1)];
+    }
+
+    static void FinishJob(FRunState& State, int32 JobIndex, double ImportSeconds, int32 NumVertices, bool bSucceeded)
+    {
+        ++State.Completed;
+        if (!bSucceeded)
+        {
+            ++State.Failures;
+            return;
+        }
+        State.LatencySeconds.Add(FPlatformTime::Seconds() - State.SubmitTimes[JobIndex]);
+        State.TotalImportSeconds += ImportSeconds;
+        State.NumVertices = NumVertices;
+    }
+
+    static void Submit(FShapEProcessManager& Manager, const FString& ScriptPath, const TSharedRef<FRunState>& State, int32 KarrasSteps, const FString& OutputDirectory)
+    {
+        const int32 JobIndex = State->Submitted++;
+
+        FShapEGenerationParameters Params;
+        // distinct prompts so nothing is deduplicated along the way
+        Params.Prompt = FString::Printf(TEXT("benchmark sphere %d"), JobIndex);
+        Params.OutputDirectory = OutputDirectory;
+        Params.KarrasSteps = KarrasSteps;
+        Params.bUseCache = false;
+        Params.bSaveLatents = false;
+        Params.bUseSharedMemory = State->bSharedMemory;
+        Params.bExportFiles = !State->bSharedMemory;
+
+        TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+        Delegates->OnSharedMeshReady.AddLambda([State](const FShapESharedMeshLayout& Layout)
+        {
+            if (!State->bImport)
+            {
+                State->bSharedMeshImported = true;
+                return;
+            }
+
+            FMeshDescription MeshDescription;
+            FString Error;
+            State->bSharedMeshImported = FShapEPlyImporter::ImportSharedMesh(Layout, MeshDescription, FShapEPlyImportOptions(), Error, &State->SharedMeshStats);
+            if (!State->bSharedMeshImported)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: %s"), *Error);
+            }
+        });
+        Delegates->OnGenerationComplete.AddLambda([State, JobIndex](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
+        {
+            if (State->bSharedMemory)
+            {
+                FinishJob(*State, JobIndex, State->SharedMeshStats.ParseSeconds, State->SharedMeshStats.NumVertices, State->bSharedMeshImported);
+                State->bSharedMeshImported = false;
+                State->SharedMeshStats = FShapEPlyImportStats();
+                return;
+            }
+            if (!State->bImport)
+            {
+                FinishJob(*State, JobIndex, 0.0, 0, true);
+                return;
+            }
+
+            FMeshDescription MeshDescription;
+            FShapEPlyImportStats Stats;
+            FString Error;
+            const bool bImported = FShapEPlyImporter::ImportMeshDescription(PlyPath, MeshDescription, FShapEPlyImportOptions(), Error, &Stats);
+            if (!bImported)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: %s"), *Error);
+            }
+            FinishJob(*State, JobIndex, Stats.ParseSeconds, Stats.NumVertices, bImported);
+        });
+        Delegates->OnErrorReceived.AddLambda([State, JobIndex](const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: Job %d failed: %s (%s)"), JobIndex, *ErrorMessage, *ErrorType);
+            FinishJob(*State, JobIndex, 0.0, 0, false);
+        });
+
+        State->SubmitTimes.Add(FPlatformTime::Seconds());
+        if (Manager.EnqueueGeneration(ScriptPath, Params, EShapEJobPriority::Interactive, Delegates).IsEmpty())
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: Job %d was rejected."), JobIndex);
+            FinishJob(*State, JobIndex, 0.0, 0, false);
+        }
+    }
+
+    struct FCancelVictim
+    {
+        FString JobId;
+        bool bSampling = false;
+        bool bFinished = false;
+    };
+
+    // A job that is cancelled once the worker reports its first sampling step
+    static TSharedRef<FCancelVictim> SubmitCancelVictim(FShapEProcessManager& Manager, const FString& ScriptPath, int32 Round, int32 KarrasSteps, const FString& OutputDirectory)
+    {
+        TSharedRef<FCancelVictim> Victim = MakeShared<FCancelVictim>();
+
+        FShapEGenerationParameters Params;
+        Params.Prompt = FString::Printf(TEXT("benchmark cancel %d"), Round);
+        Params.OutputDirectory = OutputDirectory;
+        Params.KarrasSteps = KarrasSteps;
+        Params.bUseCache = false;
+        Params.bSaveLatents = false;
+
+        TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+        Delegates->OnProgressUpdated.AddLambda([Victim](float Percentage, int32 Step, int32 TotalSteps, const FString& RawMessage)
+        {
+            Victim->bSampling |= Step > 0;
+        });
+        Delegates->OnGenerationComplete.AddLambda([Victim](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
+        {
+            Victim->bFinished = true;
+        });
+        Delegates->OnErrorReceived.AddLambda([Victim](const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
+        {
+            Victim->bFinished = true;
+        });
+
+        Victim->JobId = Manager.EnqueueGeneration(ScriptPath, Params, EShapEJobPriority::Interactive, Delegates);
+        Victim->bFinished = Victim->JobId.IsEmpty();
+        return Victim;
+    }
+
+    // Pumps the game thread like the editor loop does until Done returns true; false on timeout
+    static bool PumpUntil(TFunctionRef<bool()> Done, double Deadline, float TickSeconds)
+    {
+        double LastTickTime = FPlatformTime::Seconds();
+        while (!Done())
+        {
+            const double Now = FPlatformTime::Seconds();
+            if (Now > Deadline)
+            {
+                return false;
+            }
+
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+            FTSTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTickTime));
+            LastTickTime = Now;
+            FPlatformProcess::Sleep(TickSeconds);
+        }
+        return true;
+    }
+}
+
+UShapEBenchmarkCommandlet::UShapEBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+int32 UShapEBenchmarkCommandlet::Main(const FString& Params)
+{
+    using namespace ShapEBenchmarkCommandlet;
+
+    int32 Jobs = 50;
+    int32 Concurrency = 4;
+    int32 KarrasSteps = 16;
+    int32 Segments = 64;
+    float LoadMs = 0.0f;
+    float StepMs = 0.0f;
+    float DecodeMs = 0.0f;
+    int32 LogLines = 0;
+    int32 WarmupJobs = 1;
+    float TickMs = 1.0f;
+    float TimeoutSeconds = 600.0f;
+    FString Transport = TEXT("file");
+    FString BackendName = TEXT("process");
+    FString Protocol = TEXT("binary");
+    FString EndpointList;
+    int32 ConnectionsPerEndpoint = 2;
+    int32 NumWorkers = 1;
+    FString DeviceList;
+    FString CoreList;
+    FString ScriptPath = GetDefaultScriptPath();
+    FString ReportPath;
+    FString TimingsPath;
+    int32 Cancels = 0;
+    float CancelTimeoutSeconds = -1.0f;
+
+    FParse::Value(*Params, TEXT("jobs="), Jobs);
+    FParse::Value(*Params, TEXT("concurrency="), Concurrency);
+    FParse::Value(*Params, TEXT("steps="), KarrasSteps);
+    FParse::Value(*Params, TEXT("segments="), Segments);
+    FParse::Value(*Params, TEXT("load-ms="), LoadMs);
+    FParse::Value(*Params, TEXT("step-ms="), StepMs);
+    FParse::Value(*Params, TEXT("decode-ms="), DecodeMs);
+    FParse::Value(*Params, TEXT("log-lines="), LogLines);
+    FParse::Value(*Params, TEXT("warmup="), WarmupJobs);
+    FParse::Value(*Params, TEXT("tick-ms="), TickMs);
+    FParse::Value(*Params, TEXT("timeout="), TimeoutSeconds);
+    FParse::Value(*Params, TEXT("transport="), Transport);
+    FParse::Value(*Params, TEXT("backend="), BackendName);
+    FParse::Value(*Params, TEXT("protocol="), Protocol);
+    FParse::Value(*Params, TEXT("endpoints="), EndpointList, false);
+    FParse::Value(*Params, TEXT("connections="), ConnectionsPerEndpoint);
+    FParse::Value(*Params, TEXT("workers="), NumWorkers);
+    FParse::Value(*Params, TEXT("devices="), DeviceList, false);
+    FParse::Value(*Params, TEXT("cores="), CoreList, false);
+    FParse::Value(*Params, TEXT("script="), ScriptPath);
+    FParse::Value(*Params, TEXT("report="), ReportPath);
+    FParse::Value(*Params, TEXT("timings="), TimingsPath);
+    FParse::Value(*Params, TEXT("cancels="), Cancels);
+    FParse::Value(*Params, TEXT("cancel-timeout="), CancelTimeoutSeconds);
+
+    if (CancelTimeoutSeconds >= 0.0f)
+    {
+        // 0 terminates the worker on cancel, the behaviour to compare the cooperative cancel against
+        if (IConsoleVariable* CancelTimeoutVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("ShapE.Cancel.Timeout")))
+        {
+            CancelTimeoutVariable->Set(CancelTimeoutSeconds, ECVF_SetByCommandline);
+        }
+    }
+
+    Jobs = FMath::Max(1, Jobs);
+    Concurrency = FMath::Max(1, Concurrency);
+    KarrasSteps = FMath::Clamp(KarrasSteps, 1, 1024);
+    Segments = FMath::Clamp(Segments, 8, 4096);
+    WarmupJobs = FMath::Max(0, WarmupJobs);
+    NumWorkers = FMath::Max(1, NumWorkers);
+
+    // the mock backend runs the same timeline in-process, leaving only the manager and the import to measure
+    const bool bMockBackend = BackendName.Equals(TEXT("mock"), ESearchCase::IgnoreCase);
+    // the http backend runs against servers started separately (ue_shape_interface.py --serve --synthetic), paced there
+    const bool bHttpBackend = BackendName.Equals(TEXT("http"), ESearchCase::IgnoreCase);
+    // the worker spawned without run_shape.sh; compare worker_boot_ms against -backend=process
+    const bool bDirectBackend = BackendName.Equals(TEXT("direct"), ESearchCase::IgnoreCase);
+    // only the direct launcher can hand the worker its record pipe; everything else stays on JSON lines
+    FShapEDirectLaunchSettings DirectSettings;
+    DirectSettings.bBinaryRecords = bDirectBackend && !Protocol.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+    Protocol = DirectSettings.bBinaryRecords ? TEXT("binary") : TEXT("json");
+    if (bHttpBackend && EndpointList.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: -backend=http needs -endpoints=<url>[,<url>...]"));
+        return 1;
+    }
+    if (!bMockBackend && !bHttpBackend && !FPaths::FileExists(ScriptPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: Worker script not found: %s"), *ScriptPath);
+        return 1;
+    }
+
+    if ((bMockBackend || bHttpBackend) && Transport.Equals(TEXT("shm"), ESearchCase::IgnoreCase))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ShapEBenchmarkCommandlet: The %s backend only hands over files; using the file transport."), *BackendName);
+        Transport = TEXT("file");
+    }
+
+    FShapEMockBackendSettings MockSettings;
+    MockSettings.StartupSeconds = LoadMs / 1000.0;
+    MockSettings.SecondsPerStep = StepMs / 1000.0;
+    MockSettings.DecodeSeconds = DecodeMs / 1000.0;
+    MockSettings.Segments = Segments;
+
+    TSharedPtr<FShapEProcessManager> ManagerPtr;
+    TSharedPtr<FShapEHttpBackend, ESPMode::ThreadSafe> HttpBackend;
+    TSharedPtr<FShapEWorkerPoolBackend, ESPMode::ThreadSafe> PoolBackend;
+    if (NumWorkers > 1 && !bHttpBackend)
+    {
+        // -workers=N runs N mock timelines or N worker processes side by side, each pinned per -devices/-cores
+        FShapEWorkerPoolSettings PoolSettings;
+        PoolSettings.NumWorkers = NumWorkers;
+        TArray<FString> Devices;
+        DeviceList.ParseIntoArray(Devices, TEXT(","));
+        for (const FString& Device : Devices)
+        {
+            PoolSettings.Devices.Add(FCString::Atoi(*Device));
+        }
+        PoolSettings.bSplitCores = CoreList.Equals(TEXT("split"), ESearchCase::IgnoreCase);
+        if (!PoolSettings.bSplitCores)
+        {
+            CoreList.ParseIntoArray(PoolSettings.CoreSets, TEXT(";"));
+        }
+        if (bMockBackend)
+        {
+            PoolSettings.MakeWorker = [MockSettings](int32 WorkerIndex) -> TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>
+            {
+                return MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(MockSettings);
+            };
+        }
+        else if (bDirectBackend)
+        {
+            PoolSettings.MakeWorker = [DirectSettings](int32 WorkerIndex) -> TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>
+            {
+                return MakeShared<FShapEDirectLaunchBackend, ESPMode::ThreadSafe>(DirectSettings);
+            };
+        }
+        PoolBackend = MakeShared<FShapEWorkerPoolBackend, ESPMode::ThreadSafe>(PoolSettings);
+        ManagerPtr = MakeShared<FShapEProcessManager>(PoolBackend.ToSharedRef());
+        if (Concurrency < NumWorkers)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapEBenchmarkCommandlet: -concurrency=%d keeps only %d of %d workers busy"), Concurrency, Concurrency, NumWorkers);
+        }
+    }
+    else if (bMockBackend)
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>(MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(MockSettings));
+    }
+    else if (bHttpBackend)
+    {
+        FShapEHttpBackendSettings HttpSettings;
+        EndpointList.ParseIntoArray(HttpSettings.Endpoints, TEXT(","));
+        HttpSettings.MaxConnectionsPerEndpoint = ConnectionsPerEndpoint;
+        HttpBackend = MakeShared<FShapEHttpBackend, ESPMode::ThreadSafe>(HttpSettings);
+        ManagerPtr = MakeShared<FShapEProcessManager>(HttpBackend.ToSharedRef());
+    }
+    else if (bDirectBackend)
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>(MakeShared<FShapEDirectLaunchBackend, ESPMode::ThreadSafe>(DirectSettings));
+    }
+    else
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>();
+    }
+    if (!bMockBackend && !bHttpBackend)
+    {
+        ManagerPtr->SetWorkerArguments(FString::Printf(
+            TEXT("--synthetic --synthetic-segments %d --synthetic-load-ms %.3f --synthetic-step-ms %.3f --synthetic-decode-ms %.3f --synthetic-log-lines %d"),
+            Segments, LoadMs, StepMs, DecodeMs, LogLines));
+    }
+    TSharedRef<FShapEProcessManager> Manager = ManagerPtr.ToSharedRef();
+
+    const FString OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEBenchmark"), TEXT("Commandlet"));
+    const float TickSeconds = FMath::Max(0.0f, TickMs) / 1000.0f;
+    const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: %d jobs, concurrency %d, %d steps, %d segments, %s transport, %s backend, %s protocol, %d workers, worker %s"),
+        Jobs, Concurrency, KarrasSteps, Segments, *Transport, *Manager->GetBackend()->GetName(), *Protocol, PoolBackend.IsValid() ? NumWorkers : 1, *ScriptPath);
+
+    auto MakeState = [&]()
+    {
+        TSharedRef<FRunState> State = MakeShared<FRunState>();
+        State->bSharedMemory = Transport.Equals(TEXT("shm"), ESearchCase::IgnoreCase);
+        State->bImport = !FParse::Param(*Params, TEXT("noimport"));
+        return State;
+    };
+
+    // Warm-up: worker boot and model load stay out of the measured run; a pool gets the warm-up jobs once per worker
+    bool bTimedOut = false;
+    const double WarmupStartTime = FPlatformTime::Seconds();
+    if (WarmupJobs > 0)
+    {
+        TSharedRef<FRunState> Warmup = MakeState();
+        for (int32 Index = 0; Index < WarmupJobs * (PoolBackend.IsValid() ? NumWorkers : 1); ++Index)
+        {
+            Submit(*Manager, ScriptPath, Warmup, KarrasSteps, OutputDirectory);
+        }
+        bTimedOut = !PumpUntil([&Warmup]() { return Warmup->GetInFlight() == 0; }, Deadline, TickSeconds);
+        if (Warmup->Failures > 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: Warm-up failed; check the worker output above."));
+            Manager->StopWorker();
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: Warm-up took %.2f s"), FPlatformTime::Seconds() - WarmupStartTime);
+    }
+    // launch to first message of the worker the run uses; the warm-up's, unless there was none
+    double WorkerBootSeconds = Manager->GetWorkerBootSeconds();
+    Manager->ResetDispatchLatencyStats();
+    if (PoolBackend.IsValid())
+    {
+        PoolBackend->ResetWorkerStats();
+    }
+
+    TSharedRef<FRunState> State = MakeState();
+    const double RunStartTime = FPlatformTime::Seconds();
+    if (!bTimedOut)
+    {
+        bTimedOut = !PumpUntil([&]()
+        {
+            while (State->Submitted < Jobs && State->GetInFlight() < Concurrency)
+            {
+                Submit(*Manager, ScriptPath, State, KarrasSteps, OutputDirectory);
+            }
+            return State->Completed >= Jobs;
+        }, Deadline, TickSeconds);
+    }
+    const double RunSeconds = FPlatformTime::Seconds() - RunStartTime;
+
+    // Cancels: a job is cancelled mid-sampling with another one queued behind it, and the time from the cancel to
+    // the worker's next "ready" is taken; a terminated worker only gets there after the follow-up job reloads it
+    FShapECancelStats CancelStats;
+    int32 MissedCancels = 0;
+    if (Cancels > 0 && !bTimedOut)
+    {
+        Manager->ResetCancelStats();
+        TSharedRef<FRunState> FollowUps = MakeState();
+        for (int32 Round = 0; Round < Cancels && !bTimedOut; ++Round)
+        {
+            TSharedRef<FCancelVictim> Victim = SubmitCancelVictim(*Manager, ScriptPath, Round, KarrasSteps, OutputDirectory);
+            Submit(*Manager, ScriptPath, FollowUps, KarrasSteps, OutputDirectory);
+
+            bTimedOut = !PumpUntil([&Victim]() { return Victim->bSampling || Victim->bFinished; }, Deadline, TickSeconds);
+            if (Victim->bFinished || !Manager->CancelJob(Victim->JobId))
+            {
+                ++MissedCancels;
+            }
+            bTimedOut |= !PumpUntil([&FollowUps]() { return FollowUps->GetInFlight() == 0; }, Deadline, TickSeconds);
+        }
+        State->Failures += FollowUps->Failures;
+        CancelStats = Manager->GetCancelStats();
+
+        UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: cancel to ready over %d cancels mean %.1f ms, max %.1f ms (worker gave up the last job in %.1f ms)"),
+            CancelStats.Cancels, CancelStats.GetAverageSeconds() * 1000.0, CancelStats.MaxSeconds * 1000.0, CancelStats.LastWorkerMilliseconds);
+        if (MissedCancels > 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapEBenchmarkCommandlet: %d jobs finished before they could be cancelled; raise -step-ms or -steps"), MissedCancels);
+        }
+    }
+
+    if (WorkerBootSeconds <= 0.0)
+    {
+        WorkerBootSeconds = Manager->GetWorkerBootSeconds();
+    }
+    const FShapEDispatchLatencyStats Dispatch = Manager->GetDispatchLatencyStats();
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    const int32 Succeeded = State->Completed - State->Failures;
+    const double JobsPerSecond = RunSeconds > 0.0 ? Succeeded / RunSeconds : 0.0;
+
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: %d/%d jobs in %.2f s: %.2f jobs/s, %d failed%s"),
+        Succeeded, Jobs, RunSeconds, JobsPerSecond, State->Failures, bTimedOut ? TEXT(" (timed out)") : TEXT(""));
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: submit to complete p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms"),
+        GetPercentile(State->LatencySeconds, 0.5) * 1000.0, GetPercentile(State->LatencySeconds, 0.9) * 1000.0,
+        GetPercentile(State->LatencySeconds, 0.99) * 1000.0, GetPercentile(State->LatencySeconds, 1.0) * 1000.0);
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: event dispatch over %lld events mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms"),
+        Dispatch.Events, Dispatch.GetAverageSeconds() * 1000.0, Dispatch.GetPercentileSeconds(0.5) * 1000.0,
+        Dispatch.GetPercentileSeconds(0.99) * 1000.0, Dispatch.MaxSeconds * 1000.0);
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: worker launch to first message %.1f ms"), WorkerBootSeconds * 1000.0);
+    UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet: import %.2f ms per job, %d vertices; editor peak memory %.1f MiB"),
+        Succeeded > 0 ? State->TotalImportSeconds * 1000.0 / Succeeded : 0.0, State->NumVertices, MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+
+    // Mean per stage over the measured jobs still in the timing history (the newest ones, as it is bounded)
+    const TArray<FShapEJobTiming> Timings = Manager->GetTimingHistory();
+    TArray<FString> StageOrder;
+    TMap<FString, double> StageSeconds;
+    int32 TimedJobs = 0;
+    for (int32 Index = FMath::Max(0, Timings.Num() - State->Completed); Index < Timings.Num(); ++Index)
+    {
+        ++TimedJobs;
+        for (const FShapETimingSpan& Span : Timings[Index].Spans)
+        {
+            if (!StageSeconds.Contains(Span.Stage))
+            {
+                StageOrder.Add(Span.Stage);
+            }
+            StageSeconds.FindOrAdd(Span.Stage) += Span.GetDuration();
+        }
+    }
+
+    TSharedRef<FJsonObject> StageObject = MakeShared<FJsonObject>();
+    for (const FString& Stage : StageOrder)
+    {
+        const double MeanSeconds = StageSeconds[Stage] / FMath::Max(1, TimedJobs);
+        StageObject->SetNumberField(Stage, MeanSeconds * 1000.0);
+        UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet:   %-14s %9.2f ms per job"), *Stage, MeanSeconds * 1000.0);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> EndpointValues;
+    if (HttpBackend.IsValid())
+    {
+        for (const FShapEHttpBackend::FEndpointStats& Endpoint : HttpBackend->GetEndpointStats())
+        {
+            UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet:   %s: %d requests, %d failed, first byte %.1f ms, %.1f MiB downloaded"),
+                *Endpoint.BaseUrl, Endpoint.CompletedRequests, Endpoint.FailedRequests, Endpoint.FirstByteSeconds * 1000.0, Endpoint.DownloadedBytes / (1024.0 * 1024.0));
+
+            TSharedRef<FJsonObject> EndpointObject = MakeShared<FJsonObject>();
+            EndpointObject->SetStringField(TEXT("url"), Endpoint.BaseUrl);
+            EndpointObject->SetNumberField(TEXT("requests"), Endpoint.CompletedRequests);
+            EndpointObject->SetNumberField(TEXT("failed"), Endpoint.FailedRequests);
+            EndpointObject->SetNumberField(TEXT("first_byte_ms"), Endpoint.FirstByteSeconds * 1000.0);
+            EndpointObject->SetNumberField(TEXT("downloaded_bytes"), static_cast<double>(Endpoint.DownloadedBytes));
+            EndpointValues.Add(MakeShared<FJsonValueObject>(EndpointObject));
+        }
+    }
+
+    TArray<TSharedPtr<FJsonValue>> WorkerValues;
+    if (PoolBackend.IsValid())
+    {
+        for (const FShapEWorkerPoolBackend::FWorkerStats& Worker : PoolBackend->GetWorkerStats())
+        {
+            UE_LOG(LogTemp, Display, TEXT("ShapEBenchmarkCommandlet:   %s: %.0f%% busy, %d tasks, %d failed, %d stolen, %d restarts"),
+                *Worker.Label, Worker.Utilization * 100.0, Worker.CompletedTasks, Worker.FailedTasks, Worker.StolenTasks, Worker.Restarts);
+
+            TSharedRef<FJsonObject> WorkerObject = MakeShared<FJsonObject>();
+            WorkerObject->SetStringField(TEXT("label"), Worker.Label);
+            WorkerObject->SetNumberField(TEXT("utilization"), Worker.Utilization);
+            WorkerObject->SetNumberField(TEXT("busy_s"), Worker.BusySeconds);
+            WorkerObject->SetNumberField(TEXT("tasks"), Worker.CompletedTasks);
+            WorkerObject->SetNumberField(TEXT("failed"), Worker.FailedTasks);
+            WorkerObject->SetNumberField(TEXT("stolen"), Worker.StolenTasks);
+            WorkerObject->SetNumberField(TEXT("restarts"), Worker.Restarts);
+            WorkerValues.Add(MakeShared<FJsonValueObject>(WorkerObject));
+        }
+    }
+
+    if (!ReportPath.IsEmpty())
+    {
+        TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+        Report->SetNumberField(TEXT("jobs"), Jobs);
+        Report->SetNumberField(TEXT("concurrency"), Concurrency);
+        Report->SetNumberField(TEXT("steps"), KarrasSteps);
+        Report->SetNumberField(TEXT("segments"), Segments);
+        Report->SetStringField(TEXT("transport"), Transport);
+        Report->SetStringField(TEXT("backend"), Manager->GetBackend()->GetName());
+        Report->SetStringField(TEXT("protocol"), Protocol);
+        Report->SetNumberField(TEXT("workers"), PoolBackend.IsValid() ? NumWorkers : 1);
+        Report->SetNumberField(TEXT("succeeded"), Succeeded);
+        Report->SetNumberField(TEXT("failed"), State->Failures);
+        Report->SetBoolField(TEXT("timed_out"), bTimedOut);
+        Report->SetNumberField(TEXT("run_s"), RunSeconds);
+        Report->SetNumberField(TEXT("jobs_per_s"), JobsPerSecond);
+        Report->SetNumberField(TEXT("latency_p50_ms"), GetPercentile(State->LatencySeconds, 0.5) * 1000.0);
+        Report->SetNumberField(TEXT("latency_p90_ms"), GetPercentile(State->LatencySeconds, 0.9) * 1000.0);
+        Report->SetNumberField(TEXT("latency_p99_ms"), GetPercentile(State->LatencySeconds, 0.99) * 1000.0);
+        Report->SetNumberField(TEXT("latency_max_ms"), GetPercentile(State->LatencySeconds, 1.0) * 1000.0);
+        Report->SetNumberField(TEXT("dispatch_events"), static_cast<double>(Dispatch.Events));
+        Report->SetNumberField(TEXT("dispatch_mean_ms"), Dispatch.GetAverageSeconds() * 1000.0);
+        Report->SetNumberField(TEXT("dispatch_p99_ms"), Dispatch.GetPercentileSeconds(0.99) * 1000.0);
+        Report->SetNumberField(TEXT("dispatch_max_ms"), Dispatch.MaxSeconds * 1000.0);
+        Report->SetNumberField(TEXT("worker_boot_ms"), WorkerBootSeconds * 1000.0);
+        Report->SetNumberField(TEXT("import_ms"), Succeeded > 0 ? State->TotalImportSeconds * 1000.0 / Succeeded : 0.0);
+        Report->SetNumberField(TEXT("peak_memory_mib"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+        Report->SetObjectField(TEXT("stage_ms"), StageObject);
+        if (Cancels > 0)
+        {
+            Report->SetNumberField(TEXT("cancels"), CancelStats.Cancels);
+            Report->SetNumberField(TEXT("cancels_missed"), MissedCancels);
+            Report->SetNumberField(TEXT("cancel_to_ready_mean_ms"), CancelStats.GetAverageSeconds() * 1000.0);
+            Report->SetNumberField(TEXT("cancel_to_ready_max_ms"), CancelStats.MaxSeconds * 1000.0);
+            Report->SetNumberField(TEXT("worker_cancel_ms"), CancelStats.LastWorkerMilliseconds);
+        }
+        if (EndpointValues.Num() > 0)
+        {
+            Report->SetArrayField(TEXT("endpoints"), EndpointValues);
+        }
+        if (WorkerValues.Num() > 0)
+        {
+            Report->SetArrayField(TEXT("worker_stats"), WorkerValues);
+        }
+
+        if (!FFileHelper::SaveStringToFile(ShapEJson::ToCondensedString(Report), *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEBenchmarkCommandlet: Could not write report to %s"), *ReportPath);
+        }
+    }
+    if (!TimingsPath.IsEmpty())
+    {
+        Manager->ExportTimings(TimingsPath);
+    }
+
+    Manager->StopWorker();
+    return (State->Failures > 0 || bTimedOut) ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShapEBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless end-to-end benchmark of the generation pipeline against the synthetic worker (--synthetic, no GPU).
+ *
+ * UnrealEditor-Cmd <Project> -run=ShapEBenchmark [-jobs=50] [-concurrency=4] [-steps=16] [-segments=64]
+ *     [-load-ms=0] [-step-ms=0] [-decode-ms=0] [-log-lines=0] [-transport=file|shm] [-backend=process|direct|mock|http] [-noimport] [-warmup=1]
+ *     [-endpoints=<url>,<url>] [-connections=2] [-workers=1] [-devices=0,1] [-cores=0-7;8-15|split] [-tick-ms=1] [-timeout=600] [-script=<path to ue_shape_interface.py>]
+ *     [-cancels=0] [-cancel-timeout=<seconds>] [-protocol=binary|json] [-report=<json>] [-timings=<csv|json>]
+ *
+ * Keeps up to -concurrency jobs submitted to one FShapEProcessManager, pumping the game thread the way the
+ * editor would, and reports jobs per second, submit-to-complete latency percentiles, worker event dispatch
+ * latency, the time from launching the worker to its first message, the editor's peak memory and the mean
+ * time per stage. -backend=mock replaces the worker with the in-process FShapEMockBackend, -backend=direct
+ * spawns it without its launcher script (FShapEDirectLaunchBackend; compare worker_boot_ms with
+ * -backend=process), -backend=http sends the jobs to the -endpoints servers (pacing flags apply to the servers'
+ * own command line then). -workers=N runs N workers (processes, or mocks with -backend=mock) in an
+ * FShapEWorkerPoolBackend and reports each worker's utilization; compare jobs/s across worker counts at a
+ * -concurrency of at least N to see the pool scale. -cancels=N then cancels N jobs mid-sampling (pace them with
+ * -step-ms) and reports the time from each cancel to the worker being ready again; -cancel-timeout=0 sets
+ * ShapE.Cancel.Timeout so the worker is terminated instead, for comparison. -protocol=json keeps a direct worker
+ * on JSON lines instead of binary records (other backends always use them); raise -log-lines and lower -step-ms
+ * to compare the two under load. Returns 1 if a job failed or the run timed out.
+ */
+UCLASS()
+class UShapEBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UShapEBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
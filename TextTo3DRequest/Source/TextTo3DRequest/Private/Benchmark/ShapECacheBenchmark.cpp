@@ -0,0 +1,153 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Backend/FShapEMockBackend.h"
+#include "Manager/FShapEProcessManager.h"
+#include "Manager/FShapEResultCache.h"
+
+// Usage: ShapE.Bench.Cache [Entries]
+// Stores Entries fake results in a scratch cache under Saved/ShapEBenchmark/Cache and times key hashing, stores
+// and lookups, then checks that shrinking the budget deletes every mesh together with its latent. Then checks
+// that unseeded requests are never served from the cache: two identical unseeded generations through a manager
+// on the mock backend must both be generated.
+namespace ShapECacheBenchmark
+{
+    static FShapEGenerationParameters MakeParams(int32 Index, int32 Seed)
+    {
+        FShapEGenerationParameters Params;
+        Params.Prompt = FString::Printf(TEXT("cache benchmark chair %d"), Index);
+        Params.Seed = Seed;
+        return Params;
+    }
+
+    static void TimeCache(int32 Entries, const FString& Directory)
+    {
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+        IFileManager::Get().MakeDirectory(*Directory, true);
+        FShapEResultCache Cache(Directory);
+
+        TArray<FString> Keys;
+        Keys.Reserve(Entries);
+        const double KeyStartTime = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < Entries; ++Index)
+        {
+            Keys.Add(FShapEResultCache::MakeKey(MakeParams(Index, Index)));
+        }
+        const double KeySeconds = FPlatformTime::Seconds() - KeyStartTime;
+
+        double StoreSeconds = 0.0;
+        for (int32 Index = 0; Index < Entries; ++Index)
+        {
+            // what the worker would have written under the key
+            const FString PlyPath = FPaths::Combine(Directory, Keys[Index] + TEXT(".ply"));
+            const FString LatentPath = FPaths::Combine(Directory, Keys[Index] + TEXT(".latent.npy"));
+            FFileHelper::SaveStringToFile(TEXT("ply\nformat ascii 1.0\nend_header\n"), *PlyPath);
+            FFileHelper::SaveStringToFile(TEXT("latent"), *LatentPath);
+            const double StoreStartTime = FPlatformTime::Seconds();
+            Cache.Store(Keys[Index], MakeParams(Index, Index).Prompt, PlyPath, FString(), LatentPath);
+            StoreSeconds += FPlatformTime::Seconds() - StoreStartTime;
+        }
+
+        int32 Hits = 0;
+        const double LookupStartTime = FPlatformTime::Seconds();
+        for (const FString& Key : Keys)
+        {
+            FString PlyPath, ObjPath;
+            Hits += Cache.Lookup(Key, PlyPath, ObjPath) ? 1 : 0;
+        }
+        const double LookupSeconds = FPlatformTime::Seconds() - LookupStartTime;
+
+        UE_LOG(LogTemp, Display, TEXT("ShapECacheBenchmark: %d entries: key %.2f us, store %.2f ms, lookup %.2f ms each, %d/%d hits"),
+            Entries, KeySeconds * 1e6 / Entries, StoreSeconds * 1000.0 / Entries, LookupSeconds * 1000.0 / Entries, Hits, Entries);
+        if (Hits != Entries)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapECacheBenchmark: %d stored entries were not found"), Entries - Hits);
+        }
+
+        // a zero budget evicts everything; no mesh or latent may stay behind
+        Cache.SetMaxBytes(0);
+        TArray<FString> LeftOverMeshes, LeftOverLatents;
+        IFileManager::Get().FindFiles(LeftOverMeshes, *FPaths::Combine(Directory, TEXT("*.ply")), true, false);
+        IFileManager::Get().FindFiles(LeftOverLatents, *FPaths::Combine(Directory, TEXT("*.latent.npy")), true, false);
+        if (LeftOverMeshes.Num() > 0 || LeftOverLatents.Num() > 0 || Cache.GetStats().TotalBytes != 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapECacheBenchmark: eviction left %d meshes, %d latents and %lld bytes accounted"),
+                LeftOverMeshes.Num(), LeftOverLatents.Num(), Cache.GetStats().TotalBytes);
+        }
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    }
+
+    static void CheckUnseededBypass(const FString& OutputDirectory)
+    {
+        if (FShapEResultCache::IsCacheable(MakeParams(0, -1)) || !FShapEResultCache::IsCacheable(MakeParams(0, 7)))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapECacheBenchmark: only seeded requests should be cacheable"));
+        }
+
+        // outlives the manager, whose delegates count into it
+        int32 Finished = 0;
+        FShapEMockBackendSettings Settings;
+        Settings.Segments = 8;
+        TSharedRef<FShapEMockBackend, ESPMode::ThreadSafe> Mock = MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(Settings);
+        FShapEProcessManager Manager(Mock);
+        const int32 StoresBefore = Manager.GetCacheStats().Stores;
+
+        int32 FromCache = 0;
+        TArray<FString> JobIds;
+        for (int32 Run = 0; Run < 2; ++Run)
+        {
+            FShapEGenerationParameters Params = MakeParams(0, -1);
+            Params.OutputDirectory = OutputDirectory;
+            Params.bUseCache = true;
+
+            TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+            Delegates->OnGenerationComplete.AddLambda([&Finished](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage) { ++Finished; });
+            Delegates->OnErrorReceived.AddLambda([&Finished](const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage) { ++Finished; });
+            JobIds.Add(Manager.EnqueueGeneration(TEXT("mock"), Params, EShapEJobPriority::Interactive, Delegates));
+
+            // the second request is only made once the first one could have been stored
+            const double Deadline = FPlatformTime::Seconds() + 10.0;
+            while (Finished <= Run && FPlatformTime::Seconds() < Deadline)
+            {
+                Mock->Tick();
+                Manager.PumpEvents();
+                FPlatformProcess::Sleep(0.001f);
+            }
+        }
+
+        for (const FString& JobId : JobIds)
+        {
+            FShapEJobTiming Timing;
+            FromCache += Manager.GetJobTiming(JobId, Timing) && Timing.bFromCache ? 1 : 0;
+        }
+        const int32 Stored = Manager.GetCacheStats().Stores - StoresBefore;
+        Manager.StopWorker();
+
+        if (Finished != 2 || Mock->GetSubmittedJobs() != 2 || FromCache > 0 || Stored > 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapECacheBenchmark: unseeded requests: %d of 2 finished, %d generated, %d served from and %d stored in the cache"),
+                Finished, Mock->GetSubmittedJobs(), FromCache, Stored);
+            return;
+        }
+        UE_LOG(LogTemp, Display, TEXT("ShapECacheBenchmark: unseeded requests bypass the cache"));
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Entries = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 100000) : 1000;
+        const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEBenchmark"), TEXT("Cache"));
+
+        TimeCache(Entries, Directory);
+        CheckUnseededBypass(FPaths::Combine(Directory, TEXT("Unseeded")));
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    }
+
+    static FAutoConsoleCommand BenchCacheCommand(
+        TEXT("ShapE.Bench.Cache"),
+        TEXT("Times result cache stores and lookups and checks eviction and that unseeded requests bypass the cache. Args: [Entries]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
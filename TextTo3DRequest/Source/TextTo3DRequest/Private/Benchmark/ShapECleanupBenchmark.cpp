@@ -0,0 +1,97 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Processing/FShapEMeshCleanup.h"
+
+// Usage: ShapE.Bench.Cleanup [Segments] [Iterations]
+// Builds a sphere the way marching cubes output arrives (every triangle with its own three vertices,
+// plus collapsed triangles at the poles) and runs the cleanup stage single-threaded and in parallel.
+namespace ShapECleanupBenchmark
+{
+    static void BuildTriangleSoup(int32 Segments, FMeshDescription& OutMesh)
+    {
+        FStaticMeshAttributes Attributes(OutMesh);
+        Attributes.Register();
+        TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+        TVertexInstanceAttributesRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+        const FPolygonGroupID PolygonGroup = OutMesh.CreatePolygonGroup();
+        Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = TEXT("ShapE_Material");
+
+        const int32 Rings = Segments;
+        const int32 NumTriangles = Rings * Segments * 2;
+        OutMesh.ReserveNewVertices(NumTriangles * 3);
+        OutMesh.ReserveNewVertexInstances(NumTriangles * 3);
+        OutMesh.ReserveNewTriangles(NumTriangles);
+        OutMesh.ReserveNewPolygons(NumTriangles);
+
+        auto PointAt = [Rings, Segments](int32 Ring, int32 Segment)
+        {
+            const float Theta = PI * Ring / Rings;
+            const float Phi = 2.0f * PI * (Segment % Segments) / Segments;
+            return FVector3f(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta)) * 100.0f;
+        };
+
+        auto AddTriangle = [&](const FVector3f& A, const FVector3f& B, const FVector3f& C)
+        {
+            FVertexInstanceID Corners[3];
+            const FVector3f Points[3] = { A, B, C };
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const FVertexID VertexID = OutMesh.CreateVertex();
+                Positions[VertexID] = Points[Corner];
+                Corners[Corner] = OutMesh.CreateVertexInstance(VertexID);
+                Colors[Corners[Corner]] = FVector4f(Points[Corner].Z * 0.005f + 0.5f, 0.5f, 0.5f, 1.0f);
+            }
+            OutMesh.CreateTriangle(PolygonGroup, MakeArrayView(Corners, 3));
+        };
+
+        for (int32 Ring = 0; Ring < Rings; ++Ring)
+        {
+            for (int32 Segment = 0; Segment < Segments; ++Segment)
+            {
+                AddTriangle(PointAt(Ring, Segment), PointAt(Ring, Segment + 1), PointAt(Ring + 1, Segment));
+                AddTriangle(PointAt(Ring, Segment + 1), PointAt(Ring + 1, Segment + 1), PointAt(Ring + 1, Segment));
+            }
+        }
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Segments = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 8, 2048) : 256;
+        const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 5;
+
+        FMeshDescription Source;
+        BuildTriangleSoup(Segments, Source);
+
+        for (const bool bParallel : { false, true })
+        {
+            FShapEMeshCleanupOptions Options;
+            Options.bParallel = bParallel;
+
+            FShapEMeshCleanupStats Best;
+            Best.TotalSeconds = TNumericLimits<double>::Max();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                FMeshDescription Mesh = Source;
+                FShapEMeshCleanupStats Stats;
+                FShapEMeshCleanup::Run(Mesh, Options, &Stats);
+                if (Stats.TotalSeconds < Best.TotalSeconds)
+                {
+                    Best = Stats;
+                }
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("ShapECleanupBenchmark: %s best of %d: %d -> %d vertices, %d -> %d triangles (%d degenerate, %d duplicate)"),
+                bParallel ? TEXT("parallel") : TEXT("single-threaded"), Iterations, Best.VerticesBefore, Best.VerticesAfter, Best.TrianglesBefore, Best.TrianglesAfter, Best.DegenerateTriangles, Best.DuplicateTriangles);
+            UE_LOG(LogTemp, Display, TEXT("ShapECleanupBenchmark:   total %.1f ms (weld %.1f, filter %.1f, normals/tangents %.1f)"),
+                Best.TotalSeconds * 1000.0, Best.WeldSeconds * 1000.0, Best.FilterSeconds * 1000.0, Best.NormalSeconds * 1000.0);
+        }
+    }
+
+    static FAutoConsoleCommand BenchCleanupCommand(
+        TEXT("ShapE.Bench.Cleanup"),
+        TEXT("Times the mesh cleanup stage on an unwelded sphere, single-threaded and in parallel. Args: [Segments] [Iterations]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
@@ -0,0 +1,147 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Processing/FShapEMeshDecimator.h"
+
+// Usage: ShapE.Bench.LOD [Segments] [Iterations]
+// Builds a welded, vertex-colored sphere (Segments rings of Segments quads) and decimates it to a quarter,
+// a sixteenth and a sixty-fourth of its triangles, once with the LODs one after another and once in parallel.
+// Every LOD's actual face count is checked against its budget, on the sphere and on a flat grid.
+namespace ShapELODBenchmark
+{
+    static void BuildSphere(int32 Segments, FShapEMeshSoA& OutMesh)
+    {
+        const int32 Rings = Segments;
+        for (int32 Ring = 0; Ring <= Rings; ++Ring)
+        {
+            for (int32 Segment = 0; Segment < Segments; ++Segment)
+            {
+                const float Theta = PI * Ring / Rings;
+                const float Phi = 2.0f * PI * Segment / Segments;
+                OutMesh.PositionX.Add(FMath::Sin(Theta) * FMath::Cos(Phi) * 100.0f);
+                OutMesh.PositionY.Add(FMath::Sin(Theta) * FMath::Sin(Phi) * 100.0f);
+                OutMesh.PositionZ.Add(FMath::Cos(Theta) * 100.0f);
+                // hard color bands, which the decimator should keep
+                const bool bBand = (Ring * 8 / Rings) % 2 == 0;
+                OutMesh.ColorR.Add(bBand ? 0.9f : 0.1f);
+                OutMesh.ColorG.Add(0.5f);
+                OutMesh.ColorB.Add(bBand ? 0.1f : 0.9f);
+                OutMesh.ColorA.Add(1.0f);
+            }
+        }
+
+        auto VertexAt = [Segments](int32 Ring, int32 Segment) { return Ring * Segments + Segment % Segments; };
+        for (int32 Ring = 0; Ring < Rings; ++Ring)
+        {
+            for (int32 Segment = 0; Segment < Segments; ++Segment)
+            {
+                OutMesh.Indices.Append({ VertexAt(Ring, Segment), VertexAt(Ring, Segment + 1), VertexAt(Ring + 1, Segment) });
+                OutMesh.Indices.Append({ VertexAt(Ring, Segment + 1), VertexAt(Ring + 1, Segment + 1), VertexAt(Ring + 1, Segment) });
+            }
+        }
+    }
+
+    static void BuildGrid(int32 Cells, FShapEMeshSoA& OutMesh)
+    {
+        for (int32 Row = 0; Row <= Cells; ++Row)
+        {
+            for (int32 Column = 0; Column <= Cells; ++Column)
+            {
+                OutMesh.PositionX.Add(Column * 10.0f);
+                OutMesh.PositionY.Add(Row * 10.0f);
+                OutMesh.PositionZ.Add(0.0f);
+            }
+        }
+
+        auto VertexAt = [Cells](int32 Row, int32 Column) { return Row * (Cells + 1) + Column; };
+        for (int32 Row = 0; Row < Cells; ++Row)
+        {
+            for (int32 Column = 0; Column < Cells; ++Column)
+            {
+                OutMesh.Indices.Append({ VertexAt(Row, Column), VertexAt(Row, Column + 1), VertexAt(Row + 1, Column) });
+                OutMesh.Indices.Append({ VertexAt(Row, Column + 1), VertexAt(Row + 1, Column + 1), VertexAt(Row + 1, Column) });
+            }
+        }
+    }
+
+    // Counts the faces the LODs really hold, not what the decimator reports; false if one is over its budget
+    static bool CheckBudgets(const TCHAR* MeshName, const TArray<FShapEMeshSoA>& LODs, TConstArrayView<int32> Budgets)
+    {
+        bool bWithinBudgets = LODs.Num() == Budgets.Num();
+        for (int32 LODIndex = 0; LODIndex < LODs.Num() && LODIndex < Budgets.Num(); ++LODIndex)
+        {
+            const FShapEMeshSoA& LOD = LODs[LODIndex];
+            int32 LiveTriangles = 0;
+            for (int32 Triangle = 0; Triangle < LOD.NumTriangles(); ++Triangle)
+            {
+                const int32 A = LOD.Indices[Triangle * 3], B = LOD.Indices[Triangle * 3 + 1], C = LOD.Indices[Triangle * 3 + 2];
+                LiveTriangles += (A != B && B != C && A != C) ? 1 : 0;
+            }
+            if (LiveTriangles > Budgets[LODIndex] || LiveTriangles != LOD.NumTriangles())
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapELODBenchmark: %s LOD %d holds %d faces (%d non-degenerate) for a budget of %d"),
+                    MeshName, LODIndex, LOD.NumTriangles(), LiveTriangles, Budgets[LODIndex]);
+                bWithinBudgets = false;
+            }
+        }
+        return bWithinBudgets;
+    }
+
+    static void CheckGrid()
+    {
+        FShapEMeshSoA Grid;
+        BuildGrid(40, Grid);
+        const TArray<int32> Budgets = { 800, 400, 100 };
+        TArray<FShapEMeshSoA> LODs;
+        FShapEMeshDecimator::BuildLODChain(Grid, Budgets, FShapEMeshDecimationOptions(), LODs);
+        if (CheckBudgets(TEXT("grid"), LODs, Budgets))
+        {
+            UE_LOG(LogTemp, Display, TEXT("ShapELODBenchmark: grid %d -> %s triangles, within budget"), Grid.NumTriangles(),
+                *FString::JoinBy(LODs, TEXT(" / "), [](const FShapEMeshSoA& LOD) { return FString::FromInt(LOD.NumTriangles()); }));
+        }
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Segments = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 8, 1024) : 256;
+        const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 3;
+
+        FShapEMeshSoA Source;
+        BuildSphere(Segments, Source);
+        const int32 Triangles = Source.NumTriangles();
+        const TArray<int32> Budgets = { Triangles / 4, Triangles / 16, Triangles / 64 };
+
+        for (const bool bParallel : { false, true })
+        {
+            FShapEMeshDecimationOptions Options;
+            Options.bParallel = bParallel;
+
+            FShapEMeshDecimationStats Best;
+            Best.TotalSeconds = TNumericLimits<double>::Max();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                TArray<FShapEMeshSoA> LODs;
+                FShapEMeshDecimationStats Stats;
+                FShapEMeshDecimator::BuildLODChain(Source, Budgets, Options, LODs, &Stats);
+                if (Iteration == 0)
+                {
+                    CheckBudgets(TEXT("sphere"), LODs, Budgets);
+                }
+                if (Stats.TotalSeconds < Best.TotalSeconds)
+                {
+                    Best = Stats;
+                }
+            }
+
+            const FString Counts = FString::JoinBy(Best.LODTriangles, TEXT(" / "), [](int32 Count) { return FString::FromInt(Count); });
+            UE_LOG(LogTemp, Display, TEXT("ShapELODBenchmark: %s best of %d: %d -> %s triangles in %.1f ms (prepare %.1f ms)"),
+                bParallel ? TEXT("parallel") : TEXT("single-threaded"), Iterations, Best.TrianglesBefore, *Counts, Best.TotalSeconds * 1000.0, Best.PrepareSeconds * 1000.0);
+        }
+        CheckGrid();
+    }
+
+    static FAutoConsoleCommand BenchLODCommand(
+        TEXT("ShapE.Bench.LOD"),
+        TEXT("Times building a three-LOD chain from a colored sphere, single-threaded and in parallel. Args: [Segments] [Iterations]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
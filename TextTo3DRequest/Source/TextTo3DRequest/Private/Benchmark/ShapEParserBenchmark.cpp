@@ -0,0 +1,94 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Interfaces/IPluginManager.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+#include "Manager/FShapELineFramer.h"
+#include "Manager/FShapEOutputParser.h"
+
+// Usage: ShapE.Bench.Parser [Iterations] [CaptureFile]
+// Replays a captured worker stdout stream through the framer and line parser and reports lines per second.
+// The DOM-based path the reader used before is measured alongside for comparison.
+namespace ShapEParserBenchmark
+{
+    static FString GetDefaultCapturePath()
+    {
+        TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("TextTo3DRequest"));
+        return Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("Benchmark"), TEXT("worker_output_sample.txt")) : FString();
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 2000;
+        const FString CapturePath = Args.Num() > 1 ? Args[1] : GetDefaultCapturePath();
+
+        TArray<uint8> Capture;
+        if (CapturePath.IsEmpty() || !FFileHelper::LoadFileToArray(Capture, *CapturePath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEParserBenchmark: Could not load capture file '%s'."), *CapturePath);
+            return;
+        }
+
+        FShapELineFramer Framer;
+        FShapEParsedLine Parsed;
+        int64 LineCount = 0;
+        int64 JsonCount = 0;
+        int64 TqdmCount = 0;
+
+        auto ParseRecord = [&](const UTF8CHAR* Data, int32 Length)
+        {
+            FShapEOutputParser::Parse(FUtf8StringView(Data, Length), Parsed);
+            ++LineCount;
+            JsonCount += Parsed.Kind == EShapELineKind::Json;
+            TqdmCount += Parsed.Kind == EShapELineKind::Tqdm;
+        };
+
+        const double FastStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Framer.Append(Capture.GetData(), Capture.Num(), ParseRecord);
+            Framer.Flush(ParseRecord);
+        }
+        const double FastSeconds = FPlatformTime::Seconds() - FastStart;
+
+        int64 DomLineCount = 0;
+        auto DomRecord = [&](const UTF8CHAR* Data, int32 Length)
+        {
+            const FString Line(Length, Data);
+            TSharedPtr<FJsonObject> JsonObject;
+            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+            if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+            {
+                // the old tqdm path trimmed and searched the line as an FString
+                const FString Cleaned = Line.Replace(TEXT("\r"), TEXT("")).TrimStartAndEnd();
+                int32 PercentIndex;
+                Cleaned.FindChar(TEXT('%'), PercentIndex);
+            }
+            ++DomLineCount;
+        };
+
+        const double DomStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Framer.Append(Capture.GetData(), Capture.Num(), DomRecord);
+            Framer.Flush(DomRecord);
+        }
+        const double DomSeconds = FPlatformTime::Seconds() - DomStart;
+
+        const double FastRate = LineCount / FMath::Max(FastSeconds, UE_DOUBLE_SMALL_NUMBER);
+        const double DomRate = DomLineCount / FMath::Max(DomSeconds, UE_DOUBLE_SMALL_NUMBER);
+        UE_LOG(LogTemp, Display, TEXT("ShapEParserBenchmark: %s, %d bytes x %d iterations"), *CapturePath, Capture.Num(), Iterations);
+        UE_LOG(LogTemp, Display, TEXT("ShapEParserBenchmark: byte parser  %lld lines (%lld json, %lld tqdm) in %.3f s = %.0f lines/s"),
+            LineCount, JsonCount, TqdmCount, FastSeconds, FastRate);
+        UE_LOG(LogTemp, Display, TEXT("ShapEParserBenchmark: json dom     %lld lines in %.3f s = %.0f lines/s (%.1fx slower)"),
+            DomLineCount, DomSeconds, DomRate, FastRate / FMath::Max(DomRate, UE_DOUBLE_SMALL_NUMBER));
+    }
+
+    static FAutoConsoleCommand BenchParserCommand(
+        TEXT("ShapE.Bench.Parser"),
+        TEXT("Replays a captured Shap-E worker output file through the line parser and reports lines per second. Args: [Iterations] [CaptureFile]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
@@ -0,0 +1,143 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+
+#if WITH_EDITOR
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "MeshDescription.h"
+#include "AssetToolsModule.h"
+#include "AssetImportTask.h"
+#include "Import/FShapEPlyImporter.h"
+
+// Usage: ShapE.Bench.PlyImport [Segments] [Iterations]
+// Writes a vertex-colored sphere with Segments x Segments quads (default 512, ~260k vertices) as a
+// Shap-E style binary PLY and as OBJ, then times the native importer against the stock OBJ import.
+// Both paths create a static mesh under /Game/ShapE_Benchmark.
+namespace ShapEPlyImportBenchmark
+{
+    static void WriteSphere(int32 Segments, const FString& PlyPath, const FString& ObjPath)
+    {
+        const int32 Rings = Segments;
+        const int32 NumVertices = (Rings + 1) * Segments;
+        const int32 NumFaces = Rings * Segments * 2;
+
+        TArray<uint8> Ply;
+        const FString Header = FString::Printf(TEXT("ply\nformat binary_little_endian 1.0\nelement vertex %d\nproperty float x\nproperty float y\nproperty float z\n")
+            TEXT("property uchar red\nproperty uchar green\nproperty uchar blue\nelement face %d\nproperty list uchar int vertex_index\nend_header\n"), NumVertices, NumFaces);
+        Ply.Append(reinterpret_cast<const uint8*>(TCHAR_TO_ANSI(*Header)), Header.Len());
+        Ply.Reserve(Ply.Num() + NumVertices * 15 + NumFaces * 13);
+
+        FString Obj;
+        Obj.Reserve(NumVertices * 48 + NumFaces * 24);
+
+        for (int32 Ring = 0; Ring <= Rings; ++Ring)
+        {
+            const float Theta = PI * Ring / Rings;
+            for (int32 Segment = 0; Segment < Segments; ++Segment)
+            {
+                const float Phi = 2.0f * PI * Segment / Segments;
+                const float Position[3] = { FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta) };
+                const uint8 Color[3] = { (uint8)(255.0f * Ring / Rings), (uint8)(255.0f * Segment / Segments), 128 };
+                Ply.Append(reinterpret_cast<const uint8*>(Position), sizeof(Position));
+                Ply.Append(Color, 3);
+                Obj += FString::Printf(TEXT("v %.6f %.6f %.6f %.4f %.4f %.4f\n"), Position[0], Position[1], Position[2], Color[0] / 255.0f, Color[1] / 255.0f, Color[2] / 255.0f);
+            }
+        }
+
+        auto AddTriangle = [&Ply, &Obj](int32 A, int32 B, int32 C)
+        {
+            const uint8 Count = 3;
+            const int32 Indices[3] = { A, B, C };
+            Ply.Add(Count);
+            Ply.Append(reinterpret_cast<const uint8*>(Indices), sizeof(Indices));
+            Obj += FString::Printf(TEXT("f %d %d %d\n"), A + 1, B + 1, C + 1);
+        };
+
+        for (int32 Ring = 0; Ring < Rings; ++Ring)
+        {
+            for (int32 Segment = 0; Segment < Segments; ++Segment)
+            {
+                const int32 Next = (Segment + 1) % Segments;
+                const int32 A = Ring * Segments + Segment;
+                const int32 B = Ring * Segments + Next;
+                const int32 C = (Ring + 1) * Segments + Segment;
+                const int32 D = (Ring + 1) * Segments + Next;
+                // the pole rows collapse; the importer drops those degenerate faces like real output would
+                AddTriangle(A, C, B);
+                AddTriangle(B, C, D);
+            }
+        }
+
+        FFileHelper::SaveArrayToFile(Ply, *PlyPath);
+        FFileHelper::SaveStringToFile(Obj, *ObjPath, FFileHelper::EEncodingOptions::ForceAnsi);
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Segments = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 8, 4096) : 512;
+        const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 5;
+
+        const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEBenchmark"));
+        IFileManager::Get().MakeDirectory(*Directory, true);
+        const FString PlyPath = FPaths::Combine(Directory, FString::Printf(TEXT("sphere_%d.ply"), Segments));
+        const FString ObjPath = FPaths::Combine(Directory, FString::Printf(TEXT("sphere_%d.obj"), Segments));
+        if (!FPaths::FileExists(PlyPath) || !FPaths::FileExists(ObjPath))
+        {
+            WriteSphere(Segments, PlyPath, ObjPath);
+        }
+
+        // parse only, repeated for a stable number
+        FShapEPlyImportStats Stats;
+        double BestParseSeconds = TNumericLimits<double>::Max();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            FMeshDescription MeshDescription;
+            FString Error;
+            if (!FShapEPlyImporter::ImportMeshDescription(PlyPath, MeshDescription, FShapEPlyImportOptions(), Error, &Stats))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapEPlyImportBenchmark: %s"), *Error);
+                return;
+            }
+            BestParseSeconds = FMath::Min(BestParseSeconds, Stats.ParseSeconds);
+        }
+
+        const FString PackagePath = TEXT("/Game/ShapE_Benchmark");
+
+        FString Error;
+        const double NativeStart = FPlatformTime::Seconds();
+        UStaticMesh* NativeMesh = FShapEPlyImporter::CreateStaticMesh(PlyPath, PackagePath, FString::Printf(TEXT("SM_Native_%d"), Segments), FShapEPlyImportOptions(), Error);
+        const double NativeSeconds = FPlatformTime::Seconds() - NativeStart;
+        if (!NativeMesh)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEPlyImportBenchmark: %s"), *Error);
+            return;
+        }
+
+        UAssetImportTask* ImportTask = NewObject<UAssetImportTask>();
+        ImportTask->Filename = ObjPath;
+        ImportTask->DestinationPath = PackagePath;
+        ImportTask->DestinationName = FString::Printf(TEXT("SM_Obj_%d"), Segments);
+        ImportTask->bAutomated = true;
+        ImportTask->bReplaceExisting = true;
+        ImportTask->bSave = false;
+
+        IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+        const double ObjStart = FPlatformTime::Seconds();
+        AssetTools.ImportAssetTasks({ ImportTask });
+        const double ObjSeconds = FPlatformTime::Seconds() - ObjStart;
+
+        UE_LOG(LogTemp, Display, TEXT("ShapEPlyImportBenchmark: %d vertices, %d triangles (%lld KB PLY, %lld KB OBJ)"),
+            Stats.NumVertices, Stats.NumTriangles, IFileManager::Get().FileSize(*PlyPath) / 1024, IFileManager::Get().FileSize(*ObjPath) / 1024);
+        UE_LOG(LogTemp, Display, TEXT("ShapEPlyImportBenchmark: native PLY -> FMeshDescription  best of %d: %.1f ms"), Iterations, BestParseSeconds * 1000.0);
+        UE_LOG(LogTemp, Display, TEXT("ShapEPlyImportBenchmark: native PLY -> UStaticMesh         %.1f ms"), NativeSeconds * 1000.0);
+        UE_LOG(LogTemp, Display, TEXT("ShapEPlyImportBenchmark: stock OBJ import -> UStaticMesh   %.1f ms (%d objects imported)"), ObjSeconds * 1000.0, ImportTask->GetObjects().Num());
+    }
+
+    static FAutoConsoleCommand BenchPlyImportCommand(
+        TEXT("ShapE.Bench.PlyImport"),
+        TEXT("Times the native PLY importer against the stock OBJ import on a generated sphere. Args: [Segments] [Iterations]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
+#endif
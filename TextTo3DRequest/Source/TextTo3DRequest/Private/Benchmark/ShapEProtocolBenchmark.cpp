@@ -0,0 +1,370 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Base64.h"
+#include "Manager/FShapELineFramer.h"
+#include "Manager/FShapEOutputParser.h"
+#include "Backend/FShapEWorkerLineDecoder.h"
+#include "Backend/FShapEWorkerRecordDecoder.h"
+
+// Usage: ShapE.Bench.Protocol [Iterations] [Seed] [FuzzCases]
+// Builds the same synthetic worker session (status, stages, one progress update per step, previews, a shared-memory
+// result) as binary records and as JSON lines with a tqdm bar, and reports how fast each decodes into worker
+// events. Then checks that records split at random points decode to the same events, and fuzzes the record
+// decoder with corrupted streams fed in random chunks: it must fail or carry on cleanly, never read out of bounds
+// (run it under ASan for that) or produce events that break the invariants below.
+namespace ShapEProtocolBenchmark
+{
+    using namespace ShapEWorkerRecords;
+
+    constexpr int32 JobsPerSession = 8;
+    constexpr int32 StepsPerJob = 64;
+    constexpr int32 PreviewEvery = 16;
+    constexpr int32 PreviewSize = 64;
+    // what the reader thread gets from one pipe read at most
+    constexpr int32 ReadChunkSize = 64 * 1024;
+
+    struct FSession
+    {
+        TArray<uint8> Records;
+        TArray<uint8> Lines;
+    };
+
+    static void AppendLine(TArray<uint8>& Lines, const FString& Line)
+    {
+        FTCHARToUTF8 Utf8Line(*Line);
+        Lines.Append(reinterpret_cast<const uint8*>(Utf8Line.Get()), Utf8Line.Length());
+        Lines.Add('\n');
+    }
+
+    static void BuildSession(FRandomStream& Random, FSession& OutSession)
+    {
+        FWriter Writer(OutSession.Records);
+        TArray<uint8>& Lines = OutSession.Lines;
+
+        Writer.WriteHello(ProtocolVersion);
+        Writer.BeginRecord(ERecordType::Ready);
+        Writer.WriteString(FString());
+        Writer.EndRecord();
+        AppendLine(Lines, TEXT("{\"type\":\"ready\"}"));
+
+        TArray<uint8> Pixels;
+        Pixels.SetNumUninitialized(PreviewSize * PreviewSize * 3);
+        double WorkerTime = 1000.0;
+
+        for (int32 Job = 0; Job < JobsPerSession; ++Job)
+        {
+            const FString JobId = FString::Printf(TEXT("job-%d"), Job);
+
+            Writer.BeginRecord(ERecordType::Status);
+            Writer.WriteString(JobId);
+            Writer.WriteString(TEXT("Sampling latents"));
+            Writer.EndRecord();
+            AppendLine(Lines, FString::Printf(TEXT("{\"type\":\"status\",\"job_id\":\"%s\",\"message\":\"Sampling latents\"}"), *JobId));
+
+            auto WriteStage = [&](const TCHAR* Phase)
+            {
+                Writer.BeginRecord(ERecordType::Stage);
+                Writer.WriteString(JobId);
+                Writer.WriteString(TEXT("sample"));
+                Writer.WriteString(Phase);
+                Writer.WriteF64(WorkerTime);
+                Writer.WriteU32(StepsPerJob);
+                Writer.WriteU32(1);
+                Writer.EndRecord();
+                AppendLine(Lines, FString::Printf(TEXT("{\"type\":\"stage\",\"job_id\":\"%s\",\"stage\":\"sample\",\"phase\":\"%s\",\"t\":%.6f,\"steps\":%d,\"batch\":1}"),
+                    *JobId, Phase, WorkerTime, StepsPerJob));
+            };
+
+            WriteStage(TEXT("begin"));
+            for (int32 Step = 1; Step <= StepsPerJob; ++Step)
+            {
+                const float Rate = 20.f + Random.FRand() * 10.f;
+                Writer.BeginRecord(ERecordType::Progress);
+                Writer.WriteString(JobId);
+                Writer.WriteU32(Step);
+                Writer.WriteU32(StepsPerJob);
+                Writer.WriteF32(Rate);
+                Writer.EndRecord();
+                const int32 Percent = Step * 100 / StepsPerJob;
+                const int32 Filled = Percent / 10;
+                AppendLine(Lines, FString::Printf(TEXT("%3d%%|%s%s| %d/%d [00:01<00:01, %.2fit/s]"),
+                    Percent, *FString::ChrN(Filled, TCHAR('#')), *FString::ChrN(10 - Filled, TCHAR(' ')), Step, StepsPerJob, Rate));
+
+                if (Step % PreviewEvery == 0)
+                {
+                    for (uint8& Byte : Pixels)
+                    {
+                        Byte = static_cast<uint8>(Random.RandHelper(256));
+                    }
+                    Writer.BeginRecord(ERecordType::Preview);
+                    Writer.WriteString(JobId);
+                    Writer.WriteU32(Step);
+                    Writer.WriteU32(StepsPerJob);
+                    Writer.WriteU32(PreviewSize);
+                    Writer.WriteU32(PreviewSize);
+                    Writer.WriteF64(1.5);
+                    Writer.WriteBytes(Pixels.GetData(), Pixels.Num());
+                    Writer.EndRecord();
+                    AppendLine(Lines, FString::Printf(TEXT("{\"type\":\"preview\",\"job_id\":\"%s\",\"step\":%d,\"total_steps\":%d,\"width\":%d,\"height\":%d,\"render_ms\":1.5,\"format\":\"rgb8\",\"data\":\"%s\"}"),
+                        *JobId, Step, StepsPerJob, PreviewSize, PreviewSize, *FBase64::Encode(Pixels)));
+                }
+            }
+            WorkerTime += 2.0;
+            WriteStage(TEXT("end"));
+
+            const FString SegmentName = FString::Printf(TEXT("/shape_mesh_%d"), Job);
+            const int32 NumVertices = 20000 + Job;
+            const int32 NumTriangles = 40000 + Job;
+            Writer.BeginRecord(ERecordType::Complete);
+            Writer.WriteString(JobId);
+            Writer.WriteString(TEXT("Generation complete"));
+            Writer.WriteString(FString());
+            Writer.WriteString(FString());
+            Writer.WriteString(FString());
+            Writer.WriteString(SegmentName);
+            Writer.WriteI64(NumVertices * 15 + NumTriangles * 12);
+            Writer.WriteI64(0);
+            Writer.WriteI64(NumVertices * 12);
+            Writer.WriteI64(NumVertices * 15);
+            Writer.WriteU32(NumVertices);
+            Writer.WriteU32(NumTriangles);
+            Writer.EndRecord();
+            AppendLine(Lines, FString::Printf(TEXT("{\"type\":\"complete\",\"job_id\":\"%s\",\"message\":\"Generation complete\",\"shm_name\":\"%s\",\"shm_size\":%d,")
+                TEXT("\"positions_offset\":0,\"colors_offset\":%d,\"indices_offset\":%d,\"vertex_count\":%d,\"face_count\":%d}"),
+                *JobId, *SegmentName, NumVertices * 15 + NumTriangles * 12, NumVertices * 12, NumVertices * 15, NumVertices, NumTriangles));
+        }
+    }
+
+    static uint32 HashEvent(const FShapEWorkerEvent& Event)
+    {
+        uint32 Hash = HashCombine(GetTypeHash(static_cast<uint8>(Event.Type)), GetTypeHash(Event.JobId));
+        Hash = HashCombine(Hash, GetTypeHash(Event.Message));
+        Hash = HashCombine(Hash, GetTypeHash(Event.Step));
+        Hash = HashCombine(Hash, GetTypeHash(Event.TotalSteps));
+        Hash = HashCombine(Hash, GetTypeHash(Event.SharedMesh.SegmentName));
+        Hash = HashCombine(Hash, GetTypeHash(Event.SharedMesh.SegmentSize));
+        Hash = HashCombine(Hash, GetTypeHash(Event.Preview.Pixels.Num()));
+        return Event.Preview.Pixels.Num() > 0 ? HashCombine(Hash, GetTypeHash(Event.Preview.Pixels.Last())) : Hash;
+    }
+
+    // Counts the ways an event can be wrong no matter what bytes produced it
+    static int32 CountViolations(const FShapEWorkerEvent& Event)
+    {
+        int32 Violations = 0;
+        Violations += Event.Type == EShapEWorkerEventType::Preview && !Event.Preview.IsValid();
+        Violations += Event.Type == EShapEWorkerEventType::Progress && (Event.Percentage < 10.f || Event.Percentage > 95.f);
+        Violations += Event.Type == EShapEWorkerEventType::Progress && (Event.Step < 0 || Event.TotalSteps < 0);
+        Violations += Event.Type == EShapEWorkerEventType::WorkerExited;
+        return Violations;
+    }
+
+    // Feeds Stream in random chunks of 1 to MaxChunk bytes; false if the decoder failed on it
+    static bool DecodeInChunks(FShapEWorkerRecordDecoder& Decoder, const TArray<uint8>& Stream, FRandomStream& Random, int32 MaxChunk, TFunctionRef<void(FShapEWorkerEvent&&)> OnEvent)
+    {
+        for (int32 Offset = 0; Offset < Stream.Num();)
+        {
+            const int32 Chunk = FMath::Min(Stream.Num() - Offset, 1 + Random.RandHelper(MaxChunk));
+            if (!Decoder.Append(Stream.GetData() + Offset, Chunk, 1, OnEvent))
+            {
+                return false;
+            }
+            Offset += Chunk;
+        }
+        return true;
+    }
+
+    static void Mutate(TArray<uint8>& Stream, FRandomStream& Random)
+    {
+        switch (Random.RandHelper(6))
+        {
+        case 0: // flip a few bytes
+            for (int32 Flip = 0, Flips = 1 + Random.RandHelper(8); Flip < Flips; ++Flip)
+            {
+                Stream[Random.RandHelper(Stream.Num())] ^= static_cast<uint8>(1 + Random.RandHelper(255));
+            }
+            break;
+        case 1: // cut the stream short
+            Stream.SetNum(Random.RandHelper(Stream.Num()));
+            break;
+        case 2: // a corrupt length, often huge or zero
+        {
+            const int32 Offset = Random.RandHelper(FMath::Max(1, Stream.Num() - 4));
+            const uint32 Length = Random.RandHelper(4) == 0 ? 0u : static_cast<uint32>(Random.GetUnsignedInt());
+            FMemory::Memcpy(Stream.GetData() + Offset, &Length, FMath::Min<int32>(sizeof(Length), Stream.Num() - Offset));
+            break;
+        }
+        case 3: // junk in the middle
+        {
+            TArray<uint8> Junk;
+            Junk.SetNumUninitialized(1 + Random.RandHelper(64));
+            for (uint8& Byte : Junk)
+            {
+                Byte = static_cast<uint8>(Random.RandHelper(256));
+            }
+            Stream.Insert(Junk, Random.RandHelper(Stream.Num()));
+            break;
+        }
+        case 4: // well framed records of a random type with random bodies, behind a valid hello
+        {
+            Stream.Reset();
+            FWriter Writer(Stream);
+            Writer.WriteHello(ProtocolVersion);
+            for (int32 Record = 0, Records = 1 + Random.RandHelper(32); Record < Records; ++Record)
+            {
+                Writer.BeginRecord(static_cast<ERecordType>(Random.RandHelper(16)));
+                for (int32 Byte = 0, Bytes = Random.RandHelper(48); Byte < Bytes; ++Byte)
+                {
+                    Writer.WriteU8(static_cast<uint8>(Random.RandHelper(Random.RandHelper(2) ? 256 : 8)));
+                }
+                Writer.EndRecord();
+            }
+            break;
+        }
+        default: // pure noise
+            Stream.SetNumUninitialized(1 + Random.RandHelper(4096));
+            for (uint8& Byte : Stream)
+            {
+                Byte = static_cast<uint8>(Random.RandHelper(256));
+            }
+            break;
+        }
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 200;
+        const int32 Seed = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1234;
+        const int32 FuzzCases = Args.Num() > 2 ? FMath::Max(0, FCString::Atoi(*Args[2])) : 20000;
+        FRandomStream Random(Seed);
+
+        FSession Session;
+        BuildSession(Random, Session);
+
+        // records, in reads as large as the reader thread makes
+        FShapEWorkerRecordDecoder RecordDecoder(TEXT("ShapEProtocolBenchmark"));
+        int64 RecordEvents = 0;
+        uint32 RecordHash = 0;
+        auto CountRecordEvent = [&](FShapEWorkerEvent&& Event)
+        {
+            ++RecordEvents;
+            RecordHash = HashCombine(RecordHash, HashEvent(Event));
+        };
+        const double RecordStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            RecordDecoder.Reset();
+            RecordHash = 0;
+            for (int32 Offset = 0; Offset < Session.Records.Num(); Offset += ReadChunkSize)
+            {
+                RecordDecoder.Append(Session.Records.GetData() + Offset, FMath::Min(ReadChunkSize, Session.Records.Num() - Offset), 1, CountRecordEvent);
+            }
+        }
+        const double RecordSeconds = FPlatformTime::Seconds() - RecordStart;
+        const uint32 WholeHash = RecordHash;
+        const int64 EventsPerSession = RecordEvents / Iterations;
+
+        // the same session as JSON lines and a tqdm bar, through the path the stdout reader takes
+        FShapELineFramer Framer;
+        FShapEWorkerLineDecoder LineDecoder(TEXT("ShapEProtocolBenchmark"));
+        int64 LineEvents = 0;
+        auto DecodeLine = [&](const UTF8CHAR* Data, int32 Length)
+        {
+            const FUtf8StringView Line(Data, Length);
+            FShapEParsedLine Parsed;
+            FShapEOutputParser::Parse(Line, Parsed);
+            FShapEWorkerEvent Event;
+            LineEvents += LineDecoder.Decode(Line, Parsed, 1, Event);
+        };
+        const double LineStart = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            for (int32 Offset = 0; Offset < Session.Lines.Num(); Offset += ReadChunkSize)
+            {
+                Framer.Append(Session.Lines.GetData() + Offset, FMath::Min(ReadChunkSize, Session.Lines.Num() - Offset), DecodeLine);
+            }
+            Framer.Flush(DecodeLine);
+        }
+        const double LineSeconds = FPlatformTime::Seconds() - LineStart;
+
+        const double RecordRate = RecordEvents / FMath::Max(RecordSeconds, UE_DOUBLE_SMALL_NUMBER);
+        const double LineRate = LineEvents / FMath::Max(LineSeconds, UE_DOUBLE_SMALL_NUMBER);
+        UE_LOG(LogTemp, Display, TEXT("ShapEProtocolBenchmark: %d jobs of %d steps x %d iterations, %lld events per session"), JobsPerSession, StepsPerJob, Iterations, EventsPerSession);
+        UE_LOG(LogTemp, Display, TEXT("ShapEProtocolBenchmark: records     %d bytes, %lld events in %.3f s = %.0f events/s, %.1f MB/s"),
+            Session.Records.Num(), RecordEvents, RecordSeconds, RecordRate, Session.Records.Num() * double(Iterations) / FMath::Max(RecordSeconds, UE_DOUBLE_SMALL_NUMBER) / (1024.0 * 1024.0));
+        UE_LOG(LogTemp, Display, TEXT("ShapEProtocolBenchmark: json lines  %d bytes, %lld events in %.3f s = %.0f events/s, %.1f MB/s (%.1fx slower)"),
+            Session.Lines.Num(), LineEvents, LineSeconds, LineRate, Session.Lines.Num() * double(Iterations) / FMath::Max(LineSeconds, UE_DOUBLE_SMALL_NUMBER) / (1024.0 * 1024.0),
+            RecordRate / FMath::Max(LineRate, UE_DOUBLE_SMALL_NUMBER));
+        if (LineEvents != RecordEvents)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEProtocolBenchmark: The two encodings decoded to %lld and %lld events"), RecordEvents, LineEvents);
+        }
+
+        // any split of a valid stream decodes to the same events
+        int32 ChunkMismatches = 0;
+        for (int32 Case = 0; Case < 64; ++Case)
+        {
+            RecordDecoder.Reset();
+            RecordEvents = 0;
+            RecordHash = 0;
+            const bool bDecoded = DecodeInChunks(RecordDecoder, Session.Records, Random, 1 + Random.RandHelper(Case < 8 ? 4 : 4096), CountRecordEvent);
+            ChunkMismatches += !bDecoded || RecordEvents != EventsPerSession || RecordHash != WholeHash || RecordDecoder.GetPendingBytes() != 0;
+        }
+        UE_LOG(LogTemp, Display, TEXT("ShapEProtocolBenchmark: random splits: %d of 64 decoded differently"), ChunkMismatches);
+
+        // corrupted streams: each either decodes or fails, and a failed stream stays failed
+        int32 Open = 0, Failed = 0, Declined = 0, Violations = 0;
+        int64 FuzzEvents = 0;
+        TArray<uint8> Stream;
+        const double FuzzStart = FPlatformTime::Seconds();
+        for (int32 Case = 0; Case < FuzzCases; ++Case)
+        {
+            // a short prefix keeps the cases fast and still covers every record type
+            const int32 PrefixLength = FMath::Min(Session.Records.Num(), 64 + Random.RandHelper(32 * 1024));
+            Stream = TArray<uint8>(Session.Records.GetData(), PrefixLength);
+            for (int32 Mutation = 0, Mutations = 1 + Random.RandHelper(3); Mutation < Mutations && Stream.Num() > 0; ++Mutation)
+            {
+                Mutate(Stream, Random);
+            }
+            if (Stream.Num() == 0)
+            {
+                ++Open;
+                continue;
+            }
+
+            RecordDecoder.Reset();
+            auto CheckEvent = [&](FShapEWorkerEvent&& Event)
+            {
+                ++FuzzEvents;
+                Violations += CountViolations(Event);
+            };
+            if (!DecodeInChunks(RecordDecoder, Stream, Random, 1 + Random.RandHelper(512), CheckEvent))
+            {
+                ++Failed;
+                int64 EventsAfterFailure = 0;
+                const bool bStillFails = !RecordDecoder.Append(Session.Records.GetData(), FMath::Min(64, Session.Records.Num()), 1, [&EventsAfterFailure](FShapEWorkerEvent&&) { ++EventsAfterFailure; });
+                Violations += !bStillFails || EventsAfterFailure > 0 || RecordDecoder.GetState() != FShapEWorkerRecordDecoder::EState::Failed || RecordDecoder.GetError().IsEmpty();
+                continue;
+            }
+
+            Declined += RecordDecoder.GetState() == FShapEWorkerRecordDecoder::EState::Declined;
+            Open += RecordDecoder.GetState() != FShapEWorkerRecordDecoder::EState::Declined;
+            // a partial record never holds more than one record's worth of bytes
+            Violations += RecordDecoder.GetPendingBytes() > MaxRecordBytes + static_cast<int32>(sizeof(uint32));
+        }
+        const double FuzzSeconds = FPlatformTime::Seconds() - FuzzStart;
+
+        UE_LOG(LogTemp, Display, TEXT("ShapEProtocolBenchmark: fuzz seed %d: %d cases in %.2f s, %d decoded, %d failed, %d declined, %lld events, %d invariant violations"),
+            Seed, FuzzCases, FuzzSeconds, Open, Failed, Declined, FuzzEvents, Violations);
+        if (Violations > 0 || ChunkMismatches > 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEProtocolBenchmark: The record decoder broke its invariants; rerun with seed %d to reproduce"), Seed);
+        }
+    }
+
+    static FAutoConsoleCommand BenchProtocolCommand(
+        TEXT("ShapE.Bench.Protocol"),
+        TEXT("Compares decoding the worker's binary records with its JSON lines, then fuzzes the record decoder. Args: [Iterations] [Seed] [FuzzCases]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
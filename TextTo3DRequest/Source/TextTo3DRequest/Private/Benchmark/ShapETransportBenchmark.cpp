@@ -0,0 +1,167 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include "Interfaces/IPluginManager.h"
+#include "MeshDescription.h"
+#include "Manager/FShapEProcessManager.h"
+#include "Import/FShapEPlyImporter.h"
+
+// Usage: ShapE.Bench.Transport [BatPath] [Jobs] [Segments]
+// Starts a separate worker with --synthetic (a sphere of Segments x Segments quads per prompt, no GPU) and runs
+// Jobs generations with the file transport, then Jobs with the shared-memory transport and no file export.
+// Reports the time from enqueue until the mesh description is built, and the import step alone.
+namespace ShapETransportBenchmark
+{
+    struct FRunState
+    {
+        int32 Jobs = 0;
+        int32 Completed = 0;
+        bool bSharedMemory = false;
+        double EnqueueTime = 0.0;
+        double TotalRoundTripSeconds = 0.0;
+        double TotalImportSeconds = 0.0;
+        int32 NumVertices = 0;
+        int32 Failures = 0;
+        // filled by OnSharedMeshReady, which fires just before OnGenerationComplete
+        bool bSharedMeshImported = false;
+        FShapEPlyImportStats SharedMeshStats;
+    };
+
+    static TSharedPtr<FShapEProcessManager> BenchManager;
+    static FRunState State;
+    static FString BatPath;
+
+    static void EnqueueNext();
+
+    static FString GetDefaultBatPath()
+    {
+        TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("TextTo3DRequest"));
+        return Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("run_shape.bat")) : FString();
+    }
+
+    static void Report()
+    {
+        const int32 Succeeded = FMath::Max(1, State.Completed - State.Failures);
+        UE_LOG(LogTemp, Display, TEXT("ShapETransportBenchmark: %-13s %d jobs, %d vertices: round trip %.1f ms, import %.1f ms per job (%d failed)"),
+            State.bSharedMemory ? TEXT("shared memory") : TEXT("file"), State.Completed, State.NumVertices,
+            State.TotalRoundTripSeconds * 1000.0 / Succeeded, State.TotalImportSeconds * 1000.0 / Succeeded, State.Failures);
+    }
+
+    static void FinishJob(double ImportSeconds, int32 NumVertices, bool bSucceeded)
+    {
+        ++State.Completed;
+        if (bSucceeded)
+        {
+            State.TotalRoundTripSeconds += FPlatformTime::Seconds() - State.EnqueueTime;
+            State.TotalImportSeconds += ImportSeconds;
+            State.NumVertices = NumVertices;
+        }
+        else
+        {
+            ++State.Failures;
+        }
+
+        // called from inside the manager's broadcasts, so the next step waits until they have returned
+        AsyncTask(ENamedThreads::GameThread, []()
+        {
+            if (State.Completed < State.Jobs)
+            {
+                EnqueueNext();
+                return;
+            }
+
+            Report();
+            if (!State.bSharedMemory)
+            {
+                const int32 Jobs = State.Jobs;
+                State = FRunState();
+                State.Jobs = Jobs;
+                State.bSharedMemory = true;
+                EnqueueNext();
+                return;
+            }
+
+            BenchManager->StopWorker();
+            BenchManager.Reset();
+        });
+    }
+
+    static void EnqueueNext()
+    {
+        FShapEGenerationParameters Params;
+        // distinct prompts so nothing is deduplicated along the way
+        Params.Prompt = FString::Printf(TEXT("benchmark sphere %d"), State.Completed);
+        Params.OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEBenchmark"), TEXT("Transport"));
+        Params.KarrasSteps = 4;
+        Params.bUseCache = false;
+        Params.bUseSharedMemory = State.bSharedMemory;
+        Params.bExportFiles = !State.bSharedMemory;
+
+        TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+        Delegates->OnSharedMeshReady.AddLambda([](const FShapESharedMeshLayout& Layout)
+        {
+            FMeshDescription MeshDescription;
+            FString Error;
+            State.bSharedMeshImported = FShapEPlyImporter::ImportSharedMesh(Layout, MeshDescription, FShapEPlyImportOptions(), Error, &State.SharedMeshStats);
+            if (!State.bSharedMeshImported)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapETransportBenchmark: %s"), *Error);
+            }
+        });
+        Delegates->OnGenerationComplete.AddLambda([](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
+        {
+            if (State.bSharedMemory)
+            {
+                FinishJob(State.SharedMeshStats.ParseSeconds, State.SharedMeshStats.NumVertices, State.bSharedMeshImported);
+                State.bSharedMeshImported = false;
+                return;
+            }
+
+            FMeshDescription MeshDescription;
+            FShapEPlyImportStats Stats;
+            FString Error;
+            const bool bImported = FShapEPlyImporter::ImportMeshDescription(PlyPath, MeshDescription, FShapEPlyImportOptions(), Error, &Stats);
+            if (!bImported)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ShapETransportBenchmark: %s"), *Error);
+            }
+            FinishJob(Stats.ParseSeconds, Stats.NumVertices, bImported);
+        });
+        Delegates->OnErrorReceived.AddLambda([](const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapETransportBenchmark: %s (%s)"), *ErrorMessage, *ErrorType);
+            FinishJob(0.0, 0, false);
+        });
+
+        State.EnqueueTime = FPlatformTime::Seconds();
+        BenchManager->EnqueueGeneration(BatPath, Params, EShapEJobPriority::Interactive, Delegates);
+    }
+
+    static void Run(const TArray<FString>& Args)
+    {
+        if (BenchManager.IsValid())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapETransportBenchmark: A run is already in progress."));
+            return;
+        }
+
+        BatPath = Args.Num() > 0 ? Args[0] : GetDefaultBatPath();
+        const int32 Jobs = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10;
+        const int32 Segments = Args.Num() > 2 ? FMath::Clamp(FCString::Atoi(*Args[2]), 8, 4096) : 256;
+
+        BenchManager = MakeShared<FShapEProcessManager>();
+        BenchManager->SetWorkerArguments(FString::Printf(TEXT("--synthetic --synthetic-segments %d"), Segments));
+
+        State = FRunState();
+        State.Jobs = Jobs;
+        UE_LOG(LogTemp, Display, TEXT("ShapETransportBenchmark: %d jobs per transport, %d segments, worker %s"), Jobs, Segments, *BatPath);
+        EnqueueNext();
+    }
+
+    static FAutoConsoleCommand BenchTransportCommand(
+        TEXT("ShapE.Bench.Transport"),
+        TEXT("Compares the file and shared-memory mesh handoff using a synthetic worker. Args: [BatPath] [Jobs] [Segments]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Run));
+}
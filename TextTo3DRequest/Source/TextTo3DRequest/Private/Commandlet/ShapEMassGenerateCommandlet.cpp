@@ -0,0 +1,1103 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Commandlet/ShapEMassGenerateCommandlet.h"
+#include "Algo/AllOf.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Engine/StaticMesh.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/DefaultValueHelper.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ObjectTools.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/UObjectGlobals.h"
+#include "Manager/FShapEProcessManager.h"
+#include "Import/FShapEPlyImporter.h"
+#include "Backend/FShapEMockBackend.h"
+#include "Backend/FShapEDirectLaunchBackend.h"
+#include "Backend/FShapEWorkerPoolBackend.h"
+
+namespace ShapEMassGenerateCommandlet
+{
+    // Imports between garbage collections; saved meshes are released so a long run doesn't keep them all
+    static constexpr int32 ImportsPerGarbageCollection = 16;
+
+    struct FManifestItem
+    {
+        FString Id;
+        FString PackagePath;
+        FString AssetName;
+        FShapEGenerationParameters Params;
+        // "row 4" or "item 3", for errors
+        FString Location;
+    };
+
+    enum class EItemStatus : uint8
+    {
+        Pending,
+        Running,
+        Succeeded,
+        Failed,
+        // succeeded in an earlier run of the same report
+        Resumed
+    };
+
+    struct FItemResult
+    {
+        EItemStatus Status = EItemStatus::Pending;
+        int32 Attempts = 0;
+        int32 JobIndex = INDEX_NONE;
+        FString JobId;
+        bool bBatched = false;
+        FString PlyPath;
+        FString AssetPath;
+        FString Error;
+        FString ErrorType;
+        double SubmitTime = 0.0;
+        double CompleteSeconds = 0.0;
+        double ImportMilliseconds = 0.0;
+        // the job's timing; for a batched item, that of the whole batch
+        TSharedPtr<FJsonObject> Timing;
+        bool bFromCache = false;
+        // the record of an earlier run, written back unchanged for a resumed item
+        TSharedPtr<FJsonObject> PreviousRecord;
+    };
+
+    struct FJobRun
+    {
+        TArray<int32> Items;
+        bool bBatch = false;
+        FString JobId;
+        double SubmitTime = 0.0;
+        double Deadline = 0.0;
+        bool bSubmitted = false;
+        bool bTimedOut = false;
+        bool bFinished = false;
+    };
+
+    struct FRunState
+    {
+        TArray<FManifestItem> Items;
+        TArray<FItemResult> Results;
+        TArray<FJobRun> Jobs;
+        TWeakPtr<FShapEProcessManager> Manager;
+        bool bImport = true;
+        bool bUseCache = true;
+        bool bSaveLatents = false;
+        float ItemTimeoutSeconds = 0.0f;
+        FString OutputDirectory;
+        FString ManifestPath;
+        FString ReportPath;
+        FString BackendName;
+        int32 Concurrency = 1;
+        int32 BatchSize = 1;
+        FString StartedAt;
+        double StartTime = 0.0;
+        int32 JobsInFlight = 0;
+        int32 ItemsFinished = 0;
+        int32 ItemsToRun = 0;
+        int32 ImportsSinceGarbageCollection = 0;
+    };
+
+    static FString GetDefaultScriptPath()
+    {
+        TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("TextTo3DRequest"));
+        return Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("ue_shape_interface.py")) : FString();
+    }
+
+    static const TCHAR* GetStatusName(EItemStatus Status)
+    {
+        switch (Status)
+        {
+        case EItemStatus::Pending: return TEXT("pending");
+        case EItemStatus::Running: return TEXT("running");
+        case EItemStatus::Succeeded: return TEXT("succeeded");
+        case EItemStatus::Failed: return TEXT("failed");
+        case EItemStatus::Resumed: return TEXT("succeeded");
+        }
+        return TEXT("pending");
+    }
+
+    // Both manifest formats come down to key/value strings; an empty value keeps the default
+    static bool ApplyField(FManifestItem& Item, const FString& Key, const FString& RawValue, FString& OutError)
+    {
+        const FString Value = RawValue.TrimStartAndEnd();
+        if (Value.IsEmpty() || Key.StartsWith(TEXT("_")))
+        {
+            return true;
+        }
+
+        if (Key == TEXT("id"))
+        {
+            Item.Id = Value;
+        }
+        else if (Key == TEXT("prompt"))
+        {
+            Item.Params.Prompt = Value;
+        }
+        else if (Key == TEXT("package_path"))
+        {
+            Item.PackagePath = Value;
+        }
+        else if (Key == TEXT("asset_name"))
+        {
+            Item.AssetName = Value;
+        }
+        else if (Key == TEXT("karras_steps"))
+        {
+            if (!FDefaultValueHelper::ParseInt(Value, Item.Params.KarrasSteps))
+            {
+                OutError = FString::Printf(TEXT("karras_steps is not a whole number: %s"), *Value);
+                return false;
+            }
+        }
+        else if (Key == TEXT("guidance_scale"))
+        {
+            if (!FDefaultValueHelper::ParseFloat(Value, Item.Params.GuidanceScale))
+            {
+                OutError = FString::Printf(TEXT("guidance_scale is not a number: %s"), *Value);
+                return false;
+            }
+        }
+        else if (Key == TEXT("seed"))
+        {
+            if (!FDefaultValueHelper::ParseInt(Value, Item.Params.Seed))
+            {
+                OutError = FString::Printf(TEXT("seed is not a whole number: %s"), *Value);
+                return false;
+            }
+        }
+        else if (Key == TEXT("use_fp16"))
+        {
+            Item.Params.bUseFP16 = FCString::ToBool(*Value);
+        }
+        else if (Key == TEXT("model_version"))
+        {
+            Item.Params.ModelVersion = Value;
+        }
+        else if (Key == TEXT("lods"))
+        {
+            // "8000,2000,500"; separated by ';' or spaces too, so a CSV cell needs no quotes
+            static const TCHAR* Delimiters[] = { TEXT(","), TEXT(";"), TEXT(" ") };
+            TArray<FString> Budgets;
+            Value.ParseIntoArray(Budgets, Delimiters, UE_ARRAY_COUNT(Delimiters));
+            Item.Params.LODTriangleBudgets.Reset();
+            for (const FString& Budget : Budgets)
+            {
+                int32 Triangles = 0;
+                if (!FDefaultValueHelper::ParseInt(Budget, Triangles) || Triangles <= 0)
+                {
+                    OutError = FString::Printf(TEXT("lods holds an invalid triangle budget: %s"), *Budget);
+                    return false;
+                }
+                Item.Params.LODTriangleBudgets.Add(Triangles);
+            }
+        }
+        else if (Key == TEXT("nanite"))
+        {
+            Item.Params.bEnableNanite = FCString::ToBool(*Value);
+        }
+        else
+        {
+            // a misspelt column would otherwise silently fall back to the default
+            OutError = FString::Printf(TEXT("Unknown key \"%s\""), *Key);
+            return false;
+        }
+        return true;
+    }
+
+    static bool JsonValueToString(const TSharedPtr<FJsonValue>& Value, FString& OutString)
+    {
+        switch (Value.IsValid() ? Value->Type : EJson::None)
+        {
+        case EJson::None:
+        case EJson::Null:
+            OutString.Reset();
+            return true;
+        case EJson::String:
+            OutString = Value->AsString();
+            return true;
+        case EJson::Boolean:
+            OutString = Value->AsBool() ? TEXT("true") : TEXT("false");
+            return true;
+        case EJson::Number:
+        {
+            const double Number = Value->AsNumber();
+            OutString = Number == FMath::RoundToDouble(Number) ? FString::Printf(TEXT("%lld"), static_cast<int64>(Number)) : FString::SanitizeFloat(Number);
+            return true;
+        }
+        case EJson::Array:
+        {
+            TArray<FString> Elements;
+            for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+            {
+                FString ElementString;
+                if (!JsonValueToString(Element, ElementString) || Element->Type == EJson::Array)
+                {
+                    return false;
+                }
+                Elements.Add(ElementString);
+            }
+            OutString = FString::Join(Elements, TEXT(","));
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    static bool ApplyJsonObject(FManifestItem& Item, const FJsonObject& Object, FString& OutError)
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+        {
+            FString Value;
+            if (!JsonValueToString(Field.Value, Value))
+            {
+                OutError = FString::Printf(TEXT("\"%s\" must be a string, number, boolean or array of them"), *Field.Key);
+                return false;
+            }
+            if (!ApplyField(Item, Field.Key.ToLower(), Value, OutError))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool ParseJsonManifest(const FString& Contents, FManifestItem Defaults, TArray<FManifestItem>& OutItems, FString& OutError)
+    {
+        TSharedPtr<FJsonValue> Root;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Contents);
+        if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+        {
+            OutError = FString::Printf(TEXT("Invalid JSON: %s"), *Reader->GetErrorMessage());
+            return false;
+        }
+
+        TArray<TSharedPtr<FJsonValue>> ItemValues;
+        if (Root->Type == EJson::Array)
+        {
+            ItemValues = Root->AsArray();
+        }
+        else if (Root->Type == EJson::Object)
+        {
+            const TSharedPtr<FJsonObject> RootObject = Root->AsObject();
+            const TSharedPtr<FJsonObject>* DefaultsObject = nullptr;
+            if (RootObject->TryGetObjectField(TEXT("defaults"), DefaultsObject) && !ApplyJsonObject(Defaults, **DefaultsObject, OutError))
+            {
+                OutError = TEXT("defaults: ") + OutError;
+                return false;
+            }
+            const TArray<TSharedPtr<FJsonValue>>* ItemArray = nullptr;
+            if (!RootObject->TryGetArrayField(TEXT("items"), ItemArray))
+            {
+                OutError = TEXT("The manifest object has no \"items\" array.");
+                return false;
+            }
+            ItemValues = *ItemArray;
+        }
+        else
+        {
+            OutError = TEXT("The manifest must be an array of items or an object with \"items\".");
+            return false;
+        }
+
+        for (int32 Index = 0; Index < ItemValues.Num(); ++Index)
+        {
+            FManifestItem Item = Defaults;
+            Item.Location = FString::Printf(TEXT("item %d"), Index + 1);
+            const TSharedPtr<FJsonValue>& ItemValue = ItemValues[Index];
+            if (ItemValue.IsValid() && ItemValue->Type == EJson::String)
+            {
+                // a bare prompt
+                Item.Params.Prompt = ItemValue->AsString().TrimStartAndEnd();
+            }
+            else if (!ItemValue.IsValid() || ItemValue->Type != EJson::Object)
+            {
+                OutError = FString::Printf(TEXT("%s: expected an object or a prompt string"), *Item.Location);
+                return false;
+            }
+            else if (!ApplyJsonObject(Item, *ItemValue->AsObject(), OutError))
+            {
+                OutError = FString::Printf(TEXT("%s: %s"), *Item.Location, *OutError);
+                return false;
+            }
+            OutItems.Add(MoveTemp(Item));
+        }
+        return true;
+    }
+
+    static bool ParseCsvManifest(const FString& Contents, const FManifestItem& Defaults, TArray<FManifestItem>& OutItems, FString& OutError)
+    {
+        const FCsvParser Parser(Contents);
+        const FCsvParser::FRows& Rows = Parser.GetRows();
+        if (Rows.IsEmpty())
+        {
+            OutError = TEXT("The CSV manifest has no header row.");
+            return false;
+        }
+
+        TArray<FString> Columns;
+        for (const TCHAR* Cell : Rows[0])
+        {
+            Columns.Add(FString(Cell).TrimStartAndEnd().ToLower());
+        }
+
+        for (int32 RowIndex = 1; RowIndex < Rows.Num(); ++RowIndex)
+        {
+            const TArray<const TCHAR*>& Row = Rows[RowIndex];
+            if (Algo::AllOf(Row, [](const TCHAR* Cell) { return FString(Cell).TrimStartAndEnd().IsEmpty(); }))
+            {
+                continue;
+            }
+
+            FManifestItem Item = Defaults;
+            Item.Location = FString::Printf(TEXT("row %d"), RowIndex + 1);
+            for (int32 CellIndex = 0; CellIndex < Row.Num(); ++CellIndex)
+            {
+                const FString Cell = Row[CellIndex];
+                if (!Columns.IsValidIndex(CellIndex))
+                {
+                    if (!Cell.TrimStartAndEnd().IsEmpty())
+                    {
+                        OutError = FString::Printf(TEXT("%s: more cells than columns"), *Item.Location);
+                        return false;
+                    }
+                    continue;
+                }
+                if (!ApplyField(Item, Columns[CellIndex], Cell, OutError))
+                {
+                    OutError = FString::Printf(TEXT("%s: %s"), *Item.Location, *OutError);
+                    return false;
+                }
+            }
+            OutItems.Add(MoveTemp(Item));
+        }
+        return true;
+    }
+
+    // The id names the output files and the default asset, so it is kept to characters valid in both
+    static FString SanitizeId(const FString& Id)
+    {
+        FString Sanitized = Id;
+        for (TCHAR& Character : Sanitized)
+        {
+            if (!FChar::IsAlnum(Character) && Character != TEXT('-') && Character != TEXT('_'))
+            {
+                Character = TEXT('_');
+            }
+        }
+        return Sanitized;
+    }
+
+    // Checks every item and fills in the ids and asset names left out of the manifest
+    static bool FinalizeItems(TArray<FManifestItem>& Items, FString& OutError)
+    {
+        if (Items.IsEmpty())
+        {
+            OutError = TEXT("The manifest has no items.");
+            return false;
+        }
+
+        TSet<FString> Ids;
+        for (const FManifestItem& Item : Items)
+        {
+            if (Item.Id.IsEmpty())
+            {
+                continue;
+            }
+            if (SanitizeId(Item.Id) != Item.Id)
+            {
+                OutError = FString::Printf(TEXT("%s: the id \"%s\" may only hold letters, digits, '-' and '_'"), *Item.Location, *Item.Id);
+                return false;
+            }
+            bool bAlreadyInSet = false;
+            Ids.Add(Item.Id, &bAlreadyInSet);
+            if (bAlreadyInSet)
+            {
+                OutError = FString::Printf(TEXT("%s: the id \"%s\" is used twice"), *Item.Location, *Item.Id);
+                return false;
+            }
+        }
+
+        for (FManifestItem& Item : Items)
+        {
+            if (Item.Params.Prompt.IsEmpty())
+            {
+                OutError = FString::Printf(TEXT("%s: no prompt"), *Item.Location);
+                return false;
+            }
+            if (Item.Params.KarrasSteps < 1 || Item.Params.KarrasSteps > 1024)
+            {
+                OutError = FString::Printf(TEXT("%s: karras_steps must be between 1 and 1024"), *Item.Location);
+                return false;
+            }
+            if (Item.Params.GuidanceScale <= 0.0f)
+            {
+                OutError = FString::Printf(TEXT("%s: guidance_scale must be positive"), *Item.Location);
+                return false;
+            }
+            FText Reason;
+            if (!FPackageName::IsValidLongPackageName(Item.PackagePath, false, &Reason))
+            {
+                OutError = FString::Printf(TEXT("%s: invalid package_path %s (%s)"), *Item.Location, *Item.PackagePath, *Reason.ToString());
+                return false;
+            }
+
+            if (Item.Id.IsEmpty())
+            {
+                const FString BaseId = SanitizeId(Item.Params.Prompt.Left(48).Replace(TEXT(" "), TEXT("_")));
+                Item.Id = BaseId;
+                for (int32 Suffix = 2; Ids.Contains(Item.Id); ++Suffix)
+                {
+                    Item.Id = FString::Printf(TEXT("%s_%d"), *BaseId, Suffix);
+                }
+                Ids.Add(Item.Id);
+            }
+            Item.AssetName = ObjectTools::SanitizeObjectName(Item.AssetName.IsEmpty() ? TEXT("SM_") + Item.Id : Item.AssetName);
+        }
+        return true;
+    }
+
+    static bool LoadManifest(const FString& ManifestPath, const FManifestItem& Defaults, TArray<FManifestItem>& OutItems, FString& OutError)
+    {
+        FString Contents;
+        if (!FFileHelper::LoadFileToString(Contents, *ManifestPath))
+        {
+            OutError = FString::Printf(TEXT("Could not read %s"), *ManifestPath);
+            return false;
+        }
+
+        const bool bParsed = FPaths::GetExtension(ManifestPath).Equals(TEXT("csv"), ESearchCase::IgnoreCase)
+            ? ParseCsvManifest(Contents, Defaults, OutItems, OutError)
+            : ParseJsonManifest(Contents, Defaults, OutItems, OutError);
+        return bParsed && FinalizeItems(OutItems, OutError);
+    }
+
+    // Items that succeeded under the same id and prompt in an earlier run of this report are not run again
+    static int32 LoadPreviousRun(FRunState& State)
+    {
+        FString Contents;
+        if (!FFileHelper::LoadFileToString(Contents, *State.ReportPath))
+        {
+            return 0;
+        }
+        TSharedPtr<FJsonObject> Report;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Contents);
+        const TArray<TSharedPtr<FJsonValue>>* ItemValues = nullptr;
+        if (!FJsonSerializer::Deserialize(Reader, Report) || !Report.IsValid() || !Report->TryGetArrayField(TEXT("items"), ItemValues))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapEMassGenerateCommandlet: Ignoring unreadable report %s"), *State.ReportPath);
+            return 0;
+        }
+
+        TMap<FString, TSharedPtr<FJsonObject>> PreviousRecords;
+        for (const TSharedPtr<FJsonValue>& ItemValue : *ItemValues)
+        {
+            const TSharedPtr<FJsonObject>* Record = nullptr;
+            if (ItemValue.IsValid() && ItemValue->TryGetObject(Record))
+            {
+                PreviousRecords.Add((*Record)->GetStringField(TEXT("id")), *Record);
+            }
+        }
+
+        int32 NumResumed = 0;
+        for (int32 Index = 0; Index < State.Items.Num(); ++Index)
+        {
+            const TSharedPtr<FJsonObject>* Record = PreviousRecords.Find(State.Items[Index].Id);
+            if (!Record)
+            {
+                continue;
+            }
+            FItemResult& Result = State.Results[Index];
+            Result.Attempts = static_cast<int32>((*Record)->GetNumberField(TEXT("attempts")));
+            const bool bSucceeded = (*Record)->GetStringField(TEXT("status")) == TEXT("succeeded")
+                && (*Record)->GetStringField(TEXT("prompt")) == State.Items[Index].Params.Prompt
+                // generated with -noimport before, but this run imports
+                && (!State.bImport || !(*Record)->GetStringField(TEXT("asset")).IsEmpty());
+            if (bSucceeded)
+            {
+                Result.Status = EItemStatus::Resumed;
+                Result.PreviousRecord = *Record;
+                ++NumResumed;
+            }
+        }
+        return NumResumed;
+    }
+
+    static TSharedRef<FJsonObject> MakeItemRecord(const FManifestItem& Item, const FItemResult& Result)
+    {
+        if (Result.Status == EItemStatus::Resumed && Result.PreviousRecord.IsValid())
+        {
+            TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>(*Result.PreviousRecord);
+            Record->SetBoolField(TEXT("resumed"), true);
+            return Record;
+        }
+
+        TSharedRef<FJsonObject> Record = MakeShared<FJsonObject>();
+        Record->SetStringField(TEXT("id"), Item.Id);
+        Record->SetStringField(TEXT("prompt"), Item.Params.Prompt);
+        Record->SetStringField(TEXT("status"), GetStatusName(Result.Status));
+        Record->SetNumberField(TEXT("attempts"), Result.Attempts);
+        Record->SetStringField(TEXT("job_id"), Result.JobId);
+        Record->SetBoolField(TEXT("batched"), Result.bBatched);
+        Record->SetStringField(TEXT("asset"), Result.AssetPath);
+        Record->SetStringField(TEXT("ply_file"), Result.PlyPath);
+        Record->SetStringField(TEXT("error"), Result.Error);
+        Record->SetStringField(TEXT("error_type"), Result.ErrorType);
+        Record->SetNumberField(TEXT("submit_to_complete_s"), Result.CompleteSeconds);
+        Record->SetNumberField(TEXT("import_ms"), Result.ImportMilliseconds);
+        Record->SetBoolField(TEXT("from_cache"), Result.bFromCache);
+        if (Result.Timing.IsValid())
+        {
+            Record->SetObjectField(TEXT("timing"), Result.Timing);
+        }
+        return Record;
+    }
+
+    // Rewritten after every item, through a temporary file so a crash never leaves half a report to resume from
+    static void WriteReport(const FRunState& State)
+    {
+        int32 NumSucceeded = 0;
+        int32 NumFailed = 0;
+        int32 NumResumed = 0;
+        TArray<TSharedPtr<FJsonValue>> ItemValues;
+        ItemValues.Reserve(State.Items.Num());
+        for (int32 Index = 0; Index < State.Items.Num(); ++Index)
+        {
+            const FItemResult& Result = State.Results[Index];
+            NumSucceeded += Result.Status == EItemStatus::Succeeded || Result.Status == EItemStatus::Resumed;
+            NumFailed += Result.Status == EItemStatus::Failed;
+            NumResumed += Result.Status == EItemStatus::Resumed;
+            ItemValues.Add(MakeShared<FJsonValueObject>(MakeItemRecord(State.Items[Index], Result)));
+        }
+
+        TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+        Summary->SetNumberField(TEXT("items"), State.Items.Num());
+        Summary->SetNumberField(TEXT("succeeded"), NumSucceeded);
+        Summary->SetNumberField(TEXT("failed"), NumFailed);
+        Summary->SetNumberField(TEXT("resumed"), NumResumed);
+        Summary->SetNumberField(TEXT("pending"), State.Items.Num() - NumSucceeded - NumFailed);
+        Summary->SetNumberField(TEXT("run_s"), FPlatformTime::Seconds() - State.StartTime);
+
+        TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+        Report->SetStringField(TEXT("manifest"), State.ManifestPath);
+        Report->SetStringField(TEXT("output_directory"), State.OutputDirectory);
+        Report->SetStringField(TEXT("backend"), State.BackendName);
+        Report->SetNumberField(TEXT("concurrency"), State.Concurrency);
+        Report->SetNumberField(TEXT("batch"), State.BatchSize);
+        Report->SetStringField(TEXT("started"), State.StartedAt);
+        Report->SetObjectField(TEXT("summary"), Summary);
+        Report->SetArrayField(TEXT("items"), ItemValues);
+
+        const FString TempPath = State.ReportPath + TEXT(".tmp");
+        if (!FFileHelper::SaveStringToFile(ShapEJson::ToCondensedString(Report), *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+            || !IFileManager::Get().Move(*State.ReportPath, *TempPath, true, true))
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: Could not write %s"), *State.ReportPath);
+        }
+    }
+
+    static void FinishItem(FRunState& State, int32 ItemIndex, bool bSucceeded, const FString& Error, const FString& ErrorType)
+    {
+        FItemResult& Result = State.Results[ItemIndex];
+        if (Result.Status != EItemStatus::Running)
+        {
+            return;
+        }
+        Result.Status = bSucceeded ? EItemStatus::Succeeded : EItemStatus::Failed;
+        Result.Error = Error;
+        Result.ErrorType = ErrorType;
+        Result.CompleteSeconds = FPlatformTime::Seconds() - Result.SubmitTime;
+        ++State.ItemsFinished;
+
+        const FManifestItem& Item = State.Items[ItemIndex];
+        if (bSucceeded)
+        {
+            UE_LOG(LogTemp, Display, TEXT("ShapEMassGenerateCommandlet: [%d/%d] %s succeeded in %.1f s %s"),
+                State.ItemsFinished, State.ItemsToRun, *Item.Id, Result.CompleteSeconds, Result.AssetPath.IsEmpty() ? *Result.PlyPath : *Result.AssetPath);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: [%d/%d] %s failed after %.1f s: %s (%s)"),
+                State.ItemsFinished, State.ItemsToRun, *Item.Id, Result.CompleteSeconds, *Error, *ErrorType);
+        }
+    }
+
+    static bool SaveAsset(UStaticMesh* StaticMesh, FString& OutError)
+    {
+        UPackage* Package = StaticMesh->GetOutermost();
+        const FString FileName = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        if (!UPackage::SavePackage(Package, StaticMesh, *FileName, SaveArgs))
+        {
+            OutError = FString::Printf(TEXT("Could not save %s"), *FileName);
+            return false;
+        }
+        return true;
+    }
+
+    // Batch items are written as <index>_<prompt> into the batch's own directory; they are moved next to the single
+    // results as <id>.ply so two batches never share a file and the report points at the item's own mesh
+    static FString AdoptBatchOutput(const FRunState& State, int32 ItemIndex, const FString& PlyPath, const FString& ObjPath)
+    {
+        const FString Base = FPaths::Combine(State.OutputDirectory, State.Items[ItemIndex].Id);
+        const FString SourceBase = FPaths::Combine(FPaths::GetPath(PlyPath), FPaths::GetBaseFilename(PlyPath));
+        const FString Destination = Base + TEXT(".ply");
+        if (!IFileManager::Get().Move(*Destination, *PlyPath, true, true))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapEMassGenerate: could not move %s to %s, importing it from the batch directory"), *PlyPath, *Destination);
+            return PlyPath;
+        }
+        if (!ObjPath.IsEmpty())
+        {
+            IFileManager::Get().Move(*(Base + TEXT(".obj")), *ObjPath, true, true);
+        }
+        const FString LatentPath = SourceBase + TEXT(".latent.npy");
+        if (IFileManager::Get().FileExists(*LatentPath))
+        {
+            IFileManager::Get().Move(*(Base + TEXT(".latent.npy")), *LatentPath, true, true);
+        }
+        return Destination;
+    }
+
+    static void ImportItem(FRunState& State, int32 ItemIndex, const FString& PlyPath)
+    {
+        FItemResult& Result = State.Results[ItemIndex];
+        if (Result.Status != EItemStatus::Running)
+        {
+            return;
+        }
+        Result.PlyPath = PlyPath;
+        if (!State.bImport)
+        {
+            FinishItem(State, ItemIndex, true, FString(), FString());
+            return;
+        }
+
+        const FManifestItem& Item = State.Items[ItemIndex];
+        const double ImportStartTime = FPlatformTime::Seconds();
+        FString Error;
+        UStaticMesh* StaticMesh = FShapEPlyImporter::CreateStaticMesh(PlyPath, Item.PackagePath, Item.AssetName, FShapEPlyImportOptions::FromGenerationParameters(Item.Params), Error);
+        const bool bSaved = StaticMesh && SaveAsset(StaticMesh, Error);
+        const double ImportEndTime = FPlatformTime::Seconds();
+        Result.ImportMilliseconds = (ImportEndTime - ImportStartTime) * 1000.0;
+
+        if (StaticMesh)
+        {
+            Result.AssetPath = StaticMesh->GetPathName();
+            // it is on disk now; let the next garbage collection take it
+            StaticMesh->ClearFlags(RF_Standalone);
+            ++State.ImportsSinceGarbageCollection;
+        }
+        if (!Result.bBatched)
+        {
+            if (TSharedPtr<FShapEProcessManager> Manager = State.Manager.Pin())
+            {
+                Manager->AddJobTimingSpan(Result.JobId, ShapEStages::Import, ImportStartTime, ImportEndTime);
+            }
+        }
+        FinishItem(State, ItemIndex, bSaved, Error, bSaved ? FString() : TEXT("Import"));
+    }
+
+    // Settles every item of the job that has no result yet and records the job's timing on all of them
+    static void FinishJob(FRunState& State, int32 JobIndex, const FString& Error, const FString& ErrorType)
+    {
+        FJobRun& Job = State.Jobs[JobIndex];
+        if (Job.bFinished)
+        {
+            return;
+        }
+        Job.bFinished = true;
+        --State.JobsInFlight;
+        if (Job.bBatch)
+        {
+            // empty unless an item could not be moved out
+            IFileManager::Get().DeleteDirectory(*FPaths::Combine(State.OutputDirectory, TEXT("batches"), State.Items[Job.Items[0]].Id), false, false);
+        }
+
+        FShapEJobTiming Timing;
+        TSharedPtr<FShapEProcessManager> Manager = State.Manager.Pin();
+        const bool bHasTiming = Manager.IsValid() && !Job.JobId.IsEmpty() && Manager->GetJobTiming(Job.JobId, Timing);
+        for (const int32 ItemIndex : Job.Items)
+        {
+            if (bHasTiming)
+            {
+                State.Results[ItemIndex].Timing = Timing.ToJsonObject();
+                State.Results[ItemIndex].bFromCache = Timing.bFromCache;
+            }
+            FinishItem(State, ItemIndex, false, Error, ErrorType);
+        }
+        WriteReport(State);
+    }
+
+    static void SubmitJob(FShapEProcessManager& Manager, const FString& ScriptPath, const TSharedRef<FRunState>& State, int32 JobIndex)
+    {
+        FJobRun& Job = State->Jobs[JobIndex];
+        const double Now = FPlatformTime::Seconds();
+        Job.bSubmitted = true;
+        Job.SubmitTime = Now;
+        Job.Deadline = State->ItemTimeoutSeconds > 0.0f ? Now + State->ItemTimeoutSeconds * Job.Items.Num() : 0.0;
+        ++State->JobsInFlight;
+        for (const int32 ItemIndex : Job.Items)
+        {
+            FItemResult& Result = State->Results[ItemIndex];
+            Result.Status = EItemStatus::Running;
+            Result.JobIndex = JobIndex;
+            Result.bBatched = Job.bBatch;
+            Result.SubmitTime = Now;
+            ++Result.Attempts;
+        }
+
+        TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+        Delegates->OnErrorReceived.AddLambda([State, JobIndex](const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
+        {
+            const FJobRun& FailedJob = State->Jobs[JobIndex];
+            if (FailedJob.bTimedOut)
+            {
+                FinishJob(*State, JobIndex, FString::Printf(TEXT("Timed out after %.0f s"), FPlatformTime::Seconds() - FailedJob.SubmitTime), TEXT("Timeout"));
+                return;
+            }
+            FinishJob(*State, JobIndex, ErrorMessage, ErrorType);
+        });
+
+        const FManifestItem& FirstItem = State->Items[Job.Items[0]];
+        if (Job.bBatch)
+        {
+            FShapEBatchGenerationParameters Params;
+            for (const int32 ItemIndex : Job.Items)
+            {
+                Params.Prompts.Add(State->Items[ItemIndex].Params.Prompt);
+            }
+            // named after the first item, whose id no other batch of the run starts with
+            Params.OutputDirectory = FPaths::Combine(State->OutputDirectory, TEXT("batches"), FirstItem.Id);
+            Params.GuidanceScale = FirstItem.Params.GuidanceScale;
+            Params.KarrasSteps = FirstItem.Params.KarrasSteps;
+            Params.bUseFP16 = FirstItem.Params.bUseFP16;
+            Params.BatchSize = Job.Items.Num();
+            Params.bSaveLatents = State->bSaveLatents;
+
+            Delegates->OnBatchItemComplete.AddLambda([State, JobIndex](int32 BatchItemIndex, const FString& Prompt, const FString& PlyPath, const FString& ObjPath)
+            {
+                const TArray<int32>& Items = State->Jobs[JobIndex].Items;
+                if (Items.IsValidIndex(BatchItemIndex) && State->Results[Items[BatchItemIndex]].Status == EItemStatus::Running)
+                {
+                    ImportItem(*State, Items[BatchItemIndex], AdoptBatchOutput(*State, Items[BatchItemIndex], PlyPath, ObjPath));
+                    WriteReport(*State);
+                }
+            });
+            Delegates->OnBatchItemError.AddLambda([State, JobIndex](int32 BatchItemIndex, const FString& Prompt, const FString& ErrorMessage)
+            {
+                const TArray<int32>& Items = State->Jobs[JobIndex].Items;
+                if (Items.IsValidIndex(BatchItemIndex))
+                {
+                    FinishItem(*State, Items[BatchItemIndex], false, ErrorMessage, TEXT("BatchItem"));
+                    WriteReport(*State);
+                }
+            });
+            Delegates->OnGenerationComplete.AddLambda([State, JobIndex](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
+            {
+                FinishJob(*State, JobIndex, TEXT("The batch finished without a result for this item."), TEXT("MissingResult"));
+            });
+
+            Job.JobId = Manager.EnqueueBatch(ScriptPath, Params, EShapEJobPriority::Bulk, Delegates);
+        }
+        else
+        {
+            FShapEGenerationParameters Params = FirstItem.Params;
+            Params.OutputDirectory = State->OutputDirectory;
+            Params.OutputName = FirstItem.Id;
+            Params.bUseCache = State->bUseCache;
+            Params.bSaveLatents = State->bSaveLatents;
+            Params.bUseSharedMemory = false;
+            Params.bExportFiles = true;
+
+            const int32 ItemIndex = Job.Items[0];
+            Delegates->OnGenerationComplete.AddLambda([State, JobIndex, ItemIndex](const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
+            {
+                ImportItem(*State, ItemIndex, PlyPath);
+                FinishJob(*State, JobIndex, TEXT("The job finished without a result."), TEXT("MissingResult"));
+            });
+
+            Job.JobId = Manager.EnqueueGeneration(ScriptPath, Params, EShapEJobPriority::Bulk, Delegates);
+        }
+
+        for (const int32 ItemIndex : Job.Items)
+        {
+            State->Results[ItemIndex].JobId = Job.JobId;
+        }
+        if (Job.JobId.IsEmpty())
+        {
+            FinishJob(*State, JobIndex, TEXT("The manager rejected the job."), TEXT("Rejected"));
+        }
+    }
+
+    // Single jobs in manifest order, with -batch > 1 grouping items that one batch job can carry: batch jobs have
+    // no seed or model version, and share steps, guidance and precision across their prompts
+    static TArray<FJobRun> PlanJobs(const FRunState& State, int32 BatchSize)
+    {
+        const FString DefaultModelVersion = FShapEGenerationParameters().ModelVersion;
+        TArray<FJobRun> Jobs;
+        TMap<FString, int32> OpenBatches;
+        for (int32 Index = 0; Index < State.Items.Num(); ++Index)
+        {
+            if (State.Results[Index].Status == EItemStatus::Resumed)
+            {
+                continue;
+            }
+
+            const FShapEGenerationParameters& Params = State.Items[Index].Params;
+            if (BatchSize <= 1 || Params.Seed >= 0 || Params.ModelVersion != DefaultModelVersion)
+            {
+                Jobs.AddDefaulted_GetRef().Items.Add(Index);
+                continue;
+            }
+
+            const FString BatchKey = FString::Printf(TEXT("%d|%.4f|%d"), Params.KarrasSteps, Params.GuidanceScale, Params.bUseFP16 ? 1 : 0);
+            int32* JobIndex = OpenBatches.Find(BatchKey);
+            if (!JobIndex || Jobs[*JobIndex].Items.Num() >= BatchSize)
+            {
+                JobIndex = &OpenBatches.Add(BatchKey, Jobs.AddDefaulted());
+            }
+            Jobs[*JobIndex].Items.Add(Index);
+        }
+
+        // a group that stayed at one prompt runs as a plain job, which also names its files after the id
+        for (FJobRun& Job : Jobs)
+        {
+            Job.bBatch = Job.Items.Num() > 1;
+        }
+        return Jobs;
+    }
+
+    static void Pump(double& LastTickTime, float TickSeconds)
+    {
+        const double Now = FPlatformTime::Seconds();
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        FTSTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTickTime));
+        LastTickTime = Now;
+        FPlatformProcess::Sleep(TickSeconds);
+    }
+}
+
+UShapEMassGenerateCommandlet::UShapEMassGenerateCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+int32 UShapEMassGenerateCommandlet::Main(const FString& Params)
+{
+    using namespace ShapEMassGenerateCommandlet;
+
+    FString ManifestPath;
+    FString OutputDirectory;
+    FString ReportPath;
+    FString PackagePath = TEXT("/Game/ShapE");
+    FString BackendName = TEXT("process");
+    FString WorkerArguments;
+    FString ScriptPath = GetDefaultScriptPath();
+    int32 NumWorkers = 1;
+    int32 Concurrency = 0;
+    int32 BatchSize = 1;
+    float ItemTimeoutSeconds = 0.0f;
+    float TimeoutSeconds = 0.0f;
+    float TickMs = 5.0f;
+
+    FParse::Value(*Params, TEXT("manifest="), ManifestPath);
+    FParse::Value(*Params, TEXT("output="), OutputDirectory);
+    FParse::Value(*Params, TEXT("report="), ReportPath);
+    FParse::Value(*Params, TEXT("package="), PackagePath);
+    FParse::Value(*Params, TEXT("backend="), BackendName);
+    FParse::Value(*Params, TEXT("worker-args="), WorkerArguments, false);
+    FParse::Value(*Params, TEXT("script="), ScriptPath);
+    FParse::Value(*Params, TEXT("workers="), NumWorkers);
+    FParse::Value(*Params, TEXT("concurrency="), Concurrency);
+    FParse::Value(*Params, TEXT("batch="), BatchSize);
+    FParse::Value(*Params, TEXT("item-timeout="), ItemTimeoutSeconds);
+    FParse::Value(*Params, TEXT("timeout="), TimeoutSeconds);
+    FParse::Value(*Params, TEXT("tick-ms="), TickMs);
+
+    if (ManifestPath.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: -manifest=<json|csv> is required"));
+        return 1;
+    }
+    ManifestPath = FPaths::ConvertRelativePathToFull(ManifestPath);
+    NumWorkers = FMath::Max(1, NumWorkers);
+    // one job waiting behind every busy worker keeps them fed
+    Concurrency = Concurrency > 0 ? Concurrency : NumWorkers + 1;
+    BatchSize = FMath::Clamp(BatchSize, 1, 64);
+
+    const bool bMockBackend = BackendName.Equals(TEXT("mock"), ESearchCase::IgnoreCase);
+    const bool bDirectBackend = BackendName.Equals(TEXT("direct"), ESearchCase::IgnoreCase);
+    if (!bMockBackend && !FPaths::FileExists(ScriptPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: Worker script not found: %s"), *ScriptPath);
+        return 1;
+    }
+
+    TSharedRef<FRunState> State = MakeShared<FRunState>();
+    FManifestItem Defaults;
+    Defaults.PackagePath = PackagePath;
+    FString Error;
+    if (!LoadManifest(ManifestPath, Defaults, State->Items, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: %s: %s"), *ManifestPath, *Error);
+        return 1;
+    }
+
+    State->Results.SetNum(State->Items.Num());
+    State->ManifestPath = ManifestPath;
+    State->OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDirectory.IsEmpty()
+        ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapEMassGenerate"), FPaths::GetBaseFilename(ManifestPath))
+        : OutputDirectory);
+    State->ReportPath = FPaths::ConvertRelativePathToFull(ReportPath.IsEmpty() ? FPaths::Combine(State->OutputDirectory, TEXT("mass_generate_report.json")) : ReportPath);
+    State->bImport = !FParse::Param(*Params, TEXT("noimport"));
+    State->bUseCache = !FParse::Param(*Params, TEXT("nocache"));
+    State->bSaveLatents = FParse::Param(*Params, TEXT("latents"));
+    State->ItemTimeoutSeconds = FMath::Max(0.0f, ItemTimeoutSeconds);
+    State->Concurrency = Concurrency;
+    State->BatchSize = BatchSize;
+    State->StartedAt = FDateTime::UtcNow().ToIso8601();
+    State->StartTime = FPlatformTime::Seconds();
+    IFileManager::Get().MakeDirectory(*State->OutputDirectory, true);
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(State->ReportPath), true);
+
+    const int32 NumResumed = FParse::Param(*Params, TEXT("restart")) ? 0 : LoadPreviousRun(*State);
+    State->Jobs = PlanJobs(*State, BatchSize);
+    State->ItemsToRun = State->Items.Num() - NumResumed;
+
+    TSharedPtr<FShapEProcessManager> ManagerPtr;
+    FShapEDirectLaunchSettings DirectSettings;
+    if (NumWorkers > 1)
+    {
+        FShapEWorkerPoolSettings PoolSettings;
+        PoolSettings.NumWorkers = NumWorkers;
+        if (bMockBackend)
+        {
+            PoolSettings.MakeWorker = [](int32 WorkerIndex) -> TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>
+            {
+                return MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(FShapEMockBackendSettings());
+            };
+        }
+        else if (bDirectBackend)
+        {
+            PoolSettings.MakeWorker = [DirectSettings](int32 WorkerIndex) -> TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>
+            {
+                return MakeShared<FShapEDirectLaunchBackend, ESPMode::ThreadSafe>(DirectSettings);
+            };
+        }
+        ManagerPtr = MakeShared<FShapEProcessManager>(MakeShared<FShapEWorkerPoolBackend, ESPMode::ThreadSafe>(PoolSettings));
+    }
+    else if (bMockBackend)
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>(MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(FShapEMockBackendSettings()));
+    }
+    else if (bDirectBackend)
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>(MakeShared<FShapEDirectLaunchBackend, ESPMode::ThreadSafe>(DirectSettings));
+    }
+    else
+    {
+        ManagerPtr = MakeShared<FShapEProcessManager>();
+    }
+    if (!bMockBackend && !WorkerArguments.IsEmpty())
+    {
+        ManagerPtr->SetWorkerArguments(WorkerArguments);
+    }
+    TSharedRef<FShapEProcessManager> Manager = ManagerPtr.ToSharedRef();
+    State->Manager = Manager;
+    State->BackendName = Manager->GetBackend()->GetName();
+
+    UE_LOG(LogTemp, Display, TEXT("ShapEMassGenerateCommandlet: %d items (%d done in an earlier run) in %d jobs, concurrency %d, batch %d, %s backend, %d workers, output %s"),
+        State->Items.Num(), NumResumed, State->Jobs.Num(), Concurrency, BatchSize, *State->BackendName, NumWorkers, *State->OutputDirectory);
+    WriteReport(*State);
+
+    const float TickSeconds = FMath::Max(0.0f, TickMs) / 1000.0f;
+    const double Deadline = TimeoutSeconds > 0.0f ? State->StartTime + TimeoutSeconds : 0.0;
+    double LastTickTime = FPlatformTime::Seconds();
+    bool bTimedOut = false;
+    int32 NextJob = 0;
+    while (NextJob < State->Jobs.Num() || State->JobsInFlight > 0)
+    {
+        while (NextJob < State->Jobs.Num() && State->JobsInFlight < Concurrency)
+        {
+            SubmitJob(*Manager, ScriptPath, State, NextJob++);
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        if (Deadline > 0.0 && Now > Deadline)
+        {
+            bTimedOut = true;
+            break;
+        }
+        for (int32 JobIndex = 0; JobIndex < NextJob; ++JobIndex)
+        {
+            FJobRun& Job = State->Jobs[JobIndex];
+            if (!Job.bFinished && !Job.bTimedOut && Job.Deadline > 0.0 && Now > Job.Deadline)
+            {
+                // reported as a timeout by the error handler once the cancel lands
+                Job.bTimedOut = true;
+                UE_LOG(LogTemp, Warning, TEXT("ShapEMassGenerateCommandlet: Cancelling job %s, over its %.0f s"), *Job.JobId, Job.Deadline - Job.SubmitTime);
+                Manager->CancelJob(Job.JobId);
+            }
+        }
+
+        Pump(LastTickTime, TickSeconds);
+        if (State->ImportsSinceGarbageCollection >= ImportsPerGarbageCollection)
+        {
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+            State->ImportsSinceGarbageCollection = 0;
+        }
+    }
+
+    if (bTimedOut)
+    {
+        // items that never started stay pending, so the next run picks them up
+        UE_LOG(LogTemp, Error, TEXT("ShapEMassGenerateCommandlet: Timed out after %.0f s; cancelling %d jobs"), TimeoutSeconds, State->JobsInFlight);
+        for (FJobRun& Job : State->Jobs)
+        {
+            if (Job.bSubmitted && !Job.bFinished)
+            {
+                Job.bTimedOut = true;
+                Manager->CancelJob(Job.JobId);
+            }
+        }
+        const double GraceDeadline = FPlatformTime::Seconds() + 30.0;
+        while (State->JobsInFlight > 0 && FPlatformTime::Seconds() < GraceDeadline)
+        {
+            Pump(LastTickTime, TickSeconds);
+        }
+    }
+    Manager->StopWorker();
+    WriteReport(*State);
+
+    int32 NumSucceeded = 0;
+    int32 NumFailed = 0;
+    for (const FItemResult& Result : State->Results)
+    {
+        NumSucceeded += Result.Status == EItemStatus::Succeeded;
+        NumFailed += Result.Status == EItemStatus::Failed;
+    }
+    const double RunSeconds = FPlatformTime::Seconds() - State->StartTime;
+    UE_LOG(LogTemp, Display, TEXT("ShapEMassGenerateCommandlet: %d succeeded, %d failed, %d resumed, %d not run in %.1f s (%.1f items/hour); report %s"),
+        NumSucceeded, NumFailed, NumResumed, State->ItemsToRun - NumSucceeded - NumFailed, RunSeconds,
+        RunSeconds > 0.0 ? (NumSucceeded + NumFailed) * 3600.0 / RunSeconds : 0.0, *State->ReportPath);
+
+    return (NumFailed > 0 || bTimedOut) ? 1 : 0;
+}
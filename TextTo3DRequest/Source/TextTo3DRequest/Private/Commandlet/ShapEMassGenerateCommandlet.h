@@ -0,0 +1,40 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShapEMassGenerateCommandlet.generated.h"
+
+/**
+ * Headless mass generation: runs every prompt of a manifest through FShapEProcessManager and imports the
+ * results as saved static mesh assets, without any Slate UI.
+ *
+ * UnrealEditor-Cmd <Project> -run=ShapEMassGenerate -manifest=<json|csv> [-output=<dir>] [-report=<json>]
+ *     [-package=/Game/ShapE] [-concurrency=<jobs>] [-batch=1] [-backend=process|direct|mock] [-workers=1]
+ *     [-worker-args="<extra worker flags>"] [-item-timeout=0] [-timeout=0] [-tick-ms=5] [-script=<path to ue_shape_interface.py>]
+ *     [-restart] [-noimport] [-nocache] [-latents]
+ *
+ * The manifest is a CSV file with a header row, or JSON: an array of items (or bare prompts), or an object with
+ * "items" and "defaults" applied to every item. Keys: id, prompt (required), package_path, asset_name,
+ * karras_steps, guidance_scale, seed, use_fp16, model_version, lods ("8000,2000,500") and nanite; keys starting
+ * with "_" are ignored. Ids default to the prompt and name the output files; assets default to SM_<id>.
+ *
+ * Up to -concurrency jobs (one more than -workers by default) are queued with the manager at Bulk priority.
+ * -batch=N groups up to N unseeded items with the default model and the same steps, guidance and precision into
+ * one batch job; its meshes are written under <output>/batches and moved to <output>/<id>.ply. -item-timeout
+ * cancels a job that runs longer than that many seconds per item it holds.
+ * The report (default <output>/mass_generate_report.json) is rewritten after every item with its status,
+ * timing per stage, import time and error. Running again with the same report resumes: items that succeeded
+ * before are skipped and the rest are retried, unless -restart is given. Returns 1 if an item failed or the run
+ * timed out.
+ */
+UCLASS()
+class UShapEMassGenerateCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UShapEMassGenerateCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,753 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Import/FShapEPlyImporter.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Import/FShapESharedMemoryView.h"
+#include "Processing/FShapEMeshCleanup.h"
+#include "Processing/FShapEMeshDecimator.h"
+#include "Manager/ShapETrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#if WITH_EDITOR
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "AssetToolsModule.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/Package.h"
+#endif
+
+namespace
+{
+    // Header lines are short; the whole header of a Shap-E file is a few hundred bytes
+    constexpr int64 MaxHeaderBytes = 64 * 1024;
+    constexpr int32 MaxTokensPerLine = 8;
+
+    enum class EPlyElement : uint8
+    {
+        Vertex,
+        Face,
+        Other
+    };
+
+    struct FPlyElementInfo
+    {
+        EPlyElement Kind = EPlyElement::Other;
+        int64 Count = 0;
+        int32 FixedBytes = 0;
+        bool bHasList = false;
+    };
+
+    int32 Tokenize(FAnsiStringView Line, FAnsiStringView (&OutTokens)[MaxTokensPerLine])
+    {
+        int32 NumTokens = 0;
+        int32 Index = 0;
+        while (Index < Line.Len() && NumTokens < MaxTokensPerLine)
+        {
+            while (Index < Line.Len() && (Line[Index] == ' ' || Line[Index] == '\t'))
+            {
+                ++Index;
+            }
+            const int32 Start = Index;
+            while (Index < Line.Len() && Line[Index] != ' ' && Line[Index] != '\t')
+            {
+                ++Index;
+            }
+            if (Index > Start)
+            {
+                OutTokens[NumTokens++] = Line.Mid(Start, Index - Start);
+            }
+        }
+        return NumTokens;
+    }
+
+    bool ParseCount(FAnsiStringView Token, int64& OutCount)
+    {
+        OutCount = 0;
+        for (const ANSICHAR Char : Token)
+        {
+            if (Char < '0' || Char > '9')
+            {
+                return false;
+            }
+            OutCount = OutCount * 10 + (Char - '0');
+            if (OutCount > MAX_int32)
+            {
+                return false;
+            }
+        }
+        return !Token.IsEmpty();
+    }
+
+    EShapEPlyScalar ParseScalarType(FAnsiStringView Token)
+    {
+        if (Token == "uchar" || Token == "uint8") return EShapEPlyScalar::UInt8;
+        if (Token == "char" || Token == "int8") return EShapEPlyScalar::Int8;
+        if (Token == "ushort" || Token == "uint16") return EShapEPlyScalar::UInt16;
+        if (Token == "short" || Token == "int16") return EShapEPlyScalar::Int16;
+        if (Token == "uint" || Token == "uint32") return EShapEPlyScalar::UInt32;
+        if (Token == "int" || Token == "int32") return EShapEPlyScalar::Int32;
+        if (Token == "float" || Token == "float32") return EShapEPlyScalar::Float32;
+        if (Token == "double" || Token == "float64") return EShapEPlyScalar::Float64;
+        return EShapEPlyScalar::None;
+    }
+
+    FORCEINLINE double ReadScalar(const uint8* Ptr, EShapEPlyScalar Type)
+    {
+        // little-endian files on little-endian hosts; memcpy keeps unaligned reads legal
+        switch (Type)
+        {
+        case EShapEPlyScalar::Int8: { int8 V; FMemory::Memcpy(&V, Ptr, 1); return V; }
+        case EShapEPlyScalar::UInt8: return *Ptr;
+        case EShapEPlyScalar::Int16: { int16 V; FMemory::Memcpy(&V, Ptr, 2); return V; }
+        case EShapEPlyScalar::UInt16: { uint16 V; FMemory::Memcpy(&V, Ptr, 2); return V; }
+        case EShapEPlyScalar::Int32: { int32 V; FMemory::Memcpy(&V, Ptr, 4); return V; }
+        case EShapEPlyScalar::UInt32: { uint32 V; FMemory::Memcpy(&V, Ptr, 4); return V; }
+        case EShapEPlyScalar::Float32: { float V; FMemory::Memcpy(&V, Ptr, 4); return V; }
+        case EShapEPlyScalar::Float64: { double V; FMemory::Memcpy(&V, Ptr, 8); return V; }
+        default: return 0.0;
+        }
+    }
+
+    FORCEINLINE int64 ReadInteger(const uint8* Ptr, EShapEPlyScalar Type)
+    {
+        switch (Type)
+        {
+        case EShapEPlyScalar::UInt8: return *Ptr;
+        case EShapEPlyScalar::Int32: { int32 V; FMemory::Memcpy(&V, Ptr, 4); return V; }
+        case EShapEPlyScalar::UInt32: { uint32 V; FMemory::Memcpy(&V, Ptr, 4); return V; }
+        default: return (int64)ReadScalar(Ptr, Type);
+        }
+    }
+
+    // Normalizes a color channel to 0..1 and converts it to linear space
+    FORCEINLINE float ReadColorChannel(const uint8* Ptr, EShapEPlyScalar Type)
+    {
+        switch (Type)
+        {
+        case EShapEPlyScalar::UInt8: return FLinearColor::sRGBToLinearTable[*Ptr];
+        case EShapEPlyScalar::UInt16: return FMath::Pow((float)ReadScalar(Ptr, Type) / 65535.0f, 2.2f);
+        case EShapEPlyScalar::Float32:
+        case EShapEPlyScalar::Float64: return FMath::Pow(FMath::Clamp((float)ReadScalar(Ptr, Type), 0.0f, 1.0f), 2.2f);
+        default: return 1.0f;
+        }
+    }
+
+    // One source of vertex attributes; PLY interleaves positions and colors, shared memory keeps them in separate arrays
+    struct FVertexStreams
+    {
+        const uint8* Positions = nullptr;
+        int32 PositionStride = 0;
+        const int32* PositionOffsets = nullptr;
+        const EShapEPlyScalar* PositionTypes = nullptr;
+
+        const uint8* Colors = nullptr;
+        int32 ColorStride = 0;
+        const int32* ColorOffsets = nullptr;
+        const EShapEPlyScalar* ColorTypes = nullptr;
+    };
+
+    struct FMeshWriter
+    {
+        FMeshDescription& Mesh;
+        FStaticMeshAttributes Attributes;
+        TVertexAttributesRef<FVector3f> Positions;
+        TVertexInstanceAttributesRef<FVector4f> Colors;
+        FPolygonGroupID PolygonGroup;
+        const FShapEPlyImportOptions& Options;
+
+        FMeshWriter(FMeshDescription& InMesh, int32 NumVertices, int32 NumTriangles, const FShapEPlyImportOptions& InOptions)
+            : Mesh(InMesh)
+            , Attributes(InMesh)
+            , Options(InOptions)
+        {
+            Mesh.Empty();
+            Attributes.Register();
+
+            Mesh.ReserveNewVertices(NumVertices);
+            Mesh.ReserveNewVertexInstances(NumVertices);
+            Mesh.ReserveNewTriangles(NumTriangles);
+            Mesh.ReserveNewPolygons(NumTriangles);
+            Mesh.ReserveNewEdges(NumTriangles * 3 / 2 + 1);
+
+            Positions = Attributes.GetVertexPositions();
+            Colors = Attributes.GetVertexInstanceColors();
+            PolygonGroup = Mesh.CreatePolygonGroup();
+            Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = Options.MaterialSlotName;
+        }
+
+        // one vertex instance per vertex, shared by every triangle using it; ids are dense from zero on an empty mesh
+        void AddVertices(int32 NumVertices, const FVertexStreams& Streams)
+        {
+            const float Scale = Options.Scale;
+            const float YSign = Options.bConvertHandedness ? -1.0f : 1.0f;
+            const bool bFloatPositions = Streams.PositionTypes[0] == EShapEPlyScalar::Float32 && Streams.PositionTypes[1] == EShapEPlyScalar::Float32 && Streams.PositionTypes[2] == EShapEPlyScalar::Float32;
+
+            const uint8* PositionCursor = Streams.Positions;
+            const uint8* ColorCursor = Streams.Colors;
+            for (int32 Index = 0; Index < NumVertices; ++Index, PositionCursor += Streams.PositionStride)
+            {
+                FVector3f Position;
+                if (bFloatPositions)
+                {
+                    FMemory::Memcpy(&Position.X, PositionCursor + Streams.PositionOffsets[0], sizeof(float));
+                    FMemory::Memcpy(&Position.Y, PositionCursor + Streams.PositionOffsets[1], sizeof(float));
+                    FMemory::Memcpy(&Position.Z, PositionCursor + Streams.PositionOffsets[2], sizeof(float));
+                }
+                else
+                {
+                    Position.X = (float)ReadScalar(PositionCursor + Streams.PositionOffsets[0], Streams.PositionTypes[0]);
+                    Position.Y = (float)ReadScalar(PositionCursor + Streams.PositionOffsets[1], Streams.PositionTypes[1]);
+                    Position.Z = (float)ReadScalar(PositionCursor + Streams.PositionOffsets[2], Streams.PositionTypes[2]);
+                }
+
+                const FVertexID VertexID = Mesh.CreateVertex();
+                Positions[VertexID] = FVector3f(Position.X * Scale, Position.Y * Scale * YSign, Position.Z * Scale);
+
+                const FVertexInstanceID InstanceID = Mesh.CreateVertexInstance(VertexID);
+                if (ColorCursor)
+                {
+                    Colors[InstanceID] = FVector4f(
+                        ReadColorChannel(ColorCursor + Streams.ColorOffsets[0], Streams.ColorTypes[0]),
+                        ReadColorChannel(ColorCursor + Streams.ColorOffsets[1], Streams.ColorTypes[1]),
+                        ReadColorChannel(ColorCursor + Streams.ColorOffsets[2], Streams.ColorTypes[2]),
+                        1.0f);
+                    ColorCursor += Streams.ColorStride;
+                }
+            }
+        }
+
+        // False for out-of-range or degenerate corners
+        bool AddTriangle(int64 First, int64 Second, int64 Third, int32 NumVertices)
+        {
+            if (First < 0 || Second < 0 || Third < 0 || First >= NumVertices || Second >= NumVertices || Third >= NumVertices
+                || First == Second || Second == Third || First == Third)
+            {
+                return false;
+            }
+
+            FVertexInstanceID Corners[3];
+            Corners[0] = FVertexInstanceID((int32)First);
+            // mirroring one axis flips the winding, so swap two corners to keep faces pointing outwards
+            Corners[1] = FVertexInstanceID((int32)(Options.bConvertHandedness ? Third : Second));
+            Corners[2] = FVertexInstanceID((int32)(Options.bConvertHandedness ? Second : Third));
+            Mesh.CreateTriangle(PolygonGroup, MakeArrayView(Corners, 3));
+            return true;
+        }
+    };
+
+    void SetProperty(FShapEPlyLayout& Layout, FAnsiStringView Name, int32 Offset, EShapEPlyScalar Type)
+    {
+        static const FAnsiStringView PositionNames[3] = { "x", "y", "z" };
+        static const FAnsiStringView ColorNames[3] = { "red", "green", "blue" };
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            if (Name == PositionNames[Axis])
+            {
+                Layout.PositionOffsets[Axis] = Offset;
+                Layout.PositionTypes[Axis] = Type;
+            }
+            else if (Name == ColorNames[Axis] || (Axis == 0 && Name == "r") || (Axis == 1 && Name == "g") || (Axis == 2 && Name == "b"))
+            {
+                Layout.ColorOffsets[Axis] = Offset;
+                Layout.ColorTypes[Axis] = Type;
+            }
+        }
+    }
+}
+
+FShapEPlyImportOptions FShapEPlyImportOptions::FromGenerationParameters(const FShapEGenerationParameters& Params)
+{
+    FShapEPlyImportOptions Options;
+    Options.LODTriangleBudgets = Params.LODTriangleBudgets;
+    Options.bEnableNanite = Params.bEnableNanite;
+    return Options;
+}
+
+int32 FShapEPlyImporter::GetScalarSize(EShapEPlyScalar Type)
+{
+    switch (Type)
+    {
+    case EShapEPlyScalar::Int8:
+    case EShapEPlyScalar::UInt8: return 1;
+    case EShapEPlyScalar::Int16:
+    case EShapEPlyScalar::UInt16: return 2;
+    case EShapEPlyScalar::Int32:
+    case EShapEPlyScalar::UInt32:
+    case EShapEPlyScalar::Float32: return 4;
+    case EShapEPlyScalar::Float64: return 8;
+    default: return 0;
+    }
+}
+
+bool FShapEPlyImporter::ParseLayout(const uint8* Data, int64 Size, FShapEPlyLayout& OutLayout, FString& OutError)
+{
+    OutLayout = FShapEPlyLayout();
+
+    const int64 HeaderLimit = FMath::Min(Size, MaxHeaderBytes);
+    const ANSICHAR* Text = reinterpret_cast<const ANSICHAR*>(Data);
+
+    TArray<FPlyElementInfo, TInlineAllocator<4>> Elements;
+    bool bSawMagic = false;
+    bool bSawFormat = false;
+    int64 HeaderEnd = INDEX_NONE;
+
+    int64 LineStart = 0;
+    while (LineStart < HeaderLimit && HeaderEnd == INDEX_NONE)
+    {
+        int64 LineEnd = LineStart;
+        while (LineEnd < HeaderLimit && Text[LineEnd] != '\n')
+        {
+            ++LineEnd;
+        }
+        if (LineEnd == HeaderLimit)
+        {
+            break;
+        }
+
+        int64 ContentEnd = LineEnd;
+        if (ContentEnd > LineStart && Text[ContentEnd - 1] == '\r')
+        {
+            --ContentEnd;
+        }
+        const FAnsiStringView Line(Text + LineStart, (int32)(ContentEnd - LineStart));
+        LineStart = LineEnd + 1;
+
+        FAnsiStringView Tokens[MaxTokensPerLine];
+        const int32 NumTokens = Tokenize(Line, Tokens);
+        if (NumTokens == 0)
+        {
+            continue;
+        }
+
+        if (!bSawMagic)
+        {
+            if (Tokens[0] != "ply")
+            {
+                OutError = TEXT("Not a PLY file.");
+                return false;
+            }
+            bSawMagic = true;
+        }
+        else if (Tokens[0] == "format")
+        {
+            if (NumTokens < 2 || Tokens[1] != "binary_little_endian")
+            {
+                OutError = FString::Printf(TEXT("Unsupported PLY format '%s'; only binary_little_endian is supported."), NumTokens > 1 ? *FString(Tokens[1].Len(), Tokens[1].GetData()) : TEXT(""));
+                return false;
+            }
+            bSawFormat = true;
+        }
+        else if (Tokens[0] == "element" && NumTokens >= 3)
+        {
+            FPlyElementInfo& Element = Elements.AddDefaulted_GetRef();
+            Element.Kind = Tokens[1] == "vertex" ? EPlyElement::Vertex : (Tokens[1] == "face" ? EPlyElement::Face : EPlyElement::Other);
+            if (!ParseCount(Tokens[2], Element.Count))
+            {
+                OutError = TEXT("PLY element count out of range.");
+                return false;
+            }
+        }
+        else if (Tokens[0] == "property" && NumTokens >= 3)
+        {
+            if (Elements.IsEmpty())
+            {
+                OutError = TEXT("PLY property declared before any element.");
+                return false;
+            }
+            FPlyElementInfo& Element = Elements.Last();
+
+            if (Tokens[1] == "list")
+            {
+                if (NumTokens < 5 || Element.bHasList || Element.Kind != EPlyElement::Face)
+                {
+                    OutError = TEXT("PLY list properties are only supported as the face index list.");
+                    return false;
+                }
+                OutLayout.FaceCountType = ParseScalarType(Tokens[2]);
+                OutLayout.FaceIndexType = ParseScalarType(Tokens[3]);
+                if (OutLayout.FaceCountType == EShapEPlyScalar::None || OutLayout.FaceIndexType == EShapEPlyScalar::None
+                    || OutLayout.FaceCountType == EShapEPlyScalar::Float32 || OutLayout.FaceCountType == EShapEPlyScalar::Float64
+                    || OutLayout.FaceIndexType == EShapEPlyScalar::Float32 || OutLayout.FaceIndexType == EShapEPlyScalar::Float64)
+                {
+                    OutError = TEXT("PLY face list uses an unsupported type.");
+                    return false;
+                }
+                OutLayout.FacePrefixBytes = Element.FixedBytes;
+                Element.bHasList = true;
+                continue;
+            }
+
+            const EShapEPlyScalar Type = ParseScalarType(Tokens[1]);
+            if (Type == EShapEPlyScalar::None)
+            {
+                OutError = TEXT("PLY property has an unknown type.");
+                return false;
+            }
+            if (Element.Kind == EPlyElement::Vertex)
+            {
+                SetProperty(OutLayout, Tokens[2], Element.FixedBytes, Type);
+            }
+            else if (Element.Kind == EPlyElement::Face && Element.bHasList)
+            {
+                OutLayout.FaceSuffixBytes += GetScalarSize(Type);
+            }
+            Element.FixedBytes += GetScalarSize(Type);
+        }
+        else if (Tokens[0] == "end_header")
+        {
+            HeaderEnd = LineStart;
+        }
+    }
+
+    if (!bSawMagic || !bSawFormat || HeaderEnd == INDEX_NONE)
+    {
+        OutError = TEXT("PLY header is incomplete.");
+        return false;
+    }
+
+    // lay the element blocks out in declaration order; only the face list has a variable size
+    int64 Offset = HeaderEnd;
+    bool bFoundVertices = false;
+    bool bFoundFaces = false;
+    for (const FPlyElementInfo& Element : Elements)
+    {
+        if (Element.Kind == EPlyElement::Vertex && !bFoundVertices)
+        {
+            OutLayout.NumVertices = (int32)Element.Count;
+            OutLayout.VertexDataOffset = Offset;
+            OutLayout.VertexStride = Element.FixedBytes;
+            bFoundVertices = true;
+        }
+        else if (Element.Kind == EPlyElement::Face && !bFoundFaces)
+        {
+            OutLayout.NumFaces = Element.bHasList ? (int32)Element.Count : 0;
+            OutLayout.FaceDataOffset = Offset;
+            bFoundFaces = true;
+            // nothing after the faces is needed
+            break;
+        }
+        else if (Element.bHasList)
+        {
+            break;
+        }
+        Offset += Element.Count * Element.FixedBytes;
+    }
+
+    if (!bFoundVertices || OutLayout.PositionOffsets[0] == INDEX_NONE || OutLayout.PositionOffsets[1] == INDEX_NONE || OutLayout.PositionOffsets[2] == INDEX_NONE)
+    {
+        OutError = TEXT("PLY file has no vertex positions.");
+        return false;
+    }
+    if (OutLayout.VertexDataOffset + (int64)OutLayout.NumVertices * OutLayout.VertexStride > Size)
+    {
+        OutError = TEXT("PLY vertex block is truncated.");
+        return false;
+    }
+    if (!bFoundFaces && OutLayout.NumVertices > 0)
+    {
+        OutError = TEXT("PLY file has no faces.");
+        return false;
+    }
+    return true;
+}
+
+bool FShapEPlyImporter::ImportMeshDescription(const FString& PlyPath, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(ShapE_ImportPly, ShapEChannel);
+    const double StartTime = FPlatformTime::Seconds();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray64<uint8> FallbackBytes;
+
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+
+    FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*PlyPath);
+    if (!MappedResult.HasError())
+    {
+        MappedHandle = MappedResult.StealValue();
+        if (MappedHandle->GetFileSize() > 0)
+        {
+            MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+        }
+    }
+
+    if (MappedRegion.IsValid())
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else
+    {
+        // platforms without mapping support still get the in-place parser
+        if (!FFileHelper::LoadFileToArray(FallbackBytes, *PlyPath))
+        {
+            OutError = FString::Printf(TEXT("Could not open %s."), *PlyPath);
+            return false;
+        }
+        Data = FallbackBytes.GetData();
+        Size = FallbackBytes.Num();
+    }
+
+    FShapEPlyLayout Layout;
+    if (!ParseLayout(Data, Size, Layout, OutError))
+    {
+        OutError = FString::Printf(TEXT("%s: %s"), *FPaths::GetCleanFilename(PlyPath), *OutError);
+        return false;
+    }
+
+    if (!FillMeshDescription(Data, Size, Layout, OutMesh, Options, OutStats))
+    {
+        OutError = FString::Printf(TEXT("%s: face block is truncated."), *FPaths::GetCleanFilename(PlyPath));
+        return false;
+    }
+
+    if (OutStats)
+    {
+        OutStats->ParseSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+    return true;
+}
+
+bool FShapEPlyImporter::FillMeshDescription(const uint8* Data, int64 Size, const FShapEPlyLayout& Layout, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FShapEPlyImportStats* OutStats)
+{
+    const int32 NumVertices = Layout.NumVertices;
+    FMeshWriter Writer(OutMesh, NumVertices, Layout.NumFaces, Options);
+
+    FVertexStreams Streams;
+    Streams.Positions = Data + Layout.VertexDataOffset;
+    Streams.PositionStride = Layout.VertexStride;
+    Streams.PositionOffsets = Layout.PositionOffsets;
+    Streams.PositionTypes = Layout.PositionTypes;
+    if (Layout.HasColors())
+    {
+        Streams.Colors = Streams.Positions;
+        Streams.ColorStride = Layout.VertexStride;
+        Streams.ColorOffsets = Layout.ColorOffsets;
+        Streams.ColorTypes = Layout.ColorTypes;
+    }
+    Writer.AddVertices(NumVertices, Streams);
+
+    const int32 CountSize = GetScalarSize(Layout.FaceCountType);
+    const int32 IndexSize = GetScalarSize(Layout.FaceIndexType);
+    const uint8* Cursor = Data + Layout.FaceDataOffset;
+    const uint8* End = Data + Size;
+
+    int32 NumTriangles = 0;
+    int32 SkippedFaces = 0;
+    for (int32 Face = 0; Face < Layout.NumFaces; ++Face)
+    {
+        if (End - Cursor < Layout.FacePrefixBytes + CountSize)
+        {
+            return false;
+        }
+        Cursor += Layout.FacePrefixBytes;
+        const int64 Count = ReadInteger(Cursor, Layout.FaceCountType);
+        Cursor += CountSize;
+        if (Count < 0 || End - Cursor < Count * IndexSize + Layout.FaceSuffixBytes)
+        {
+            return false;
+        }
+
+        const uint8* Indices = Cursor;
+        Cursor += Count * IndexSize + Layout.FaceSuffixBytes;
+
+        // polygons are fanned around their first corner
+        const int64 First = ReadInteger(Indices, Layout.FaceIndexType);
+        bool bEmitted = false;
+        for (int64 Corner = 1; Corner + 1 < Count; ++Corner)
+        {
+            const int64 Second = ReadInteger(Indices + Corner * IndexSize, Layout.FaceIndexType);
+            const int64 Third = ReadInteger(Indices + (Corner + 1) * IndexSize, Layout.FaceIndexType);
+            if (Writer.AddTriangle(First, Second, Third, NumVertices))
+            {
+                ++NumTriangles;
+                bEmitted = true;
+            }
+        }
+        SkippedFaces += bEmitted ? 0 : 1;
+    }
+
+    if (OutStats)
+    {
+        OutStats->NumVertices = NumVertices;
+        OutStats->NumTriangles = NumTriangles;
+        OutStats->SkippedFaces = SkippedFaces;
+    }
+    return true;
+}
+
+bool FShapEPlyImporter::ImportSharedMesh(const FShapESharedMeshLayout& Layout, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(ShapE_ImportSharedMesh, ShapEChannel);
+    const double StartTime = FPlatformTime::Seconds();
+
+    FShapESharedMemoryView View;
+    if (!View.Open(Layout.SegmentName, Layout.SegmentSize, OutError) || !View.ValidateLayout(Layout, OutError))
+    {
+        return false;
+    }
+
+    static const int32 PositionOffsets[3] = { 0, 4, 8 };
+    static const EShapEPlyScalar PositionTypes[3] = { EShapEPlyScalar::Float32, EShapEPlyScalar::Float32, EShapEPlyScalar::Float32 };
+    static const int32 ColorOffsets[3] = { 0, 1, 2 };
+    static const EShapEPlyScalar ColorTypes[3] = { EShapEPlyScalar::UInt8, EShapEPlyScalar::UInt8, EShapEPlyScalar::UInt8 };
+
+    FMeshWriter Writer(OutMesh, Layout.NumVertices, Layout.NumTriangles, Options);
+
+    FVertexStreams Streams;
+    Streams.Positions = View.GetData() + Layout.PositionsOffset;
+    Streams.PositionStride = 3 * sizeof(float);
+    Streams.PositionOffsets = PositionOffsets;
+    Streams.PositionTypes = PositionTypes;
+    if (Layout.ColorsOffset != INDEX_NONE)
+    {
+        Streams.Colors = View.GetData() + Layout.ColorsOffset;
+        Streams.ColorStride = 3;
+        Streams.ColorOffsets = ColorOffsets;
+        Streams.ColorTypes = ColorTypes;
+    }
+    Writer.AddVertices(Layout.NumVertices, Streams);
+
+    int32 NumTriangles = 0;
+    const uint8* Indices = View.GetData() + Layout.IndicesOffset;
+    for (int32 Triangle = 0; Triangle < Layout.NumTriangles; ++Triangle, Indices += 3 * sizeof(int32))
+    {
+        int32 Corners[3];
+        FMemory::Memcpy(Corners, Indices, sizeof(Corners));
+        NumTriangles += Writer.AddTriangle(Corners[0], Corners[1], Corners[2], Layout.NumVertices) ? 1 : 0;
+    }
+
+    if (OutStats)
+    {
+        OutStats->NumVertices = Layout.NumVertices;
+        OutStats->NumTriangles = NumTriangles;
+        OutStats->SkippedFaces = Layout.NumTriangles - NumTriangles;
+        OutStats->ParseSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+    return true;
+}
+
+#if WITH_EDITOR
+UStaticMesh* FShapEPlyImporter::CreateStaticMesh(const FString& PlyPath, const FString& PackagePath, const FString& AssetName, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats)
+{
+    FShapEPlyImportStats Stats;
+    FMeshDescription MeshDescription;
+    if (!ImportMeshDescription(PlyPath, MeshDescription, Options, OutError, &Stats))
+    {
+        return nullptr;
+    }
+    if (Stats.NumTriangles == 0)
+    {
+        OutError = FString::Printf(TEXT("%s contains no triangles."), *FPaths::GetCleanFilename(PlyPath));
+        return nullptr;
+    }
+    return CreateStaticMesh(MoveTemp(MeshDescription), PackagePath, AssetName, Options, OutError, Stats, OutStats);
+}
+
+UStaticMesh* FShapEPlyImporter::CreateStaticMesh(FMeshDescription&& MeshDescription, const FString& PackagePath, const FString& AssetName, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats Stats, FShapEPlyImportStats* OutStats)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(ShapE_CreateStaticMesh, ShapEChannel);
+    Stats.bCleanedUp = Options.bCleanupMesh && FShapEMeshCleanup::Run(MeshDescription, Options.Cleanup, &Stats.Cleanup);
+    bool bHasNormals = Stats.bCleanedUp && Options.Cleanup.bComputeNormalsAndTangents;
+
+    // the LOD meshes are decimated before the asset exists, so nothing half-built is left behind
+    const TArray<int32> Budgets = FShapEMeshDecimator::SanitizeBudgets(Options.LODTriangleBudgets);
+    TArray<FMeshDescription> LODMeshes;
+    if (!Options.bEnableNanite && Budgets.Num() > 0)
+    {
+        FShapEMeshSoA Source;
+        FShapEMeshCleanup::ExtractSoA(MeshDescription, Source);
+        if (!Stats.bCleanedUp)
+        {
+            // the decimator needs a welded mesh; unwelded, every triangle edge would count as a boundary
+            FShapEMeshCleanupStats WeldStats;
+            FShapEMeshCleanup::WeldVertices(Source, Options.Cleanup.WeldTolerance, Options.Cleanup.bParallel);
+            FShapEMeshCleanup::RemoveDegenerateTriangles(Source, Options.Cleanup.MinTriangleArea, false, Options.Cleanup.bParallel, WeldStats);
+        }
+        TArray<FShapEMeshSoA> LODs;
+        FShapEMeshDecimator::BuildLODChain(Source, Budgets, Options.Decimation, LODs, &Stats.Decimation);
+
+        LODMeshes.SetNum(LODs.Num());
+        ParallelFor(LODs.Num(), [&](int32 LODIndex)
+        {
+            FShapEMeshCleanup::BuildMeshDescription(LODs[LODIndex], LODMeshes[LODIndex], Options.MaterialSlotName);
+        }, Options.Decimation.bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+        // the decimator computes normals and tangents for every LOD it returns
+        bHasNormals = true;
+    }
+    else
+    {
+        LODMeshes.Add(MoveTemp(MeshDescription));
+    }
+    const int32 FullTriangles = LODMeshes[0].Triangles().Num();
+
+    const double BuildStart = FPlatformTime::Seconds();
+
+    FString PackageName;
+    FString UniqueAssetName;
+    IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+    AssetTools.CreateUniqueAssetName(FPaths::Combine(PackagePath, AssetName), TEXT(""), PackageName, UniqueAssetName);
+
+    UPackage* Package = CreatePackage(*PackageName);
+    if (!Package)
+    {
+        OutError = FString::Printf(TEXT("Could not create package %s."), *PackageName);
+        return nullptr;
+    }
+
+    UStaticMesh* StaticMesh = NewObject<UStaticMesh>(Package, *UniqueAssetName, RF_Public | RF_Standalone);
+
+    // Shap-E meshes carry their look in vertex colors and have no UVs
+    UMaterialInterface* VertexColorMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Engine/EngineDebugMaterials/VertexColorMaterial.VertexColorMaterial"));
+    StaticMesh->GetStaticMaterials().Add(FStaticMaterial(VertexColorMaterial, Options.MaterialSlotName, Options.MaterialSlotName));
+
+    for (int32 LODIndex = 0; LODIndex < LODMeshes.Num(); ++LODIndex)
+    {
+        FStaticMeshSourceModel& SourceModel = StaticMesh->AddSourceModel();
+        SourceModel.BuildSettings.bRecomputeNormals = !bHasNormals;
+        SourceModel.BuildSettings.bRecomputeTangents = !bHasNormals;
+        SourceModel.BuildSettings.bGenerateLightmapUVs = false;
+
+        StaticMesh->CreateMeshDescription(LODIndex, MoveTemp(LODMeshes[LODIndex]));
+        StaticMesh->CommitMeshDescription(LODIndex);
+    }
+    // screen sizes of the decimated LODs are derived from their triangle counts
+    StaticMesh->bAutoComputeLODScreenSize = true;
+
+    if (Options.bEnableNanite)
+    {
+        FMeshNaniteSettings NaniteSettings = StaticMesh->GetNaniteSettings();
+        NaniteSettings.bEnabled = true;
+        if (Budgets.Num() > 0 && FullTriangles > 0)
+        {
+            NaniteSettings.FallbackTarget = ENaniteFallbackTarget::PercentTriangles;
+            NaniteSettings.FallbackPercentTriangles = FMath::Clamp((float)Budgets.Last() / FullTriangles, 0.0f, 1.0f);
+        }
+        StaticMesh->SetNaniteSettings(NaniteSettings);
+        Stats.bNaniteEnabled = true;
+    }
+    StaticMesh->Build(false);
+    StaticMesh->PostEditChange();
+
+    FAssetRegistryModule::AssetCreated(StaticMesh);
+    Package->MarkPackageDirty();
+
+    Stats.BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEPlyImporter: Created %s (%d vertices, %d triangles, %d LODs%s, parse %.1f ms, decimate %.1f ms, build %.1f ms)"),
+        *StaticMesh->GetPathName(), Stats.NumVertices, Stats.NumTriangles, StaticMesh->GetNumSourceModels(), Stats.bNaniteEnabled ? TEXT(", Nanite") : TEXT(""),
+        Stats.ParseSeconds * 1000.0, Stats.Decimation.TotalSeconds * 1000.0, Stats.BuildSeconds * 1000.0);
+    return StaticMesh;
+}
+#endif
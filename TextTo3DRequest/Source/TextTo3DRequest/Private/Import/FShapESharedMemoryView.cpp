@@ -0,0 +1,119 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Import/FShapESharedMemoryView.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+FShapESharedMemoryView::~FShapESharedMemoryView()
+{
+    Close();
+}
+
+bool FShapESharedMemoryView::Open(const FString& SegmentName, int64 Size, FString& OutError)
+{
+    Close();
+
+    if (SegmentName.IsEmpty() || Size <= 0)
+    {
+        OutError = TEXT("Shared mesh segment name or size is missing.");
+        return false;
+    }
+
+#if PLATFORM_WINDOWS
+    HANDLE Mapping = ::OpenFileMappingW(FILE_MAP_READ, 0, *SegmentName);
+    if (!Mapping)
+    {
+        OutError = FString::Printf(TEXT("Could not open shared memory '%s' (error %u)."), *SegmentName, ::GetLastError());
+        return false;
+    }
+
+    void* View = ::MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(Size));
+    if (!View)
+    {
+        OutError = FString::Printf(TEXT("Could not map shared memory '%s' (error %u)."), *SegmentName, ::GetLastError());
+        ::CloseHandle(Mapping);
+        return false;
+    }
+
+    MappingHandle = Mapping;
+    MappedData = View;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+    // Python prefixes POSIX segment names with '/' and reports them without it
+    const FString PosixName = SegmentName.StartsWith(TEXT("/")) ? SegmentName : TEXT("/") + SegmentName;
+    const int Fd = shm_open(TCHAR_TO_UTF8(*PosixName), O_RDONLY, 0);
+    if (Fd < 0)
+    {
+        OutError = FString::Printf(TEXT("Could not open shared memory '%s' (errno %d)."), *PosixName, errno);
+        return false;
+    }
+
+    struct stat Info;
+    if (fstat(Fd, &Info) != 0 || Info.st_size < Size)
+    {
+        OutError = FString::Printf(TEXT("Shared memory '%s' is smaller than announced."), *PosixName);
+        close(Fd);
+        return false;
+    }
+
+    void* View = mmap(nullptr, static_cast<size_t>(Size), PROT_READ, MAP_SHARED, Fd, 0);
+    close(Fd);
+    if (View == MAP_FAILED)
+    {
+        OutError = FString::Printf(TEXT("Could not map shared memory '%s' (errno %d)."), *PosixName, errno);
+        return false;
+    }
+
+    MappedData = View;
+#else
+    OutError = TEXT("Shared memory transport is not supported on this platform.");
+    return false;
+#endif
+
+    MappedSize = Size;
+    return true;
+}
+
+void FShapESharedMemoryView::Close()
+{
+    if (!MappedData)
+    {
+        return;
+    }
+
+#if PLATFORM_WINDOWS
+    ::UnmapViewOfFile(MappedData);
+    ::CloseHandle(static_cast<HANDLE>(MappingHandle));
+    MappingHandle = nullptr;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+    munmap(MappedData, static_cast<size_t>(MappedSize));
+#endif
+
+    MappedData = nullptr;
+    MappedSize = 0;
+}
+
+bool FShapESharedMemoryView::ValidateLayout(const FShapESharedMeshLayout& Layout, FString& OutError) const
+{
+    auto Fits = [this](int64 Offset, int64 Bytes)
+    {
+        return Offset >= 0 && Bytes >= 0 && Offset <= MappedSize && Bytes <= MappedSize - Offset;
+    };
+
+    if (Layout.NumVertices < 0 || Layout.NumTriangles < 0
+        || !Fits(Layout.PositionsOffset, (int64)Layout.NumVertices * 3 * sizeof(float))
+        || (Layout.ColorsOffset != INDEX_NONE && !Fits(Layout.ColorsOffset, (int64)Layout.NumVertices * 3))
+        || !Fits(Layout.IndicesOffset, (int64)Layout.NumTriangles * 3 * sizeof(int32)))
+    {
+        OutError = FString::Printf(TEXT("Shared mesh layout does not fit in segment '%s'."), *Layout.SegmentName);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/FShapEJobQueue.h"
+
+void FShapEJobQueue::Enqueue(const TSharedRef<FShapEJob>& Job)
+{
+    Queues[static_cast<int32>(Job->Priority)].Add(Job);
+}
+
+void FShapEJobQueue::EnqueueFront(const TSharedRef<FShapEJob>& Job)
+{
+    Queues[static_cast<int32>(Job->Priority)].Insert(Job, 0);
+}
+
+TSharedPtr<FShapEJob> FShapEJobQueue::Dequeue()
+{
+    for (TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        if (Queue.Num() > 0)
+        {
+            TSharedRef<FShapEJob> Job = Queue[0];
+            Queue.RemoveAt(0);
+            return Job;
+        }
+    }
+    return nullptr;
+}
+
+TSharedPtr<FShapEJob> FShapEJobQueue::Remove(const FString& JobId)
+{
+    for (TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        const int32 Index = Queue.IndexOfByPredicate([&JobId](const TSharedRef<FShapEJob>& Job) { return Job->JobId == JobId; });
+        if (Index != INDEX_NONE)
+        {
+            TSharedRef<FShapEJob> Job = Queue[Index];
+            Queue.RemoveAt(Index);
+            return Job;
+        }
+    }
+    return nullptr;
+}
+
+TSharedPtr<FShapEJob> FShapEJobQueue::Find(const FString& JobId) const
+{
+    for (const TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        if (const TSharedRef<FShapEJob>* Job = Queue.FindByPredicate([&JobId](const TSharedRef<FShapEJob>& Candidate) { return Candidate->JobId == JobId; }))
+        {
+            return *Job;
+        }
+    }
+    return nullptr;
+}
+
+void FShapEJobQueue::Empty(TArray<TSharedRef<FShapEJob>>& OutJobs)
+{
+    for (TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        OutJobs.Append(Queue);
+        Queue.Reset();
+    }
+}
+
+int32 FShapEJobQueue::Num() const
+{
+    int32 Total = 0;
+    for (const TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        Total += Queue.Num();
+    }
+    return Total;
+}
+
+double FShapEJobQueue::GetOldestWaitSeconds(double Now) const
+{
+    double OldestWait = 0.0;
+    for (const TArray<TSharedRef<FShapEJob>>& Queue : Queues)
+    {
+        for (const TSharedRef<FShapEJob>& Job : Queue)
+        {
+            OldestWait = FMath::Max(OldestWait, Now - Job->EnqueueTime);
+        }
+    }
+    return OldestWait;
+}
@@ -0,0 +1,73 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/FShapELineFramer.h"
+
+FShapELineFramer::FShapELineFramer(int32 InitialCapacity)
+{
+    Buffer.Reserve(InitialCapacity);
+}
+
+void FShapELineFramer::Append(const uint8* Data, int32 Length, FRecordFunc OnRecord)
+{
+    if (Length <= 0)
+    {
+        return;
+    }
+
+    // Drop the consumed prefix before growing, so the buffer only ever holds one partial record
+    if (ConsumedBytes > 0)
+    {
+        Buffer.RemoveAt(0, ConsumedBytes, EAllowShrinking::No);
+        ConsumedBytes = 0;
+    }
+
+    int32 ScanStart = Buffer.Num();
+    Buffer.Append(Data, Length);
+
+    const uint8* Bytes = Buffer.GetData();
+    const int32 NumBytes = Buffer.Num();
+    int32 RecordStart = 0;
+
+    for (int32 Index = ScanStart; Index < NumBytes; ++Index)
+    {
+        const uint8 Byte = Bytes[Index];
+        if (Byte != '\n' && Byte != '\r')
+        {
+            bSkipNextLineFeed = false;
+            continue;
+        }
+
+        if (Byte == '\n' && bSkipNextLineFeed && Index == RecordStart)
+        {
+            // second half of a "\r\n" pair
+            bSkipNextLineFeed = false;
+            RecordStart = Index + 1;
+            continue;
+        }
+
+        if (Index > RecordStart)
+        {
+            OnRecord(reinterpret_cast<const UTF8CHAR*>(Bytes + RecordStart), Index - RecordStart);
+        }
+        bSkipNextLineFeed = (Byte == '\r');
+        RecordStart = Index + 1;
+    }
+
+    ConsumedBytes = RecordStart;
+}
+
+void FShapELineFramer::Flush(FRecordFunc OnRecord)
+{
+    const int32 Pending = GetPendingBytes();
+    if (Pending > 0)
+    {
+        OnRecord(reinterpret_cast<const UTF8CHAR*>(Buffer.GetData() + ConsumedBytes), Pending);
+    }
+    Reset();
+}
+
+void FShapELineFramer::Reset()
+{
+    Buffer.Reset();
+    ConsumedBytes = 0;
+    bSkipNextLineFeed = false;
+}
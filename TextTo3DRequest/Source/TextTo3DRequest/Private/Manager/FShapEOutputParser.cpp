@@ -0,0 +1,559 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/FShapEOutputParser.h"
+
+namespace
+{
+    FORCEINLINE bool IsJsonSpace(UTF8CHAR C)
+    {
+        return C == ' ' || C == '\t' || C == '\r' || C == '\n';
+    }
+
+    FORCEINLINE bool IsDigit(UTF8CHAR C)
+    {
+        return C >= '0' && C <= '9';
+    }
+
+    FORCEINLINE void SkipSpace(const UTF8CHAR*& Cursor, const UTF8CHAR* End)
+    {
+        while (Cursor < End && IsJsonSpace(*Cursor))
+        {
+            ++Cursor;
+        }
+    }
+
+    // Cursor is on the opening quote; leaves it after the closing quote
+    bool ScanString(const UTF8CHAR*& Cursor, const UTF8CHAR* End, FUtf8StringView& OutContents, bool& bOutEscaped)
+    {
+        const UTF8CHAR* Start = ++Cursor;
+        bOutEscaped = false;
+        while (Cursor < End)
+        {
+            const UTF8CHAR C = *Cursor;
+            if (C == '\\')
+            {
+                if (End - Cursor < 2)
+                {
+                    return false;
+                }
+                bOutEscaped = true;
+                Cursor += 2;
+                continue;
+            }
+            if (C == '"')
+            {
+                OutContents = FUtf8StringView(Start, UE_PTRDIFF_TO_INT32(Cursor - Start));
+                ++Cursor;
+                return true;
+            }
+            ++Cursor;
+        }
+        return false;
+    }
+
+    // Skips a nested object or array, honouring strings so brackets inside them don't count
+    bool SkipCompound(const UTF8CHAR*& Cursor, const UTF8CHAR* End)
+    {
+        int32 Depth = 0;
+        while (Cursor < End)
+        {
+            const UTF8CHAR C = *Cursor;
+            if (C == '"')
+            {
+                FUtf8StringView Ignored;
+                bool bIgnored;
+                if (!ScanString(Cursor, End, Ignored, bIgnored))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (C == '{' || C == '[')
+            {
+                ++Depth;
+            }
+            else if (C == '}' || C == ']')
+            {
+                if (--Depth == 0)
+                {
+                    ++Cursor;
+                    return true;
+                }
+            }
+            ++Cursor;
+        }
+        return false;
+    }
+
+    FORCEINLINE int32 HexValue(UTF8CHAR C)
+    {
+        if (C >= '0' && C <= '9') return C - '0';
+        if (C >= 'a' && C <= 'f') return C - 'a' + 10;
+        if (C >= 'A' && C <= 'F') return C - 'A' + 10;
+        return -1;
+    }
+
+    bool ReadHex4(const UTF8CHAR* Cursor, const UTF8CHAR* End, uint32& OutCodeUnit)
+    {
+        if (End - Cursor < 4)
+        {
+            return false;
+        }
+        OutCodeUnit = 0;
+        for (int32 Index = 0; Index < 4; ++Index)
+        {
+            const int32 Digit = HexValue(Cursor[Index]);
+            if (Digit < 0)
+            {
+                return false;
+            }
+            OutCodeUnit = (OutCodeUnit << 4) | (uint32)Digit;
+        }
+        return true;
+    }
+
+    void AppendCodepoint(FString& Out, uint32 Codepoint)
+    {
+        if (Codepoint > 0xFFFF && sizeof(TCHAR) == 2)
+        {
+            Codepoint -= 0x10000;
+            Out.AppendChar((TCHAR)(0xD800 + (Codepoint >> 10)));
+            Out.AppendChar((TCHAR)(0xDC00 + (Codepoint & 0x3FF)));
+        }
+        else
+        {
+            Out.AppendChar((TCHAR)Codepoint);
+        }
+    }
+
+    void AppendUtf8(FString& Out, const UTF8CHAR* Begin, const UTF8CHAR* End)
+    {
+        if (Begin < End)
+        {
+            const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Begin), UE_PTRDIFF_TO_INT32(End - Begin));
+            Out.Append(Converted.Get(), Converted.Length());
+        }
+    }
+
+    // Finds Needle in Haystack starting at From; INDEX_NONE if missing
+    int32 FindBytes(FUtf8StringView Haystack, const char* Needle, int32 NeedleLen, int32 From = 0)
+    {
+        const UTF8CHAR* Data = Haystack.GetData();
+        for (int32 Index = From; Index + NeedleLen <= Haystack.Len(); ++Index)
+        {
+            if (FMemory::Memcmp(Data + Index, Needle, NeedleLen) == 0)
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+}
+
+const FShapEJsonField* FShapEParsedLine::FindField(FUtf8StringView Key) const
+{
+    for (const FShapEJsonField& Field : Fields)
+    {
+        if (Field.Key.Len() == Key.Len() && FMemory::Memcmp(Field.Key.GetData(), Key.GetData(), Key.Len()) == 0)
+        {
+            return &Field;
+        }
+    }
+    return nullptr;
+}
+
+bool FShapEParsedLine::TypeEquals(FUtf8StringView Type) const
+{
+    const FShapEJsonField* Field = FindField(UTF8TEXTVIEW("type"));
+    return Field && Field->Kind == EShapEJsonValueKind::String && !Field->bEscaped
+        && Field->Value.Len() == Type.Len() && FMemory::Memcmp(Field->Value.GetData(), Type.GetData(), Type.Len()) == 0;
+}
+
+bool FShapEParsedLine::TryGetString(FUtf8StringView Key, FString& OutValue) const
+{
+    const FShapEJsonField* Field = FindField(Key);
+    if (!Field || Field->Kind != EShapEJsonValueKind::String)
+    {
+        return false;
+    }
+    FShapEOutputParser::UnescapeJsonString(Field->Value, Field->bEscaped, OutValue);
+    return true;
+}
+
+bool FShapEParsedLine::TryGetInt(FUtf8StringView Key, int32& OutValue) const
+{
+    const FShapEJsonField* Field = FindField(Key);
+    return Field && Field->Kind == EShapEJsonValueKind::Number && FShapEOutputParser::ParseInt(Field->Value, OutValue);
+}
+
+bool FShapEParsedLine::TryGetDouble(FUtf8StringView Key, double& OutValue) const
+{
+    const FShapEJsonField* Field = FindField(Key);
+    return Field && Field->Kind == EShapEJsonValueKind::Number && FShapEOutputParser::ParseDouble(Field->Value, OutValue);
+}
+
+void FShapEOutputParser::Parse(FUtf8StringView Line, FShapEParsedLine& OutLine)
+{
+    OutLine.Kind = EShapELineKind::Empty;
+    OutLine.Fields.Reset();
+    OutLine.Percent = INDEX_NONE;
+    OutLine.Step = INDEX_NONE;
+    OutLine.TotalSteps = INDEX_NONE;
+    OutLine.Rate = 0.0;
+    OutLine.bSecondsPerIteration = false;
+
+    const UTF8CHAR* Cursor = Line.GetData();
+    const UTF8CHAR* End = Cursor + Line.Len();
+    SkipSpace(Cursor, End);
+    if (Cursor == End)
+    {
+        return;
+    }
+
+    // worker messages always start with '{'; everything else is library chatter or a tqdm bar
+    if (*Cursor == '{' && ParseJsonObject(Line, OutLine))
+    {
+        OutLine.Kind = EShapELineKind::Json;
+        return;
+    }
+    OutLine.Fields.Reset();
+
+    OutLine.Kind = ParseTqdm(Line, OutLine) ? EShapELineKind::Tqdm : EShapELineKind::Other;
+}
+
+bool FShapEOutputParser::ParseJsonObject(FUtf8StringView Line, FShapEParsedLine& OutLine)
+{
+    const UTF8CHAR* Cursor = Line.GetData();
+    const UTF8CHAR* End = Cursor + Line.Len();
+
+    SkipSpace(Cursor, End);
+    if (Cursor == End || *Cursor != '{')
+    {
+        return false;
+    }
+    ++Cursor;
+
+    SkipSpace(Cursor, End);
+    if (Cursor < End && *Cursor == '}')
+    {
+        return true;
+    }
+
+    while (Cursor < End)
+    {
+        SkipSpace(Cursor, End);
+        if (Cursor == End || *Cursor != '"')
+        {
+            return false;
+        }
+
+        FShapEJsonField Field;
+        bool bKeyEscaped;
+        if (!ScanString(Cursor, End, Field.Key, bKeyEscaped))
+        {
+            return false;
+        }
+
+        SkipSpace(Cursor, End);
+        if (Cursor == End || *Cursor != ':')
+        {
+            return false;
+        }
+        ++Cursor;
+        SkipSpace(Cursor, End);
+        if (Cursor == End)
+        {
+            return false;
+        }
+
+        const UTF8CHAR* ValueStart = Cursor;
+        const UTF8CHAR C = *Cursor;
+        if (C == '"')
+        {
+            Field.Kind = EShapEJsonValueKind::String;
+            if (!ScanString(Cursor, End, Field.Value, Field.bEscaped))
+            {
+                return false;
+            }
+        }
+        else if (C == '{' || C == '[')
+        {
+            Field.Kind = EShapEJsonValueKind::Compound;
+            if (!SkipCompound(Cursor, End))
+            {
+                return false;
+            }
+            Field.Value = FUtf8StringView(ValueStart, UE_PTRDIFF_TO_INT32(Cursor - ValueStart));
+        }
+        else
+        {
+            Field.Kind = (C == '-' || IsDigit(C)) ? EShapEJsonValueKind::Number : EShapEJsonValueKind::Literal;
+            while (Cursor < End && *Cursor != ',' && *Cursor != '}' && !IsJsonSpace(*Cursor))
+            {
+                ++Cursor;
+            }
+            Field.Value = FUtf8StringView(ValueStart, UE_PTRDIFF_TO_INT32(Cursor - ValueStart));
+        }
+
+        // keys with escapes never match one of ours, so they are simply not indexed
+        if (!bKeyEscaped)
+        {
+            OutLine.Fields.Add(Field);
+        }
+
+        SkipSpace(Cursor, End);
+        if (Cursor == End)
+        {
+            return false;
+        }
+        if (*Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+        return *Cursor == '}';
+    }
+    return false;
+}
+
+bool FShapEOutputParser::ParseTqdm(FUtf8StringView Line, FShapEParsedLine& OutLine)
+{
+    // " 45%|████▌     | 29/64 [00:05<00:06,  5.41it/s]"
+    const int32 PercentBar = FindBytes(Line, "%|", 2);
+    if (PercentBar == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const UTF8CHAR* Data = Line.GetData();
+    int32 DigitsStart = PercentBar;
+    while (DigitsStart > 0 && IsDigit(Data[DigitsStart - 1]))
+    {
+        --DigitsStart;
+    }
+    if (DigitsStart == PercentBar || !ParseInt(Line.Mid(DigitsStart, PercentBar - DigitsStart), OutLine.Percent))
+    {
+        return false;
+    }
+
+    const int32 BarEnd = FindBytes(Line, "|", 1, PercentBar + 2);
+    if (BarEnd == INDEX_NONE)
+    {
+        return true;
+    }
+
+    // "n/total" after the bar
+    int32 Cursor = BarEnd + 1;
+    while (Cursor < Line.Len() && Data[Cursor] == ' ')
+    {
+        ++Cursor;
+    }
+    int32 StepEnd = Cursor;
+    while (StepEnd < Line.Len() && IsDigit(Data[StepEnd]))
+    {
+        ++StepEnd;
+    }
+    if (StepEnd > Cursor && StepEnd < Line.Len() && Data[StepEnd] == '/')
+    {
+        int32 TotalEnd = StepEnd + 1;
+        while (TotalEnd < Line.Len() && IsDigit(Data[TotalEnd]))
+        {
+            ++TotalEnd;
+        }
+        ParseInt(Line.Mid(Cursor, StepEnd - Cursor), OutLine.Step);
+        ParseInt(Line.Mid(StepEnd + 1, TotalEnd - StepEnd - 1), OutLine.TotalSteps);
+        Cursor = TotalEnd;
+    }
+
+    // rate is the last ", <number>it/s" or ", <number>s/it" inside the brackets; "?it/s" until known
+    const int32 Comma = FindBytes(Line, ",", 1, Cursor);
+    if (Comma != INDEX_NONE)
+    {
+        int32 RateStart = Comma + 1;
+        while (RateStart < Line.Len() && Data[RateStart] == ' ')
+        {
+            ++RateStart;
+        }
+        int32 RateEnd = RateStart;
+        while (RateEnd < Line.Len() && (IsDigit(Data[RateEnd]) || Data[RateEnd] == '.'))
+        {
+            ++RateEnd;
+        }
+        if (RateEnd > RateStart && ParseDouble(Line.Mid(RateStart, RateEnd - RateStart), OutLine.Rate))
+        {
+            OutLine.bSecondsPerIteration = Line.Mid(RateEnd, 4).Equals(UTF8TEXTVIEW("s/it"), ESearchCase::CaseSensitive);
+        }
+    }
+    return true;
+}
+
+void FShapEOutputParser::UnescapeJsonString(FUtf8StringView Raw, bool bEscaped, FString& OutValue)
+{
+    OutValue.Reset();
+    const UTF8CHAR* Cursor = Raw.GetData();
+    const UTF8CHAR* End = Cursor + Raw.Len();
+    if (!bEscaped)
+    {
+        AppendUtf8(OutValue, Cursor, End);
+        return;
+    }
+
+    OutValue.Reserve(Raw.Len());
+    const UTF8CHAR* RunStart = Cursor;
+    while (Cursor < End)
+    {
+        if (*Cursor != '\\')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        AppendUtf8(OutValue, RunStart, Cursor);
+        if (Cursor + 1 >= End)
+        {
+            RunStart = End;
+            break;
+        }
+
+        const UTF8CHAR Escape = Cursor[1];
+        Cursor += 2;
+        switch (Escape)
+        {
+        case 'n': OutValue.AppendChar(TEXT('\n')); break;
+        case 'r': OutValue.AppendChar(TEXT('\r')); break;
+        case 't': OutValue.AppendChar(TEXT('\t')); break;
+        case 'b': OutValue.AppendChar(TEXT('\b')); break;
+        case 'f': OutValue.AppendChar(TEXT('\f')); break;
+        case 'u':
+        {
+            // python's json.dumps escapes every non-ASCII character, astral ones as surrogate pairs
+            uint32 CodeUnit;
+            if (!ReadHex4(Cursor, End, CodeUnit))
+            {
+                OutValue.AppendChar(TEXT('?'));
+                break;
+            }
+            Cursor += 4;
+            uint32 Low;
+            if (CodeUnit >= 0xD800 && CodeUnit <= 0xDBFF && End - Cursor >= 6 && Cursor[0] == '\\' && Cursor[1] == 'u'
+                && ReadHex4(Cursor + 2, End, Low) && Low >= 0xDC00 && Low <= 0xDFFF)
+            {
+                Cursor += 6;
+                AppendCodepoint(OutValue, 0x10000 + ((CodeUnit - 0xD800) << 10) + (Low - 0xDC00));
+            }
+            else
+            {
+                AppendCodepoint(OutValue, CodeUnit);
+            }
+            break;
+        }
+        default:
+            // '"', '\\' and '/' stand for themselves
+            OutValue.AppendChar((TCHAR)Escape);
+            break;
+        }
+        RunStart = Cursor;
+    }
+    AppendUtf8(OutValue, RunStart, End);
+}
+
+bool FShapEOutputParser::ParseInt(FUtf8StringView Text, int32& OutValue)
+{
+    const UTF8CHAR* Cursor = Text.GetData();
+    const UTF8CHAR* End = Cursor + Text.Len();
+    const bool bNegative = Cursor < End && *Cursor == '-';
+    if (bNegative)
+    {
+        ++Cursor;
+    }
+    if (Cursor == End)
+    {
+        return false;
+    }
+
+    int64 Value = 0;
+    for (; Cursor < End; ++Cursor)
+    {
+        if (!IsDigit(*Cursor))
+        {
+            return false;
+        }
+        Value = Value * 10 + (*Cursor - '0');
+        if (Value > MAX_int32)
+        {
+            return false;
+        }
+    }
+    OutValue = bNegative ? -(int32)Value : (int32)Value;
+    return true;
+}
+
+bool FShapEOutputParser::ParseDouble(FUtf8StringView Text, double& OutValue)
+{
+    const UTF8CHAR* Cursor = Text.GetData();
+    const UTF8CHAR* End = Cursor + Text.Len();
+    const bool bNegative = Cursor < End && *Cursor == '-';
+    if (bNegative)
+    {
+        ++Cursor;
+    }
+
+    double Value = 0.0;
+    bool bAnyDigit = false;
+    for (; Cursor < End && IsDigit(*Cursor); ++Cursor)
+    {
+        Value = Value * 10.0 + (*Cursor - '0');
+        bAnyDigit = true;
+    }
+    if (Cursor < End && *Cursor == '.')
+    {
+        double Scale = 0.1;
+        for (++Cursor; Cursor < End && IsDigit(*Cursor); ++Cursor)
+        {
+            Value += (*Cursor - '0') * Scale;
+            Scale *= 0.1;
+            bAnyDigit = true;
+        }
+    }
+    if (!bAnyDigit)
+    {
+        return false;
+    }
+    if (Cursor < End && (*Cursor == 'e' || *Cursor == 'E'))
+    {
+        ++Cursor;
+        const bool bNegativeExponent = Cursor < End && *Cursor == '-';
+        if (Cursor < End && (*Cursor == '-' || *Cursor == '+'))
+        {
+            ++Cursor;
+        }
+        int32 Exponent = 0;
+        if (Cursor == End)
+        {
+            return false;
+        }
+        for (; Cursor < End && IsDigit(*Cursor); ++Cursor)
+        {
+            Exponent = FMath::Min(Exponent * 10 + (*Cursor - '0'), 400);
+        }
+        Value *= FMath::Pow(10.0, (double)(bNegativeExponent ? -Exponent : Exponent));
+    }
+    if (Cursor != End)
+    {
+        return false;
+    }
+    OutValue = bNegative ? -Value : Value;
+    return true;
+}
+
+bool FShapELogRateLimiter::ShouldLog(double Now, int32& OutSuppressed)
+{
+    if (LastLogTime >= 0.0 && Now - LastLogTime < IntervalSeconds)
+    {
+        ++SuppressedCount;
+        return false;
+    }
+    OutSuppressed = SuppressedCount;
+    SuppressedCount = 0;
+    LastLogTime = Now;
+    return true;
+}
@@ -1,394 +1,1103 @@
 // Copyright 2025 Devhanghae All Rights Reserved.
 #include "Manager/FShapEProcessManager.h"
-#include "HAL/RunnableThread.h"
 #include "Misc/Paths.h"
-#include "Serialization/JsonSerializer.h"
 #include "Dom/JsonObject.h"
 #include "Async/Async.h"
-#include "Serialization/JsonWriter.h"
-#include "Misc/Base64.h"
+#include "Misc/Guid.h"
+#include "Backend/FShapEProcessBackend.h"
+#include "Manager/ShapETrace.h"
+#include "Containers/Ticker.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformMemory.h"
 
 
-FString FShapEGenerationParameters::ToJsonString() const
+FShapEProcessManager::FShapEProcessManager()
+    : Backend(MakeShared<FShapEProcessBackend, ESPMode::ThreadSafe>())
 {
-    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
-    JsonObject->SetStringField(TEXT("prompt"), Prompt);
-    JsonObject->SetStringField(TEXT("output_dir"), OutputDirectory);
-    JsonObject->SetNumberField(TEXT("guidance_scale"), GuidanceScale);
-    JsonObject->SetNumberField(TEXT("karras_steps"), KarrasSteps);
-    JsonObject->SetBoolField(TEXT("use_fp16"), bUseFP16);
-
-    FString OutputString;
-    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
-    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer, true);
+}
 
-    
-    return OutputString;
+FShapEProcessManager::FShapEProcessManager(const TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>& InBackend)
+    : Backend(InBackend)
+{
 }
 
 FShapEProcessManager::~FShapEProcessManager()
 {
-    RequestStopProcess();
-    if (ReaderThread)
+    if (EventTickerHandle.IsValid())
     {
-        ReaderThread->WaitForCompletion();
-        delete ReaderThread;
-        ReaderThread = nullptr;
+        FTSTicker::GetCoreTicker().RemoveTicker(EventTickerHandle);
+        EventTickerHandle.Reset();
+    }
+
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        TArray<TSharedRef<FShapEJob>> DroppedJobs;
+        JobQueue.Empty(DroppedJobs);
+        RunningJobs.Reset();
+        CurrentJobId.Reset();
     }
-    OutputReaderRunnable.Reset();
-    CleanupProcessHandles();
+    StopWorker();
 }
 
-bool FShapEProcessManager::LaunchProcess(const FString& ScriptPath, const FShapEGenerationParameters& Params)
+FString FShapEProcessManager::EnqueueGeneration(const FString& ScriptPath, const FShapEGenerationParameters& Params, EShapEJobPriority Priority, TSharedPtr<FShapEJobDelegates> Delegates)
 {
-    FScopeLock Lock(&ProcessManagementCS);
+    TSharedRef<FShapEJob> Job = MakeShared<FShapEJob>();
+    Job->Kind = EShapEJobKind::Generate;
+    Job->Priority = Priority;
+    Job->ScriptPath = ScriptPath;
+    Job->Params = Params;
+    if (Delegates.IsValid())
+    {
+        Job->Delegates = Delegates.ToSharedRef();
+    }
 
-    if (bIsProcessRunning)
+    if (Params.bUseCache && FShapEResultCache::IsCacheable(Params))
     {
-        AsyncTask(ENamedThreads::GameThread, [this]() {
-            ErrorReceivedDelegate.Broadcast(TEXT("Another generation process is already running."), TEXT("ProcessBusy"), TEXT(""));
-            });
-        return false;
+        if (TryCompleteFromCache(Job))
+        {
+            return Job->JobId;
+        }
+
+        // a miss is generated straight into the cache under its key
+        Job->Params.OutputDirectory = GetResultCache().GetDirectory();
+        Job->Params.OutputName = Job->CacheKey;
+        Job->Params.bExportFiles = true;
     }
+    return EnqueueJob(Job);
+}
 
-    const FString BatPath = FPaths::Combine(FPaths::GetPath(ScriptPath), TEXT("run_shape.bat"));
-    if (!FPaths::FileExists(BatPath))
+FShapEResultCache& FShapEProcessManager::GetResultCache()
+{
+    if (!ResultCache.IsValid())
     {
-        const FString ErrorMsg = FString::Printf(TEXT("Batch file not found: %s"), *BatPath);
-        UE_LOG(LogTemp, Error, TEXT("FShapEProcessManager: %s"), *ErrorMsg);
-        AsyncTask(ENamedThreads::GameThread, [this, ErrorMsg]() {
-            ErrorReceivedDelegate.Broadcast(ErrorMsg, TEXT("FileNotFound"), TEXT(""));
-            });
-        return false;
+        ResultCache = MakeUnique<FShapEResultCache>(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapECache")));
     }
+    return *ResultCache;
+}
 
-    CleanupProcessHandles();
+bool FShapEProcessManager::TryCompleteFromCache(const TSharedRef<FShapEJob>& Job)
+{
+    Job->CacheKey = FShapEResultCache::MakeKey(Job->Params);
 
-    if (!FPlatformProcess::CreatePipe(ReadPipe, WritePipe))
+    FString PlyPath, ObjPath;
+    if (!GetResultCache().Lookup(Job->CacheKey, PlyPath, ObjPath))
     {
-        AsyncTask(ENamedThreads::GameThread, [this]() {
-            ErrorReceivedDelegate.Broadcast(TEXT("Failed to create stdout pipe for batch process."), TEXT("PipeError"), TEXT(""));
-            });
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Cache miss for %s (%s)"), *Job->Describe(), *Job->CacheKey);
         return false;
     }
 
-    const FString JsonParamsString = Params.ToJsonString();
-    const FString Base64Params = FBase64::Encode(JsonParamsString);
-
-    // ue flag to skip batch file to skip directory setting process
-    const FString CommandLineArgs = FString::Printf(TEXT("--ue --params-base64 \"%s\""), *Base64Params);
-
-    const FString WorkingDirectory = FPaths::GetPath(BatPath);
+    Job->JobId = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+    Job->EnqueueTime = FPlatformTime::Seconds();
+    Job->State = EShapEJobState::Completed;
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Cache hit for %s, job %s served from %s"), *Job->Describe(), *Job->JobId, *PlyPath);
 
-    PythonProcessHandle = FPlatformProcess::CreateProc(
-        *BatPath,
-        *CommandLineArgs,
-        false,    // bLaunchDetached
-        true,     // bLaunchHidden
-        true,     // bLaunchReallyHidden
-        nullptr,  // OutProcessID
-        0,        // PriorityModifier
-        *WorkingDirectory,
-        WritePipe, // Process's StdOut
-        nullptr    // Process's StdIn -> Not using
-    );
+    // deferred so the caller has the job id before any delegate fires
+    AsyncTask(ENamedThreads::GameThread, [this, Job, PlyPath, ObjPath]() {
+        const FString RawMessage = FString::Printf(TEXT("{\"type\":\"complete\",\"message\":\"Served from cache.\",\"cache_key\":\"%s\"}"), *Job->CacheKey);
+        StatusMessageReceivedDelegate.Broadcast(TEXT("Result served from cache."));
+        ProgressUpdatedDelegate.Broadcast(100.f, 0, 0, RawMessage);
+        Job->Delegates->OnProgressUpdated.Broadcast(100.f, 0, 0, RawMessage);
+        // the latent was saved under the same name as the mesh when the entry was generated
+        const FString CachedLatentPath = FPaths::ChangeExtension(PlyPath, TEXT("latent.npy"));
+        if (!PlyPath.IsEmpty() && FPaths::FileExists(CachedLatentPath))
+        {
+            Job->LatentPath = CachedLatentPath;
+            LatentSavedDelegate.Broadcast(Job->JobId, INDEX_NONE, CachedLatentPath);
+            Job->Delegates->OnLatentSaved.Broadcast(Job->JobId, INDEX_NONE, CachedLatentPath);
+        }
+        Job->Timing.bFromCache = true;
+        FinishJobTiming(*Job);
+        GenerationCompleteDelegate.Broadcast(PlyPath, ObjPath, RawMessage);
+        Job->Delegates->OnGenerationComplete.Broadcast(PlyPath, ObjPath, RawMessage);
+        ProcessFinishedDelegate.Broadcast();
+        });
+    return true;
+}
 
-    if (!PythonProcessHandle.IsValid())
+FString FShapEProcessManager::EnqueueBatch(const FString& ScriptPath, const FShapEBatchGenerationParameters& Params, EShapEJobPriority Priority, TSharedPtr<FShapEJobDelegates> Delegates)
+{
+    if (Params.Prompts.IsEmpty())
     {
         AsyncTask(ENamedThreads::GameThread, [this]() {
-            ErrorReceivedDelegate.Broadcast(TEXT("Failed to launch batch file. Check permissions and paths."), TEXT("ProcessLaunchError"), TEXT(""));
+            ErrorReceivedDelegate.Broadcast(TEXT("Batch request contains no prompts."), TEXT("BadRequest"), TEXT(""));
             });
-        CleanupProcessHandles();
-        return false;
+        return FString();
     }
 
-    bIsProcessRunning = true;
+    TSharedRef<FShapEJob> Job = MakeShared<FShapEJob>();
+    Job->Kind = EShapEJobKind::Batch;
+    Job->Priority = Priority;
+    Job->ScriptPath = ScriptPath;
+    Job->BatchParams = Params;
+    if (Delegates.IsValid())
+    {
+        Job->Delegates = Delegates.ToSharedRef();
+    }
+    return EnqueueJob(Job);
+}
 
-    // stdout, start read thread
-    OutputReaderRunnable = MakeShared<FShapEOutputReaderRunnable>(ReadPipe, StaticCastSharedRef<FShapEProcessManager>(AsShared()));
-    ReaderThread = FRunnableThread::Create(OutputReaderRunnable.Get(), TEXT("ShapEOutputReaderThread"));
-    if (!ReaderThread)
+FString FShapEProcessManager::EnqueueDecode(const FString& ScriptPath, const FShapEDecodeParameters& Params, EShapEJobPriority Priority, TSharedPtr<FShapEJobDelegates> Delegates)
+{
+    if (Params.LatentPath.IsEmpty() || !FPaths::FileExists(Params.LatentPath))
     {
-        UE_LOG(LogTemp, Error, TEXT("FShapEProcessManager: Failed to create output reader thread."));
-        RequestStopProcess();
-        AsyncTask(ENamedThreads::GameThread, [this]() {
-            ErrorReceivedDelegate.Broadcast(TEXT("Failed to create reader thread."), TEXT("ThreadError"), TEXT(""));
+        const FString Message = FString::Printf(TEXT("Latent file not found: %s"), *Params.LatentPath);
+        AsyncTask(ENamedThreads::GameThread, [this, Message]() {
+            ErrorReceivedDelegate.Broadcast(Message, TEXT("BadRequest"), TEXT(""));
             });
-        return false;
+        return FString();
     }
 
-    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Batch file launched successfully with args: %s"), *CommandLineArgs);
-    return true;
+    TSharedRef<FShapEJob> Job = MakeShared<FShapEJob>();
+    Job->Kind = EShapEJobKind::Decode;
+    Job->Priority = Priority;
+    Job->ScriptPath = ScriptPath;
+    Job->DecodeParams = Params;
+    if (Delegates.IsValid())
+    {
+        Job->Delegates = Delegates.ToSharedRef();
+    }
+    return EnqueueJob(Job);
 }
 
-void FShapEProcessManager::RequestStopProcess()
+FString FShapEProcessManager::EnqueueJob(const TSharedRef<FShapEJob>& Job)
+{
+    Job->JobId = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+    Job->EnqueueTime = FPlatformTime::Seconds();
+    Job->State = EShapEJobState::Queued;
+
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        JobQueue.Enqueue(Job);
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Job %s queued (%s, %s priority), queue depth %d"),
+            *Job->JobId, *Job->Describe(), Job->Priority == EShapEJobPriority::Interactive ? TEXT("interactive") : TEXT("bulk"), JobQueue.Num());
+    }
+
+    TryDispatchNextJob();
+    return Job->JobId;
+}
+
+bool FShapEProcessManager::LaunchProcess(const FString& ScriptPath, const FShapEGenerationParameters& Params)
+{
+    return !EnqueueGeneration(ScriptPath, Params, EShapEJobPriority::Interactive).IsEmpty();
+}
+
+bool FShapEProcessManager::LaunchBatch(const FString& ScriptPath, const FShapEBatchGenerationParameters& Params)
+{
+    return !EnqueueBatch(ScriptPath, Params, EShapEJobPriority::Bulk).IsEmpty();
+}
+
+bool FShapEProcessManager::CancelJob(const FString& JobId)
 {
-    bool bWasRunning = false;
+    TSharedPtr<FShapEJob> Job;
     {
         FScopeLock Lock(&ProcessManagementCS);
+        Job = JobQueue.Remove(JobId);
+    }
+
+    if (Job.IsValid())
+    {
+        Job->State = EShapEJobState::Cancelled;
+        FinishJobTiming(*Job);
+        Job->Delegates->OnErrorReceived.Broadcast(TEXT("Job was cancelled before it started."), TEXT("Cancelled"), TEXT(""));
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Queued job %s cancelled"), *JobId);
+        return true;
+    }
 
-        if (!bIsProcessRunning && !PythonProcessHandle.IsValid())
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        Job = RemoveRunningJob(JobId);
+        if (!Job.IsValid())
         {
-            return;
+            return false;
         }
+        bIsWorkerReady = false;
+        if (CancelRequestTime == 0.0)
+        {
+            CancelRequestTime = FPlatformTime::Seconds();
+        }
+    }
+    Backend->Cancel(JobId);
+
+    Job->State = EShapEJobState::Cancelled;
+    FinishJobTiming(*Job);
+    Job->Delegates->OnErrorReceived.Broadcast(TEXT("Job was cancelled."), TEXT("Cancelled"), TEXT(""));
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Running job %s cancelled"), *JobId);
+    NotifyProcessFinished();
 
+    TryDispatchNextJob();
 
-        if (OutputReaderRunnable.IsValid())
+    // a terminated worker with nothing queued is only restarted by the next job, which says nothing about the cancel
+    if (!Backend->IsRunning())
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        CancelRequestTime = 0.0;
+    }
+    return true;
+}
+
+void FShapEProcessManager::CancelAllJobs()
+{
+    TArray<TSharedRef<FShapEJob>> DroppedJobs;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        JobQueue.Empty(DroppedJobs);
+    }
+
+    for (const TSharedRef<FShapEJob>& Job : DroppedJobs)
+    {
+        Job->State = EShapEJobState::Cancelled;
+        FinishJobTiming(*Job);
+        Job->Delegates->OnErrorReceived.Broadcast(TEXT("Job was cancelled before it started."), TEXT("Cancelled"), TEXT(""));
+    }
+
+    // every job the backend runs at once, not only the last one dispatched
+    TArray<FString> RunningJobIds;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        for (const TSharedRef<FShapEJob>& Job : RunningJobs)
         {
-            OutputReaderRunnable->Stop();
+            RunningJobIds.Add(Job->JobId);
         }
+    }
+    for (const FString& JobId : RunningJobIds)
+    {
+        CancelJob(JobId);
+    }
+}
+
+void FShapEProcessManager::SetPreemptBulkBatches(bool bEnable)
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    bPreemptBulkBatches = bEnable;
+}
+
+int32 FShapEProcessManager::GetQueueDepth()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return JobQueue.Num();
+}
+
+FShapEQueueStats FShapEProcessManager::GetQueueStats()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+
+    FShapEQueueStats Stats;
+    Stats.QueueDepth = JobQueue.Num();
+    Stats.InteractiveDepth = JobQueue.Num(EShapEJobPriority::Interactive);
+    Stats.BulkDepth = JobQueue.Num(EShapEJobPriority::Bulk);
+    Stats.OldestWaitSeconds = JobQueue.GetOldestWaitSeconds(FPlatformTime::Seconds());
+    Stats.DispatchedJobs = DispatchedJobCount;
+    Stats.AverageWaitSeconds = DispatchedJobCount > 0 ? TotalWaitSeconds / DispatchedJobCount : 0.0;
+    return Stats;
+}
+
+FShapEDispatchLatencyStats FShapEProcessManager::GetDispatchLatencyStats()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return DispatchLatency;
+}
+
+void FShapEProcessManager::ResetDispatchLatencyStats()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    DispatchLatency = FShapEDispatchLatencyStats();
+}
+
+double FShapEProcessManager::GetWorkerBootSeconds()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return WorkerBootSeconds;
+}
+
+FShapECancelStats FShapEProcessManager::GetCancelStats()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return CancelStats;
+}
 
-        if (PythonProcessHandle.IsValid())
+void FShapEProcessManager::ResetCancelStats()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    CancelStats = FShapECancelStats();
+}
+
+void FShapEProcessManager::TryDispatchNextJob()
+{
+    while (true)
+    {
+        TSharedPtr<FShapEJob> Job;
         {
-            if (FPlatformProcess::IsProcRunning(PythonProcessHandle))
+            FScopeLock Lock(&ProcessManagementCS);
+            if (RunningJobs.Num() >= FMath::Max(1, Backend->GetMaxConcurrentJobs()))
             {
-                FPlatformProcess::TerminateProc(PythonProcessHandle, true);
+                return;
+            }
+            Job = JobQueue.Dequeue();
+
+            // restarting the backend for another launcher would cut off the jobs still running on it
+            if (Job.IsValid() && RunningJobs.Num() > 0 && (!Backend->IsRunning() || !Backend->IsStartedFor(Job->ScriptPath)))
+            {
+                JobQueue.EnqueueFront(Job.ToSharedRef());
+                return;
             }
-            FPlatformProcess::CloseProc(PythonProcessHandle);
-            PythonProcessHandle.Reset();
         }
 
-        CleanupProcessHandles();
+        if (!Job.IsValid())
+        {
+            return;
+        }
 
-        if (bIsProcessRunning)
+        if (DispatchJob(Job.ToSharedRef()))
         {
-            bIsProcessRunning = false;
-            bWasRunning = true;
+            continue;
         }
-    }
 
-    if (bWasRunning)
-    {
+        // the job could not be handed to a worker; report it and move on to the next one
+        Job->State = EShapEJobState::Failed;
+        FinishJobTiming(*Job);
+        Job->Delegates->OnErrorReceived.Broadcast(TEXT("Failed to dispatch the job to the worker process."), TEXT("DispatchError"), TEXT(""));
         NotifyProcessFinished();
     }
 }
 
-bool FShapEProcessManager::IsRunning()
+bool FShapEProcessManager::DispatchJob(const TSharedRef<FShapEJob>& Job)
 {
+    // Reuse the warm worker unless it died or a different launcher was selected
+    bool bStartedWorker = false;
+    if (!Backend->IsRunning() || !Backend->IsStartedFor(Job->ScriptPath))
+    {
+        if (!StartWorker(Job->ScriptPath))
+        {
+            return false;
+        }
+        bStartedWorker = true;
+    }
+
+    TSharedPtr<FJsonObject> JobObject;
+    int32 SliceEnd = 0;
+    if (Job->Kind == EShapEJobKind::Batch)
+    {
+        const int32 TotalItems = Job->BatchParams.Prompts.Num();
+        // a backend running several jobs spreads the whole batch itself and still has room for interactive jobs
+        const bool bSlice = bPreemptBulkBatches && Job->Priority == EShapEJobPriority::Bulk && Backend->GetMaxConcurrentJobs() <= 1;
+        SliceEnd = bSlice ? FMath::Min(TotalItems, Job->NextBatchItem + FMath::Max(1, Job->BatchParams.BatchSize)) : TotalItems;
+
+        FShapEBatchGenerationParameters SliceParams = Job->BatchParams;
+        SliceParams.Prompts = TArray<FString>(Job->BatchParams.Prompts.GetData() + Job->NextBatchItem, SliceEnd - Job->NextBatchItem);
+
+        JobObject = SliceParams.ToJsonObject();
+        JobObject->SetStringField(TEXT("type"), TEXT("batch"));
+        JobObject->SetNumberField(TEXT("item_offset"), Job->NextBatchItem);
+        JobObject->SetNumberField(TEXT("item_count"), TotalItems);
+    }
+    else if (Job->Kind == EShapEJobKind::Decode)
+    {
+        JobObject = Job->DecodeParams.ToJsonObject();
+        JobObject->SetStringField(TEXT("type"), TEXT("decode"));
+    }
+    else
+    {
+        JobObject = Job->Params.ToJsonObject();
+        JobObject->SetStringField(TEXT("type"), TEXT("generate"));
+    }
+    JobObject->SetStringField(TEXT("job_id"), Job->JobId);
+
     FScopeLock Lock(&ProcessManagementCS);
-    return bIsProcessRunning && PythonProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(PythonProcessHandle);
+
+    if (!Backend->Submit(Job->JobId, JobObject.ToSharedRef()))
+    {
+        AsyncTask(ENamedThreads::GameThread, [this]() {
+            ErrorReceivedDelegate.Broadcast(TEXT("Failed to send the job to the worker process."), TEXT("PipeError"), TEXT(""));
+            });
+        return false;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    if (Job->StartTime == 0.0)
+    {
+        Job->StartTime = Now;
+        TotalWaitSeconds += Now - Job->EnqueueTime;
+        ++DispatchedJobCount;
+        AddTimingSpan(*Job, ShapEStages::QueueWait, Job->EnqueueTime, Now);
+    }
+    // a cold start is charged to the job that caused it
+    if (bStartedWorker)
+    {
+        const FShapETimingSpan StartSpan = Backend->GetStartSpan();
+        AddTimingSpan(*Job, StartSpan.Stage, StartSpan.StartSeconds, StartSpan.EndSeconds);
+    }
+
+    if (Job->Kind == EShapEJobKind::Batch)
+    {
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Job %s dispatched items %d-%d of %d"), *Job->JobId, Job->NextBatchItem + 1, SliceEnd, Job->BatchParams.Prompts.Num());
+        Job->NextBatchItem = SliceEnd;
+    }
+    else
+    {
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Job %s dispatched after %.2fs in queue"), *Job->JobId, Now - Job->EnqueueTime);
+    }
+
+    Job->State = EShapEJobState::Running;
+    RunningJobs.Add(Job);
+    CurrentJobId = Job->JobId;
+    bIsWorkerReady = false;
+    return true;
 }
 
-void FShapEProcessManager::CleanupProcessHandles()
+TSharedPtr<FShapEJob> FShapEProcessManager::FindRunningJob(const FString& JobId) const
 {
-    // closes write pipe (used by child process) - read pipe closing is handled by OutputReaderRunnable
-    if (WritePipe)
+    for (const TSharedRef<FShapEJob>& Job : RunningJobs)
     {
-        FPlatformProcess::ClosePipe(0, WritePipe);
-        WritePipe = nullptr;
+        if (Job->JobId == JobId)
+        {
+            return Job;
+        }
     }
+    return nullptr;
 }
 
-void FShapEProcessManager::HandlePythonOutputLine(const FString& OutputLine)
+TSharedPtr<FShapEJob> FShapEProcessManager::RemoveRunningJob(const FString& JobId)
 {
-    if (OutputLine.IsEmpty()) return;
+    const int32 Index = RunningJobs.IndexOfByPredicate([&JobId](const TSharedRef<FShapEJob>& Job) { return Job->JobId == JobId; });
+    if (Index == INDEX_NONE)
+    {
+        return nullptr;
+    }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(OutputLine);
+    TSharedPtr<FShapEJob> Job = RunningJobs[Index];
+    RunningJobs.RemoveAt(Index);
+    CurrentJobId = RunningJobs.Num() > 0 ? RunningJobs.Last()->JobId : FString();
+    return Job;
+}
 
-    if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+void FShapEProcessManager::HandleJobComplete(const FString& JobId, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath, const FString& RawMessage, const FShapESharedMeshLayout& SharedMesh)
+{
+    TSharedPtr<FShapEJob> Job;
+    bool bSliceFinished = false;
     {
-        FString Type;
-        if (JsonObject->TryGetStringField(TEXT("type"), Type))
+        FScopeLock Lock(&ProcessManagementCS);
+        Job = RemoveRunningJob(JobId);
+        if (!Job.IsValid())
         {
-            if (Type == TEXT("status"))
-            {
-                FString Message = JsonObject->GetStringField(TEXT("message"));
-                AsyncTask(ENamedThreads::GameThread, [this, Message, OutputLine]() {
-                    StatusMessageReceivedDelegate.Broadcast(Message);
-                    if (Message.Contains(TEXT("Loading models"))) ProgressUpdatedDelegate.Broadcast(1.f, 0, 0, OutputLine);
-                    else if (Message.Contains(TEXT("Models loaded"))) ProgressUpdatedDelegate.Broadcast(10.f, 0, 0, OutputLine);
-                    else if (Message.Contains(TEXT("Decoding latents"))) ProgressUpdatedDelegate.Broadcast(95.f, 0, 0, OutputLine);
-                    });
-            }
-            else if (Type == TEXT("complete"))
+            ReleaseSharedMesh(SharedMesh);
+            return;
+        }
+
+        if (Job->Kind == EShapEJobKind::Batch && Job->NextBatchItem < Job->BatchParams.Prompts.Num())
+        {
+            // Suspend the batch between items; anything interactive that arrived meanwhile is dequeued first
+            bSliceFinished = true;
+            Job->State = EShapEJobState::Queued;
+            JobQueue.EnqueueFront(Job.ToSharedRef());
+            if (JobQueue.HasQueued(EShapEJobPriority::Interactive) && Job->Priority != EShapEJobPriority::Interactive)
             {
-                FString PlyPath = JsonObject->GetStringField(TEXT("ply_file"));
-                FString ObjPath = JsonObject->GetStringField(TEXT("obj_file"));
-                AsyncTask(ENamedThreads::GameThread, [this, PlyPath, ObjPath, OutputLine]() {
-                    FScopeLock Lock(&ProcessManagementCS);
-                    bIsProcessRunning = false;
-                    ProgressUpdatedDelegate.Broadcast(100.f, 0, 0, OutputLine);
-                    GenerationCompleteDelegate.Broadcast(PlyPath, ObjPath, OutputLine);
-                    NotifyProcessFinished();
-                    });
+                UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Batch %s suspended after %d items for interactive work"), *JobId, Job->NextBatchItem);
             }
-            else if (Type == TEXT("error"))
+        }
+        else
+        {
+            Job->State = EShapEJobState::Completed;
+            if (Job->Kind == EShapEJobKind::Batch)
             {
-                FString Message = JsonObject->GetStringField(TEXT("message"));
-                FString ErrorType = JsonObject->GetStringField(TEXT("error_type"));
-                AsyncTask(ENamedThreads::GameThread, [this, Message, ErrorType, OutputLine]() {
-                    FScopeLock Lock(&ProcessManagementCS);
-                    bIsProcessRunning = false;
-                    ErrorReceivedDelegate.Broadcast(Message, ErrorType, OutputLine);
-                    NotifyProcessFinished();
-                    });
+                UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Batch %s finished, %d of %d items failed"), *JobId, Job->FailedBatchItems, Job->BatchParams.Prompts.Num());
             }
-            else if (Type == TEXT("info") || Type == TEXT("debug"))
+            else
             {
-                FString Message = JsonObject->GetStringField(TEXT("message"));
-                AsyncTask(ENamedThreads::GameThread, [this, Message]() {
-                    InfoMessageReceivedDelegate.Broadcast(Message);
-                    });
+                UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Job %s (%s) finished %.2fs after dispatch"), *JobId, *Job->Describe(), FPlatformTime::Seconds() - Job->StartTime);
             }
         }
     }
-    else
+
+    if (!bSliceFinished)
     {
-        FString CleanedLine = OutputLine.Replace(TEXT("\r"), TEXT("")).TrimStartAndEnd();
+        FinishJobTiming(*Job);
 
-        // Process of parsing progress output from python
-        if (CleanedLine.Contains(TEXT("%|")) && (CleanedLine.Contains(TEXT("s/it")) || CleanedLine.Contains(TEXT("it/s"))))
+        if (Job->Kind == EShapEJobKind::Generate && !Job->CacheKey.IsEmpty())
         {
-            UE_LOG(LogTemp, Log, TEXT("HandlePythonOutputLine: Line identified as tqdm format: '%s'"), *CleanedLine);
+            GetResultCache().Store(Job->CacheKey, Job->Params.Prompt, PlyPath, ObjPath, LatentPath);
+        }
 
-            int32 PercentageCharIndex;
-            if (CleanedLine.FindChar(TEXT('%'), PercentageCharIndex))
-            {
-                FString LeftSide = CleanedLine.Left(PercentageCharIndex);
-                FString PercentageStr;
-
-                for (int i = LeftSide.Len() - 1; i >= 0; --i)
-                {
-                    if (FChar::IsDigit(LeftSide[i]))
-                    {
-                        PercentageStr.InsertAt(0, LeftSide[i]);
-                    }
-                    else
-                    {
-                        if (!PercentageStr.IsEmpty()) break;
-                    }
-                }
-
-                UE_LOG(LogTemp, Log, TEXT("HandlePythonOutputLine: Parsed percentage string is '%s'"), *PercentageStr);
-
-                if (PercentageStr.IsNumeric())
-                {
-                    const int32 TqdmPercentage = FCString::Atoi(*PercentageStr);
-                    const float MappedPercentage = 10.f + (TqdmPercentage / 100.f) * 85.f;
-
-                    UE_LOG(LogTemp, Warning, TEXT(">>> SUCCESS: Broadcasting Progress: %.2f%% (from tqdm %d%%)"), MappedPercentage, TqdmPercentage);
-
-                    AsyncTask(ENamedThreads::GameThread, [this, MappedPercentage, CleanedLine]() {
-                        ProgressUpdatedDelegate.Broadcast(MappedPercentage, 0, 0, CleanedLine);
-                        });
-                    return;
-                }
-            }
+        if (!LatentPath.IsEmpty() && Job->Kind != EShapEJobKind::Batch)
+        {
+            Job->LatentPath = LatentPath;
+            LatentSavedDelegate.Broadcast(JobId, INDEX_NONE, LatentPath);
+            Job->Delegates->OnLatentSaved.Broadcast(JobId, INDEX_NONE, LatentPath);
         }
 
-        UE_LOG(LogTemp, Warning, TEXT("FShapEProcessManager: Received non-JSON, non-tqdm output: %s"), *OutputLine);
+        // listeners read the mesh during the broadcast; the worker may unlink the segment right after
+        if (SharedMesh.IsValid())
+        {
+            SharedMeshReadyDelegate.Broadcast(SharedMesh);
+            Job->Delegates->OnSharedMeshReady.Broadcast(SharedMesh);
+        }
+        ReleaseSharedMesh(SharedMesh);
+
+        ProgressUpdatedDelegate.Broadcast(100.f, 0, 0, RawMessage);
+        Job->Delegates->OnProgressUpdated.Broadcast(100.f, 0, 0, RawMessage);
+        GenerationCompleteDelegate.Broadcast(PlyPath, ObjPath, RawMessage);
+        Job->Delegates->OnGenerationComplete.Broadcast(PlyPath, ObjPath, RawMessage);
+        NotifyProcessFinished();
     }
+
+    TryDispatchNextJob();
 }
 
+void FShapEProcessManager::HandleJobError(const FString& JobId, const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
+{
+    TSharedPtr<FShapEJob> Job;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        Job = RemoveRunningJob(JobId);
+    }
+
+    ErrorReceivedDelegate.Broadcast(ErrorMessage, ErrorType, RawMessage);
 
+    // errors outside of any job (e.g. launcher configuration) have nothing to finish
+    if (!Job.IsValid())
+    {
+        return;
+    }
 
-void FShapEProcessManager::NotifyProcessFinished()
+    Job->State = EShapEJobState::Failed;
+    FinishJobTiming(*Job);
+    Job->Delegates->OnErrorReceived.Broadcast(ErrorMessage, ErrorType, RawMessage);
+    NotifyProcessFinished();
+
+    TryDispatchNextJob();
+}
+
+void FShapEProcessManager::HandleBatchItemComplete(const FString& JobId, int32 ItemIndex, int32 ItemCount, const FString& Prompt, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath, const FString& RawMessage)
 {
-    AsyncTask(ENamedThreads::GameThread, [this]() {
-        ProcessFinishedDelegate.Broadcast();
-        });
+    TSharedPtr<FShapEJob> Job;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        Job = FindRunningJob(JobId);
+        if (!Job.IsValid())
+        {
+            return;
+        }
+    }
+
+    const float BatchPercentage = ItemCount > 0 ? 100.f * (ItemIndex + 1) / ItemCount : 0.f;
+    ProgressUpdatedDelegate.Broadcast(BatchPercentage, ItemIndex + 1, ItemCount, RawMessage);
+    Job->Delegates->OnProgressUpdated.Broadcast(BatchPercentage, ItemIndex + 1, ItemCount, RawMessage);
+    if (!LatentPath.IsEmpty())
+    {
+        LatentSavedDelegate.Broadcast(JobId, ItemIndex, LatentPath);
+        Job->Delegates->OnLatentSaved.Broadcast(JobId, ItemIndex, LatentPath);
+    }
+    BatchItemCompleteDelegate.Broadcast(ItemIndex, Prompt, PlyPath, ObjPath);
+    Job->Delegates->OnBatchItemComplete.Broadcast(ItemIndex, Prompt, PlyPath, ObjPath);
 }
 
+void FShapEProcessManager::SetWorkerArguments(const FString& InArguments)
+{
+    Backend->SetWorkerArguments(InArguments);
+}
 
-//=====================================================================================================\\
-// --- FShapEOutputReaderRunnable Implementation ---
+bool FShapEProcessManager::StartWorker(const FString& ScriptPath)
+{
+    StopWorker();
 
-FShapEOutputReaderRunnable::FShapEOutputReaderRunnable(void* InReadPipe, TSharedRef<FShapEProcessManager, ESPMode::ThreadSafe> InProcessManager)
-    : ReadPipe(InReadPipe)
-    , ProcessManagerPtr(InProcessManager)
-    , bStopRequested(false)
-    , bFinished(false)
+    if (!EventTickerHandle.IsValid())
+    {
+        EventTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FShapEProcessManager::TickEvents));
+    }
+
+    FString ErrorMsg, ErrorType;
+    if (!Backend->Start(ScriptPath, ErrorMsg, ErrorType))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FShapEProcessManager: %s backend failed to start: %s"), *Backend->GetName(), *ErrorMsg);
+        AsyncTask(ENamedThreads::GameThread, [this, ErrorMsg, ErrorType]() {
+            ErrorReceivedDelegate.Broadcast(ErrorMsg, ErrorType, TEXT(""));
+            });
+        FScopeLock Lock(&ProcessManagementCS);
+        WarmupState = EShapEWarmupState::Failed;
+        return false;
+    }
+
+    FScopeLock Lock(&ProcessManagementCS);
+    bIsWorkerReady = false;
+    WarmupState = EShapEWarmupState::WarmingUp;
+    CancelRequestTime = 0.0;
+    bWorkerOutputSeen = false;
+    WorkerBootSeconds = 0.0;
+    bHasWorkerClockOffset = false;
+    return true;
+}
+
+void FShapEProcessManager::StopWorker()
 {
+    Backend->Stop();
+
+    TArray<TSharedRef<FShapEJob>> InterruptedJobs;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        bIsWorkerReady = false;
+        if (WarmupState != EShapEWarmupState::Skipped && WarmupState != EShapEWarmupState::Failed)
+        {
+            WarmupState = EShapEWarmupState::Cold;
+        }
+        InterruptedJobs = MoveTemp(RunningJobs);
+        RunningJobs.Reset();
+        CurrentJobId.Reset();
+        CancelRequestTime = 0.0;
+    }
+
+    for (const TSharedRef<FShapEJob>& InterruptedJob : InterruptedJobs)
+    {
+        InterruptedJob->State = EShapEJobState::Cancelled;
+        FinishJobTiming(*InterruptedJob);
+        InterruptedJob->Delegates->OnErrorReceived.Broadcast(TEXT("Job was cancelled because the worker stopped."), TEXT("Cancelled"), TEXT(""));
+        NotifyProcessFinished();
+    }
+}
+
+void FShapEProcessManager::SetBackend(const TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>& InBackend)
+{
+    StopWorker();
+
+    // whatever the previous backend still had queued belongs to jobs that no longer exist
+    FShapEWorkerEvent DroppedEvent;
+    while (Backend->DequeueEvent(DroppedEvent))
+    {
+    }
+
+    Backend = InBackend;
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Using the %s backend"), *Backend->GetName());
 }
 
-FShapEOutputReaderRunnable::~FShapEOutputReaderRunnable()
+void FShapEProcessManager::RequestStopProcess()
 {
-    if (ReadPipe)
+    const FString JobId = GetCurrentJobId();
+    if (!JobId.IsEmpty())
     {
-        FPlatformProcess::ClosePipe(ReadPipe, nullptr);
-        ReadPipe = nullptr;
+        CancelJob(JobId);
     }
 }
 
-bool FShapEOutputReaderRunnable::Init()
+bool FShapEProcessManager::IsRunning()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return RunningJobs.Num() > 0 && Backend->IsRunning();
+}
+
+int32 FShapEProcessManager::GetRunningJobCount()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return RunningJobs.Num();
+}
+
+bool FShapEProcessManager::IsWorkerRunning()
+{
+    return Backend->IsRunning();
+}
+
+bool FShapEProcessManager::IsWorkerReady()
 {
-    bFinished = false;
-    return ReadPipe != nullptr;
+    FScopeLock Lock(&ProcessManagementCS);
+    return bIsWorkerReady && Backend->IsRunning();
 }
 
-uint32 FShapEOutputReaderRunnable::Run()
+bool FShapEProcessManager::Prewarm(const FString& ScriptPath, uint64 MinFreeMemoryBytes)
 {
-    if (!ReadPipe)
     {
-        bFinished = true;
-        return 1;
+        FScopeLock Lock(&ProcessManagementCS);
+        // a running backend is either warm already or loading for the job that started it
+        if (RunningJobs.Num() > 0 || (Backend->IsRunning() && Backend->IsStartedFor(ScriptPath)))
+        {
+            return false;
+        }
+
+        const uint64 AvailableBytes = FPlatformMemory::GetStats().AvailablePhysical;
+        if (AvailableBytes < MinFreeMemoryBytes)
+        {
+            UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Warm-up skipped, %.0f MiB free of the %.0f MiB budget"),
+                AvailableBytes / (1024.0 * 1024.0), MinFreeMemoryBytes / (1024.0 * 1024.0));
+            WarmupState = EShapEWarmupState::Skipped;
+            return false;
+        }
     }
 
-    while (!bStopRequested)
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Warming up the %s backend for %s"), *Backend->GetName(), *ScriptPath);
+    return StartWorker(ScriptPath);
+}
+
+EShapEWarmupState FShapEProcessManager::GetWarmupState()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return WarmupState;
+}
+
+FString FShapEProcessManager::GetCurrentJobId()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return CurrentJobId;
+}
+
+void FShapEProcessManager::ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh)
+{
+    if (SharedMesh.IsValid())
     {
-        FString Output = FPlatformProcess::ReadPipe(ReadPipe);
+        Backend->ReleaseSharedMesh(SharedMesh);
+    }
+}
+
 
-        if (!Output.IsEmpty())
+
+bool FShapEProcessManager::TickEvents(float DeltaTime)
+{
+    PumpEvents();
+    return true;
+}
+
+void FShapEProcessManager::PumpEvents()
+{
+    // Drain everything the reader produced since the last tick; runs of progress updates for one job keep only the newest
+    FShapEWorkerEvent Event;
+    while (Backend->DequeueEvent(Event))
+    {
+        if (Event.Type == EShapEWorkerEventType::Progress && PendingEvents.Num() > 0)
         {
-            TArray<FString> Lines;
-            Output.ParseIntoArrayLines(Lines, false); 
-            for (const FString& Line : Lines)
+            FShapEWorkerEvent& Previous = PendingEvents.Last();
+            if (Previous.Type == EShapEWorkerEventType::Progress && Previous.JobId == Event.JobId && Previous.WorkerGeneration == Event.WorkerGeneration)
             {
-                if (!Line.TrimStartAndEnd().IsEmpty())
-                {
-                    if (TSharedPtr<FShapEProcessManager> ProcManager = ProcessManagerPtr.Pin())
-                    {
-                        ProcManager->HandlePythonOutputLine(Line);
-                    }
-                    else
-                    {
-                        bStopRequested = true;
-                        break;
-                    }
-                }
+                Previous = MoveTemp(Event);
+                continue;
             }
         }
+        PendingEvents.Add(MoveTemp(Event));
+    }
+
+    for (const FShapEWorkerEvent& PendingEvent : PendingEvents)
+    {
+        DispatchEvent(PendingEvent);
+    }
+    PendingEvents.Reset();
+}
+
+FString FShapEProcessManager::ResolveEventJobId(const FShapEWorkerEvent& Event)
+{
+    // untagged messages (launcher errors, tqdm output) belong to whatever job is in flight on that worker
+    FScopeLock Lock(&ProcessManagementCS);
+    if (!Event.JobId.IsEmpty())
+    {
+        return Event.JobId;
+    }
+    return Event.WorkerGeneration == Backend->GetGeneration() ? CurrentJobId : FString();
+}
+
+void FShapEProcessManager::DispatchEvent(const FShapEWorkerEvent& Event)
+{
+    const FString JobId = ResolveEventJobId(Event);
 
-        if (TSharedPtr<FShapEProcessManager> ProcManager = ProcessManagerPtr.Pin())
+    TSharedPtr<FShapEJob> Job;
+    bool bIsStale = false;
+    bool bFirstWorkerOutput = false;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        Job = FindRunningJob(JobId);
+        bIsStale = !JobId.IsEmpty() && !Job.IsValid();
+        if (Event.ReceiveTime > 0.0)
         {
-            if (!ProcManager->IsRunning())
+            DispatchLatency.Record(FPlatformTime::Seconds() - Event.ReceiveTime);
+        }
+        bFirstWorkerOutput = !bWorkerOutputSeen && Event.WorkerGeneration == Backend->GetGeneration() && Event.Type != EShapEWorkerEventType::WorkerExited
+            && Event.Type != EShapEWorkerEventType::Restarted;
+        bWorkerOutputSeen |= bFirstWorkerOutput;
+        if (bFirstWorkerOutput && Event.ReceiveTime > 0.0)
+        {
+            WorkerBootSeconds = Event.ReceiveTime - Backend->GetStartSpan().StartSeconds;
+            UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: First message from the %s worker %.1f ms after its launch"), *Backend->GetName(), WorkerBootSeconds * 1000.0);
+        }
+    }
+
+    // the first line of a fresh worker ends its boot: batch file, conda activation and interpreter start
+    if (bFirstWorkerOutput && Job.IsValid())
+    {
+        AddTimingSpan(*Job, ShapEStages::WorkerBoot, Backend->GetStartSpan().EndSeconds, Event.ReceiveTime);
+    }
+
+    switch (Event.Type)
+    {
+    case EShapEWorkerEventType::Ready:
+    {
+        {
+            FScopeLock Lock(&ProcessManagementCS);
+            if (Event.WorkerGeneration != Backend->GetGeneration())
             {
                 break;
             }
+            bIsWorkerReady = RunningJobs.Num() < FMath::Max(1, Backend->GetMaxConcurrentJobs());
+            WarmupState = EShapEWarmupState::Warm;
+
+            if (CancelRequestTime > 0.0)
+            {
+                const double CancelSeconds = FPlatformTime::Seconds() - CancelRequestTime;
+                CancelRequestTime = 0.0;
+                ++CancelStats.Cancels;
+                CancelStats.LastSeconds = CancelSeconds;
+                CancelStats.TotalSeconds += CancelSeconds;
+                CancelStats.MaxSeconds = FMath::Max(CancelStats.MaxSeconds, CancelSeconds);
+                UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Worker ready %.1f ms after the cancel"), CancelSeconds * 1000.0);
+            }
         }
-        else
+        WorkerReadyDelegate.Broadcast();
+        break;
+    }
+    case EShapEWorkerEventType::Status:
+    {
+        if (bIsStale) break;
+        StatusMessageReceivedDelegate.Broadcast(Event.Message);
+        break;
+    }
+    case EShapEWorkerEventType::Stage:
+    {
+        if (bIsStale) break;
+        RecordStageEvent(Event, Job.Get());
+
+        // sampling reports its own steps; the stages around it map to fixed points of the bar
+        float StagePercentage = -1.f;
+        if (Event.Stage == ShapEStages::ModelLoad) StagePercentage = Event.bStageBegin ? 1.f : 10.f;
+        else if (Event.Stage == ShapEStages::Decode && Event.bStageBegin && (!Job.IsValid() || Job->Kind != EShapEJobKind::Batch)) StagePercentage = 95.f;
+
+        if (StagePercentage >= 0.f)
         {
-            break; 
+            ProgressUpdatedDelegate.Broadcast(StagePercentage, 0, 0, Event.RawMessage);
+            if (Job.IsValid())
+            {
+                Job->Delegates->OnProgressUpdated.Broadcast(StagePercentage, 0, 0, Event.RawMessage);
+            }
         }
-
-        FPlatformProcess::Sleep(0.02f);
+        break;
     }
+    case EShapEWorkerEventType::Info:
+        if (bIsStale) break;
+        InfoMessageReceivedDelegate.Broadcast(Event.Message);
+        break;
+    case EShapEWorkerEventType::Progress:
+        if (bIsStale) break;
+        ProgressUpdatedDelegate.Broadcast(Event.Percentage, Event.Step, Event.TotalSteps, Event.RawMessage);
+        if (Job.IsValid())
+        {
+            Job->Delegates->OnProgressUpdated.Broadcast(Event.Percentage, Event.Step, Event.TotalSteps, Event.RawMessage);
+        }
+        break;
+    case EShapEWorkerEventType::Preview:
+        if (bIsStale) break;
+        PreviewReceivedDelegate.Broadcast(Event.Preview);
+        if (Job.IsValid())
+        {
+            Job->Delegates->OnPreviewReceived.Broadcast(Event.Preview);
+        }
+        break;
+    case EShapEWorkerEventType::ItemComplete:
+        HandleBatchItemComplete(JobId, Event.ItemIndex, Event.ItemCount, Event.Prompt, Event.PlyPath, Event.ObjPath, Event.LatentPath, Event.RawMessage);
+        break;
+    case EShapEWorkerEventType::ItemError:
+        if (!Job.IsValid()) break;
+        ++Job->FailedBatchItems;
+        BatchItemErrorDelegate.Broadcast(Event.ItemIndex, Event.Prompt, Event.Message);
+        Job->Delegates->OnBatchItemError.Broadcast(Event.ItemIndex, Event.Prompt, Event.Message);
+        break;
+    case EShapEWorkerEventType::Complete:
+        HandleJobComplete(JobId, Event.PlyPath, Event.ObjPath, Event.LatentPath, Event.RawMessage, Event.SharedMesh);
+        break;
+    case EShapEWorkerEventType::Cancelled:
+    {
+        // the job was already reported cancelled when it was removed; this only says how long the worker took
+        {
+            FScopeLock Lock(&ProcessManagementCS);
+            CancelStats.LastWorkerMilliseconds = Event.CancelMilliseconds;
+        }
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Worker gave up job %s %.1f ms after reading the cancel (%s)"), *JobId, Event.CancelMilliseconds, *Event.Message);
+        if (Job.IsValid())
+        {
+            HandleJobError(JobId, Event.Message, TEXT("Cancelled"), Event.RawMessage);
+        }
+        break;
+    }
+    case EShapEWorkerEventType::Error:
+        if (bIsStale) break;
+        HandleJobError(JobId, Event.Message, Event.ErrorType, Event.RawMessage);
+        break;
+    case EShapEWorkerEventType::WorkerExited:
+        NotifyWorkerExited(Event.WorkerGeneration);
+        break;
+    case EShapEWorkerEventType::Restarted:
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+        if (Event.WorkerGeneration != Backend->GetGeneration())
+        {
+            break;
+        }
+        // as in StartWorker; a pending cancel still ends with the new worker's "ready"
+        bIsWorkerReady = false;
+        WarmupState = EShapEWarmupState::WarmingUp;
+        bWorkerOutputSeen = false;
+        WorkerBootSeconds = 0.0;
+        bHasWorkerClockOffset = false;
+        UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: %s"), *Event.Message);
+        break;
+    }
+    }
+}
 
-    bFinished = true;
+void FShapEProcessManager::AddTimingSpan(FShapEJob& Job, const FString& Stage, double StartSeconds, double EndSeconds)
+{
+    const FShapETimingSpan& Span = Job.Timing.Spans.Add_GetRef(FShapETimingSpan{ Stage, StartSeconds, EndSeconds });
+    ShapETrace::OutputSpan(Job.JobId, Span);
+}
 
-    if (TSharedPtr<FShapEProcessManager> ProcManager = ProcessManagerPtr.Pin())
+void FShapEProcessManager::RecordStageEvent(const FShapEWorkerEvent& Event, FShapEJob* Job)
+{
+    const double ClockOffset = Event.ReceiveTime - Event.WorkerTimestamp;
+    if (!bHasWorkerClockOffset || ClockOffset < WorkerClockOffset)
     {
-        AsyncTask(ENamedThreads::GameThread, [ProcManager]() {
-            FScopeLock Lock(&(ProcManager->ProcessManagementCS));
-            if (ProcManager->bIsProcessRunning)
+        WorkerClockOffset = ClockOffset;
+        bHasWorkerClockOffset = true;
+    }
+
+    if (Event.bStageBegin)
+    {
+        ShapETrace::BeginStage(Event.Stage);
+        if (Job)
+        {
+            Job->OpenStages.Add(Event.Stage, Event.WorkerTimestamp);
+            if (Event.Stage == ShapEStages::Sample)
             {
-                ProcManager->bIsProcessRunning = false;
-                ProcManager->NotifyProcessFinished();
+                Job->Timing.SampledSteps += FMath::Max(Event.TotalSteps, 0);
             }
-            });
+        }
+        return;
     }
 
-    if (ReadPipe)
+    ShapETrace::EndStage(Event.Stage);
+    double BeginTimestamp = 0.0;
+    if (Job && Job->OpenStages.RemoveAndCopyValue(Event.Stage, BeginTimestamp))
     {
-        FPlatformProcess::ClosePipe(ReadPipe, nullptr);
-        ReadPipe = nullptr;
+        AddTimingSpan(*Job, Event.Stage, BeginTimestamp + WorkerClockOffset, Event.WorkerTimestamp + WorkerClockOffset);
     }
+}
+
+void FShapEProcessManager::FinishJobTiming(FShapEJob& Job)
+{
+    FShapEJobTiming& Timing = Job.Timing;
+    Timing.JobId = Job.JobId;
+    Timing.Description = Job.Describe();
+    Timing.State = Job.State;
+    Timing.EnqueueTime = Job.EnqueueTime;
+    Timing.FinishTime = FPlatformTime::Seconds();
+    Job.OpenStages.Reset();
+
+    ShapETrace::OutputJobTotal(Timing.GetTotalSeconds());
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Job %s timing: %s"), *Job.JobId, *Timing.Summarize());
 
-    return 0;
+    FScopeLock Lock(&ProcessManagementCS);
+    TimingHistory.Add(Timing);
+    if (TimingHistory.Num() > MaxTimingHistory)
+    {
+        TimingHistory.RemoveAt(0, TimingHistory.Num() - MaxTimingHistory);
+    }
 }
 
-void FShapEOutputReaderRunnable::Stop()
+bool FShapEProcessManager::GetJobTiming(const FString& JobId, FShapEJobTiming& OutTiming)
 {
-    bStopRequested = true;
+    FScopeLock Lock(&ProcessManagementCS);
+    for (int32 Index = TimingHistory.Num() - 1; Index >= 0; --Index)
+    {
+        if (TimingHistory[Index].JobId == JobId)
+        {
+            OutTiming = TimingHistory[Index];
+            return true;
+        }
+    }
+    return false;
 }
+
+TArray<FShapEJobTiming> FShapEProcessManager::GetTimingHistory()
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    return TimingHistory;
+}
+
+void FShapEProcessManager::AddJobTimingSpan(const FString& JobId, const FString& Stage, double StartSeconds, double EndSeconds)
+{
+    FScopeLock Lock(&ProcessManagementCS);
+    for (int32 Index = TimingHistory.Num() - 1; Index >= 0; --Index)
+    {
+        FShapEJobTiming& Timing = TimingHistory[Index];
+        if (Timing.JobId == JobId)
+        {
+            const FShapETimingSpan& Span = Timing.Spans.Add_GetRef(FShapETimingSpan{ Stage, StartSeconds, EndSeconds });
+            ShapETrace::OutputSpan(JobId, Span);
+            return;
+        }
+    }
+}
+
+bool FShapEProcessManager::ExportTimings(const FString& FilePath)
+{
+    const TArray<FShapEJobTiming> Timings = GetTimingHistory();
+
+    FString Contents;
+    if (FPaths::GetExtension(FilePath).Equals(TEXT("json"), ESearchCase::IgnoreCase))
+    {
+        TArray<TSharedPtr<FJsonValue>> JobValues;
+        JobValues.Reserve(Timings.Num());
+        for (const FShapEJobTiming& Timing : Timings)
+        {
+            JobValues.Add(MakeShared<FJsonValueObject>(Timing.ToJsonObject()));
+        }
+        TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+        RootObject->SetArrayField(TEXT("jobs"), JobValues);
+        Contents = ShapEJson::ToCondensedString(RootObject);
+    }
+    else
+    {
+        Contents = FShapEJobTiming::ToCsv(Timings);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Contents, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEProcessManager: Could not write timings to %s"), *FilePath);
+        return false;
+    }
+    UE_LOG(LogTemp, Log, TEXT("FShapEProcessManager: Wrote timings of %d jobs to %s"), Timings.Num(), *FilePath);
+    return true;
+}
+
+void FShapEProcessManager::NotifyProcessFinished()
+{
+    AsyncTask(ENamedThreads::GameThread, [this]() {
+        ProcessFinishedDelegate.Broadcast();
+        });
+}
+
+void FShapEProcessManager::NotifyWorkerExited(uint32 Generation)
+{
+    TArray<FString> LostJobIds;
+    {
+        FScopeLock Lock(&ProcessManagementCS);
+
+        // a newer worker may already have replaced the one this reader belonged to
+        if (Generation != Backend->GetGeneration())
+        {
+            return;
+        }
+
+        bIsWorkerReady = false;
+        WarmupState = WarmupState == EShapEWarmupState::WarmingUp ? EShapEWarmupState::Failed : EShapEWarmupState::Cold;
+        for (const TSharedRef<FShapEJob>& Job : RunningJobs)
+        {
+            LostJobIds.Add(Job->JobId);
+        }
+    }
+
+    // fails the jobs and dispatches the next ones on a fresh worker
+    for (const FString& LostJobId : LostJobIds)
+    {
+        HandleJobError(LostJobId, TEXT("Worker process exited unexpectedly."), TEXT("WorkerExited"), TEXT(""));
+    }
+}
+
@@ -0,0 +1,350 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/FShapEResultCache.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+
+namespace
+{
+    constexpr int32 CacheIndexVersion = 1;
+}
+
+FShapEResultCache::FShapEResultCache(const FString& InCacheDirectory, int64 InMaxBytes)
+    : CacheDirectory(FPaths::ConvertRelativePathToFull(InCacheDirectory))
+    , MaxBytes(InMaxBytes)
+{
+}
+
+FShapEResultCache::~FShapEResultCache()
+{
+    if (bIndexDirty)
+    {
+        SaveIndex();
+    }
+}
+
+FString FShapEResultCache::NormalizePrompt(const FString& Prompt)
+{
+    // case and whitespace differences don't change what the text encoder sees in practice
+    FString Normalized;
+    Normalized.Reserve(Prompt.Len());
+    bool bPendingSpace = false;
+    for (const TCHAR Char : Prompt.TrimStartAndEnd())
+    {
+        if (FChar::IsWhitespace(Char))
+        {
+            bPendingSpace = true;
+            continue;
+        }
+        if (bPendingSpace)
+        {
+            Normalized.AppendChar(TEXT(' '));
+            bPendingSpace = false;
+        }
+        Normalized.AppendChar(FChar::ToLower(Char));
+    }
+    return Normalized;
+}
+
+FString FShapEResultCache::MakeKey(const FShapEGenerationParameters& Params)
+{
+    const FString Canonical = FString::Printf(TEXT("v%d\n%s\n%.3f\n%d\n%d\n%d\n%s"),
+        CacheIndexVersion, *NormalizePrompt(Params.Prompt), Params.GuidanceScale, Params.KarrasSteps, Params.bUseFP16 ? 1 : 0, Params.Seed, *Params.ModelVersion);
+
+    FTCHARToUTF8 Utf8(*Canonical);
+    uint8 Digest[FSHA1::DigestSize];
+    FSHA1::HashBuffer(Utf8.Get(), Utf8.Length(), Digest);
+    return BytesToHex(Digest, FSHA1::DigestSize).ToLower();
+}
+
+bool FShapEResultCache::Lookup(const FString& Key, FString& OutPlyPath, FString& OutObjPath)
+{
+    LoadIndex();
+
+    FShapECacheEntry* Entry = Entries.Find(Key);
+    if (Entry)
+    {
+        const FString PlyPath = GetFilePath(Entry->PlyFile);
+        const FString ObjPath = Entry->ObjFile.IsEmpty() ? FString() : GetFilePath(Entry->ObjFile);
+        if (FPaths::FileExists(PlyPath) && (ObjPath.IsEmpty() || FPaths::FileExists(ObjPath)))
+        {
+            // rewriting the whole index on every hit would make hits slower as the cache grows
+            Entry->LastAccessTime = FDateTime::UtcNow();
+            bIndexDirty = true;
+            ++Hits;
+            OutPlyPath = PlyPath;
+            OutObjPath = ObjPath;
+            return true;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("FShapEResultCache: Files for %s are missing, dropping the entry"), *Key);
+        RemoveEntry(Key, true);
+        SaveIndex();
+    }
+
+    ++Misses;
+    return false;
+}
+
+void FShapEResultCache::Store(const FString& Key, const FString& Prompt, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath)
+{
+    LoadIndex();
+
+    if (PlyPath.IsEmpty() || !FPaths::FileExists(PlyPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEResultCache: Not caching %s, the PLY file is missing"), *Key);
+        return;
+    }
+
+    // replaces an entry whose files went missing under the same key
+    RemoveEntry(Key, false);
+
+    FShapECacheEntry Entry;
+    Entry.Key = Key;
+    Entry.Prompt = Prompt;
+    Entry.PlyFile = FPaths::GetCleanFilename(PlyPath);
+    Entry.ObjFile = ObjPath.IsEmpty() ? FString() : FPaths::GetCleanFilename(ObjPath);
+    Entry.SizeBytes = FMath::Max<int64>(IFileManager::Get().FileSize(*PlyPath), 0);
+    if (!ObjPath.IsEmpty())
+    {
+        Entry.SizeBytes += FMath::Max<int64>(IFileManager::Get().FileSize(*ObjPath), 0);
+    }
+    if (!LatentPath.IsEmpty() && FPaths::FileExists(LatentPath))
+    {
+        Entry.LatentFile = FPaths::GetCleanFilename(LatentPath);
+        Entry.SizeBytes += FMath::Max<int64>(IFileManager::Get().FileSize(*LatentPath), 0);
+    }
+    Entry.CreatedTime = FDateTime::UtcNow();
+    Entry.LastAccessTime = Entry.CreatedTime;
+
+    TotalBytes += Entry.SizeBytes;
+    Entries.Add(Key, MoveTemp(Entry));
+    ++Stores;
+
+    EvictToBudget(Key);
+    SaveIndex();
+}
+
+void FShapEResultCache::Clear()
+{
+    LoadIndex();
+
+    TArray<FString> Keys;
+    Entries.GetKeys(Keys);
+    for (const FString& Key : Keys)
+    {
+        RemoveEntry(Key, true);
+    }
+
+    // latents of entries evicted before they were tracked
+    TArray<FString> StrayLatents;
+    IFileManager::Get().FindFiles(StrayLatents, *FPaths::Combine(CacheDirectory, TEXT("*.latent.npy")), true, false);
+    for (const FString& StrayLatent : StrayLatents)
+    {
+        IFileManager::Get().Delete(*GetFilePath(StrayLatent), false, false, true);
+    }
+    SaveIndex();
+}
+
+void FShapEResultCache::SetMaxBytes(int64 InMaxBytes)
+{
+    MaxBytes = FMath::Max<int64>(InMaxBytes, 0);
+    if (bIndexLoaded)
+    {
+        EvictToBudget(FString());
+        SaveIndex();
+    }
+}
+
+FShapECacheStats FShapEResultCache::GetStats() const
+{
+    FShapECacheStats Stats;
+    Stats.Hits = Hits;
+    Stats.Misses = Misses;
+    Stats.Stores = Stores;
+    Stats.Evictions = Evictions;
+    Stats.EntryCount = Entries.Num();
+    Stats.TotalBytes = TotalBytes;
+    Stats.MaxBytes = MaxBytes;
+    return Stats;
+}
+
+FString FShapEResultCache::GetIndexPath() const
+{
+    return FPaths::Combine(CacheDirectory, TEXT("index.json"));
+}
+
+FString FShapEResultCache::GetFilePath(const FString& FileName) const
+{
+    return FPaths::Combine(CacheDirectory, FileName);
+}
+
+void FShapEResultCache::LoadIndex()
+{
+    if (bIndexLoaded)
+    {
+        return;
+    }
+    bIndexLoaded = true;
+
+    IFileManager::Get().MakeDirectory(*CacheDirectory, true);
+
+    FString IndexString;
+    if (!FFileHelper::LoadFileToString(IndexString, *GetIndexPath()))
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> IndexObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(IndexString);
+    if (!FJsonSerializer::Deserialize(Reader, IndexObject) || !IndexObject.IsValid() || IndexObject->GetIntegerField(TEXT("version")) != CacheIndexVersion)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEResultCache: Ignoring unreadable cache index at %s"), *GetIndexPath());
+        return;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* EntryValues = nullptr;
+    if (!IndexObject->TryGetArrayField(TEXT("entries"), EntryValues))
+    {
+        return;
+    }
+
+    for (const TSharedPtr<FJsonValue>& Value : *EntryValues)
+    {
+        const TSharedPtr<FJsonObject>* EntryObject = nullptr;
+        if (!Value.IsValid() || !Value->TryGetObject(EntryObject))
+        {
+            continue;
+        }
+
+        FShapECacheEntry Entry;
+        FString Created, LastAccess;
+        double SizeBytes = 0.0;
+        if (!(*EntryObject)->TryGetStringField(TEXT("key"), Entry.Key) || !(*EntryObject)->TryGetStringField(TEXT("ply_file"), Entry.PlyFile))
+        {
+            continue;
+        }
+        (*EntryObject)->TryGetStringField(TEXT("obj_file"), Entry.ObjFile);
+        (*EntryObject)->TryGetStringField(TEXT("latent_file"), Entry.LatentFile);
+        (*EntryObject)->TryGetStringField(TEXT("prompt"), Entry.Prompt);
+        (*EntryObject)->TryGetNumberField(TEXT("size_bytes"), SizeBytes);
+        (*EntryObject)->TryGetStringField(TEXT("created"), Created);
+        (*EntryObject)->TryGetStringField(TEXT("last_access"), LastAccess);
+        FDateTime::ParseIso8601(*Created, Entry.CreatedTime);
+        FDateTime::ParseIso8601(*LastAccess, Entry.LastAccessTime);
+        Entry.SizeBytes = (int64)SizeBytes;
+        if (Entry.LatentFile.IsEmpty())
+        {
+            // indexes written before latents were tracked: adopt the one saved under the mesh's name
+            const FString LatentFile = FPaths::GetBaseFilename(Entry.PlyFile) + TEXT(".latent.npy");
+            const int64 LatentBytes = IFileManager::Get().FileSize(*GetFilePath(LatentFile));
+            if (LatentBytes >= 0)
+            {
+                Entry.LatentFile = LatentFile;
+                Entry.SizeBytes += LatentBytes;
+            }
+        }
+
+        TotalBytes += Entry.SizeBytes;
+        Entries.Add(Entry.Key, MoveTemp(Entry));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEResultCache: Loaded %d entries (%.1f MB) from %s"), Entries.Num(), TotalBytes / (1024.0 * 1024.0), *CacheDirectory);
+}
+
+void FShapEResultCache::SaveIndex()
+{
+    bIndexDirty = false;
+
+    TArray<TSharedPtr<FJsonValue>> EntryValues;
+    EntryValues.Reserve(Entries.Num());
+    for (const TPair<FString, FShapECacheEntry>& Pair : Entries)
+    {
+        const FShapECacheEntry& Entry = Pair.Value;
+        TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+        EntryObject->SetStringField(TEXT("key"), Entry.Key);
+        EntryObject->SetStringField(TEXT("prompt"), Entry.Prompt);
+        EntryObject->SetStringField(TEXT("ply_file"), Entry.PlyFile);
+        EntryObject->SetStringField(TEXT("obj_file"), Entry.ObjFile);
+        EntryObject->SetStringField(TEXT("latent_file"), Entry.LatentFile);
+        EntryObject->SetNumberField(TEXT("size_bytes"), (double)Entry.SizeBytes);
+        EntryObject->SetStringField(TEXT("created"), Entry.CreatedTime.ToIso8601());
+        EntryObject->SetStringField(TEXT("last_access"), Entry.LastAccessTime.ToIso8601());
+        EntryValues.Add(MakeShared<FJsonValueObject>(EntryObject));
+    }
+
+    TSharedRef<FJsonObject> IndexObject = MakeShared<FJsonObject>();
+    IndexObject->SetNumberField(TEXT("version"), CacheIndexVersion);
+    IndexObject->SetArrayField(TEXT("entries"), EntryValues);
+
+    if (!FFileHelper::SaveStringToFile(ShapEJson::ToCondensedString(IndexObject), *GetIndexPath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEResultCache: Failed to write cache index %s"), *GetIndexPath());
+    }
+}
+
+void FShapEResultCache::RemoveEntry(const FString& Key, bool bDeleteFiles)
+{
+    FShapECacheEntry Entry;
+    if (!Entries.RemoveAndCopyValue(Key, Entry))
+    {
+        return;
+    }
+
+    TotalBytes -= Entry.SizeBytes;
+    if (bDeleteFiles)
+    {
+        IFileManager::Get().Delete(*GetFilePath(Entry.PlyFile), false, false, true);
+        if (!Entry.ObjFile.IsEmpty())
+        {
+            IFileManager::Get().Delete(*GetFilePath(Entry.ObjFile), false, false, true);
+        }
+        if (!Entry.LatentFile.IsEmpty())
+        {
+            IFileManager::Get().Delete(*GetFilePath(Entry.LatentFile), false, false, true);
+        }
+    }
+}
+
+void FShapEResultCache::EvictToBudget(const FString& KeepKey)
+{
+    if (TotalBytes <= MaxBytes)
+    {
+        return;
+    }
+
+    // least recently used first
+    TArray<const FShapECacheEntry*> Candidates;
+    Candidates.Reserve(Entries.Num());
+    for (const TPair<FString, FShapECacheEntry>& Pair : Entries)
+    {
+        if (Pair.Key != KeepKey)
+        {
+            Candidates.Add(&Pair.Value);
+        }
+    }
+    Candidates.Sort([](const FShapECacheEntry& A, const FShapECacheEntry& B) { return A.LastAccessTime < B.LastAccessTime; });
+
+    TArray<FString> Victims;
+    int64 ProjectedBytes = TotalBytes;
+    for (const FShapECacheEntry* Candidate : Candidates)
+    {
+        if (ProjectedBytes <= MaxBytes)
+        {
+            break;
+        }
+        ProjectedBytes -= Candidate->SizeBytes;
+        Victims.Add(Candidate->Key);
+    }
+
+    for (const FString& Victim : Victims)
+    {
+        RemoveEntry(Victim, true);
+        ++Evictions;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEResultCache: Evicted %d entries, %.1f of %.1f MB in use"), Victims.Num(), TotalBytes / (1024.0 * 1024.0), MaxBytes / (1024.0 * 1024.0));
+}
@@ -0,0 +1,227 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/ShapEJobTypes.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+#include "Misc/Paths.h"
+
+FString ShapEJson::ToCondensedString(const TSharedRef<FJsonObject>& JsonObject)
+{
+    FString OutputString;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+    FJsonSerializer::Serialize(JsonObject, Writer, true);
+    return OutputString;
+}
+
+TSharedRef<FJsonObject> FShapEGenerationParameters::ToJsonObject() const
+{
+    TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+    JsonObject->SetStringField(TEXT("prompt"), Prompt);
+    JsonObject->SetStringField(TEXT("output_dir"), OutputDirectory);
+    JsonObject->SetNumberField(TEXT("guidance_scale"), GuidanceScale);
+    JsonObject->SetNumberField(TEXT("karras_steps"), KarrasSteps);
+    JsonObject->SetBoolField(TEXT("use_fp16"), bUseFP16);
+    JsonObject->SetNumberField(TEXT("seed"), Seed);
+    JsonObject->SetStringField(TEXT("model_version"), ModelVersion);
+    if (!OutputName.IsEmpty())
+    {
+        JsonObject->SetStringField(TEXT("output_name"), OutputName);
+    }
+    JsonObject->SetStringField(TEXT("transport"), bUseSharedMemory ? TEXT("shm") : TEXT("file"));
+    JsonObject->SetBoolField(TEXT("export_files"), bExportFiles || !bUseSharedMemory);
+    JsonObject->SetBoolField(TEXT("save_latent"), bSaveLatents);
+    if (PreviewEverySteps > 0)
+    {
+        JsonObject->SetNumberField(TEXT("preview_every"), PreviewEverySteps);
+        JsonObject->SetNumberField(TEXT("preview_size"), PreviewSize);
+        JsonObject->SetNumberField(TEXT("preview_max_overhead"), PreviewMaxOverhead);
+    }
+    return JsonObject;
+}
+
+FString FShapEGenerationParameters::ToJsonString() const
+{
+    return ShapEJson::ToCondensedString(ToJsonObject());
+}
+
+TSharedRef<FJsonObject> FShapEBatchGenerationParameters::ToJsonObject() const
+{
+    TArray<TSharedPtr<FJsonValue>> PromptValues;
+    PromptValues.Reserve(Prompts.Num());
+    for (const FString& Prompt : Prompts)
+    {
+        PromptValues.Add(MakeShared<FJsonValueString>(Prompt));
+    }
+
+    TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+    JsonObject->SetArrayField(TEXT("prompts"), PromptValues);
+    JsonObject->SetStringField(TEXT("output_dir"), OutputDirectory);
+    JsonObject->SetNumberField(TEXT("guidance_scale"), GuidanceScale);
+    JsonObject->SetNumberField(TEXT("karras_steps"), KarrasSteps);
+    JsonObject->SetBoolField(TEXT("use_fp16"), bUseFP16);
+    JsonObject->SetNumberField(TEXT("batch_size"), FMath::Max(1, BatchSize));
+    JsonObject->SetBoolField(TEXT("save_latent"), bSaveLatents);
+    return JsonObject;
+}
+
+TSharedRef<FJsonObject> FShapEDecodeParameters::ToJsonObject() const
+{
+    TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+    JsonObject->SetStringField(TEXT("latent_file"), LatentPath);
+    if (!OutputDirectory.IsEmpty())
+    {
+        JsonObject->SetStringField(TEXT("output_dir"), OutputDirectory);
+    }
+    if (!OutputName.IsEmpty())
+    {
+        JsonObject->SetStringField(TEXT("output_name"), OutputName);
+    }
+    JsonObject->SetStringField(TEXT("transport"), bUseSharedMemory ? TEXT("shm") : TEXT("file"));
+    JsonObject->SetBoolField(TEXT("export_files"), bExportFiles || !bUseSharedMemory);
+    return JsonObject;
+}
+
+FString FShapEJob::Describe() const
+{
+    if (Kind == EShapEJobKind::Batch)
+    {
+        return FString::Printf(TEXT("batch of %d prompts"), BatchParams.Prompts.Num());
+    }
+    if (Kind == EShapEJobKind::Decode)
+    {
+        return FString::Printf(TEXT("decode of '%s'"), *FPaths::GetCleanFilename(DecodeParams.LatentPath));
+    }
+    return FString::Printf(TEXT("prompt '%s'"), *Params.Prompt);
+}
+
+static const TCHAR* GetJobStateName(EShapEJobState State)
+{
+    switch (State)
+    {
+    case EShapEJobState::Queued: return TEXT("queued");
+    case EShapEJobState::Running: return TEXT("running");
+    case EShapEJobState::Completed: return TEXT("completed");
+    case EShapEJobState::Failed: return TEXT("failed");
+    case EShapEJobState::Cancelled: return TEXT("cancelled");
+    }
+    return TEXT("unknown");
+}
+
+double FShapEJobTiming::GetStageSeconds(const FString& Stage) const
+{
+    double Seconds = 0.0;
+    for (const FShapETimingSpan& Span : Spans)
+    {
+        if (Span.Stage == Stage)
+        {
+            Seconds += Span.GetDuration();
+        }
+    }
+    return Seconds;
+}
+
+double FShapEJobTiming::GetTotalSeconds() const
+{
+    // an import reported afterwards extends the job past FinishTime
+    double EndTime = FinishTime;
+    for (const FShapETimingSpan& Span : Spans)
+    {
+        EndTime = FMath::Max(EndTime, Span.EndSeconds);
+    }
+    return EnqueueTime > 0.0 ? FMath::Max(0.0, EndTime - EnqueueTime) : 0.0;
+}
+
+FString FShapEJobTiming::Summarize() const
+{
+    TArray<FString> Stages;
+    for (const FShapETimingSpan& Span : Spans)
+    {
+        Stages.AddUnique(Span.Stage);
+    }
+
+    FString Summary = FString::JoinBy(Stages, TEXT(", "), [this](const FString& Stage)
+    {
+        return FString::Printf(TEXT("%s %.2fs"), *Stage, GetStageSeconds(Stage));
+    });
+    if (SampledSteps > 0)
+    {
+        Summary += FString::Printf(TEXT(" (%.1f ms/step)"), GetSecondsPerStep() * 1000.0);
+    }
+    return FString::Printf(TEXT("%s%stotal %.2fs"), *Summary, Summary.IsEmpty() ? TEXT("") : TEXT(", "), GetTotalSeconds());
+}
+
+TSharedRef<FJsonObject> FShapEJobTiming::ToJsonObject() const
+{
+    TArray<TSharedPtr<FJsonValue>> SpanValues;
+    SpanValues.Reserve(Spans.Num());
+    for (const FShapETimingSpan& Span : Spans)
+    {
+        TSharedRef<FJsonObject> SpanObject = MakeShared<FJsonObject>();
+        SpanObject->SetStringField(TEXT("stage"), Span.Stage);
+        // relative to the enqueue, so jobs from different sessions line up
+        SpanObject->SetNumberField(TEXT("start_s"), Span.StartSeconds - EnqueueTime);
+        SpanObject->SetNumberField(TEXT("duration_s"), Span.GetDuration());
+        SpanValues.Add(MakeShared<FJsonValueObject>(SpanObject));
+    }
+
+    TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+    JsonObject->SetStringField(TEXT("job_id"), JobId);
+    JsonObject->SetStringField(TEXT("description"), Description);
+    JsonObject->SetStringField(TEXT("state"), GetJobStateName(State));
+    JsonObject->SetBoolField(TEXT("from_cache"), bFromCache);
+    JsonObject->SetNumberField(TEXT("total_s"), GetTotalSeconds());
+    JsonObject->SetNumberField(TEXT("sampled_steps"), SampledSteps);
+    JsonObject->SetNumberField(TEXT("step_ms"), GetSecondsPerStep() * 1000.0);
+    JsonObject->SetArrayField(TEXT("spans"), SpanValues);
+    return JsonObject;
+}
+
+FString FShapEJobTiming::ToCsv(TConstArrayView<FShapEJobTiming> Timings)
+{
+    auto Quote = [](const FString& Value)
+    {
+        return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+    };
+
+    FString Csv = TEXT("job_id,description,state,from_cache,stage,start_s,duration_s\n");
+    for (const FShapEJobTiming& Timing : Timings)
+    {
+        const FString Prefix = FString::Printf(TEXT("%s,%s,%s,%d"), *Timing.JobId, *Quote(Timing.Description), GetJobStateName(Timing.State), Timing.bFromCache ? 1 : 0);
+        for (const FShapETimingSpan& Span : Timing.Spans)
+        {
+            Csv += FString::Printf(TEXT("%s,%s,%.6f,%.6f\n"), *Prefix, *Span.Stage, Span.StartSeconds - Timing.EnqueueTime, Span.GetDuration());
+        }
+        Csv += FString::Printf(TEXT("%s,total,0.000000,%.6f\n"), *Prefix, Timing.GetTotalSeconds());
+    }
+    return Csv;
+}
+
+void FShapEDispatchLatencyStats::Record(double Seconds)
+{
+    ++Events;
+    TotalSeconds += Seconds;
+    MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+
+    if (RecentSeconds.Num() < MaxRecentSamples)
+    {
+        RecentSeconds.Add(static_cast<float>(Seconds));
+    }
+    else
+    {
+        RecentSeconds[NextRecentIndex] = static_cast<float>(Seconds);
+        NextRecentIndex = (NextRecentIndex + 1) % MaxRecentSamples;
+    }
+}
+
+double FShapEDispatchLatencyStats::GetPercentileSeconds(double Percentile) const
+{
+    if (RecentSeconds.IsEmpty())
+    {
+        return 0.0;
+    }
+
+    TArray<float> Sorted = RecentSeconds;
+    Sorted.Sort();
+    const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+    return Sorted[Index];
+}
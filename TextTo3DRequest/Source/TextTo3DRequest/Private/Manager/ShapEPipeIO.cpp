@@ -0,0 +1,175 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/ShapEPipeIO.h"
+#include "HAL/PlatformProcess.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include "HAL/PlatformTime.h"
+
+bool ShapEPipeIO::ReadBlocking(void* ReadPipe, TArray<uint8>& OutBuffer, int32 Capacity, const FThreadSafeBool& bStopRequested)
+{
+    if (!ReadPipe || Capacity <= 0)
+    {
+        return false;
+    }
+
+#if PLATFORM_WINDOWS
+    OutBuffer.SetNumUninitialized(Capacity, EAllowShrinking::No);
+
+    // anonymous pipes are synchronous: ReadFile waits for data and fails with ERROR_BROKEN_PIPE at EOF
+    ::DWORD BytesRead = 0;
+    const bool bRead = !!::ReadFile(static_cast<HANDLE>(ReadPipe), OutBuffer.GetData(), static_cast<::DWORD>(Capacity), &BytesRead, nullptr);
+    OutBuffer.SetNum(bRead ? static_cast<int32>(BytesRead) : 0, EAllowShrinking::No);
+    return bRead && BytesRead > 0;
+#elif PLATFORM_UNIX
+    OutBuffer.SetNumUninitialized(Capacity, EAllowShrinking::No);
+
+    const int Fd = static_cast<FPipeHandle*>(ReadPipe)->GetHandle();
+    while (true)
+    {
+        pollfd PollFd;
+        PollFd.fd = Fd;
+        PollFd.events = POLLIN;
+        PollFd.revents = 0;
+
+        if (poll(&PollFd, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        // POLLHUP still allows draining whatever the child wrote before exiting
+        const ssize_t BytesRead = read(Fd, OutBuffer.GetData(), Capacity);
+        if (BytesRead < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            continue;
+        }
+        if (BytesRead > 0)
+        {
+            OutBuffer.SetNum(static_cast<int32>(BytesRead), EAllowShrinking::No);
+            return true;
+        }
+        break;
+    }
+
+    OutBuffer.SetNum(0, EAllowShrinking::No);
+    return false;
+#else
+    while (!bStopRequested)
+    {
+        if (FPlatformProcess::ReadPipeToArray(ReadPipe, OutBuffer) && OutBuffer.Num() > 0)
+        {
+            return true;
+        }
+        FPlatformProcess::Sleep(0.005f);
+    }
+    return false;
+#endif
+}
+
+bool ShapEPipeIO::WriteAll(void* WritePipe, const uint8* Data, int32 Length, double TimeoutSeconds)
+{
+    if (!WritePipe || (!Data && Length > 0))
+    {
+        return false;
+    }
+
+#if PLATFORM_WINDOWS
+    // anonymous pipes block in WriteFile until the child has taken everything, so a stalled worker would hang the
+    // caller; in PIPE_NOWAIT mode a full pipe takes what fits (or nothing) and returns, which lets us time out
+    HANDLE Handle = static_cast<HANDLE>(WritePipe);
+    ::DWORD Mode = PIPE_NOWAIT;
+    const bool bNonBlocking = !!::SetNamedPipeHandleState(Handle, &Mode, nullptr, nullptr);
+    // a non-blocking write larger than the pipe's whole buffer may never go through, so stay below its default size
+    const int32 MaxChunkSize = bNonBlocking ? 4096 : Length;
+
+    int32 Offset = 0;
+    double LastProgressTime = FPlatformTime::Seconds();
+    while (Offset < Length)
+    {
+        ::DWORD BytesWritten = 0;
+        const int32 ChunkSize = FMath::Min(MaxChunkSize, Length - Offset);
+        if (!::WriteFile(Handle, Data + Offset, static_cast<::DWORD>(ChunkSize), &BytesWritten, nullptr))
+        {
+            // ERROR_NO_DATA / ERROR_BROKEN_PIPE: the child closed its end
+            return false;
+        }
+        if (BytesWritten > 0)
+        {
+            Offset += static_cast<int32>(BytesWritten);
+            LastProgressTime = FPlatformTime::Seconds();
+            continue;
+        }
+        if (FPlatformTime::Seconds() - LastProgressTime > TimeoutSeconds)
+        {
+            return false;
+        }
+        FPlatformProcess::Sleep(0.001f);
+    }
+    return true;
+#elif PLATFORM_UNIX
+    // the editor's pipes are non-blocking, so a full pipe shows up as EAGAIN rather than a wait
+    const int Fd = static_cast<FPipeHandle*>(WritePipe)->GetHandle();
+    int32 Offset = 0;
+    double LastProgressTime = FPlatformTime::Seconds();
+    while (Offset < Length)
+    {
+        const ssize_t BytesWritten = write(Fd, Data + Offset, Length - Offset);
+        if (BytesWritten > 0)
+        {
+            Offset += static_cast<int32>(BytesWritten);
+            LastProgressTime = FPlatformTime::Seconds();
+            continue;
+        }
+        if (BytesWritten < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            // EPIPE: the child exited
+            return false;
+        }
+
+        const double RemainingSeconds = LastProgressTime + TimeoutSeconds - FPlatformTime::Seconds();
+        if (RemainingSeconds <= 0.0)
+        {
+            return false;
+        }
+        pollfd PollFd;
+        PollFd.fd = Fd;
+        PollFd.events = POLLOUT;
+        PollFd.revents = 0;
+        poll(&PollFd, 1, FMath::Max(1, static_cast<int>(RemainingSeconds * 1000.0)));
+    }
+    return true;
+#else
+    int32 Offset = 0;
+    double LastProgressTime = FPlatformTime::Seconds();
+    while (Offset < Length)
+    {
+        int32 BytesWritten = 0;
+        FPlatformProcess::WritePipe(WritePipe, Data + Offset, Length - Offset, &BytesWritten);
+        if (BytesWritten > 0)
+        {
+            Offset += BytesWritten;
+            LastProgressTime = FPlatformTime::Seconds();
+        }
+        else if (FPlatformTime::Seconds() - LastProgressTime > TimeoutSeconds)
+        {
+            return false;
+        }
+        else
+        {
+            FPlatformProcess::Sleep(0.001f);
+        }
+    }
+    return true;
+#endif
+}
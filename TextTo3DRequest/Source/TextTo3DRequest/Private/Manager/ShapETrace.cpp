@@ -0,0 +1,98 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Manager/ShapETrace.h"
+#include "Manager/ShapEJobTypes.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(ShapEChannel)
+
+UE_TRACE_EVENT_BEGIN(ShapE, StageSpan)
+    UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+    UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, JobId)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Stage)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_FLOAT_COUNTER(ShapEQueueWaitMs, TEXT("ShapE/QueueWaitMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEWorkerSpawnMs, TEXT("ShapE/WorkerSpawnMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEWorkerBootMs, TEXT("ShapE/WorkerBootMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEModelLoadMs, TEXT("ShapE/ModelLoadMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapESampleMs, TEXT("ShapE/SampleMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEDecodeMs, TEXT("ShapE/DecodeMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEExportMs, TEXT("ShapE/ExportMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEImportMs, TEXT("ShapE/ImportMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShapEJobTotalMs, TEXT("ShapE/JobTotalMs"));
+
+namespace ShapETrace
+{
+    static FString MakeRegionName(const FString& Stage)
+    {
+        return TEXT("ShapE ") + Stage;
+    }
+
+    void BeginStage(const FString& Stage)
+    {
+        if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ShapEChannel))
+        {
+            TRACE_BEGIN_REGION(*MakeRegionName(Stage));
+        }
+    }
+
+    void EndStage(const FString& Stage)
+    {
+        if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ShapEChannel))
+        {
+            TRACE_END_REGION(*MakeRegionName(Stage));
+        }
+    }
+
+    void OutputSpan(const FString& JobId, const FShapETimingSpan& Span)
+    {
+        const double Milliseconds = Span.GetDuration() * 1000.0;
+        if (Span.Stage == ShapEStages::QueueWait)
+        {
+            TRACE_COUNTER_SET(ShapEQueueWaitMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::WorkerSpawn)
+        {
+            TRACE_COUNTER_SET(ShapEWorkerSpawnMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::WorkerBoot)
+        {
+            TRACE_COUNTER_SET(ShapEWorkerBootMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::ModelLoad)
+        {
+            TRACE_COUNTER_SET(ShapEModelLoadMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::Sample)
+        {
+            TRACE_COUNTER_SET(ShapESampleMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::Decode)
+        {
+            TRACE_COUNTER_SET(ShapEDecodeMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::ExportFiles || Span.Stage == ShapEStages::ExportSharedMemory)
+        {
+            TRACE_COUNTER_SET(ShapEExportMs, Milliseconds);
+        }
+        else if (Span.Stage == ShapEStages::Import)
+        {
+            TRACE_COUNTER_SET(ShapEImportMs, Milliseconds);
+        }
+
+        // FPlatformTime::Seconds and Cycles64 share a clock, so the span lines up with the rest of the trace
+        const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+        UE_TRACE_LOG(ShapE, StageSpan, ShapEChannel)
+            << StageSpan.StartCycle(uint64(Span.StartSeconds / SecondsPerCycle))
+            << StageSpan.EndCycle(uint64(Span.EndSeconds / SecondsPerCycle))
+            << StageSpan.JobId(*JobId, JobId.Len())
+            << StageSpan.Stage(*Span.Stage, Span.Stage.Len());
+    }
+
+    void OutputJobTotal(double TotalSeconds)
+    {
+        TRACE_COUNTER_SET(ShapEJobTotalMs, TotalSeconds * 1000.0);
+    }
+}
@@ -0,0 +1,525 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Processing/FShapEMeshCleanup.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "Math/VectorRegister.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+
+namespace
+{
+    // A multiple of 4, so SIMD groups never straddle two chunks
+    constexpr int32 ChunkSize = 4096;
+
+    template <typename FunctionType>
+    void ForEachChunk(int32 Num, bool bParallel, const FunctionType& Function)
+    {
+        const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+        ParallelFor(NumChunks, [&Function, Num](int32 Chunk)
+        {
+            const int32 Start = Chunk * ChunkSize;
+            Function(Start, FMath::Min(Start + ChunkSize, Num));
+        }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+    }
+
+    FORCEINLINE uint32 HashCell(int32 X, int32 Y, int32 Z)
+    {
+        return ((uint32)X * 73856093u) ^ ((uint32)Y * 19349663u) ^ ((uint32)Z * 83492791u);
+    }
+
+    void GatherFloats(TArray<float>& Values, const TArray<int32>& Sources, bool bParallel)
+    {
+        if (Values.IsEmpty())
+        {
+            return;
+        }
+        TArray<float> Gathered;
+        Gathered.SetNumUninitialized(Sources.Num());
+        ForEachChunk(Sources.Num(), bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Index = Start; Index < End; ++Index)
+            {
+                Gathered[Index] = Values[Sources[Index]];
+            }
+        });
+        Values = MoveTemp(Gathered);
+    }
+
+    // Keeps the vertices listed in Sources (old indices, in their new order) and rewrites the indices through Remap
+    void CompactVertices(FShapEMeshSoA& SoA, const TArray<int32>& Sources, const TArray<int32>& Remap, bool bParallel)
+    {
+        for (TArray<float>* Values : { &SoA.PositionX, &SoA.PositionY, &SoA.PositionZ, &SoA.ColorR, &SoA.ColorG, &SoA.ColorB, &SoA.ColorA })
+        {
+            GatherFloats(*Values, Sources, bParallel);
+        }
+        for (TArray<float>* Values : { &SoA.NormalX, &SoA.NormalY, &SoA.NormalZ, &SoA.TangentX, &SoA.TangentY, &SoA.TangentZ })
+        {
+            Values->Reset();
+        }
+
+        ForEachChunk(SoA.Indices.Num(), bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Index = Start; Index < End; ++Index)
+            {
+                SoA.Indices[Index] = Remap[SoA.Indices[Index]];
+            }
+        });
+    }
+
+    // Area-weighted face normals (twice the area in length), four triangles per register; the arrays are padded to a multiple of 4
+    void ComputeFaceNormals(const FShapEMeshSoA& SoA, TArray<float>& OutX, TArray<float>& OutY, TArray<float>& OutZ, bool bParallel)
+    {
+        const int32 NumTriangles = SoA.NumTriangles();
+        const int32 Padded = Align(NumTriangles, 4);
+        OutX.SetNumUninitialized(Padded);
+        OutY.SetNumUninitialized(Padded);
+        OutZ.SetNumUninitialized(Padded);
+
+        const float* X = SoA.PositionX.GetData();
+        const float* Y = SoA.PositionY.GetData();
+        const float* Z = SoA.PositionZ.GetData();
+        const int32* Indices = SoA.Indices.GetData();
+
+        ForEachChunk(NumTriangles, bParallel, [&](int32 Start, int32 End)
+        {
+            float Ax[4], Ay[4], Az[4], Bx[4], By[4], Bz[4], Cx[4], Cy[4], Cz[4];
+            for (int32 First = Start; First < End; First += 4)
+            {
+                for (int32 Lane = 0; Lane < 4; ++Lane)
+                {
+                    // the tail repeats the last triangle; those lanes land in the padding
+                    const int32* Corners = Indices + FMath::Min(First + Lane, End - 1) * 3;
+                    Ax[Lane] = X[Corners[0]]; Ay[Lane] = Y[Corners[0]]; Az[Lane] = Z[Corners[0]];
+                    Bx[Lane] = X[Corners[1]]; By[Lane] = Y[Corners[1]]; Bz[Lane] = Z[Corners[1]];
+                    Cx[Lane] = X[Corners[2]]; Cy[Lane] = Y[Corners[2]]; Cz[Lane] = Z[Corners[2]];
+                }
+
+                const VectorRegister4Float AX = VectorLoad(Ax), AY = VectorLoad(Ay), AZ = VectorLoad(Az);
+                const VectorRegister4Float E1X = VectorSubtract(VectorLoad(Cx), AX), E1Y = VectorSubtract(VectorLoad(Cy), AY), E1Z = VectorSubtract(VectorLoad(Cz), AZ);
+                const VectorRegister4Float E2X = VectorSubtract(VectorLoad(Bx), AX), E2Y = VectorSubtract(VectorLoad(By), AY), E2Z = VectorSubtract(VectorLoad(Bz), AZ);
+
+                // (C - A) x (B - A), the winding UE's own normal computation uses
+                VectorStore(VectorNegateMultiplyAdd(E1Z, E2Y, VectorMultiply(E1Y, E2Z)), OutX.GetData() + First);
+                VectorStore(VectorNegateMultiplyAdd(E1X, E2Z, VectorMultiply(E1Z, E2X)), OutY.GetData() + First);
+                VectorStore(VectorNegateMultiplyAdd(E1Y, E2X, VectorMultiply(E1X, E2Y)), OutZ.GetData() + First);
+            }
+        });
+    }
+}
+
+bool FShapEMeshCleanup::Run(FMeshDescription& InOutMesh, const FShapEMeshCleanupOptions& Options, FShapEMeshCleanupStats* OutStats)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    FShapEMeshCleanupStats Stats;
+
+    // Shap-E meshes have a single material slot, which the rebuilt mesh keeps
+    FName MaterialSlotName = NAME_None;
+    {
+        const FStaticMeshConstAttributes Attributes(InOutMesh);
+        const TPolygonGroupAttributesConstRef<FName> SlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+        for (const FPolygonGroupID GroupID : InOutMesh.PolygonGroups().GetElementIDs())
+        {
+            MaterialSlotName = SlotNames.IsValid() ? SlotNames[GroupID] : NAME_None;
+            break;
+        }
+    }
+
+    FShapEMeshSoA SoA;
+    ExtractSoA(InOutMesh, SoA);
+    Stats.VerticesBefore = SoA.NumVertices();
+    Stats.TrianglesBefore = SoA.NumTriangles();
+
+    double PassStart = FPlatformTime::Seconds();
+    WeldVertices(SoA, Options.WeldTolerance, Options.bParallel);
+    Stats.WeldSeconds = FPlatformTime::Seconds() - PassStart;
+
+    PassStart = FPlatformTime::Seconds();
+    RemoveDegenerateTriangles(SoA, Options.MinTriangleArea, Options.bRemoveDuplicateTriangles, Options.bParallel, Stats);
+    Stats.FilterSeconds = FPlatformTime::Seconds() - PassStart;
+
+    if (SoA.NumTriangles() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FShapEMeshCleanup: Every triangle was degenerate, keeping the mesh as it was"));
+        return false;
+    }
+
+    if (Options.bComputeNormalsAndTangents)
+    {
+        PassStart = FPlatformTime::Seconds();
+        ComputeNormalsAndTangents(SoA, Options.bParallel);
+        Stats.NormalSeconds = FPlatformTime::Seconds() - PassStart;
+    }
+
+    BuildMeshDescription(SoA, InOutMesh, MaterialSlotName);
+
+    Stats.VerticesAfter = SoA.NumVertices();
+    Stats.TrianglesAfter = SoA.NumTriangles();
+    Stats.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FShapEMeshCleanup: %d -> %d vertices, %d -> %d triangles (%d degenerate, %d duplicate) in %.1f ms (weld %.1f, filter %.1f, normals %.1f)"),
+        Stats.VerticesBefore, Stats.VerticesAfter, Stats.TrianglesBefore, Stats.TrianglesAfter, Stats.DegenerateTriangles, Stats.DuplicateTriangles,
+        Stats.TotalSeconds * 1000.0, Stats.WeldSeconds * 1000.0, Stats.FilterSeconds * 1000.0, Stats.NormalSeconds * 1000.0);
+    return true;
+}
+
+void FShapEMeshCleanup::ExtractSoA(const FMeshDescription& Mesh, FShapEMeshSoA& OutSoA)
+{
+    OutSoA = FShapEMeshSoA();
+
+    const FStaticMeshConstAttributes Attributes(Mesh);
+    const TVertexAttributesConstRef<FVector3f> Positions = Attributes.GetVertexPositions();
+    const TVertexInstanceAttributesConstRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+
+    const int32 NumVertices = Mesh.Vertices().Num();
+    for (TArray<float>* Values : { &OutSoA.PositionX, &OutSoA.PositionY, &OutSoA.PositionZ, &OutSoA.ColorR, &OutSoA.ColorG, &OutSoA.ColorB, &OutSoA.ColorA })
+    {
+        Values->Reserve(NumVertices);
+    }
+
+    // element ids can be sparse after edits, so they are packed on the way out
+    TArray<int32> PackedIndex;
+    PackedIndex.Init(INDEX_NONE, Mesh.Vertices().GetArraySize());
+    for (const FVertexID VertexID : Mesh.Vertices().GetElementIDs())
+    {
+        PackedIndex[VertexID.GetValue()] = OutSoA.PositionX.Num();
+
+        const FVector3f Position = Positions[VertexID];
+        OutSoA.PositionX.Add(Position.X);
+        OutSoA.PositionY.Add(Position.Y);
+        OutSoA.PositionZ.Add(Position.Z);
+
+        // one color per position; the importer creates a single instance per vertex
+        const TArrayView<const FVertexInstanceID> Instances = Mesh.GetVertexVertexInstanceIDs(VertexID);
+        const FVector4f Color = Colors.IsValid() && Instances.Num() > 0 ? Colors[Instances[0]] : FVector4f(1.0f, 1.0f, 1.0f, 1.0f);
+        OutSoA.ColorR.Add(Color.X);
+        OutSoA.ColorG.Add(Color.Y);
+        OutSoA.ColorB.Add(Color.Z);
+        OutSoA.ColorA.Add(Color.W);
+    }
+
+    OutSoA.Indices.Reserve(Mesh.Triangles().Num() * 3);
+    for (const FTriangleID TriangleID : Mesh.Triangles().GetElementIDs())
+    {
+        for (const FVertexID VertexID : Mesh.GetTriangleVertices(TriangleID))
+        {
+            OutSoA.Indices.Add(PackedIndex[VertexID.GetValue()]);
+        }
+    }
+}
+
+void FShapEMeshCleanup::BuildMeshDescription(const FShapEMeshSoA& SoA, FMeshDescription& OutMesh, FName MaterialSlotName)
+{
+    OutMesh.Empty();
+    FStaticMeshAttributes Attributes(OutMesh);
+    Attributes.Register();
+
+    const int32 NumVertices = SoA.NumVertices();
+    const int32 NumTriangles = SoA.NumTriangles();
+    OutMesh.ReserveNewVertices(NumVertices);
+    OutMesh.ReserveNewVertexInstances(NumVertices);
+    OutMesh.ReserveNewTriangles(NumTriangles);
+    OutMesh.ReserveNewPolygons(NumTriangles);
+    OutMesh.ReserveNewEdges(NumTriangles * 3 / 2 + 1);
+
+    TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+    TVertexInstanceAttributesRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+    TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+    TVertexInstanceAttributesRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+    TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+
+    const FPolygonGroupID PolygonGroup = OutMesh.CreatePolygonGroup();
+    Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = MaterialSlotName;
+
+    const bool bHasColors = SoA.ColorR.Num() == NumVertices;
+    const bool bHasNormals = SoA.HasNormals();
+    for (int32 Index = 0; Index < NumVertices; ++Index)
+    {
+        const FVertexID VertexID = OutMesh.CreateVertex();
+        Positions[VertexID] = FVector3f(SoA.PositionX[Index], SoA.PositionY[Index], SoA.PositionZ[Index]);
+
+        const FVertexInstanceID InstanceID = OutMesh.CreateVertexInstance(VertexID);
+        if (bHasColors)
+        {
+            Colors[InstanceID] = FVector4f(SoA.ColorR[Index], SoA.ColorG[Index], SoA.ColorB[Index], SoA.ColorA[Index]);
+        }
+        if (bHasNormals)
+        {
+            Normals[InstanceID] = FVector3f(SoA.NormalX[Index], SoA.NormalY[Index], SoA.NormalZ[Index]);
+            Tangents[InstanceID] = FVector3f(SoA.TangentX[Index], SoA.TangentY[Index], SoA.TangentZ[Index]);
+            BinormalSigns[InstanceID] = 1.0f;
+        }
+    }
+
+    // vertex instance ids are dense from zero on an emptied mesh
+    for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+    {
+        const FVertexInstanceID Corners[3] = {
+            FVertexInstanceID(SoA.Indices[Triangle * 3 + 0]),
+            FVertexInstanceID(SoA.Indices[Triangle * 3 + 1]),
+            FVertexInstanceID(SoA.Indices[Triangle * 3 + 2]) };
+        OutMesh.CreateTriangle(PolygonGroup, MakeArrayView(Corners, 3));
+    }
+}
+
+void FShapEMeshCleanup::WeldVertices(FShapEMeshSoA& SoA, float Tolerance, bool bParallel)
+{
+    const int32 NumVertices = SoA.NumVertices();
+    if (NumVertices == 0)
+    {
+        return;
+    }
+
+    const float CellSize = FMath::Max(Tolerance, UE_SMALL_NUMBER);
+    const float InvCellSize = 1.0f / CellSize;
+    const float ToleranceSquared = Tolerance * Tolerance;
+
+    TArray<FIntVector> Cells;
+    Cells.SetNumUninitialized(NumVertices);
+    ForEachChunk(NumVertices, bParallel, [&](int32 Start, int32 End)
+    {
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            Cells[Index] = FIntVector(
+                FMath::FloorToInt32(SoA.PositionX[Index] * InvCellSize),
+                FMath::FloorToInt32(SoA.PositionY[Index] * InvCellSize),
+                FMath::FloorToInt32(SoA.PositionZ[Index] * InvCellSize));
+        }
+    });
+
+    // bucket heads plus a chain through the kept vertices; a match can sit in any of the 27 surrounding cells
+    const int32 NumBuckets = FMath::RoundUpToPowerOfTwo(FMath::Max(NumVertices * 2, 16));
+    const uint32 BucketMask = (uint32)NumBuckets - 1;
+    TArray<int32> Heads;
+    Heads.Init(INDEX_NONE, NumBuckets);
+    TArray<int32> Next;
+    Next.SetNumUninitialized(NumVertices);
+
+    TArray<int32> Remap;
+    Remap.SetNumUninitialized(NumVertices);
+    TArray<int32> Kept;
+    Kept.Reserve(NumVertices);
+
+    // own cell first, that is where exact duplicates are
+    static const FIntVector NeighbourOffsets[27] = {
+        { 0, 0, 0 },
+        { -1, -1, -1 }, { 0, -1, -1 }, { 1, -1, -1 }, { -1, 0, -1 }, { 0, 0, -1 }, { 1, 0, -1 }, { -1, 1, -1 }, { 0, 1, -1 }, { 1, 1, -1 },
+        { -1, -1, 0 }, { 0, -1, 0 }, { 1, -1, 0 }, { -1, 0, 0 }, { 1, 0, 0 }, { -1, 1, 0 }, { 0, 1, 0 }, { 1, 1, 0 },
+        { -1, -1, 1 }, { 0, -1, 1 }, { 1, -1, 1 }, { -1, 0, 1 }, { 0, 0, 1 }, { 1, 0, 1 }, { -1, 1, 1 }, { 0, 1, 1 }, { 1, 1, 1 } };
+
+    for (int32 Index = 0; Index < NumVertices; ++Index)
+    {
+        const FIntVector Cell = Cells[Index];
+        const float X = SoA.PositionX[Index];
+        const float Y = SoA.PositionY[Index];
+        const float Z = SoA.PositionZ[Index];
+
+        int32 Match = INDEX_NONE;
+        for (int32 Offset = 0; Offset < 27 && Match == INDEX_NONE; ++Offset)
+        {
+            const FIntVector Neighbour = Cell + NeighbourOffsets[Offset];
+            for (int32 Candidate = Heads[HashCell(Neighbour.X, Neighbour.Y, Neighbour.Z) & BucketMask]; Candidate != INDEX_NONE; Candidate = Next[Candidate])
+            {
+                const float DX = SoA.PositionX[Candidate] - X;
+                const float DY = SoA.PositionY[Candidate] - Y;
+                const float DZ = SoA.PositionZ[Candidate] - Z;
+                if (DX * DX + DY * DY + DZ * DZ <= ToleranceSquared)
+                {
+                    Match = Candidate;
+                    break;
+                }
+            }
+        }
+
+        if (Match != INDEX_NONE)
+        {
+            Remap[Index] = Remap[Match];
+            continue;
+        }
+
+        Remap[Index] = Kept.Add(Index);
+        const uint32 Bucket = HashCell(Cell.X, Cell.Y, Cell.Z) & BucketMask;
+        Next[Index] = Heads[Bucket];
+        Heads[Bucket] = Index;
+    }
+
+    if (Kept.Num() < NumVertices)
+    {
+        CompactVertices(SoA, Kept, Remap, bParallel);
+    }
+}
+
+void FShapEMeshCleanup::RemoveDegenerateTriangles(FShapEMeshSoA& SoA, float MinTriangleArea, bool bRemoveDuplicates, bool bParallel, FShapEMeshCleanupStats& Stats)
+{
+    const int32 NumTriangles = SoA.NumTriangles();
+
+    TArray<float> FaceX, FaceY, FaceZ;
+    ComputeFaceNormals(SoA, FaceX, FaceY, FaceZ, bParallel);
+
+    // the face normal is twice the triangle area long
+    const float MinDoubleAreaSquared = 4.0f * MinTriangleArea * MinTriangleArea;
+    TArray<bool> Keep;
+    Keep.SetNumUninitialized(NumTriangles);
+    ForEachChunk(NumTriangles, bParallel, [&](int32 Start, int32 End)
+    {
+        for (int32 Triangle = Start; Triangle < End; ++Triangle)
+        {
+            const int32* Corners = SoA.Indices.GetData() + Triangle * 3;
+            const bool bCollapsed = Corners[0] == Corners[1] || Corners[1] == Corners[2] || Corners[0] == Corners[2];
+            const float DoubleAreaSquared = FaceX[Triangle] * FaceX[Triangle] + FaceY[Triangle] * FaceY[Triangle] + FaceZ[Triangle] * FaceZ[Triangle];
+            Keep[Triangle] = !bCollapsed && DoubleAreaSquared >= MinDoubleAreaSquared;
+        }
+    });
+
+    TSet<FIntVector> Seen;
+    if (bRemoveDuplicates)
+    {
+        Seen.Reserve(NumTriangles);
+    }
+
+    TArray<int32> KeptIndices;
+    KeptIndices.Reserve(SoA.Indices.Num());
+    for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+    {
+        if (!Keep[Triangle])
+        {
+            ++Stats.DegenerateTriangles;
+            continue;
+        }
+
+        const int32* Corners = SoA.Indices.GetData() + Triangle * 3;
+        if (bRemoveDuplicates)
+        {
+            // the same three corners in any order, so back-to-back copies go too
+            int32 Sorted[3] = { Corners[0], Corners[1], Corners[2] };
+            Algo::Sort(Sorted);
+            bool bAlreadySeen = false;
+            Seen.Add(FIntVector(Sorted[0], Sorted[1], Sorted[2]), &bAlreadySeen);
+            if (bAlreadySeen)
+            {
+                ++Stats.DuplicateTriangles;
+                continue;
+            }
+        }
+        KeptIndices.Append(Corners, 3);
+    }
+    SoA.Indices = MoveTemp(KeptIndices);
+
+    // vertices only the dropped triangles used
+    TArray<int32> Remap;
+    Remap.Init(INDEX_NONE, SoA.NumVertices());
+    for (const int32 Index : SoA.Indices)
+    {
+        Remap[Index] = 0;
+    }
+
+    TArray<int32> Kept;
+    Kept.Reserve(SoA.NumVertices());
+    for (int32 Index = 0; Index < Remap.Num(); ++Index)
+    {
+        if (Remap[Index] != INDEX_NONE)
+        {
+            Remap[Index] = Kept.Add(Index);
+        }
+    }
+
+    if (Kept.Num() < SoA.NumVertices())
+    {
+        CompactVertices(SoA, Kept, Remap, bParallel);
+    }
+}
+
+void FShapEMeshCleanup::ComputeNormalsAndTangents(FShapEMeshSoA& SoA, bool bParallel)
+{
+    const int32 NumVertices = SoA.NumVertices();
+    const int32 NumTriangles = SoA.NumTriangles();
+
+    TArray<float> FaceX, FaceY, FaceZ;
+    ComputeFaceNormals(SoA, FaceX, FaceY, FaceZ, bParallel);
+
+    // vertex -> triangle adjacency, so every vertex sums its own faces without atomics
+    TArray<int32> FirstFace;
+    FirstFace.SetNumZeroed(NumVertices + 1);
+    for (const int32 Index : SoA.Indices)
+    {
+        ++FirstFace[Index + 1];
+    }
+    for (int32 Index = 0; Index < NumVertices; ++Index)
+    {
+        FirstFace[Index + 1] += FirstFace[Index];
+    }
+    TArray<int32> Fill = FirstFace;
+    TArray<int32> VertexFaces;
+    VertexFaces.SetNumUninitialized(SoA.Indices.Num());
+    for (int32 Corner = 0; Corner < SoA.Indices.Num(); ++Corner)
+    {
+        VertexFaces[Fill[SoA.Indices[Corner]]++] = Corner / 3;
+    }
+
+    const int32 Padded = Align(NumVertices, 4);
+    for (TArray<float>* Values : { &SoA.NormalX, &SoA.NormalY, &SoA.NormalZ, &SoA.TangentX, &SoA.TangentY, &SoA.TangentZ })
+    {
+        Values->SetNumUninitialized(Padded);
+    }
+
+    ForEachChunk(NumVertices, bParallel, [&](int32 Start, int32 End)
+    {
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+        const VectorRegister4Float MinusOne = VectorSetFloat1(-1.0f);
+        const VectorRegister4Float Epsilon = VectorSetFloat1(UE_SMALL_NUMBER);
+
+        float SumX[4], SumY[4], SumZ[4];
+        for (int32 First = Start; First < End; First += 4)
+        {
+            for (int32 Lane = 0; Lane < 4; ++Lane)
+            {
+                SumX[Lane] = SumY[Lane] = SumZ[Lane] = 0.0f;
+                const int32 Vertex = First + Lane;
+                if (Vertex >= End)
+                {
+                    continue;
+                }
+                for (int32 Ref = FirstFace[Vertex]; Ref < FirstFace[Vertex + 1]; ++Ref)
+                {
+                    const int32 Face = VertexFaces[Ref];
+                    SumX[Lane] += FaceX[Face];
+                    SumY[Lane] += FaceY[Face];
+                    SumZ[Lane] += FaceZ[Face];
+                }
+            }
+
+            // normalize; vertices whose faces cancel out get +Z
+            const VectorRegister4Float SX = VectorLoad(SumX), SY = VectorLoad(SumY), SZ = VectorLoad(SumZ);
+            const VectorRegister4Float LengthSquared = VectorMultiplyAdd(SZ, SZ, VectorMultiplyAdd(SY, SY, VectorMultiply(SX, SX)));
+            const VectorRegister4Float Valid = VectorCompareGT(LengthSquared, Epsilon);
+            const VectorRegister4Float InvLength = VectorReciprocalSqrt(VectorMax(LengthSquared, Epsilon));
+            const VectorRegister4Float NX = VectorSelect(Valid, VectorMultiply(SX, InvLength), Zero);
+            const VectorRegister4Float NY = VectorSelect(Valid, VectorMultiply(SY, InvLength), Zero);
+            const VectorRegister4Float NZ = VectorSelect(Valid, VectorMultiply(SZ, InvLength), One);
+
+            // branchless orthonormal basis around the normal (Duff et al. 2017)
+            const VectorRegister4Float Sign = VectorSelect(VectorCompareGE(NZ, Zero), One, MinusOne);
+            const VectorRegister4Float A = VectorDivide(MinusOne, VectorAdd(Sign, NZ));
+            const VectorRegister4Float B = VectorMultiply(VectorMultiply(NX, NY), A);
+            const VectorRegister4Float TX = VectorMultiplyAdd(VectorMultiply(Sign, VectorMultiply(NX, NX)), A, One);
+            const VectorRegister4Float TY = VectorMultiply(Sign, B);
+            const VectorRegister4Float TZ = VectorNegate(VectorMultiply(Sign, NX));
+
+            VectorStore(NX, SoA.NormalX.GetData() + First);
+            VectorStore(NY, SoA.NormalY.GetData() + First);
+            VectorStore(NZ, SoA.NormalZ.GetData() + First);
+            VectorStore(TX, SoA.TangentX.GetData() + First);
+            VectorStore(TY, SoA.TangentY.GetData() + First);
+            VectorStore(TZ, SoA.TangentZ.GetData() + First);
+        }
+    });
+
+    for (TArray<float>* Values : { &SoA.NormalX, &SoA.NormalY, &SoA.NormalZ, &SoA.TangentX, &SoA.TangentY, &SoA.TangentZ })
+    {
+        Values->SetNum(NumVertices, EAllowShrinking::No);
+    }
+}
@@ -0,0 +1,615 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "Processing/FShapEMeshDecimator.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    constexpr int32 ChunkSize = 4096;
+
+    template <typename FunctionType>
+    void ForEachChunk(int32 Num, bool bParallel, const FunctionType& Function)
+    {
+        const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+        ParallelFor(NumChunks, [&Function, Num](int32 Chunk)
+        {
+            const int32 Start = Chunk * ChunkSize;
+            Function(Start, FMath::Min(Start + ChunkSize, Num));
+        }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+    }
+
+    // Symmetric 4x4 plane quadric: error(p) = p'Ap + 2b'p + c
+    struct FQuadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+        double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+        double C = 0.0;
+
+        void AddPlane(const FVector3d& Normal, double Distance, double Weight)
+        {
+            A00 += Weight * Normal.X * Normal.X;
+            A01 += Weight * Normal.X * Normal.Y;
+            A02 += Weight * Normal.X * Normal.Z;
+            A11 += Weight * Normal.Y * Normal.Y;
+            A12 += Weight * Normal.Y * Normal.Z;
+            A22 += Weight * Normal.Z * Normal.Z;
+            B0 += Weight * Distance * Normal.X;
+            B1 += Weight * Distance * Normal.Y;
+            B2 += Weight * Distance * Normal.Z;
+            C += Weight * Distance * Distance;
+        }
+
+        FQuadric& operator+=(const FQuadric& Other)
+        {
+            A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+            A11 += Other.A11; A12 += Other.A12; A22 += Other.A22;
+            B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+            C += Other.C;
+            return *this;
+        }
+
+        double Evaluate(const FVector3d& P) const
+        {
+            const double X = P.X, Y = P.Y, Z = P.Z;
+            const double Error = A00 * X * X + 2.0 * A01 * X * Y + 2.0 * A02 * X * Z + A11 * Y * Y + 2.0 * A12 * Y * Z + A22 * Z * Z
+                + 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+            return FMath::Max(Error, 0.0);
+        }
+
+        // Point of least error; false when A is close to singular (flat or straight neighbourhoods)
+        bool Minimize(FVector3d& OutPoint) const
+        {
+            const double C00 = A11 * A22 - A12 * A12;
+            const double C01 = A02 * A12 - A01 * A22;
+            const double C02 = A01 * A12 - A02 * A11;
+            const double Det = A00 * C00 + A01 * C01 + A02 * C02;
+            const double Scale = FMath::Max3(A00, A11, A22);
+            if (Scale <= 0.0 || FMath::Abs(Det) < 1e-9 * Scale * Scale * Scale)
+            {
+                return false;
+            }
+
+            const double C11 = A00 * A22 - A02 * A02;
+            const double C12 = A01 * A02 - A00 * A12;
+            const double C22 = A00 * A11 - A01 * A01;
+            const double InvDet = 1.0 / Det;
+            OutPoint.X = -(C00 * B0 + C01 * B1 + C02 * B2) * InvDet;
+            OutPoint.Y = -(C01 * B0 + C11 * B1 + C12 * B2) * InvDet;
+            OutPoint.Z = -(C02 * B0 + C12 * B1 + C22 * B2) * InvDet;
+            return true;
+        }
+    };
+
+    struct FCollapse
+    {
+        double Cost = 0.0;
+        FVector3d Position = FVector3d::ZeroVector;
+        // Where Position falls along the edge from V0 to V1, used to blend the colors
+        float Alpha = 0.0f;
+        int32 V0 = INDEX_NONE;
+        int32 V1 = INDEX_NONE;
+        uint32 Stamp0 = 0;
+        uint32 Stamp1 = 0;
+    };
+
+    struct FCollapseLess
+    {
+        bool operator()(const FCollapse& A, const FCollapse& B) const { return A.Cost < B.Cost; }
+    };
+
+    FORCEINLINE uint64 MakeEdgeKey(int32 A, int32 B)
+    {
+        return A < B ? ((uint64)(uint32)A << 32) | (uint32)B : ((uint64)(uint32)B << 32) | (uint32)A;
+    }
+
+    FORCEINLINE FVector3d FaceNormal(const FVector3d& A, const FVector3d& B, const FVector3d& C)
+    {
+        return FVector3d::CrossProduct(C - A, B - A);
+    }
+
+    /** Everything the collapse loop starts from; identical for every LOD, so it is built once and copied. */
+    struct FDecimationInput
+    {
+        TArray<FVector3d> Positions;
+        TArray<FVector4f> Colors;
+        TArray<FQuadric> Quadrics;
+        // A third of the area of every face around the vertex, weighting its color shift
+        TArray<double> Areas;
+        TArray<FIntVector> Triangles;
+        // Faces around each vertex, CSR
+        TArray<int32> VertexTriangleOffsets;
+        TArray<int32> VertexTriangles;
+        // Initial collapse of every edge, already in heap order
+        TArray<FCollapse> Heap;
+    };
+
+    class FCollapseState
+    {
+    public:
+        FCollapseState(const FDecimationInput& Input, const FShapEMeshDecimationOptions& InOptions)
+            : Options(InOptions)
+            , Positions(Input.Positions)
+            , Colors(Input.Colors)
+            , Quadrics(Input.Quadrics)
+            , Areas(Input.Areas)
+            , Triangles(Input.Triangles)
+            , Heap(Input.Heap)
+        {
+            const int32 NumVertices = Positions.Num();
+            Stamps.SetNumZeroed(NumVertices);
+            RemovedVertices.Init(false, NumVertices);
+            RemovedTriangles.Init(false, Triangles.Num());
+            LiveTriangles = Triangles.Num();
+
+            VertexTriangles.SetNum(NumVertices);
+            for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+            {
+                const int32 Start = Input.VertexTriangleOffsets[Vertex];
+                VertexTriangles[Vertex].Append(&Input.VertexTriangles[Start], Input.VertexTriangleOffsets[Vertex + 1] - Start);
+            }
+        }
+
+        static FCollapse Evaluate(int32 V0, int32 V1, const TArray<FVector3d>& Positions, const TArray<FVector4f>& Colors,
+            const TArray<FQuadric>& Quadrics, const TArray<double>& Areas, const FShapEMeshDecimationOptions& Options)
+        {
+            FCollapse Collapse;
+            Collapse.V0 = V0;
+            Collapse.V1 = V1;
+
+            FQuadric Quadric = Quadrics[V0];
+            Quadric += Quadrics[V1];
+
+            const FVector3d& P0 = Positions[V0];
+            const FVector3d& P1 = Positions[V1];
+            const FVector3d Edge = P1 - P0;
+            const double EdgeLengthSquared = Edge.SizeSquared();
+
+            // the optimum of a nearly flat neighbourhood can land far off the edge, so it has to stay close
+            FVector3d Optimum;
+            if (Quadric.Minimize(Optimum) && FVector3d::DistSquared(Optimum, (P0 + P1) * 0.5) <= 4.0 * EdgeLengthSquared)
+            {
+                Collapse.Position = Optimum;
+                Collapse.Cost = Quadric.Evaluate(Optimum);
+            }
+            else
+            {
+                const FVector3d Candidates[3] = { P0, P1, (P0 + P1) * 0.5 };
+                Collapse.Cost = TNumericLimits<double>::Max();
+                for (const FVector3d& Candidate : Candidates)
+                {
+                    const double Error = Quadric.Evaluate(Candidate);
+                    if (Error < Collapse.Cost)
+                    {
+                        Collapse.Cost = Error;
+                        Collapse.Position = Candidate;
+                    }
+                }
+            }
+
+            const double Alpha = EdgeLengthSquared > 0.0 ? FMath::Clamp(FVector3d::DotProduct(Collapse.Position - P0, Edge) / EdgeLengthSquared, 0.0, 1.0) : 0.5;
+            Collapse.Alpha = (float)Alpha;
+
+            // V0's surroundings shift by Alpha of the color difference, V1's by the rest
+            const FVector4f ColorDelta = Colors[V1] - Colors[V0];
+            const double ColorDeltaSquared = (double)ColorDelta.X * ColorDelta.X + (double)ColorDelta.Y * ColorDelta.Y + (double)ColorDelta.Z * ColorDelta.Z + (double)ColorDelta.W * ColorDelta.W;
+            const double ColorScale = (double)Options.ColorDistance * Options.ColorDistance;
+            Collapse.Cost += ColorScale * ColorDeltaSquared * (Alpha * Alpha * Areas[V0] + (1.0 - Alpha) * (1.0 - Alpha) * Areas[V1]);
+            return Collapse;
+        }
+
+        void Run(int32 TargetTriangles)
+        {
+            FCollapse Collapse;
+            while (LiveTriangles > TargetTriangles && Heap.Num() > 0)
+            {
+                Heap.HeapPop(Collapse, FCollapseLess(), EAllowShrinking::No);
+                if (RemovedVertices[Collapse.V0] || RemovedVertices[Collapse.V1]
+                    || Stamps[Collapse.V0] != Collapse.Stamp0 || Stamps[Collapse.V1] != Collapse.Stamp1)
+                {
+                    continue;
+                }
+                if (!CanCollapse(Collapse.V0, Collapse.V1, Collapse.Position))
+                {
+                    continue;
+                }
+                Apply(Collapse);
+            }
+        }
+
+        void Extract(FShapEMeshSoA& OutMesh) const
+        {
+            OutMesh = FShapEMeshSoA();
+
+            TArray<int32> Remap;
+            Remap.Init(INDEX_NONE, Positions.Num());
+            OutMesh.Indices.Reserve(LiveTriangles * 3);
+            for (int32 Triangle = 0; Triangle < Triangles.Num(); ++Triangle)
+            {
+                if (RemovedTriangles[Triangle])
+                {
+                    continue;
+                }
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    const int32 Vertex = Triangles[Triangle][Corner];
+                    if (Remap[Vertex] == INDEX_NONE)
+                    {
+                        Remap[Vertex] = OutMesh.PositionX.Num();
+                        OutMesh.PositionX.Add((float)Positions[Vertex].X);
+                        OutMesh.PositionY.Add((float)Positions[Vertex].Y);
+                        OutMesh.PositionZ.Add((float)Positions[Vertex].Z);
+                        OutMesh.ColorR.Add(Colors[Vertex].X);
+                        OutMesh.ColorG.Add(Colors[Vertex].Y);
+                        OutMesh.ColorB.Add(Colors[Vertex].Z);
+                        OutMesh.ColorA.Add(Colors[Vertex].W);
+                    }
+                    OutMesh.Indices.Add(Remap[Vertex]);
+                }
+            }
+        }
+
+    private:
+        bool CanCollapse(int32 V0, int32 V1, const FVector3d& Position) const
+        {
+            // link condition: the two rings may only share the vertices opposite the edge, or the surface pinches
+            TArray<int32, TInlineAllocator<32>> Ring0;
+            int32 EdgeTriangles = 0;
+            for (const int32 Triangle : VertexTriangles[V0])
+            {
+                if (RemovedTriangles[Triangle])
+                {
+                    continue;
+                }
+                const FIntVector& Corners = Triangles[Triangle];
+                const bool bOnEdge = Corners.X == V1 || Corners.Y == V1 || Corners.Z == V1;
+                EdgeTriangles += bOnEdge ? 1 : 0;
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    if (Corners[Corner] != V0 && Corners[Corner] != V1)
+                    {
+                        Ring0.AddUnique(Corners[Corner]);
+                    }
+                }
+            }
+            if (EdgeTriangles == 0)
+            {
+                return false;
+            }
+
+            TArray<int32, TInlineAllocator<32>> Shared;
+            for (const int32 Triangle : VertexTriangles[V1])
+            {
+                if (RemovedTriangles[Triangle])
+                {
+                    continue;
+                }
+                const FIntVector& Corners = Triangles[Triangle];
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    if (Ring0.Contains(Corners[Corner]))
+                    {
+                        Shared.AddUnique(Corners[Corner]);
+                    }
+                }
+            }
+            if (Shared.Num() != EdgeTriangles)
+            {
+                return false;
+            }
+
+            // no face around either end may fold over or collapse to a sliver
+            for (const int32 Vertex : { V0, V1 })
+            {
+                for (const int32 Triangle : VertexTriangles[Vertex])
+                {
+                    if (RemovedTriangles[Triangle])
+                    {
+                        continue;
+                    }
+                    const FIntVector& Corners = Triangles[Triangle];
+                    if ((Corners.X == V0 || Corners.Y == V0 || Corners.Z == V0) && (Corners.X == V1 || Corners.Y == V1 || Corners.Z == V1))
+                    {
+                        continue;
+                    }
+
+                    FVector3d Moved[3] = { Positions[Corners.X], Positions[Corners.Y], Positions[Corners.Z] };
+                    const FVector3d Before = FaceNormal(Moved[0], Moved[1], Moved[2]);
+                    for (int32 Corner = 0; Corner < 3; ++Corner)
+                    {
+                        if (Corners[Corner] == Vertex)
+                        {
+                            Moved[Corner] = Position;
+                        }
+                    }
+                    const FVector3d After = FaceNormal(Moved[0], Moved[1], Moved[2]);
+
+                    const double BeforeLength = Before.Size();
+                    const double AfterLength = After.Size();
+                    if (AfterLength <= 1e-6 * BeforeLength || AfterLength <= 0.0)
+                    {
+                        return false;
+                    }
+                    if (BeforeLength > 0.0 && FVector3d::DotProduct(Before, After) < Options.MinNormalDot * BeforeLength * AfterLength)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void Apply(const FCollapse& Collapse)
+        {
+            const int32 V0 = Collapse.V0;
+            const int32 V1 = Collapse.V1;
+
+            Positions[V0] = Collapse.Position;
+            Colors[V0] = FMath::Lerp(Colors[V0], Colors[V1], Collapse.Alpha);
+            Quadrics[V0] += Quadrics[V1];
+            Areas[V0] += Areas[V1];
+
+            for (const int32 Triangle : VertexTriangles[V1])
+            {
+                if (RemovedTriangles[Triangle])
+                {
+                    continue;
+                }
+                FIntVector& Corners = Triangles[Triangle];
+                if (Corners.X == V0 || Corners.Y == V0 || Corners.Z == V0)
+                {
+                    RemovedTriangles[Triangle] = true;
+                    --LiveTriangles;
+                    // the vertex opposite the edge must not see the face again, or a later collapse removes it twice
+                    for (int32 Corner = 0; Corner < 3; ++Corner)
+                    {
+                        if (Corners[Corner] != V0 && Corners[Corner] != V1)
+                        {
+                            VertexTriangles[Corners[Corner]].RemoveSingleSwap(Triangle, EAllowShrinking::No);
+                        }
+                    }
+                    continue;
+                }
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    if (Corners[Corner] == V1)
+                    {
+                        Corners[Corner] = V0;
+                    }
+                }
+                VertexTriangles[V0].Add(Triangle);
+            }
+            VertexTriangles[V0].RemoveAllSwap([this](int32 Triangle) { return RemovedTriangles[Triangle]; }, EAllowShrinking::No);
+            VertexTriangles[V1].Empty();
+            RemovedVertices[V1] = true;
+            ++Stamps[V0];
+
+            // every edge that now ends in V0 gets a fresh candidate; older ones are dropped by their stamp
+            TArray<int32, TInlineAllocator<32>> Ring;
+            for (const int32 Triangle : VertexTriangles[V0])
+            {
+                const FIntVector& Corners = Triangles[Triangle];
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    if (Corners[Corner] != V0)
+                    {
+                        Ring.AddUnique(Corners[Corner]);
+                    }
+                }
+            }
+            for (const int32 Neighbour : Ring)
+            {
+                FCollapse Candidate = Evaluate(V0, Neighbour, Positions, Colors, Quadrics, Areas, Options);
+                Candidate.Stamp0 = Stamps[V0];
+                Candidate.Stamp1 = Stamps[Neighbour];
+                Heap.HeapPush(MoveTemp(Candidate), FCollapseLess());
+            }
+        }
+
+        const FShapEMeshDecimationOptions& Options;
+        TArray<FVector3d> Positions;
+        TArray<FVector4f> Colors;
+        TArray<FQuadric> Quadrics;
+        TArray<double> Areas;
+        TArray<FIntVector> Triangles;
+        TArray<FCollapse> Heap;
+
+        TArray<TArray<int32, TInlineAllocator<8>>> VertexTriangles;
+        TArray<uint32> Stamps;
+        TBitArray<> RemovedVertices;
+        TBitArray<> RemovedTriangles;
+        int32 LiveTriangles = 0;
+    };
+
+    void PrepareInput(const FShapEMeshSoA& Source, const FShapEMeshDecimationOptions& Options, FDecimationInput& Input)
+    {
+        const int32 NumVertices = Source.NumVertices();
+        const int32 NumTriangles = Source.NumTriangles();
+        const bool bHasColors = Source.ColorR.Num() == NumVertices;
+        const bool bParallel = Options.bParallel;
+
+        Input.Positions.SetNumUninitialized(NumVertices);
+        Input.Colors.SetNumUninitialized(NumVertices);
+        ForEachChunk(NumVertices, bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Vertex = Start; Vertex < End; ++Vertex)
+            {
+                Input.Positions[Vertex] = FVector3d(Source.PositionX[Vertex], Source.PositionY[Vertex], Source.PositionZ[Vertex]);
+                Input.Colors[Vertex] = bHasColors ? FVector4f(Source.ColorR[Vertex], Source.ColorG[Vertex], Source.ColorB[Vertex], Source.ColorA[Vertex]) : FVector4f(1.0f, 1.0f, 1.0f, 1.0f);
+            }
+        });
+
+        Input.Triangles.SetNumUninitialized(NumTriangles);
+        TArray<FVector3d> FaceNormals;
+        TArray<double> FaceAreas;
+        FaceNormals.SetNumUninitialized(NumTriangles);
+        FaceAreas.SetNumUninitialized(NumTriangles);
+        ForEachChunk(NumTriangles, bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Triangle = Start; Triangle < End; ++Triangle)
+            {
+                const FIntVector Corners(Source.Indices[Triangle * 3 + 0], Source.Indices[Triangle * 3 + 1], Source.Indices[Triangle * 3 + 2]);
+                Input.Triangles[Triangle] = Corners;
+                const FVector3d Normal = FaceNormal(Input.Positions[Corners.X], Input.Positions[Corners.Y], Input.Positions[Corners.Z]);
+                const double Length = Normal.Size();
+                FaceAreas[Triangle] = Length * 0.5;
+                FaceNormals[Triangle] = Length > 0.0 ? Normal / Length : FVector3d::ZeroVector;
+            }
+        });
+
+        // faces around each vertex
+        TArray<int32>& Offsets = Input.VertexTriangleOffsets;
+        Offsets.SetNumZeroed(NumVertices + 1);
+        for (const int32 Vertex : Source.Indices)
+        {
+            ++Offsets[Vertex + 1];
+        }
+        for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+        {
+            Offsets[Vertex + 1] += Offsets[Vertex];
+        }
+        Input.VertexTriangles.SetNumUninitialized(Source.Indices.Num());
+        {
+            TArray<int32> Cursor(Offsets.GetData(), NumVertices);
+            for (int32 Index = 0; Index < Source.Indices.Num(); ++Index)
+            {
+                Input.VertexTriangles[Cursor[Source.Indices[Index]]++] = Index / 3;
+            }
+        }
+
+        Input.Quadrics.SetNumUninitialized(NumVertices);
+        Input.Areas.SetNumUninitialized(NumVertices);
+        ForEachChunk(NumVertices, bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Vertex = Start; Vertex < End; ++Vertex)
+            {
+                FQuadric Quadric;
+                double Area = 0.0;
+                for (int32 Entry = Offsets[Vertex]; Entry < Offsets[Vertex + 1]; ++Entry)
+                {
+                    const int32 Triangle = Input.VertexTriangles[Entry];
+                    const FVector3d& Normal = FaceNormals[Triangle];
+                    Quadric.AddPlane(Normal, -FVector3d::DotProduct(Normal, Input.Positions[Input.Triangles[Triangle].X]), FaceAreas[Triangle]);
+                    Area += FaceAreas[Triangle] / 3.0;
+                }
+                Input.Quadrics[Vertex] = Quadric;
+                Input.Areas[Vertex] = Area;
+            }
+        });
+
+        // unique edges; those with a single face are open borders and get a plane at right angles to that face
+        TMap<uint64, int32> EdgeFaces;
+        EdgeFaces.Reserve(NumTriangles * 3 / 2 + 1);
+        TArray<TPair<int32, int32>> Edges;
+        Edges.Reserve(NumTriangles * 3 / 2 + 1);
+        TSet<uint64> BoundaryEdges;
+        for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+        {
+            const FIntVector& Corners = Input.Triangles[Triangle];
+            for (int32 Corner = 0; Corner < 3; ++Corner)
+            {
+                const int32 A = Corners[Corner];
+                const int32 B = Corners[(Corner + 1) % 3];
+                const uint64 Key = MakeEdgeKey(A, B);
+                if (EdgeFaces.Contains(Key))
+                {
+                    BoundaryEdges.Remove(Key);
+                    continue;
+                }
+                EdgeFaces.Add(Key, Triangle);
+                BoundaryEdges.Add(Key);
+                Edges.Emplace(FMath::Min(A, B), FMath::Max(A, B));
+            }
+        }
+        for (const uint64 Key : BoundaryEdges)
+        {
+            const int32 A = (int32)(Key >> 32);
+            const int32 B = (int32)(Key & 0xffffffffu);
+            const FVector3d Edge = Input.Positions[B] - Input.Positions[A];
+            const FVector3d Normal = FVector3d::CrossProduct(Edge, FaceNormals[EdgeFaces[Key]]).GetSafeNormal();
+            if (Normal.IsZero())
+            {
+                continue;
+            }
+            const double Distance = -FVector3d::DotProduct(Normal, Input.Positions[A]);
+            const double Weight = Options.BoundaryWeight * Edge.SizeSquared();
+            Input.Quadrics[A].AddPlane(Normal, Distance, Weight);
+            Input.Quadrics[B].AddPlane(Normal, Distance, Weight);
+        }
+
+        Input.Heap.SetNumUninitialized(Edges.Num());
+        ForEachChunk(Edges.Num(), bParallel, [&](int32 Start, int32 End)
+        {
+            for (int32 Index = Start; Index < End; ++Index)
+            {
+                Input.Heap[Index] = FCollapseState::Evaluate(Edges[Index].Key, Edges[Index].Value, Input.Positions, Input.Colors, Input.Quadrics, Input.Areas, Options);
+            }
+        });
+        Input.Heap.Heapify(FCollapseLess());
+    }
+
+    void DecimateFrom(const FDecimationInput& Input, const FShapEMeshSoA& Source, int32 TargetTriangles, const FShapEMeshDecimationOptions& Options, FShapEMeshSoA& OutMesh)
+    {
+        if (TargetTriangles >= Source.NumTriangles())
+        {
+            OutMesh = Source;
+        }
+        else
+        {
+            FCollapseState State(Input, Options);
+            State.Run(FMath::Max(TargetTriangles, 1));
+            State.Extract(OutMesh);
+        }
+        if (!OutMesh.HasNormals())
+        {
+            FShapEMeshCleanup::ComputeNormalsAndTangents(OutMesh, Options.bParallel);
+        }
+    }
+}
+
+void FShapEMeshDecimator::Decimate(const FShapEMeshSoA& Source, int32 TargetTriangles, const FShapEMeshDecimationOptions& Options, FShapEMeshSoA& OutMesh)
+{
+    FDecimationInput Input;
+    PrepareInput(Source, Options, Input);
+    DecimateFrom(Input, Source, TargetTriangles, Options, OutMesh);
+}
+
+void FShapEMeshDecimator::BuildLODChain(const FShapEMeshSoA& Source, TConstArrayView<int32> TriangleBudgets, const FShapEMeshDecimationOptions& Options, TArray<FShapEMeshSoA>& OutLODs, FShapEMeshDecimationStats* OutStats)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    FShapEMeshDecimationStats Stats;
+    Stats.TrianglesBefore = Source.NumTriangles();
+
+    FDecimationInput Input;
+    PrepareInput(Source, Options, Input);
+    Stats.PrepareSeconds = FPlatformTime::Seconds() - StartTime;
+
+    // each LOD starts over from the full mesh, so they do not wait on each other
+    OutLODs.Reset();
+    OutLODs.SetNum(TriangleBudgets.Num());
+    ParallelFor(TriangleBudgets.Num(), [&](int32 LODIndex)
+    {
+        DecimateFrom(Input, Source, TriangleBudgets[LODIndex], Options, OutLODs[LODIndex]);
+    }, Options.bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+    for (const FShapEMeshSoA& LOD : OutLODs)
+    {
+        Stats.LODTriangles.Add(LOD.NumTriangles());
+    }
+    Stats.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+    if (OutStats)
+    {
+        *OutStats = MoveTemp(Stats);
+    }
+}
+
+TArray<int32> FShapEMeshDecimator::SanitizeBudgets(TConstArrayView<int32> TriangleBudgets)
+{
+    TArray<int32> Budgets;
+    for (const int32 Budget : TriangleBudgets)
+    {
+        if (Budget > 0 && (Budgets.IsEmpty() || Budget < Budgets.Last()))
+        {
+            Budgets.Add(Budget);
+        }
+    }
+    return Budgets;
+}
@@ -1,9 +1,148 @@
 // Copyright 2025 Devhanghae All Rights Reserved.
 #include "TextTo3DRequest.h"
 #include "Manager/FShapEProcessManager.h"
+#include "Backend/FShapEProcessBackend.h"
+#include "Backend/FShapEDirectLaunchBackend.h"
+#include "Backend/FShapEMockBackend.h"
+#include "Backend/FShapEHttpBackend.h"
+#include "Backend/FShapEWorkerPoolBackend.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FTextTo3DRequestModule"
 
+// Set in DefaultEngine.ini under [ConsoleVariables] to have the models loaded before the first generation
+static TAutoConsoleVariable<int32> CVarShapEWarmup(
+    TEXT("ShapE.Warmup"),
+    0,
+    TEXT("Starts the worker ahead of the first job so it does not wait for the models to load.
+")
+    TEXT("0: off, start with the first job (default)
+")
+    TEXT("1: when the editor has started
+")
+    TEXT("2: when the Shap-E tab is first opened"));
+
+static TAutoConsoleVariable<FString> CVarShapEWarmupLauncher(
+    TEXT("ShapE.Warmup.Launcher"),
+    TEXT(""),
+    TEXT("Launcher the worker is warmed up with, and the tab's default launcher. Empty for C:/AIModel/shap-e-local/run_shape.bat"));
+
+// The worker holds the models in memory for as long as it runs, so a machine short on memory is better off
+// paying the load with the first job
+static TAutoConsoleVariable<int32> CVarShapEWarmupMinFreeMemoryMB(
+    TEXT("ShapE.Warmup.MinFreeMemoryMB"),
+    6144,
+    TEXT("Free physical memory (MiB) below which the warm-up is skipped. 0 to always warm up"));
+
+// Usage: ShapE.Timing.Export [Path]
+// Writes the per-job timing of the editor's manager as CSV, or JSON for a .json path (default Saved/ShapETimings.csv)
+static FAutoConsoleCommand ShapETimingExportCommand(
+    TEXT("ShapE.Timing.Export"),
+    TEXT("Writes the per-stage timing of recent generation jobs. Args: [Path(.csv|.json)]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        TSharedPtr<FShapEProcessManager> Manager = FTextTo3DRequestModule::Get().GetProcessManager();
+        if (Manager.IsValid())
+        {
+            Manager->ExportTimings(Args.Num() > 0 ? Args[0] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShapETimings.csv")));
+        }
+    }));
+
+// Usage: ShapE.Backend process | direct [Interpreter] | mock [MsPerStep] [Segments] | http <Url>[,<Url>...] [ConnectionsPerEndpoint]
+//     | pool <Workers> [Device,Device...] [Cores;Cores... | split]
+// Switches the editor's manager between the Python worker (through its launcher script, or spawned directly without it), the
+// in-process mock (e.g. to load-test the widget and the import), remote inference servers and a pool of local workers,
+// e.g. "pool 2 0,1 0-7;8-15" for one worker per GPU and half the cores
+static FAutoConsoleCommand ShapEBackendCommand(
+    TEXT("ShapE.Backend"),
+    TEXT("Selects the generation backend of the editor. Args: process | direct [Interpreter] | mock [MsPerStep] [Segments] | http <Url>[,<Url>...] [ConnectionsPerEndpoint] | pool <Workers> [Device,Device...] [Cores;Cores... | split]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        TSharedPtr<FShapEProcessManager> Manager = FTextTo3DRequestModule::Get().GetProcessManager();
+        if (!Manager.IsValid() || Args.Num() == 0)
+        {
+            return;
+        }
+
+        if (Args[0].Equals(TEXT("mock"), ESearchCase::IgnoreCase))
+        {
+            FShapEMockBackendSettings Settings;
+            Settings.SecondsPerStep = Args.Num() > 1 ? FCString::Atof(*Args[1]) / 1000.0 : 0.0;
+            Settings.Segments = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : Settings.Segments;
+            Manager->SetBackend(MakeShared<FShapEMockBackend, ESPMode::ThreadSafe>(Settings));
+        }
+        else if (Args[0].Equals(TEXT("direct"), ESearchCase::IgnoreCase))
+        {
+            // picks up a changed shape_config.txt or SHAPE_PYTHON
+            FShapEDirectLaunchBackend::ResetInterpreterCache();
+            FShapEDirectLaunchSettings Settings;
+            Settings.Interpreter = Args.Num() > 1 ? Args[1] : FString();
+            Manager->SetBackend(MakeShared<FShapEDirectLaunchBackend, ESPMode::ThreadSafe>(Settings));
+        }
+        else if (Args[0].Equals(TEXT("http"), ESearchCase::IgnoreCase) && Args.Num() > 1)
+        {
+            FShapEHttpBackendSettings Settings;
+            Args[1].ParseIntoArray(Settings.Endpoints, TEXT(","));
+            Settings.MaxConnectionsPerEndpoint = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : Settings.MaxConnectionsPerEndpoint;
+            Manager->SetBackend(MakeShared<FShapEHttpBackend, ESPMode::ThreadSafe>(Settings));
+        }
+        else if (Args[0].Equals(TEXT("pool"), ESearchCase::IgnoreCase) && Args.Num() > 1)
+        {
+            FShapEWorkerPoolSettings Settings;
+            Settings.NumWorkers = FCString::Atoi(*Args[1]);
+            if (Args.Num() > 2)
+            {
+                TArray<FString> Devices;
+                Args[2].ParseIntoArray(Devices, TEXT(","));
+                for (const FString& Device : Devices)
+                {
+                    Settings.Devices.Add(FCString::Atoi(*Device));
+                }
+            }
+            if (Args.Num() > 3)
+            {
+                Settings.bSplitCores = Args[3].Equals(TEXT("split"), ESearchCase::IgnoreCase);
+                if (!Settings.bSplitCores)
+                {
+                    Args[3].ParseIntoArray(Settings.CoreSets, TEXT(";"));
+                }
+            }
+            Manager->SetBackend(MakeShared<FShapEWorkerPoolBackend, ESPMode::ThreadSafe>(Settings));
+        }
+        else
+        {
+            Manager->SetBackend(MakeShared<FShapEProcessBackend, ESPMode::ThreadSafe>());
+        }
+    }));
+
+// Usage: ShapE.Pool.Stats [reset]
+// Logs what each worker of the pool backend has run and how busy it was
+static FAutoConsoleCommand ShapEPoolStatsCommand(
+    TEXT("ShapE.Pool.Stats"),
+    TEXT("Logs the per-worker utilization of the pool backend. Args: [reset]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        TSharedPtr<FShapEProcessManager> Manager = FTextTo3DRequestModule::Get().GetProcessManager();
+        if (!Manager.IsValid() || Manager->GetBackend()->GetName() != TEXT("Pool"))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ShapE.Pool.Stats: The pool backend is not selected (ShapE.Backend pool <Workers>)"));
+            return;
+        }
+
+        FShapEWorkerPoolBackend& Pool = static_cast<FShapEWorkerPoolBackend&>(Manager->GetBackend().Get());
+        for (const FShapEWorkerPoolBackend::FWorkerStats& Stats : Pool.GetWorkerStats())
+        {
+            UE_LOG(LogTemp, Log, TEXT("ShapE.Pool.Stats: %s: %s, %.0f%% busy (%.1fs), %d done, %d failed, %d stolen, %d queued, %d restarts"),
+                *Stats.Label, Stats.bRunning ? (Stats.bBusy ? TEXT("running a task") : TEXT("idle")) : TEXT("stopped"),
+                Stats.Utilization * 100.0, Stats.BusySeconds, Stats.CompletedTasks, Stats.FailedTasks, Stats.StolenTasks, Stats.QueuedTasks, Stats.Restarts);
+        }
+        if (Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+        {
+            Pool.ResetWorkerStats();
+        }
+    }));
 
 #if WITH_EDITOR
 
@@ -26,10 +165,36 @@ TSharedRef<SDockTab> OnSpawnPluginTab(const FSpawnTabArgs& SpawnTabArgs)
 #endif
 
 
+FString FTextTo3DRequestModule::GetDefaultLauncherPath()
+{
+    const FString Launcher = CVarShapEWarmupLauncher.GetValueOnGameThread();
+    return Launcher.IsEmpty() ? FString(TEXT("C:/AIModel/shap-e-local/run_shape.bat")) : Launcher;
+}
+
+void FTextTo3DRequestModule::WarmUpWorker(int32 WarmupMode, const FString& ScriptPath)
+{
+    if (!ShapEProcessManager.IsValid() || CVarShapEWarmup.GetValueOnGameThread() != WarmupMode)
+    {
+        return;
+    }
+
+    const uint64 MinFreeBytes = (uint64)FMath::Max(0, CVarShapEWarmupMinFreeMemoryMB.GetValueOnGameThread()) * 1024 * 1024;
+    ShapEProcessManager->Prewarm(ScriptPath, MinFreeBytes);
+}
+
 void FTextTo3DRequestModule::StartupModule()
 {
     ShapEProcessManager = MakeShared<FShapEProcessManager>();
 
+    // after the engine is up, so the ini's console variables are applied and the worker does not compete with startup
+    EngineInitHandle = FCoreDelegates::OnFEngineLoopInitComplete.AddLambda([this]()
+    {
+        if (!IsRunningCommandlet())
+        {
+            WarmUpWorker(1, GetDefaultLauncherPath());
+        }
+    });
+
 #if WITH_EDITOR
     FTextTo3DRequestCommands::Register();
     PluginCommands = MakeShareable(new FUICommandList);
@@ -49,6 +214,8 @@ void FTextTo3DRequestModule::StartupModule()
 
 void FTextTo3DRequestModule::ShutdownModule()
 {
+    FCoreDelegates::OnFEngineLoopInitComplete.Remove(EngineInitHandle);
+
 #if WITH_EDITOR
     UToolMenus::UnregisterOwner(this);
     FTextTo3DRequestCommands::Unregister();
@@ -57,7 +224,8 @@ void FTextTo3DRequestModule::ShutdownModule()
 
     if (ShapEProcessManager.IsValid())
     {
-        ShapEProcessManager->RequestStopProcess();
+        ShapEProcessManager->CancelAllJobs();
+        ShapEProcessManager->StopWorker();
         ShapEProcessManager.Reset();
     }
 }
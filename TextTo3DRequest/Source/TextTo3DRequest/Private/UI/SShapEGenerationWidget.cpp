@@ -9,11 +9,16 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SSpinBox.h"
 #include "Widgets/Input/SCheckBox.h"
-#include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Notifications/SProgressBar.h"
 #include "Widgets/Text/STextBlock.h"
+#include "Widgets/Images/SImage.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Modules/ModuleManager.h"
+#include "Import/FShapEPlyImporter.h"
+#include "MeshDescription.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "ObjectTools.h"
 
 void SShapEGenerationWidget::Construct(const FArguments& InArgs)
 {
@@ -33,12 +38,12 @@ void SShapEGenerationWidget::Construct(const FArguments& InArgs)
         return;
     }
 
-    ProcessManager->OnProgressUpdated().AddSP(this, &SShapEGenerationWidget::HandleProgressUpdated);
+    // worker messages only; the widget's own job reports through the delegates it is queued with
     ProcessManager->OnStatusMessageReceived().AddSP(this, &SShapEGenerationWidget::HandleStatusMessageReceived);
-    ProcessManager->OnGenerationComplete().AddSP(this, &SShapEGenerationWidget::HandleGenerationComplete);
-    ProcessManager->OnErrorReceived().AddSP(this, &SShapEGenerationWidget::HandleErrorReceived);
     ProcessManager->OnInfoMessageReceived().AddSP(this, &SShapEGenerationWidget::HandleInfoMessageReceived);
-    ProcessManager->OnProcessFinished().AddSP(this, &SShapEGenerationWidget::HandleProcessFinished);
+
+    CurrentBatFilePath = FTextTo3DRequestModule::GetDefaultLauncherPath();
+    Module.WarmUpWorker(2, CurrentBatFilePath);
 
     ChildSlot
         [
@@ -76,6 +81,32 @@ void SShapEGenerationWidget::Construct(const FArguments& InArgs)
                         + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 5, 0).VAlign(VAlign_Center)[SNew(STextBlock).Text(FText::FromString(TEXT("Karras Steps:")))]
                         + SHorizontalBox::Slot().AutoWidth()[SAssignNew(KarrasStepsSpinBox, SSpinBox<int32>).MinValue(16).MaxValue(256).Value(16).Delta(1)]
                         + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 0, 0).VAlign(VAlign_Center)[SAssignNew(UseFP16CheckBox, SCheckBox).IsChecked(ECheckBoxState::Checked)[SNew(STextBlock).Text(FText::FromString(TEXT("Use FP16")))]]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 5, 0).VAlign(VAlign_Center)[SNew(STextBlock).Text(FText::FromString(TEXT("Preview Every:"))).ToolTipText(FText::FromString(TEXT("Show a low-resolution preview every N Karras steps while sampling; 0 disables previews")))]
+                        + SHorizontalBox::Slot().AutoWidth()[SAssignNew(PreviewEverySpinBox, SSpinBox<int32>).MinValue(0).MaxValue(64).Value(0).Delta(1)]
+                ]
+                // UI for the LOD stage of the import
+                + SVerticalBox::Slot().AutoHeight().Padding(2, 2)
+                [
+                    SNew(SHorizontalBox)
+                        + SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 5, 0).VAlign(VAlign_Center)[SNew(STextBlock).Text(FText::FromString(TEXT("LOD Triangles:"))).ToolTipText(FText::FromString(TEXT("Comma-separated triangle budget per LOD, LOD0 first; empty keeps the full mesh")))]
+                        + SHorizontalBox::Slot().FillWidth(1.0f)[SAssignNew(LODBudgetsTextBox, SEditableTextBox).HintText(FText::FromString(TEXT("e.g. 20000, 5000, 1200")))]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 0, 0).VAlign(VAlign_Center)[SAssignNew(NaniteCheckBox, SCheckBox).IsChecked(ECheckBoxState::Unchecked).ToolTipText(FText::FromString(TEXT("Enable Nanite on the full mesh instead of building LODs; the last budget sizes the fallback mesh")))[SNew(STextBlock).Text(FText::FromString(TEXT("Nanite")))]]
+                ]
+                + SVerticalBox::Slot().AutoHeight().Padding(2, 2)
+                [
+                    SNew(SHorizontalBox)
+                        + SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 5, 0).VAlign(VAlign_Center)[SNew(STextBlock).Text(FText::FromString(TEXT("Seed:"))).ToolTipText(FText::FromString(TEXT("-1 for a random seed")))]
+                        + SHorizontalBox::Slot().AutoWidth()[SAssignNew(SeedSpinBox, SSpinBox<int32>).MinValue(-1).MaxValue(MAX_int32).Value(-1).Delta(1)]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 0, 0).VAlign(VAlign_Center)[SAssignNew(UseCacheCheckBox, SCheckBox).IsChecked(ECheckBoxState::Checked).ToolTipText(FText::FromString(TEXT("Reuse the result of an identical earlier request; only applies with a fixed seed")))[SNew(STextBlock).Text(FText::FromString(TEXT("Use Cache")))]]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 0, 0).VAlign(VAlign_Center)[SAssignNew(SharedMemoryCheckBox, SCheckBox).IsChecked(ECheckBoxState::Unchecked).ToolTipText(FText::FromString(TEXT("Hand the mesh over in shared memory instead of reading files back")))[SNew(STextBlock).Text(FText::FromString(TEXT("Shared Memory")))]]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(10, 0, 0, 0).VAlign(VAlign_Center)[SAssignNew(ExportFilesCheckBox, SCheckBox).IsChecked(ECheckBoxState::Checked).ToolTipText(FText::FromString(TEXT("Also write PLY/OBJ files; always on for cached results")))[SNew(STextBlock).Text(FText::FromString(TEXT("Export Files")))]]
+                ]
+                // UI for importing the result as a static mesh
+                + SVerticalBox::Slot().AutoHeight().Padding(2, 2)
+                [
+                    SNew(SHorizontalBox)
+                        + SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 5, 0).VAlign(VAlign_Center)[SAssignNew(ImportMeshCheckBox, SCheckBox).IsChecked(ECheckBoxState::Checked)[SNew(STextBlock).Text(FText::FromString(TEXT("Import Static Mesh to:")))]]
+                        + SHorizontalBox::Slot().FillWidth(1.0f)[SAssignNew(ImportPathTextBox, SEditableTextBox).Text(FText::FromString(CurrentImportPath)).HintText(FText::FromString(TEXT("Content folder, e.g. /Game/ShapE"))).OnTextCommitted_Lambda([this](const FText& NewText, ETextCommit::Type) { CurrentImportPath = NewText.ToString(); })]
                 ]
                 // UI for Generate Model
                 + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center).Padding(5, 10)
@@ -89,6 +120,14 @@ void SShapEGenerationWidget::Construct(const FArguments& InArgs)
                                 .IsEnabled(this, &SShapEGenerationWidget::IsGenerateButtonEnabled)
                         ]
                         + SHorizontalBox::Slot().AutoWidth().Padding(5)
+                        [
+                            SNew(SButton)
+                                .Text(FText::FromString(TEXT("Re-decode Last")))
+                                .ToolTipText(FText::FromString(TEXT("Decode the last saved latent again with the current export and import settings, without sampling")))
+                                .OnClicked(this, &SShapEGenerationWidget::OnRedecodeButtonClicked)
+                                .IsEnabled(this, &SShapEGenerationWidget::IsRedecodeButtonEnabled)
+                        ]
+                        + SHorizontalBox::Slot().AutoWidth().Padding(5)
                         [
                             SAssignNew(ActionButton, SButton)
                                 .OnClicked(this, &SShapEGenerationWidget::OnActionButtonClicked)
@@ -106,16 +145,24 @@ void SShapEGenerationWidget::Construct(const FArguments& InArgs)
                 [
                     SAssignNew(StatusTextBlock, STextBlock).Text(FText::FromString(TEXT("Idle")))
                 ]
+                // Whether the next job still waits for the models to load
+                + SVerticalBox::Slot().AutoHeight().Padding(2, 2)
+                [
+                    SNew(STextBlock)
+                        .Text(this, &SShapEGenerationWidget::GetWarmupText)
+                        .ColorAndOpacity(this, &SShapEGenerationWidget::GetWarmupColor)
+                ]
+                // UI for the sampling preview; Cancel stops the job early if it is heading the wrong way
+                + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center).Padding(2, 5)
+                [
+                    SNew(SVerticalBox)
+                        .Visibility(this, &SShapEGenerationWidget::GetPreviewVisibility)
+                        + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center)[SNew(SImage).Image(&PreviewBrush)]
+                        + SVerticalBox::Slot().AutoHeight().HAlign(HAlign_Center).Padding(0, 2)[SAssignNew(PreviewStepTextBlock, STextBlock)]
+                ]
                 + SVerticalBox::Slot().FillHeight(1.0f).Padding(2, 5)
                 [
-                    SNew(SBorder).Padding(FMargin(3))
-                        [
-                            SAssignNew(LogScrollBox, SScrollBox)
-                                + SScrollBox::Slot()
-                                [
-                                    SAssignNew(LogTextBlock, STextBlock).AutoWrapText(true)
-                                ]
-                        ]
+                    SAssignNew(LogPanel, SShapELogPanel)
                 ]
         ];
 }
@@ -124,12 +171,8 @@ SShapEGenerationWidget::~SShapEGenerationWidget()
 {
     if (ProcessManager.IsValid())
     {
-        ProcessManager->OnProgressUpdated().RemoveAll(this);
         ProcessManager->OnStatusMessageReceived().RemoveAll(this);
-        ProcessManager->OnGenerationComplete().RemoveAll(this);
-        ProcessManager->OnErrorReceived().RemoveAll(this);
         ProcessManager->OnInfoMessageReceived().RemoveAll(this);
-        ProcessManager->OnProcessFinished().RemoveAll(this);
     }
 }
 
@@ -174,7 +217,7 @@ FReply SShapEGenerationWidget::OnBrowseOutputDirClicked()
 
 FReply SShapEGenerationWidget::OnGenerateButtonClicked()
 {
-    if (!ProcessManager.IsValid() || ProcessManager->IsRunning())
+    if (!ProcessManager.IsValid() || bJobInFlight)
     {
         return FReply::Handled();
     }
@@ -184,12 +227,12 @@ FReply SShapEGenerationWidget::OnGenerateButtonClicked()
 
     if (BatFilePath.IsEmpty() || !FPaths::FileExists(BatFilePath))
     {
-        AddLogMessage(TEXT("Error: Batch file path is invalid."), FLinearColor::Red);
+        AddLogMessage(TEXT("Error: Batch file path is invalid."), FLinearColor::Red, EShapELogSeverity::Error);
         return FReply::Handled();
     }
     if (Prompt.IsEmpty())
     {
-        AddLogMessage(TEXT("Error: Prompt cannot be empty."), FLinearColor::Red);
+        AddLogMessage(TEXT("Error: Prompt cannot be empty."), FLinearColor::Red, EShapELogSeverity::Error);
         return FReply::Handled();
     }
 
@@ -202,30 +245,103 @@ FReply SShapEGenerationWidget::OnGenerateButtonClicked()
     Params.GuidanceScale = GuidanceScaleSpinBox->GetValue();
     Params.KarrasSteps = KarrasStepsSpinBox->GetValue();
     Params.bUseFP16 = UseFP16CheckBox->IsChecked();
-
-    LogTextBlock->SetText(FText::GetEmpty());
+    Params.Seed = SeedSpinBox->GetValue();
+    Params.bUseCache = UseCacheCheckBox->IsChecked();
+    Params.bUseSharedMemory = SharedMemoryCheckBox->IsChecked();
+    Params.bExportFiles = ExportFilesCheckBox->IsChecked();
+    Params.LODTriangleBudgets = ParseLODBudgets(LODBudgetsTextBox->GetText().ToString());
+    Params.bEnableNanite = NaniteCheckBox->IsChecked();
+    Params.PreviewEverySteps = PreviewEverySpinBox->GetValue();
+    ActivePrompt = Prompt;
+    ActiveImportOptions = FShapEPlyImportOptions::FromGenerationParameters(Params);
+    bImportedSharedMesh = false;
+
+    LogPanel->Clear();
+    ClearPreview();
     AddLogMessage(TEXT("Starting generation process..."), FLinearColor(0.8f, 0.8f, 1.0f));
     ProgressBar->SetPercent(0.0f);
     StatusTextBlock->SetText(FText::FromString(TEXT("Initializing...")));
 
-    if (!ProcessManager->LaunchProcess(BatFilePath, Params))
+    ActiveJobId = ProcessManager->EnqueueGeneration(BatFilePath, Params, EShapEJobPriority::Interactive, MakeJobDelegates());
+    bJobInFlight = !ActiveJobId.IsEmpty();
+    if (ActiveJobId.IsEmpty())
     {
-        AddLogMessage(TEXT("Error: Failed to launch process. Check path and log for details."), FLinearColor::Red);
+        AddLogMessage(TEXT("Error: Failed to launch process. Check path and log for details."), FLinearColor::Red, EShapELogSeverity::Error);
         HandleProcessFinished();
     }
 
     return FReply::Handled();
 }
 
+FReply SShapEGenerationWidget::OnRedecodeButtonClicked()
+{
+    if (!ProcessManager.IsValid() || bJobInFlight || LastLatentPath.IsEmpty())
+    {
+        return FReply::Handled();
+    }
+
+    const FString BatFilePath = BatFilePathTextBox->GetText().ToString();
+    if (BatFilePath.IsEmpty() || !FPaths::FileExists(BatFilePath))
+    {
+        AddLogMessage(TEXT("Error: Batch file path is invalid."), FLinearColor::Red, EShapELogSeverity::Error);
+        return FReply::Handled();
+    }
+
+    bIsGenerationFinished = false;
+    bWasCanceled = false;
+
+    FShapEDecodeParameters DecodeParams;
+    DecodeParams.LatentPath = LastLatentPath;
+    DecodeParams.OutputDirectory = OutputDirTextBox->GetText().ToString();
+    DecodeParams.bUseSharedMemory = SharedMemoryCheckBox->IsChecked();
+    DecodeParams.bExportFiles = ExportFilesCheckBox->IsChecked();
+
+    // the prompt of the original job still names the asset; LOD settings come from the current controls
+    FShapEGenerationParameters ImportParams;
+    ImportParams.LODTriangleBudgets = ParseLODBudgets(LODBudgetsTextBox->GetText().ToString());
+    ImportParams.bEnableNanite = NaniteCheckBox->IsChecked();
+    ActiveImportOptions = FShapEPlyImportOptions::FromGenerationParameters(ImportParams);
+    bImportedSharedMesh = false;
+
+    LogPanel->Clear();
+    ClearPreview();
+    AddLogMessage(FString::Printf(TEXT("Re-decoding %s..."), *LastLatentPath), FLinearColor(0.8f, 0.8f, 1.0f));
+    ProgressBar->SetPercent(0.0f);
+    StatusTextBlock->SetText(FText::FromString(TEXT("Decoding...")));
+
+    ActiveJobId = ProcessManager->EnqueueDecode(BatFilePath, DecodeParams, EShapEJobPriority::Interactive, MakeJobDelegates());
+    bJobInFlight = !ActiveJobId.IsEmpty();
+    if (ActiveJobId.IsEmpty())
+    {
+        AddLogMessage(TEXT("Error: Failed to queue the decode job."), FLinearColor::Red, EShapELogSeverity::Error);
+        HandleProcessFinished();
+    }
+
+    return FReply::Handled();
+}
+
+TSharedRef<FShapEJobDelegates> SShapEGenerationWidget::MakeJobDelegates()
+{
+    TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+    Delegates->OnProgressUpdated.AddSP(this, &SShapEGenerationWidget::HandleProgressUpdated);
+    Delegates->OnGenerationComplete.AddSP(this, &SShapEGenerationWidget::HandleGenerationComplete);
+    Delegates->OnSharedMeshReady.AddSP(this, &SShapEGenerationWidget::HandleSharedMeshReady);
+    Delegates->OnLatentSaved.AddSP(this, &SShapEGenerationWidget::HandleLatentSaved);
+    Delegates->OnPreviewReceived.AddSP(this, &SShapEGenerationWidget::HandlePreviewReceived);
+    Delegates->OnErrorReceived.AddSP(this, &SShapEGenerationWidget::HandleErrorReceived);
+    return Delegates;
+}
+
 FReply SShapEGenerationWidget::OnActionButtonClicked()
 {
     if (!ProcessManager.IsValid()) return FReply::Handled();
 
-    if (ProcessManager->IsRunning())
+    if (bJobInFlight)
     {
         bWasCanceled = true;
-        AddLogMessage(TEXT("Cancellation requested by user..."), FLinearColor::Yellow);
-        ProcessManager->RequestStopProcess();
+        AddLogMessage(TEXT("Cancellation requested by user..."), FLinearColor::Yellow, EShapELogSeverity::Warning);
+        // only this widget's job, wherever it is; jobs of other callers keep running
+        ProcessManager->CancelJob(ActiveJobId);
     }
     else if (bIsGenerationFinished)
     {
@@ -252,41 +368,212 @@ void SShapEGenerationWidget::HandleProgressUpdated(float Percentage, int32 Step,
 void SShapEGenerationWidget::HandleStatusMessageReceived(const FString& Message)
 {
     StatusTextBlock->SetText(FText::FromString(Message));
-    AddLogMessage(FString::Printf(TEXT("[STATUS] %s"), *Message));
+    AddLogMessage(Message, FLinearColor::White, EShapELogSeverity::Status);
 }
 
 void SShapEGenerationWidget::HandleGenerationComplete(const FString& PlyPath, const FString& ObjPath, const FString& RawMessage)
 {
     ProgressBar->SetPercent(1.0f);
-    FString CompleteMsg = FString::Printf(TEXT("Generation Complete! Files saved.\nPLY: %s\nOBJ: %s"), *PlyPath, *ObjPath);
+    const FString CompleteMsg = PlyPath.IsEmpty() && ObjPath.IsEmpty()
+        ? FString(TEXT("Generation Complete! No files were exported."))
+        : FString::Printf(TEXT("Generation Complete! Files saved.\nPLY: %s\nOBJ: %s"), *PlyPath, *ObjPath);
     StatusTextBlock->SetText(FText::FromString(TEXT("Generation Complete!")));
-    AddLogMessage(CompleteMsg, FLinearColor::Green);
+    AddLogMessage(CompleteMsg, FLinearColor::Green, EShapELogSeverity::Success);
+    bJobInFlight = false;
     bIsGenerationFinished = true;
+
+    if (ImportMeshCheckBox->IsChecked() && !PlyPath.IsEmpty() && !bImportedSharedMesh)
+    {
+        ImportGeneratedMesh(PlyPath);
+    }
+    LogJobTiming();
+}
+
+void SShapEGenerationWidget::HandleSharedMeshReady(const FShapESharedMeshLayout& Layout)
+{
+    if (!ImportMeshCheckBox->IsChecked())
+    {
+        return;
+    }
+
+    // the segment is only guaranteed to exist during this broadcast, so the mesh description is built right here
+    const double ImportStartTime = FPlatformTime::Seconds();
+    FString Error;
+    FShapEPlyImportStats Stats;
+    FMeshDescription MeshDescription;
+    UStaticMesh* StaticMesh = nullptr;
+    if (FShapEPlyImporter::ImportSharedMesh(Layout, MeshDescription, ActiveImportOptions, Error, &Stats))
+    {
+        StaticMesh = FShapEPlyImporter::CreateStaticMesh(MoveTemp(MeshDescription), ImportPathTextBox->GetText().ToString(), MakeImportAssetName(Layout.SegmentName), ActiveImportOptions, Error, Stats, &Stats);
+    }
+    LogImportResult(StaticMesh, Stats, Error);
+    RecordImportTiming(ImportStartTime);
+    // exported files are still imported if reading the segment failed
+    bImportedSharedMesh = StaticMesh != nullptr;
+}
+
+void SShapEGenerationWidget::HandleLatentSaved(const FString& JobId, int32 ItemIndex, const FString& LatentPath)
+{
+    // batch items are not offered for re-decoding from here
+    if (ItemIndex == INDEX_NONE)
+    {
+        LastLatentPath = LatentPath;
+        AddLogMessage(FString::Printf(TEXT("Latent saved: %s"), *LatentPath));
+    }
+}
+
+void SShapEGenerationWidget::HandlePreviewReceived(const FShapEPreviewImage& Preview)
+{
+    if (!Preview.IsValid())
+    {
+        return;
+    }
+
+    if (!PreviewTexture.IsValid() || PreviewTexture->GetSizeX() != Preview.Width || PreviewTexture->GetSizeY() != Preview.Height)
+    {
+        UTexture2D* Texture = UTexture2D::CreateTransient(Preview.Width, Preview.Height, PF_B8G8R8A8);
+        if (!Texture)
+        {
+            return;
+        }
+        Texture->SRGB = true;
+        Texture->UpdateResource();
+        PreviewTexture.Reset(Texture);
+        PreviewBrush.SetResourceObject(Texture);
+        // small previews are scaled up so they stay readable
+        const float DisplayScale = FMath::Max(1.0f, 192.0f / FMath::Max(Preview.Width, Preview.Height));
+        PreviewBrush.ImageSize = FVector2D(Preview.Width * DisplayScale, Preview.Height * DisplayScale);
+    }
+
+    // FColor is laid out as BGRA, matching the texture; the copy lives until the render thread has uploaded it
+    TArray<FColor>* Pixels = new TArray<FColor>(Preview.Pixels);
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Preview.Width, Preview.Height);
+    PreviewTexture->UpdateTextureRegions(0, 1, Region, Preview.Width * sizeof(FColor), sizeof(FColor), reinterpret_cast<uint8*>(Pixels->GetData()),
+        [Pixels](uint8*, const FUpdateTextureRegion2D* Regions)
+        {
+            delete Pixels;
+            delete Regions;
+        });
+
+    PreviewStepTextBlock->SetText(FText::FromString(FString::Printf(TEXT("Preview at step %d / %d (%.0f ms)"), Preview.Step, Preview.TotalSteps, Preview.RenderMilliseconds)));
+}
+
+void SShapEGenerationWidget::ClearPreview()
+{
+    PreviewTexture.Reset();
+    PreviewBrush.SetResourceObject(nullptr);
+    if (PreviewStepTextBlock.IsValid())
+    {
+        PreviewStepTextBlock->SetText(FText::GetEmpty());
+    }
+}
+
+void SShapEGenerationWidget::ImportGeneratedMesh(const FString& PlyPath)
+{
+    const double ImportStartTime = FPlatformTime::Seconds();
+    FString Error;
+    FShapEPlyImportStats Stats;
+    UStaticMesh* StaticMesh = FShapEPlyImporter::CreateStaticMesh(PlyPath, ImportPathTextBox->GetText().ToString(), MakeImportAssetName(FPaths::GetBaseFilename(PlyPath)), ActiveImportOptions, Error, &Stats);
+    LogImportResult(StaticMesh, Stats, Error);
+    RecordImportTiming(ImportStartTime);
+}
+
+void SShapEGenerationWidget::RecordImportTiming(double ImportStartTime)
+{
+    if (!ActiveJobId.IsEmpty())
+    {
+        ProcessManager->AddJobTimingSpan(ActiveJobId, ShapEStages::Import, ImportStartTime, FPlatformTime::Seconds());
+    }
+}
+
+void SShapEGenerationWidget::LogJobTiming()
+{
+    FShapEJobTiming Timing;
+    if (!ActiveJobId.IsEmpty() && ProcessManager->GetJobTiming(ActiveJobId, Timing))
+    {
+        AddLogMessage(FString::Printf(TEXT("Timing: %s"), *Timing.Summarize()), FLinearColor(0.6f, 0.6f, 0.6f));
+    }
+}
+
+TArray<int32> SShapEGenerationWidget::ParseLODBudgets(const FString& Text)
+{
+    TArray<FString> Entries;
+    Text.ParseIntoArray(Entries, TEXT(","));
+    TArray<int32> Budgets;
+    for (const FString& Entry : Entries)
+    {
+        const FString Trimmed = Entry.TrimStartAndEnd();
+        if (Trimmed.IsNumeric())
+        {
+            Budgets.Add(FCString::Atoi(*Trimmed));
+        }
+    }
+    return Budgets;
+}
+
+FString SShapEGenerationWidget::MakeImportAssetName(const FString& FallbackName) const
+{
+    return ObjectTools::SanitizeObjectName(TEXT("SM_") + (ActivePrompt.IsEmpty() ? FallbackName : ActivePrompt.Left(48).Replace(TEXT(" "), TEXT("_"))));
+}
+
+void SShapEGenerationWidget::LogImportResult(UStaticMesh* StaticMesh, const FShapEPlyImportStats& Stats, const FString& Error)
+{
+    if (StaticMesh)
+    {
+        AddLogMessage(FString::Printf(TEXT("Imported %s (%d vertices, %d triangles) in %.0f ms"),
+            *StaticMesh->GetPathName(), Stats.NumVertices, Stats.NumTriangles, (Stats.ParseSeconds + Stats.Cleanup.TotalSeconds + Stats.BuildSeconds) * 1000.0), FLinearColor::Green, EShapELogSeverity::Success);
+        if (Stats.bCleanedUp)
+        {
+            const FShapEMeshCleanupStats& Cleanup = Stats.Cleanup;
+            AddLogMessage(FString::Printf(TEXT("Cleanup: %d -> %d vertices, %d -> %d triangles (%d degenerate, %d duplicate removed) in %.0f ms"),
+                Cleanup.VerticesBefore, Cleanup.VerticesAfter, Cleanup.TrianglesBefore, Cleanup.TrianglesAfter, Cleanup.DegenerateTriangles, Cleanup.DuplicateTriangles, Cleanup.TotalSeconds * 1000.0));
+        }
+        if (Stats.Decimation.LODTriangles.Num() > 0)
+        {
+            const FString Counts = FString::JoinBy(Stats.Decimation.LODTriangles, TEXT(" / "), [](int32 Count) { return FString::FromInt(Count); });
+            AddLogMessage(FString::Printf(TEXT("LODs: %d -> %s triangles in %.0f ms"), Stats.Decimation.TrianglesBefore, *Counts, Stats.Decimation.TotalSeconds * 1000.0));
+        }
+        if (Stats.bNaniteEnabled)
+        {
+            AddLogMessage(TEXT("Nanite enabled."));
+        }
+    }
+    else
+    {
+        AddLogMessage(FString::Printf(TEXT("Static mesh import failed: %s"), *Error), FLinearColor::Red, EShapELogSeverity::Error);
+    }
 }
 
 void SShapEGenerationWidget::HandleErrorReceived(const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage)
 {
+    bJobInFlight = false;
+    if (bWasCanceled && ErrorType == TEXT("Cancelled"))
+    {
+        HandleProcessFinished();
+        return;
+    }
+
     ProgressBar->SetPercent(0.0f);
     FString FullErrorMsg = FString::Printf(TEXT("ERROR (%s): %s"), *ErrorType, *ErrorMessage);
     StatusTextBlock->SetText(FText::FromString(TEXT("Error Occurred!")));
-    AddLogMessage(FullErrorMsg, FLinearColor::Red);
+    AddLogMessage(FullErrorMsg, FLinearColor::Red, EShapELogSeverity::Error);
     if (!RawMessage.IsEmpty() && !RawMessage.Contains(ErrorMessage))
     {
-        AddLogMessage(FString::Printf(TEXT("Raw Data: %s"), *RawMessage), FLinearColor(0.8f, 0.2f, 0.2f));
+        AddLogMessage(FString::Printf(TEXT("Raw Data: %s"), *RawMessage), FLinearColor(0.8f, 0.2f, 0.2f), EShapELogSeverity::Error);
     }
     bIsGenerationFinished = true;
 }
 
 void SShapEGenerationWidget::HandleInfoMessageReceived(const FString& Message)
 {
-    AddLogMessage(FString::Printf(TEXT("[INFO] %s"), *Message), FLinearColor(0.6f, 0.6f, 0.6f));
+    AddLogMessage(Message, FLinearColor(0.6f, 0.6f, 0.6f), EShapELogSeverity::Info);
 }
 
 void SShapEGenerationWidget::HandleProcessFinished()
 {
     if (bWasCanceled)
     {
-        AddLogMessage(TEXT("Process has been canceled."), FLinearColor::Yellow);
+        AddLogMessage(TEXT("Process has been canceled."), FLinearColor::Yellow, EShapELogSeverity::Warning);
         ResetUIState();
     }
     else
@@ -295,19 +582,11 @@ void SShapEGenerationWidget::HandleProcessFinished()
     }
 }
 
-void SShapEGenerationWidget::AddLogMessage(const FString& Message, const FLinearColor& Color)
+void SShapEGenerationWidget::AddLogMessage(const FString& Message, const FLinearColor& Color, EShapELogSeverity Severity)
 {
-    if (LogTextBlock.IsValid() && LogScrollBox.IsValid())
+    if (LogPanel.IsValid())
     {
-        FString Timestamp = FDateTime::Now().ToString(TEXT("[%H:%M:%S] "));
-        FString CurrentLog = LogTextBlock->GetText().ToString();
-        if (!CurrentLog.IsEmpty())
-        {
-            CurrentLog += TEXT("\n");
-        }
-        CurrentLog += Timestamp + Message;
-        LogTextBlock->SetText(FText::FromString(CurrentLog));
-        LogScrollBox->ScrollToEnd();
+        LogPanel->AddEntry(Message, Severity, Color);
     }
 }
 
@@ -317,26 +596,37 @@ void SShapEGenerationWidget::ResetUIState()
     bWasCanceled = false;
     ProgressBar->SetPercent(0.0f);
     StatusTextBlock->SetText(FText::FromString(TEXT("Idle")));
-    LogTextBlock->SetText(FText::GetEmpty());
+    LogPanel->Clear();
+    ClearPreview();
 }
 
 bool SShapEGenerationWidget::IsGenerateButtonEnabled() const
 {
-    return ProcessManager.IsValid() && !ProcessManager->IsRunning() && !bIsGenerationFinished;
+    return ProcessManager.IsValid() && !bJobInFlight && !bIsGenerationFinished;
+}
+
+bool SShapEGenerationWidget::IsRedecodeButtonEnabled() const
+{
+    return ProcessManager.IsValid() && !bJobInFlight && !LastLatentPath.IsEmpty();
 }
 
 EVisibility SShapEGenerationWidget::GetActionButtonVisibility() const
 {
-    if (ProcessManager.IsValid() && (ProcessManager->IsRunning() || bIsGenerationFinished))
+    if (ProcessManager.IsValid() && (bJobInFlight || bIsGenerationFinished))
     {
         return EVisibility::Visible;
     }
     return EVisibility::Collapsed;
 }
 
+EVisibility SShapEGenerationWidget::GetPreviewVisibility() const
+{
+    return PreviewTexture.IsValid() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
 FText SShapEGenerationWidget::GetActionButtonText() const
 {
-    if (ProcessManager.IsValid() && ProcessManager->IsRunning())
+    if (ProcessManager.IsValid() && bJobInFlight)
     {
         return FText::FromString(TEXT("Cancel"));
     }
@@ -347,4 +637,37 @@ FText SShapEGenerationWidget::GetActionButtonText() const
     return FText::GetEmpty();
 }
 
-#endif
\ No newline at end of file
+FText SShapEGenerationWidget::GetWarmupText() const
+{
+    switch (ProcessManager.IsValid() ? ProcessManager->GetWarmupState() : EShapEWarmupState::Cold)
+    {
+    case EShapEWarmupState::WarmingUp:
+        return FText::FromString(TEXT("Worker: warming up (loading models)..."));
+    case EShapEWarmupState::Warm:
+        return FText::FromString(TEXT("Worker: warm, models loaded"));
+    case EShapEWarmupState::Skipped:
+        return FText::FromString(TEXT("Worker: warm-up skipped, not enough free memory"));
+    case EShapEWarmupState::Failed:
+        return FText::FromString(TEXT("Worker: failed to start, see the log"));
+    default:
+        return FText::FromString(TEXT("Worker: cold, models load with the first job"));
+    }
+}
+
+FSlateColor SShapEGenerationWidget::GetWarmupColor() const
+{
+    switch (ProcessManager.IsValid() ? ProcessManager->GetWarmupState() : EShapEWarmupState::Cold)
+    {
+    case EShapEWarmupState::WarmingUp:
+        return FSlateColor(FLinearColor::Yellow);
+    case EShapEWarmupState::Warm:
+        return FSlateColor(FLinearColor::Green);
+    case EShapEWarmupState::Skipped:
+    case EShapEWarmupState::Failed:
+        return FSlateColor(FLinearColor(1.f, 0.5f, 0.f));
+    default:
+        return FSlateColor(FLinearColor::Gray);
+    }
+}
+
+#endif
@@ -0,0 +1,251 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#include "UI/SShapELogPanel.h"
+#if WITH_EDITOR
+#include "DesktopPlatformModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+#include "Framework/Application/SlateApplication.h"
+
+void SShapELogPanel::Construct(const FArguments& InArgs)
+{
+    Ring.SetNum(FMath::Max(1, InArgs._MaxEntries));
+    for (bool& bEnabled : SeverityEnabled)
+    {
+        bEnabled = true;
+    }
+
+    TSharedRef<SHorizontalBox> Toolbar = SNew(SHorizontalBox);
+    for (int32 Index = 0; Index < (int32)EShapELogSeverity::Count; ++Index)
+    {
+        Toolbar->AddSlot().AutoWidth().Padding(0, 0, 8, 0).VAlign(VAlign_Center)[MakeSeverityToggle((EShapELogSeverity)Index)];
+    }
+    Toolbar->AddSlot().FillWidth(1.0f)[SNullWidget::NullWidget];
+    Toolbar->AddSlot().AutoWidth().Padding(2, 0)[SNew(SButton).Text(FText::FromString(TEXT("Clear"))).OnClicked(this, &SShapELogPanel::OnClearClicked)];
+    Toolbar->AddSlot().AutoWidth().Padding(2, 0)[SNew(SButton).Text(FText::FromString(TEXT("Export..."))).OnClicked(this, &SShapELogPanel::OnExportClicked)];
+
+    ChildSlot
+        [
+            SNew(SVerticalBox)
+                + SVerticalBox::Slot().AutoHeight().Padding(0, 0, 0, 2)
+                [
+                    Toolbar
+                ]
+                + SVerticalBox::Slot().FillHeight(1.0f)
+                [
+                    SNew(SBorder).Padding(FMargin(3))
+                        [
+                            SAssignNew(ListView, SListView<FEntryPtr>)
+                                .ListItemsSource(&VisibleEntries)
+                                .OnGenerateRow(this, &SShapELogPanel::OnGenerateRow)
+                                .SelectionMode(ESelectionMode::Multi)
+                        ]
+                ]
+        ];
+}
+
+void SShapELogPanel::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+    SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+    if (bHasPendingEvictions)
+    {
+        // everything older than the oldest retained entry has left the ring
+        const uint64 OldestSequence = Count > 0 ? GetOldest()->Sequence : NextSequence;
+        int32 NumEvicted = 0;
+        while (NumEvicted < VisibleEntries.Num() && VisibleEntries[NumEvicted]->Sequence < OldestSequence)
+        {
+            ++NumEvicted;
+        }
+        VisibleEntries.RemoveAt(0, NumEvicted, EAllowShrinking::No);
+        bHasPendingEvictions = false;
+        ListView->RequestListRefresh();
+    }
+
+    if (bScrollToBottom)
+    {
+        ListView->ScrollToBottom();
+        bScrollToBottom = false;
+    }
+}
+
+void SShapELogPanel::AddEntry(const FString& Message, EShapELogSeverity Severity, const FLinearColor& Color)
+{
+    FEntryPtr Entry = MakeShared<FShapELogEntry>();
+    Entry->Sequence = NextSequence++;
+    Entry->Timestamp = FDateTime::Now();
+    Entry->Severity = Severity;
+    Entry->Color = Color;
+    Entry->Message = Message;
+
+    if (Count == Ring.Num())
+    {
+        Ring[Head] = Entry;
+        Head = (Head + 1) % Ring.Num();
+        bHasPendingEvictions = true;
+    }
+    else
+    {
+        Ring[(Head + Count) % Ring.Num()] = Entry;
+        ++Count;
+    }
+
+    if (PassesFilter(*Entry))
+    {
+        // only follow the log if the user hasn't scrolled up to read something
+        bScrollToBottom |= IsScrolledToBottom();
+        VisibleEntries.Add(MoveTemp(Entry));
+        if (ListView.IsValid())
+        {
+            ListView->RequestListRefresh();
+        }
+    }
+}
+
+void SShapELogPanel::Clear()
+{
+    for (FEntryPtr& Entry : Ring)
+    {
+        Entry.Reset();
+    }
+    Head = 0;
+    Count = 0;
+    bHasPendingEvictions = false;
+    VisibleEntries.Reset();
+    if (ListView.IsValid())
+    {
+        ListView->RequestListRefresh();
+    }
+}
+
+bool SShapELogPanel::ExportToFile(const FString& FilePath) const
+{
+    // exports what the filters currently show, oldest first
+    FString Output;
+    Output.Reserve(VisibleEntries.Num() * 96);
+    for (const FEntryPtr& Entry : VisibleEntries)
+    {
+        Output += FString::Printf(TEXT("%s [%s] %s\n"), *Entry->Timestamp.ToString(TEXT("%Y-%m-%d %H:%M:%S.%s")), GetSeverityName(Entry->Severity), *Entry->Message);
+    }
+    return FFileHelper::SaveStringToFile(Output, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+const TCHAR* SShapELogPanel::GetSeverityName(EShapELogSeverity Severity)
+{
+    switch (Severity)
+    {
+    case EShapELogSeverity::Info: return TEXT("INFO");
+    case EShapELogSeverity::Status: return TEXT("STATUS");
+    case EShapELogSeverity::Success: return TEXT("SUCCESS");
+    case EShapELogSeverity::Warning: return TEXT("WARNING");
+    case EShapELogSeverity::Error: return TEXT("ERROR");
+    default: return TEXT("?");
+    }
+}
+
+bool SShapELogPanel::PassesFilter(const FShapELogEntry& Entry) const
+{
+    return SeverityEnabled[(int32)Entry.Severity];
+}
+
+void SShapELogPanel::RebuildVisibleEntries()
+{
+    VisibleEntries.Reset();
+    for (int32 Offset = 0; Offset < Count; ++Offset)
+    {
+        const FEntryPtr& Entry = Ring[(Head + Offset) % Ring.Num()];
+        if (PassesFilter(*Entry))
+        {
+            VisibleEntries.Add(Entry);
+        }
+    }
+    bHasPendingEvictions = false;
+    bScrollToBottom = true;
+    ListView->RequestListRefresh();
+}
+
+bool SShapELogPanel::IsScrolledToBottom() const
+{
+    return !ListView.IsValid() || ListView->GetScrollDistanceRemaining().Y <= UE_KINDA_SMALL_NUMBER;
+}
+
+TSharedRef<ITableRow> SShapELogPanel::OnGenerateRow(FEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(STableRow<FEntryPtr>, OwnerTable)
+        [
+            SNew(SHorizontalBox)
+                + SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 6, 0)
+                [
+                    SNew(STextBlock)
+                        .Text(FText::FromString(Entry->Timestamp.ToString(TEXT("[%H:%M:%S]"))))
+                        .ColorAndOpacity(FSlateColor(FLinearColor(0.5f, 0.5f, 0.5f)))
+                ]
+                + SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 6, 0)
+                [
+                    SNew(SBox).WidthOverride(64.0f)
+                        [
+                            SNew(STextBlock)
+                                .Text(FText::FromString(GetSeverityName(Entry->Severity)))
+                                .ColorAndOpacity(FSlateColor(Entry->Color))
+                        ]
+                ]
+                + SHorizontalBox::Slot().FillWidth(1.0f)
+                [
+                    SNew(STextBlock)
+                        .Text(FText::FromString(Entry->Message))
+                        .ColorAndOpacity(FSlateColor(Entry->Color))
+                        .AutoWrapText(true)
+                ]
+        ];
+}
+
+TSharedRef<SWidget> SShapELogPanel::MakeSeverityToggle(EShapELogSeverity Severity)
+{
+    const int32 Index = (int32)Severity;
+    return SNew(SCheckBox)
+        .IsChecked_Lambda([this, Index]() { return SeverityEnabled[Index] ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+        .OnCheckStateChanged_Lambda([this, Index](ECheckBoxState NewState)
+            {
+                SeverityEnabled[Index] = NewState == ECheckBoxState::Checked;
+                RebuildVisibleEntries();
+            })
+        [
+            SNew(STextBlock).Text(FText::FromString(GetSeverityName(Severity)))
+        ];
+}
+
+FReply SShapELogPanel::OnExportClicked()
+{
+    IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+    if (DesktopPlatform)
+    {
+        TArray<FString> OutFiles;
+        const FString DefaultName = FDateTime::Now().ToString(TEXT("ShapE_Log_%Y%m%d_%H%M%S.txt"));
+        if (DesktopPlatform->SaveFileDialog(
+            FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+            TEXT("Export Log"), FPaths::ProjectSavedDir(), DefaultName,
+            TEXT("Text Files (*.txt)|*.txt|All Files (*.*)|*.*"),
+            EFileDialogFlags::None, OutFiles) && OutFiles.Num() > 0)
+        {
+            if (!ExportToFile(OutFiles[0]))
+            {
+                AddEntry(FString::Printf(TEXT("Failed to export log to %s"), *OutFiles[0]), EShapELogSeverity::Error, FLinearColor::Red);
+            }
+        }
+    }
+    return FReply::Handled();
+}
+
+FReply SShapELogPanel::OnClearClicked()
+{
+    Clear();
+    return FReply::Handled();
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Backend/FShapEProcessBackend.h"
+
+struct FShapEDirectLaunchSettings
+{
+    // Interpreter to run; when empty it is resolved like run_shape.sh does: SHAPE_PYTHON, the Conda environment
+    // of shape_config.txt, then python3 from PATH
+    FString Interpreter;
+    // Added to (or replacing) the worker's environment
+    TMap<FString, FString> Environment;
+    // Offer the worker the binary record protocol on a descriptor of its own; off keeps it on JSON lines
+    bool bBinaryRecords = true;
+};
+
+/**
+ * The persistent Python worker without run_shape.sh in front of it: the environment's interpreter is resolved
+ * once per launcher directory and cached, and every start posix_spawns it directly with ue_shape_interface.py,
+ * an explicit environment (the editor's, minus its own Python paths, plus what Conda activation would set), the
+ * job pipes as stdin and stdout and the record pipe as descriptor 3. Linux only; elsewhere it falls back to the
+ * launcher script.
+ */
+class FShapEDirectLaunchBackend : public FShapEProcessBackend
+{
+public:
+    explicit FShapEDirectLaunchBackend(const FShapEDirectLaunchSettings& InSettings = FShapEDirectLaunchSettings());
+    virtual ~FShapEDirectLaunchBackend() override;
+
+    virtual FString GetName() const override { return TEXT("Direct"); }
+
+    // Forgets the resolved interpreters, e.g. after shape_config.txt changed
+    static void ResetInterpreterCache();
+
+protected:
+    virtual bool LaunchWorker(const FString& ScriptPath, const FString& Arguments, FString& OutError, FString& OutErrorType) override;
+    virtual bool IsWorkerProcessRunning() override;
+    virtual void KillWorkerProcess() override;
+    virtual bool WantsRecordChannel() const override;
+
+private:
+    FShapEDirectLaunchSettings Settings;
+
+    // Guarded by ProcessCS; the child is reaped as soon as it is seen to have exited
+    int32 ChildPid = -1;
+};
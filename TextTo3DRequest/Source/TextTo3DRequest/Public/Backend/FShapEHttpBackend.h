@@ -0,0 +1,194 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Backend/IShapEGenerationBackend.h"
+#include "Backend/FShapEWorkerLineDecoder.h"
+#include "Manager/FShapELineFramer.h"
+
+struct FShapEHttpBackendSettings
+{
+    // Base URLs of the inference servers (ue_shape_interface.py --serve), e.g. http://gpu-box-1:8765
+    TArray<FString> Endpoints;
+    // Requests open at once per endpoint; more wait for one of its connections to free up
+    int32 MaxConnectionsPerEndpoint = 2;
+    // Job streams stay open for the whole job, so only silence counts against them
+    float ActivityTimeoutSeconds = 120.f;
+    // An endpoint that could not be reached is tried last for this long
+    double RetryDelaySeconds = 10.0;
+    // How old an endpoint's reported load may get before the next submit asks again
+    double HealthRefreshSeconds = 5.0;
+    // Split each batch dispatch across the endpoints that have room, instead of sending it to one
+    bool bFanOutBatches = true;
+    // The PLY is always downloaded; the OBJ and the latent only when set
+    bool bDownloadObj = true;
+    bool bDownloadLatent = true;
+};
+
+/**
+ * Runs jobs on remote inference servers. Every job (or every endpoint's share of a batch) is one POST whose
+ * response streams the worker's messages line by line; meshes are downloaded as binary files into the job's
+ * output directory before the job reports them. Requests go to the endpoint with the least load, counting
+ * this editor's open requests and the load the server reported last. Connections are kept alive and reused
+ * between jobs, at most MaxConnectionsPerEndpoint per endpoint.
+ */
+class FShapEHttpBackend : public IShapEGenerationBackend, public TSharedFromThis<FShapEHttpBackend, ESPMode::ThreadSafe>
+{
+public:
+    explicit FShapEHttpBackend(const FShapEHttpBackendSettings& InSettings);
+    virtual ~FShapEHttpBackend() override;
+
+    virtual FString GetName() const override { return TEXT("Http"); }
+
+    virtual bool Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType) override;
+    virtual void Stop() override;
+    virtual bool IsRunning() override;
+    virtual bool IsStartedFor(const FString& ScriptPath) override { return true; }
+    virtual uint32 GetGeneration() const override { return Generation; }
+    virtual FShapETimingSpan GetStartSpan() const override { return StartSpan; }
+    // One job per connection, so the servers share the queue instead of waiting behind each other
+    virtual int32 GetMaxConcurrentJobs() const override { return FMath::Max(1, Settings.Endpoints.Num() * Settings.MaxConnectionsPerEndpoint); }
+
+    virtual bool Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage) override;
+    // Closes the job's streams; the server abandons the job once it notices its client is gone
+    virtual void Cancel(const FString& JobId) override;
+
+    virtual bool DequeueEvent(FShapEWorkerEvent& OutEvent) override { return EventQueue.Dequeue(OutEvent); }
+
+    struct FEndpointStats
+    {
+        FString BaseUrl;
+        bool bReachable = false;
+        int32 OpenRequests = 0;
+        int32 QueuedRequests = 0;
+        // As reported by the server's health check, including other clients' jobs
+        int32 ReportedActiveJobs = 0;
+        int32 ReportedMaxJobs = 1;
+        int32 CompletedRequests = 0;
+        int32 FailedRequests = 0;
+        // Moving average from sending a job to its first streamed byte
+        double FirstByteSeconds = 0.0;
+        int64 DownloadedBytes = 0;
+    };
+    TArray<FEndpointStats> GetEndpointStats();
+
+    const FShapEHttpBackendSettings& GetSettings() const { return Settings; }
+
+private:
+    struct FJobState;
+
+    struct FEndpoint
+    {
+        FEndpointStats Stats;
+        double RetryTime = 0.0;
+        double LastHealthTime = -1.0;
+        bool bHealthCheckPending = false;
+        // Jobs of other clients at the last health check
+        int32 ExternalJobs = 0;
+        // Editor clock minus the server's clock; the smallest difference carries the least delivery latency
+        double ClockOffset = 0.0;
+        bool bHasClockOffset = false;
+    };
+
+    // One POST: a whole job, or one endpoint's share of a batch
+    struct FStream
+    {
+        TSharedPtr<FJobState, ESPMode::ThreadSafe> Job;
+        int32 EndpointIndex = INDEX_NONE;
+        TArray<uint8> Body;
+        // Batch items of this share, relative to the whole batch
+        int32 FirstItem = 0;
+        int32 NumItems = 0;
+        TArray<int32> TriedEndpoints;
+        FHttpRequestPtr Request;
+        double SendTime = 0.0;
+        bool bReceivedData = false;
+        // Set by an "error" line of a batch share; its unreported items fail with it
+        FString ErrorMessage;
+        FString ErrorType;
+        // Only touched by the thread the response body arrives on
+        FShapELineFramer Framer{ 4 * 1024 };
+        FShapEWorkerLineDecoder LineDecoder{ TEXT("FShapEHttpBackend") };
+    };
+
+    struct FJobState
+    {
+        FString JobId;
+        FString Type;
+        uint32 Generation = 0;
+        // Where the worker would have written the files; downloads go here
+        FString OutputDirectory;
+        // Decode jobs report the local latent they were given, not the server's copy
+        FString LocalLatentPath;
+        TArray<TSharedRef<FStream, ESPMode::ThreadSafe>> Streams;
+        TArray<FHttpRequestPtr> Downloads;
+        int32 OpenStreams = 0;
+        int32 PendingDownloads = 0;
+        // Batch items that reported back, complete or failed
+        TSet<int32> ReportedItems;
+        int32 FailedItems = 0;
+        int32 ItemCount = 0;
+        // A "complete" line arrived; its files may still be downloading
+        bool bHasResult = false;
+        // Held back until every stream and download of the job is done
+        TOptional<FShapEWorkerEvent> FinalEvent;
+        bool bCancelled = false;
+    };
+
+    // A completed mesh whose files are still downloading
+    struct FPendingResult
+    {
+        FShapEWorkerEvent Event;
+        int32 PendingFiles = 0;
+        bool bFailed = false;
+        // The job's own result rather than a batch item; becomes the job's final event
+        bool bFinal = false;
+    };
+
+    enum class EResultFile : uint8
+    {
+        Ply,
+        Obj,
+        Latent
+    };
+
+    FShapEHttpBackendSettings Settings;
+
+    // Guards the endpoints, the jobs and the connection queues; events are produced on the HTTP thread
+    // (streamed lines) and the game thread (completions)
+    FCriticalSection StateCS;
+    TArray<FEndpoint> Endpoints;
+    TMap<FString, TSharedPtr<FJobState, ESPMode::ThreadSafe>> Jobs;
+    // Streams waiting for a free connection, per endpoint
+    TArray<TArray<TSharedRef<FStream, ESPMode::ThreadSafe>>> WaitingStreams;
+    bool bIsRunning = false;
+    bool bAnnouncedReady = false;
+    uint32 Generation = 0;
+    FShapETimingSpan StartSpan;
+
+    TQueue<FShapEWorkerEvent, EQueueMode::Mpsc> EventQueue;
+
+    // Index of the endpoint with the least load per slot; unreachable endpoints only when all are
+    int32 PickEndpoint(const TArray<int32>& Excluded) const;
+    void SendHealthCheck(int32 EndpointIndex);
+    void OnHealthCheckComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 EndpointIndex, uint32 CheckGeneration);
+
+    void QueueStream(const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream, int32 EndpointIndex);
+    void SendStream(const TSharedRef<FStream, ESPMode::ThreadSafe>& Stream);
+    void SendWaitingStreams(int32 EndpointIndex);
+    void OnStreamData(void* Data, int64& Length, TSharedRef<FStream, ESPMode::ThreadSafe> Stream);
+    void OnStreamComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, TSharedRef<FStream, ESPMode::ThreadSafe> Stream);
+    void HandleStreamLine(FStream& Stream, FUtf8StringView Line);
+
+    // Fetches the files of a completed mesh on the game thread, then reports Event with their local paths
+    void DownloadResult(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job, int32 EndpointIndex, FShapEWorkerEvent Event, const FString& PlyUrl, const FString& ObjUrl, const FString& LatentUrl, bool bFinal);
+    void OnDownloadComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, TSharedRef<FJobState, ESPMode::ThreadSafe> Job, TSharedRef<FPendingResult, ESPMode::ThreadSafe> Result, EResultFile File, int32 EndpointIndex);
+    void CompleteResult(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job, const TSharedRef<FPendingResult, ESPMode::ThreadSafe>& Result);
+    // Reports the job's result and "ready" once every stream and download of the job is done
+    void FinishJobIfDone(const TSharedRef<FJobState, ESPMode::ThreadSafe>& Job);
+
+    void Emit(FShapEWorkerEvent&& Event);
+    FShapEWorkerEvent MakeEvent(EShapEWorkerEventType Type, const FJobState& Job) const;
+};
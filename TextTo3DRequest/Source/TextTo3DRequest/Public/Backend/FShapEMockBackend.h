@@ -0,0 +1,93 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Backend/IShapEGenerationBackend.h"
+
+struct FShapEMockBackendSettings
+{
+    // Stands in for the model load between Start and "ready"
+    double StartupSeconds = 0.0;
+    double SecondsPerStep = 0.0;
+    double DecodeSeconds = 0.0;
+    // Every prompt becomes a UV sphere of Segments x Segments quads, tinted by the prompt like the --synthetic worker
+    int32 Segments = 64;
+    // Write the PLY/OBJ files the worker would write; without them results carry no paths
+    bool bWriteFiles = true;
+    bool bWriteObj = true;
+    // Every Nth submitted job (or batch item) fails with "MockFailure"; 0 never fails
+    int32 FailEveryNthJob = 0;
+};
+
+/**
+ * In-process stand-in for the worker, for load-testing the manager's scheduling, caching and import without
+ * Python. Jobs run one after another on a timeline derived from the settings, producing the same stage,
+ * progress and completion events as the worker in the same order every time. Meshes are always handed over
+ * as files; shared-memory requests are answered with files too.
+ */
+class FShapEMockBackend : public IShapEGenerationBackend
+{
+public:
+    explicit FShapEMockBackend(const FShapEMockBackendSettings& InSettings = FShapEMockBackendSettings());
+    virtual ~FShapEMockBackend() override;
+
+    virtual FString GetName() const override { return TEXT("Mock"); }
+
+    virtual bool Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType) override;
+    virtual void Stop() override;
+    virtual bool IsRunning() override { return bIsRunning; }
+    virtual bool IsStartedFor(const FString& ScriptPath) override { return true; }
+    virtual uint32 GetGeneration() const override { return Generation; }
+    virtual FShapETimingSpan GetStartSpan() const override { return StartSpan; }
+
+    virtual bool Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage) override;
+    virtual void Cancel(const FString& JobId) override;
+
+    virtual bool DequeueEvent(FShapEWorkerEvent& OutEvent) override { return EventQueue.Dequeue(OutEvent); }
+
+    // Emits every event that is due; runs on the core ticker while started, callable directly when no ticker is pumped
+    void Tick();
+
+    const FShapEMockBackendSettings& GetSettings() const { return Settings; }
+    int32 GetSubmittedJobs() const { return SubmittedJobs; }
+
+private:
+    struct FScheduledEvent
+    {
+        double DueTime = 0.0;
+        FShapEWorkerEvent Event;
+        // When set, the mesh is written right before the event is emitted and its paths filled in
+        FString MeshDirectory;
+        FString MeshName;
+        uint32 MeshTint = 0;
+    };
+
+    FShapEMockBackendSettings Settings;
+    bool bIsRunning = false;
+    uint32 Generation = 0;
+    FShapETimingSpan StartSpan;
+    int32 SubmittedJobs = 0;
+    int32 SubmittedItems = 0;
+
+    // Ordered by DueTime; jobs are appended behind whatever is still scheduled
+    TArray<FScheduledEvent> Timeline;
+    TQueue<FShapEWorkerEvent, EQueueMode::Spsc> EventQueue;
+    FTSTicker::FDelegateHandle TickerHandle;
+
+    // Sphere geometry shared by every mesh; only the vertex colors depend on the prompt
+    TArray<FVector3f> SpherePositions;
+    TArray<int32> SphereIndices;
+
+    double GetTimelineEnd() const;
+    FScheduledEvent& Schedule(double DueTime, EShapEWorkerEventType Type, const FString& JobId);
+    void ScheduleStage(double DueTime, const FString& JobId, const TCHAR* Stage, bool bBegin, int32 Steps = 0);
+    // Sampling progress and the stages around one mesh; returns the time the mesh is done
+    double ScheduleSampling(double StartTime, const FString& JobId, int32 Steps);
+    double ScheduleDecode(double StartTime, const FString& JobId);
+    bool ShouldFailNextItem();
+
+    void BuildSphere();
+    bool WriteMesh(const FString& Directory, const FString& Name, uint32 Tint, FString& OutPlyPath, FString& OutObjPath, FString& OutError) const;
+};
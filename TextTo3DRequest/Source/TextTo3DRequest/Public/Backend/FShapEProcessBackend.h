@@ -0,0 +1,141 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Containers/Queue.h"
+#include "Backend/IShapEGenerationBackend.h"
+#include "Backend/FShapEWorkerLineDecoder.h"
+#include "Backend/FShapEWorkerRecordDecoder.h"
+
+class FShapEOutputReaderRunnable;
+
+/**
+ * Runs jobs on the persistent Python worker: run_shape.bat (run_shape.sh outside Windows) is launched with
+ * --worker, jobs are written to its stdin as JSON lines and its stdout is parsed into worker events on a
+ * reader thread. Launchers that can hand the worker a descriptor of its own (WantsRecordChannel) offer it the
+ * binary record protocol on it; the worker's messages then arrive there and stdout only carries its human
+ * readable output.
+ */
+class FShapEProcessBackend : public IShapEGenerationBackend, public TSharedFromThis<FShapEProcessBackend, ESPMode::ThreadSafe>
+{
+public:
+    virtual ~FShapEProcessBackend() override;
+
+    virtual FString GetName() const override { return TEXT("Process"); }
+
+    virtual bool Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType) override;
+    virtual void Stop() override;
+    virtual bool IsRunning() override;
+    virtual bool IsStartedFor(const FString& ScriptPath) override;
+    virtual uint32 GetGeneration() const override { return WorkerGeneration; }
+    virtual FShapETimingSpan GetStartSpan() const override { return WorkerSpawnSpan; }
+    virtual void SetWorkerArguments(const FString& Arguments) override;
+
+    virtual bool Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage) override;
+    // Sends the worker a cancel, which it acts on between sampling steps and answers with "cancelled"; it stays
+    // warm for the next job. A worker that has not answered ShapE.Cancel.Timeout seconds after it was ready is
+    // terminated instead, and restarted with the jobs submitted in the meantime. A timeout of 0 always terminates
+    virtual void Cancel(const FString& JobId) override;
+    virtual void ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh) override;
+
+    virtual bool DequeueEvent(FShapEWorkerEvent& OutEvent) override;
+
+protected:
+    // Launches the worker with WritePipe as its stdout and StdInReadPipe as its stdin; called under ProcessCS.
+    // Arguments go to the Python script (e.g. "--ue --worker --synthetic")
+    virtual bool LaunchWorker(const FString& ScriptPath, const FString& Arguments, FString& OutError, FString& OutErrorType);
+    virtual bool IsWorkerProcessRunning();
+    // Kills the worker if it still runs and releases its handle
+    virtual void KillWorkerProcess();
+    // Whether LaunchWorker can pass RecordWritePipe to the worker as ShapEWorkerRecords::WorkerFd
+    virtual bool WantsRecordChannel() const { return false; }
+
+    void* ReadPipe = nullptr;  // pipe for reading stdout of child process
+    void* WritePipe = nullptr; // handle for child process to write
+    void* StdInReadPipe = nullptr;  // handle for child process to read jobs from
+    void* StdInWritePipe = nullptr; // pipe for writing jobs to stdin of child process
+    void* RecordReadPipe = nullptr;  // pipe for reading the worker's records, when WantsRecordChannel
+    void* RecordWritePipe = nullptr; // handle for child process to write records
+
+    FCriticalSection ProcessCS;
+
+    // How long a job line may wait for room in the stdin pipe before the write is given up
+    static constexpr double StdInWriteTimeoutSeconds = 10.0;
+
+private:
+    friend class FShapEOutputReaderRunnable;
+
+    // Process handle of the launcher
+    FProcHandle PythonProcessHandle;
+
+    // Asynch
+    FRunnableThread* ReaderThread = nullptr;
+    TSharedPtr<FShapEOutputReaderRunnable> OutputReaderRunnable;
+    FRunnableThread* RecordReaderThread = nullptr;
+    TSharedPtr<FShapEOutputReaderRunnable> RecordReaderRunnable;
+
+    bool bIsWorkerRunning = false;
+    FString WorkerScriptPath;
+    FString WorkerArguments;
+    uint32 WorkerGeneration = 0;
+    FShapETimingSpan WorkerSpawnSpan;
+
+    // Reader threads produce, the manager drains on the game thread
+    TQueue<FShapEWorkerEvent, EQueueMode::Mpsc> EventQueue;
+
+    // Guarded by ProcessCS: cancels the worker has not answered yet (job id to when they were sent), when it was
+    // first ready (0 while it loads, which no cancel can interrupt) and the job lines written since the oldest cancel
+    TMap<FString, double> PendingCancels;
+    double WorkerReadyTime = 0.0;
+    TArray<FString> LinesSinceCancel;
+
+    // Only touched from the reader thread
+    FShapEWorkerLineDecoder LineDecoder{ TEXT("FShapEProcessBackend") };
+    // Only touched from the record reader thread
+    FShapEWorkerRecordDecoder RecordDecoder{ TEXT("FShapEProcessBackend") };
+    // Set once the worker accepted the record protocol; its progress records replace tqdm's bar on stdout
+    FThreadSafeBool bRecordsOpen;
+    // Guarded by ProcessCS: a worker whose record stream failed to decode is restarted on JSON lines
+    bool bRecordChannelBroken = false;
+
+    void CleanupProcessHandles();
+    bool WriteJobLine(const FString& JsonLine);
+    void TerminateWorker();
+    // Terminates a worker that let a cancel time out and restarts it with LinesSinceCancel; game thread
+    void CheckPendingCancels();
+    void HandlePythonOutputLine(FUtf8StringView OutputLine, uint32 Generation);
+    // False once the record stream failed
+    bool HandleWorkerRecords(const uint8* Data, int32 Length, uint32 Generation);
+    void ClosePipesAfterFailedStart();
+};
+
+// Runnable Class for Reading Async: stdout as lines, or the record pipe as records. The last of a worker's
+// readers to see EOF reports its exit, so every message of both streams is queued before it
+class FShapEOutputReaderRunnable : public FRunnable
+{
+public:
+    FShapEOutputReaderRunnable(void* InReadPipe, TSharedRef<FShapEProcessBackend, ESPMode::ThreadSafe> InBackend, uint32 InWorkerGeneration,
+        bool bInReadsRecords, TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> InOpenReaders);
+    virtual ~FShapEOutputReaderRunnable();
+
+    virtual bool Init() override;
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+    bool IsFinished() const { return bFinished; }
+
+private:
+    static constexpr int32 ReadChunkSize = 64 * 1024;
+
+    void* ReadPipe = nullptr;
+    TWeakPtr<FShapEProcessBackend, ESPMode::ThreadSafe> BackendPtr;
+    uint32 WorkerGeneration = 0;
+    bool bReadsRecords = false;
+    TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> OpenReaders;
+    FThreadSafeBool bStopRequested;
+    FThreadSafeBool bFinished;
+};
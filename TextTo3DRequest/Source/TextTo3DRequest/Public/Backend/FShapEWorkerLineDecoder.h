@@ -0,0 +1,27 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/FShapEOutputParser.h"
+#include "Manager/ShapEWorkerEvents.h"
+
+/**
+ * Turns parsed worker output lines (JSON messages and tqdm bars) into worker events, for every backend that
+ * speaks the worker's line protocol, over a pipe or an HTTP stream. Lines that are neither are logged, rate
+ * limited. Not thread safe; keep one per producing thread or stream.
+ */
+class FShapEWorkerLineDecoder
+{
+public:
+    // LogName prefixes the decoder's log lines, e.g. the owning backend's class name
+    explicit FShapEWorkerLineDecoder(const TCHAR* InLogName) : LogName(InLogName) {}
+
+    // False when the line carries no event (empty, unknown message type, library output, malformed preview)
+    bool Decode(FUtf8StringView Line, const FShapEParsedLine& Parsed, uint32 Generation, FShapEWorkerEvent& Event);
+
+private:
+    const TCHAR* LogName;
+    FShapELogRateLimiter TqdmLogLimiter{ 1.0 };
+    FShapELogRateLimiter UnparsedLogLimiter{ 1.0 };
+    FShapELogRateLimiter PreviewLogLimiter{ 1.0 };
+};
@@ -0,0 +1,158 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Deque.h"
+#include "Containers/Queue.h"
+#include "Backend/IShapEGenerationBackend.h"
+
+struct FShapEWorkerPoolSettings
+{
+    int32 NumWorkers = 2;
+    // Per worker, by index: the CUDA device (--device) and the CPU cores (--cores, e.g. "0-3") it is pinned to.
+    // Workers past the end of a list are left to the worker's defaults and the OS scheduler
+    TArray<int32> Devices;
+    TArray<FString> CoreSets;
+    // Without CoreSets, give every worker an equal, contiguous share of the machine's logical cores
+    bool bSplitCores = false;
+    // Jobs the manager may hand over beyond one per worker; they wait in the workers' deques
+    int32 QueuedJobsPerWorker = 1;
+    // Split batches into tasks of batch_size items, so idle workers can take them over
+    bool bSplitBatches = true;
+    // Makes the backend of one worker; an FShapEProcessBackend when unset
+    TFunction<TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>(int32 WorkerIndex)> MakeWorker;
+};
+
+/**
+ * Runs jobs on several workers at once, each one its own backend (a worker process unless MakeWorker says
+ * otherwise), optionally pinned to a GPU and a set of cores. Every worker has a deque of tasks: whole jobs, or
+ * batch_size items of a batch. New tasks go to the least loaded worker, single jobs ahead of batch items; a
+ * worker runs the front of its own deque and, once that is empty, steals from the back of the fullest one.
+ * Each worker is handed one task at a time, so nothing queued is lost when a worker dies; it is restarted the
+ * next time it has work. Everything runs on the game thread: the workers' events are drained and the next
+ * tasks submitted whenever the manager polls for events.
+ */
+class FShapEWorkerPoolBackend : public IShapEGenerationBackend
+{
+public:
+    explicit FShapEWorkerPoolBackend(const FShapEWorkerPoolSettings& InSettings);
+    virtual ~FShapEWorkerPoolBackend() override;
+
+    virtual FString GetName() const override { return TEXT("Pool"); }
+
+    // Starts every worker; fails only if none of them starts
+    virtual bool Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType) override;
+    virtual void Stop() override;
+    virtual bool IsRunning() override { return bIsRunning; }
+    virtual bool IsStartedFor(const FString& ScriptPath) override { return bIsRunning && ScriptPath == StartedScriptPath; }
+    virtual uint32 GetGeneration() const override { return Generation; }
+    virtual FShapETimingSpan GetStartSpan() const override { return StartSpan; }
+    virtual void SetWorkerArguments(const FString& Arguments) override { BaseArguments = Arguments; }
+    virtual int32 GetMaxConcurrentJobs() const override { return Workers.Num() * (1 + FMath::Max(0, Settings.QueuedJobsPerWorker)); }
+
+    virtual bool Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage) override;
+    // Drops the job's queued tasks and cancels the ones running; their workers take the next task once they gave them
+    // up (their "cancelled" answer, forwarded for the cancel stats) or exited
+    virtual void Cancel(const FString& JobId) override;
+    virtual void ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh) override;
+
+    virtual bool DequeueEvent(FShapEWorkerEvent& OutEvent) override;
+
+    struct FWorkerStats
+    {
+        FString Label;
+        bool bRunning = false;
+        bool bBusy = false;
+        int32 QueuedTasks = 0;
+        int32 CompletedTasks = 0;
+        int32 FailedTasks = 0;
+        // Tasks this worker took from another worker's deque
+        int32 StolenTasks = 0;
+        int32 Restarts = 0;
+        double BusySeconds = 0.0;
+        // Share of the time since the pool started (or the stats were reset) spent running tasks
+        double Utilization = 0.0;
+    };
+    TArray<FWorkerStats> GetWorkerStats() const;
+    void ResetWorkerStats();
+
+    const FShapEWorkerPoolSettings& GetSettings() const { return Settings; }
+
+private:
+    struct FTask
+    {
+        FString JobId;
+        // Id the worker sees; the events it sends back are renamed to JobId
+        FString TaskId;
+        TSharedPtr<FJsonObject> Message;
+        // Items of a split batch, relative to the whole batch; NumItems is 0 for whole jobs
+        int32 FirstItem = 0;
+        int32 NumItems = 0;
+    };
+
+    struct FWorker
+    {
+        int32 Index = 0;
+        FString Label;
+        FString PinArguments;
+        TSharedPtr<IShapEGenerationBackend, ESPMode::ThreadSafe> Backend;
+        // Owner takes from the front, thieves from the back
+        TDeque<FTask> Tasks;
+        TOptional<FTask> RunningTask;
+        // RunningTask was cancelled and the worker has not answered yet
+        bool bCancelling = false;
+        double BusySince = 0.0;
+        // Failed to start; its tasks go to the others until the pool starts again
+        bool bDisabled = false;
+        FWorkerStats Stats;
+    };
+
+    struct FPoolJob
+    {
+        FString Type;
+        int32 OpenTasks = 0;
+        int32 ItemCount = 0;
+        int32 FailedItems = 0;
+        TSet<int32> ReportedItems;
+        // Stages open on any of the job's workers; forwarded when the first opens and the last closes
+        TMap<FString, int32> OpenStages;
+    };
+
+    FShapEWorkerPoolSettings Settings;
+    TArray<FWorker> Workers;
+    TMap<FString, FPoolJob> Jobs;
+    // Shared-memory segments by the worker that created them
+    TMap<FString, int32> SegmentOwners;
+    TQueue<FShapEWorkerEvent, EQueueMode::Spsc> EventQueue;
+
+    FString StartedScriptPath;
+    FString BaseArguments;
+    bool bIsRunning = false;
+    bool bAnnouncedReady = false;
+    uint32 Generation = 0;
+    int32 NextTaskIndex = 0;
+    FShapETimingSpan StartSpan;
+    double StatsStartTime = 0.0;
+
+    bool StartWorker(FWorker& Worker, FString& OutError, FString& OutErrorType);
+    // Index of the enabled worker with the fewest running and queued tasks, INDEX_NONE if there is none
+    int32 PickWorker() const;
+    void QueueTask(FTask&& Task, bool bFront);
+
+    // Drains every worker's events, then hands idle workers their next task
+    void PollWorkers();
+    void ScheduleTasks();
+    void RunTask(FWorker& Worker, FTask&& Task);
+    void HandleWorkerEvent(FWorker& Worker, FShapEWorkerEvent&& Event);
+    void HandleStageEvent(FPoolJob& Job, FShapEWorkerEvent&& Event);
+    // Clears the worker's running task and charges its busy time
+    FTask EndTask(FWorker& Worker);
+    // Reports a task that will not complete: its items fail one by one, a whole job fails outright
+    void FailTask(const FTask& Task, const FString& Message, const FString& ErrorType);
+    // Counts a batch task as done; the batch completes with its last task
+    void FinishBatchTask(const FString& JobId);
+    void FinishJob(const FString& JobId);
+
+    void Emit(FShapEWorkerEvent&& Event);
+    FShapEWorkerEvent MakeEvent(EShapEWorkerEventType Type, const FString& JobId) const;
+};
@@ -0,0 +1,113 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Backend/FShapEWorkerLineDecoder.h"
+#include "Manager/ShapEWorkerEvents.h"
+
+/**
+ * The worker's binary record protocol (ue_shape_interface.py --record-fd): every record is a uint32 length of
+ * what follows, a uint8 record type and the body, all little-endian. Bodies start with the job id; strings and
+ * byte arrays carry a uint32 length. The first record is a Hello with the version the worker picked from the
+ * ones the editor offered; version 0 means it stays on JSON lines.
+ */
+namespace ShapEWorkerRecords
+{
+    // The version this editor speaks, offered to the worker with --record-versions
+    constexpr uint16 ProtocolVersion = 1;
+    // Descriptor the record pipe becomes in the worker
+    constexpr int32 WorkerFd = 3;
+    // Anything longer is taken for a corrupt stream; the largest real records are previews of at most 256x256
+    constexpr int32 MaxRecordBytes = 16 * 1024 * 1024;
+
+    enum class ERecordType : uint8
+    {
+        Hello = 1,
+        Ready,
+        Status,
+        Info,
+        Progress,
+        Stage,
+        Error,
+        Complete,
+        ItemComplete,
+        ItemError,
+        Cancelled,
+        Preview,
+        // A JSON message in the line protocol's format, for messages with fields outside their record's layout
+        Json
+    };
+
+    /** Appends records to a buffer the way the worker's encode_record does; used to build test streams. */
+    class FWriter
+    {
+    public:
+        explicit FWriter(TArray<uint8>& InBuffer) : Buffer(InBuffer) {}
+
+        void BeginRecord(ERecordType Type);
+        void EndRecord();
+
+        void WriteU8(uint8 Value) { Buffer.Add(Value); }
+        void WriteU16(uint16 Value);
+        void WriteU32(uint32 Value);
+        void WriteI64(int64 Value);
+        void WriteF32(float Value);
+        void WriteF64(double Value);
+        void WriteString(const FString& Value);
+        void WriteBytes(const uint8* Data, int32 Length);
+
+        // The hello the worker opens the stream with
+        void WriteHello(uint16 Version);
+
+    private:
+        TArray<uint8>& Buffer;
+        int32 RecordStart = INDEX_NONE;
+    };
+}
+
+/**
+ * Turns the worker's record stream into worker events. Records may arrive split across any number of reads;
+ * a partial record is kept until the rest arrives. A malformed record cannot be skipped reliably, so the first
+ * one fails the stream and nothing after it is decoded. Not thread safe; keep one per reading thread.
+ */
+class FShapEWorkerRecordDecoder
+{
+public:
+    enum class EState : uint8
+    {
+        // Nothing but a hello is accepted yet
+        AwaitingHello,
+        Open,
+        // The worker answered with version 0 and stays on JSON lines
+        Declined,
+        Failed
+    };
+
+    explicit FShapEWorkerRecordDecoder(const TCHAR* InLogName) : LogName(InLogName), JsonDecoder(InLogName) {}
+
+    // Decodes every record Data completes and hands their events to OnEvent. False once the stream failed; GetError
+    // says why, the decoder does not log it
+    bool Append(const uint8* Data, int32 Length, uint32 Generation, TFunctionRef<void(FShapEWorkerEvent&&)> OnEvent);
+    void Reset();
+
+    EState GetState() const { return State; }
+    uint16 GetVersion() const { return Version; }
+    const FString& GetError() const { return Error; }
+    int32 GetPendingBytes() const { return Buffer.Num() - ConsumedBytes; }
+
+private:
+    const TCHAR* LogName;
+    FShapEWorkerLineDecoder JsonDecoder;
+    FShapELogRateLimiter PreviewLogLimiter{ 1.0 };
+
+    TArray<uint8> Buffer;
+    int32 ConsumedBytes = 0;
+    EState State = EState::AwaitingHello;
+    uint16 Version = 0;
+    FString Error;
+
+    bool DecodeHello(const uint8* Body, int32 Length);
+    // False if the body does not match its type's layout; bOutHasEvent is false for records without an event
+    bool DecodeRecord(ShapEWorkerRecords::ERecordType Type, const uint8* Body, int32 Length, uint32 Generation, FShapEWorkerEvent& OutEvent, bool& bOutHasEvent);
+    bool Fail(const FString& Reason);
+};
@@ -0,0 +1,50 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+#include "Manager/ShapEWorkerEvents.h"
+
+class FJsonObject;
+
+/**
+ * Executes generation jobs for FShapEProcessManager. The manager keeps the queue, the result cache, timing and
+ * the delegates; a backend runs the job messages it is handed, up to GetMaxConcurrentJobs at a time, and reports
+ * back through the same worker events the Python worker produces. Calls come from the game thread; events may be produced on one
+ * thread of the backend's choosing and are drained on the game thread.
+ */
+class IShapEGenerationBackend
+{
+public:
+    virtual ~IShapEGenerationBackend() = default;
+
+    virtual FString GetName() const = 0;
+
+    // Brings the backend up for jobs queued with ScriptPath (e.g. launches the worker). On failure OutError and
+    // OutErrorType describe why, in the terms of the error delegates
+    virtual bool Start(const FString& ScriptPath, FString& OutError, FString& OutErrorType) = 0;
+    // Shuts down and waits for the backend's threads; events not drained yet are dropped
+    virtual void Stop() = 0;
+    virtual bool IsRunning() = 0;
+    // False when the backend has to be started again before it can run a job queued with ScriptPath
+    virtual bool IsStartedFor(const FString& ScriptPath) = 0;
+    // Changes with every Start; events carry the value of the start they belong to
+    virtual uint32 GetGeneration() const = 0;
+    // What the last Start took on the editor's clock, charged to the job that caused it
+    virtual FShapETimingSpan GetStartSpan() const = 0;
+    // Extra launch arguments, applied the next time the backend starts
+    virtual void SetWorkerArguments(const FString& Arguments) {}
+    // Jobs the manager may have submitted at once; the rest wait in its queue. Backends running more than one
+    // tag every event with its job id
+    virtual int32 GetMaxConcurrentJobs() const { return 1; }
+
+    // Hands over one job message: {"type": "generate" | "batch" | "decode", "job_id": ..., parameters...}
+    virtual bool Submit(const FString& JobId, const TSharedRef<FJsonObject>& JobMessage) = 0;
+    // Abandons a submitted job; it reports nothing afterwards
+    virtual void Cancel(const FString& JobId) = 0;
+    // Called once the listeners of a Complete event are done with its shared-memory mesh
+    virtual void ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh) {}
+
+    // Next event in the order the backend produced them; false when there is none
+    virtual bool DequeueEvent(FShapEWorkerEvent& OutEvent) = 0;
+};
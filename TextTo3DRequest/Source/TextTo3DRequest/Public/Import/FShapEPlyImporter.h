@@ -0,0 +1,108 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+#include "Processing/FShapEMeshCleanup.h"
+#include "Processing/FShapEMeshDecimator.h"
+
+struct FMeshDescription;
+class UStaticMesh;
+
+enum class EShapEPlyScalar : uint8
+{
+    None,
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
+
+/**
+ * Layout of a binary little-endian PLY file, as written by Shap-E's write_ply:
+ * a vertex element with float x/y/z and optional uchar red/green/blue, followed by a face element
+ * holding one "list uchar int vertex_index" property. Other scalar types and extra properties are
+ * accepted as long as every element except the face list has a fixed stride.
+ */
+struct FShapEPlyLayout
+{
+    int32 NumVertices = 0;
+    int32 NumFaces = 0;
+
+    int64 VertexDataOffset = 0;
+    int32 VertexStride = 0;
+    int32 PositionOffsets[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+    EShapEPlyScalar PositionTypes[3] = { EShapEPlyScalar::None, EShapEPlyScalar::None, EShapEPlyScalar::None };
+    int32 ColorOffsets[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+    EShapEPlyScalar ColorTypes[3] = { EShapEPlyScalar::None, EShapEPlyScalar::None, EShapEPlyScalar::None };
+
+    int64 FaceDataOffset = 0;
+    // Fixed-size scalar properties around the index list
+    int32 FacePrefixBytes = 0;
+    int32 FaceSuffixBytes = 0;
+    EShapEPlyScalar FaceCountType = EShapEPlyScalar::None;
+    EShapEPlyScalar FaceIndexType = EShapEPlyScalar::None;
+
+    bool HasColors() const { return ColorOffsets[0] != INDEX_NONE && ColorOffsets[1] != INDEX_NONE && ColorOffsets[2] != INDEX_NONE; }
+};
+
+struct FShapEPlyImportOptions
+{
+    // Shap-E meshes span roughly [-1, 1]; 100 maps that to about two metres
+    float Scale = 100.0f;
+    // Shap-E writes right-handed coordinates; mirroring Y (and flipping the winding) converts them to UE's left-handed space
+    bool bConvertHandedness = true;
+    FName MaterialSlotName = TEXT("ShapE_Material");
+    // Weld, drop degenerate faces and compute normals/tangents before the static mesh is built
+    bool bCleanupMesh = true;
+    FShapEMeshCleanupOptions Cleanup;
+    // Triangle budget of each LOD, LOD0 first; decimation needs the welded mesh the cleanup produces
+    TArray<int32> LODTriangleBudgets;
+    FShapEMeshDecimationOptions Decimation;
+    // Enables Nanite on the full-resolution mesh instead of building LODs; the last budget sizes the fallback mesh
+    bool bEnableNanite = false;
+
+    static FShapEPlyImportOptions FromGenerationParameters(const FShapEGenerationParameters& Params);
+};
+
+struct FShapEPlyImportStats
+{
+    int32 NumVertices = 0;
+    int32 NumTriangles = 0;
+    int32 SkippedFaces = 0;
+    double ParseSeconds = 0.0;
+    double BuildSeconds = 0.0;
+    bool bCleanedUp = false;
+    FShapEMeshCleanupStats Cleanup;
+    bool bNaniteEnabled = false;
+    // LODTriangles is empty when no LODs were built
+    FShapEMeshDecimationStats Decimation;
+};
+
+/**
+ * Imports Shap-E PLY output without going through a text importer. The file is memory mapped and the
+ * vertex and face blocks are read in place into an FMeshDescription, with vertex colors.
+ * Meshes handed over in shared memory go through the same path without touching the disk.
+ */
+class FShapEPlyImporter
+{
+public:
+    static bool ParseLayout(const uint8* Data, int64 Size, FShapEPlyLayout& OutLayout, FString& OutError);
+
+    static bool ImportMeshDescription(const FString& PlyPath, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats = nullptr);
+    static bool FillMeshDescription(const uint8* Data, int64 Size, const FShapEPlyLayout& Layout, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FShapEPlyImportStats* OutStats = nullptr);
+    // Same mesh build, reading the arrays the worker left in shared memory
+    static bool ImportSharedMesh(const FShapESharedMeshLayout& Layout, FMeshDescription& OutMesh, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats = nullptr);
+
+#if WITH_EDITOR
+    // Creates and saves-dirty a static mesh asset at a unique name under PackagePath (e.g. /Game/ShapE)
+    static UStaticMesh* CreateStaticMesh(const FString& PlyPath, const FString& PackagePath, const FString& AssetName, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats* OutStats = nullptr);
+    static UStaticMesh* CreateStaticMesh(FMeshDescription&& MeshDescription, const FString& PackagePath, const FString& AssetName, const FShapEPlyImportOptions& Options, FString& OutError, FShapEPlyImportStats Stats = FShapEPlyImportStats(), FShapEPlyImportStats* OutStats = nullptr);
+#endif
+
+    static int32 GetScalarSize(EShapEPlyScalar Type);
+};
@@ -0,0 +1,37 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+
+/**
+ * Read-only mapping of a named shared-memory segment created by the worker
+ * (Python's multiprocessing.shared_memory: a named file mapping on Windows, shm_open elsewhere).
+ * The mapping is released when the view is destroyed; the worker unlinks the segment on "release".
+ */
+class FShapESharedMemoryView
+{
+public:
+    FShapESharedMemoryView() = default;
+    ~FShapESharedMemoryView();
+
+    FShapESharedMemoryView(const FShapESharedMemoryView&) = delete;
+    FShapESharedMemoryView& operator=(const FShapESharedMemoryView&) = delete;
+
+    bool Open(const FString& SegmentName, int64 Size, FString& OutError);
+    void Close();
+
+    // Checks that every array described by the layout lies inside the mapped segment
+    bool ValidateLayout(const FShapESharedMeshLayout& Layout, FString& OutError) const;
+
+    const uint8* GetData() const { return static_cast<const uint8*>(MappedData); }
+    int64 GetSize() const { return MappedSize; }
+    bool IsOpen() const { return MappedData != nullptr; }
+
+private:
+    void* MappedData = nullptr;
+    int64 MappedSize = 0;
+#if PLATFORM_WINDOWS
+    void* MappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,30 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+
+/**
+ * Priority queue of pending generation jobs, FIFO within each priority.
+ * Not thread safe; the owning manager guards it.
+ */
+class FShapEJobQueue
+{
+public:
+    void Enqueue(const TSharedRef<FShapEJob>& Job);
+    // Puts a suspended job back ahead of the other jobs of its priority
+    void EnqueueFront(const TSharedRef<FShapEJob>& Job);
+    TSharedPtr<FShapEJob> Dequeue();
+    TSharedPtr<FShapEJob> Remove(const FString& JobId);
+    TSharedPtr<FShapEJob> Find(const FString& JobId) const;
+    void Empty(TArray<TSharedRef<FShapEJob>>& OutJobs);
+
+    bool HasQueued(EShapEJobPriority Priority) const { return Queues[static_cast<int32>(Priority)].Num() > 0; }
+    int32 Num(EShapEJobPriority Priority) const { return Queues[static_cast<int32>(Priority)].Num(); }
+    int32 Num() const;
+    bool IsEmpty() const { return Num() == 0; }
+    double GetOldestWaitSeconds(double Now) const;
+
+private:
+    TArray<TSharedRef<FShapEJob>> Queues[static_cast<int32>(EShapEJobPriority::Count)];
+};
@@ -0,0 +1,31 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Splits a byte stream into records. A record ends at '\n' or at a bare '\r', so every
+ * tqdm carriage-return update becomes its own record. Bytes after the last terminator are
+ * kept until the rest of the line arrives. The internal buffer is reused between reads.
+ */
+class FShapELineFramer
+{
+public:
+    // Receives the UTF-8 bytes of one record, without its terminator. Only valid during the call.
+    using FRecordFunc = TFunctionRef<void(const UTF8CHAR* /*Data*/, int32 /*Length*/)>;
+
+    explicit FShapELineFramer(int32 InitialCapacity = 64 * 1024);
+
+    void Append(const uint8* Data, int32 Length, FRecordFunc OnRecord);
+    // Emits the pending partial record, if any (call once the stream has ended)
+    void Flush(FRecordFunc OnRecord);
+    void Reset();
+
+    int32 GetPendingBytes() const { return Buffer.Num() - ConsumedBytes; }
+
+private:
+    TArray<uint8> Buffer;
+    int32 ConsumedBytes = 0;
+    // The previous record ended in '\r'; a leading '\n' completes that terminator
+    bool bSkipNextLineFeed = false;
+};
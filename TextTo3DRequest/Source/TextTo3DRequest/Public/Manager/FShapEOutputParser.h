@@ -0,0 +1,92 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+enum class EShapELineKind : uint8
+{
+    Empty,
+    Json,
+    Tqdm,
+    Other
+};
+
+enum class EShapEJsonValueKind : uint8
+{
+    String,
+    Number,
+    Literal,  // true / false / null
+    Compound  // nested object or array, kept as raw text
+};
+
+// One top-level "key": value pair. Views point into the parsed line.
+struct FShapEJsonField
+{
+    FUtf8StringView Key;
+    FUtf8StringView Value; // string contents without quotes, still escaped if bEscaped
+    EShapEJsonValueKind Kind = EShapEJsonValueKind::Literal;
+    bool bEscaped = false;
+};
+
+/**
+ * Result of classifying one worker output line. Nothing is copied: every view points into the
+ * caller's line buffer and is only valid as long as that buffer is.
+ */
+struct FShapEParsedLine
+{
+    EShapELineKind Kind = EShapELineKind::Empty;
+
+    // Json
+    TArray<FShapEJsonField, TInlineAllocator<24>> Fields;
+
+    // Tqdm; INDEX_NONE when the bar does not show the value (yet)
+    int32 Percent = INDEX_NONE;
+    int32 Step = INDEX_NONE;
+    int32 TotalSteps = INDEX_NONE;
+    double Rate = 0.0;
+    bool bSecondsPerIteration = false; // tqdm switches from it/s to s/it for slow loops
+
+    const FShapEJsonField* FindField(FUtf8StringView Key) const;
+    bool TypeEquals(FUtf8StringView Type) const;
+
+    // Accessors convert on demand; they only allocate for the FString they return
+    bool TryGetString(FUtf8StringView Key, FString& OutValue) const;
+    bool TryGetInt(FUtf8StringView Key, int32& OutValue) const;
+    bool TryGetDouble(FUtf8StringView Key, double& OutValue) const;
+};
+
+/**
+ * Classifies worker output lines by their first bytes and extracts JSON fields and tqdm counters
+ * straight from the UTF-8 bytes, without building a JSON DOM or intermediate strings.
+ * Only flat top-level fields are indexed; nested values are skipped and exposed as raw text.
+ */
+class FShapEOutputParser
+{
+public:
+    static void Parse(FUtf8StringView Line, FShapEParsedLine& OutLine);
+
+    static bool ParseJsonObject(FUtf8StringView Line, FShapEParsedLine& OutLine);
+    static bool ParseTqdm(FUtf8StringView Line, FShapEParsedLine& OutLine);
+
+    static void UnescapeJsonString(FUtf8StringView Raw, bool bEscaped, FString& OutValue);
+    static bool ParseInt(FUtf8StringView Text, int32& OutValue);
+    static bool ParseDouble(FUtf8StringView Text, double& OutValue);
+};
+
+/**
+ * Lets a diagnostic through at most once per interval and counts what it swallowed in between.
+ * Not thread safe; keep one per producing thread.
+ */
+struct FShapELogRateLimiter
+{
+    explicit FShapELogRateLimiter(double InIntervalSeconds = 1.0) : IntervalSeconds(InIntervalSeconds) {}
+
+    // True if the caller should log now; OutSuppressed is the number of calls dropped since the last log
+    bool ShouldLog(double Now, int32& OutSuppressed);
+
+private:
+    double IntervalSeconds;
+    double LastLogTime = -1.0;
+    int32 SuppressedCount = 0;
+};
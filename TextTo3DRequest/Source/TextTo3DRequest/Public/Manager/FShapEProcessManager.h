@@ -2,39 +2,93 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "HAL/Runnable.h"
-#include "HAL/PlatformProcess.h"
-#include "HAL/ThreadSafeBool.h" 
 #include "Delegates/DelegateCombinations.h"
-
-struct FShapEGenerationParameters
-{
-    FString Prompt;
-    FString OutputDirectory;
-    float GuidanceScale = 15.0f;
-    int32 KarrasSteps = 64;
-    bool bUseFP16 = true;
-
-    FString ToJsonString() const; 
-};
-
-DECLARE_MULTICAST_DELEGATE_FourParams(FOnShapEProgressUpdated, float /*Percentage*/, int32 /*Step*/, int32 /*TotalSteps*/, const FString& /*RawMessage*/);
-DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapEStatusMessageReceived, const FString& /*Message*/);
-DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapEGenerationComplete, const FString& /*PlyPath*/, const FString& /*ObjPath*/, const FString& /*RawMessage*/);
-DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapEErrorReceived, const FString& /*ErrorMessage*/, const FString& /*ErrorType*/, const FString& /*RawMessage*/);
-DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapEInfoMessageReceived, const FString& /*Message*/);
-DECLARE_MULTICAST_DELEGATE(FOnShapEProcessFinished);
-
-class FShapEOutputReaderRunnable; 
-
+#include "Manager/ShapEJobTypes.h"
+#include "Manager/FShapEJobQueue.h"
+#include "Manager/ShapEWorkerEvents.h"
+#include "Manager/FShapEResultCache.h"
+#include "Backend/IShapEGenerationBackend.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Queues generation jobs, serves repeats from the result cache, dispatches jobs to its backend (as many at once as
+ * the backend accepts, usually one) and turns the backend's events into the delegates below. The backend is the Python worker process unless another
+ * one is passed in (e.g. FShapEMockBackend for load tests).
+ */
 class FShapEProcessManager : public TSharedFromThis<FShapEProcessManager>
 {
 public:
+    FShapEProcessManager();
+    explicit FShapEProcessManager(const TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>& InBackend);
     ~FShapEProcessManager();
 
+    // Stops the current backend (cancelling a running job) and sends later jobs to InBackend
+    void SetBackend(const TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe>& InBackend);
+    TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe> GetBackend() const { return Backend; }
+
+    // Queues a job and returns its id (empty if the request is invalid). The worker is started on demand.
+    // Requests already in the result cache complete on the next game thread tick without running the worker.
+    FString EnqueueGeneration(const FString& ScriptPath, const FShapEGenerationParameters& Params, EShapEJobPriority Priority = EShapEJobPriority::Interactive, TSharedPtr<FShapEJobDelegates> Delegates = nullptr);
+    // Every item of a batch reports through OnBatchItemComplete, the batch as a whole through OnGenerationComplete.
+    FString EnqueueBatch(const FString& ScriptPath, const FShapEBatchGenerationParameters& Params, EShapEJobPriority Priority = EShapEJobPriority::Bulk, TSharedPtr<FShapEJobDelegates> Delegates = nullptr);
+    // Re-exports a stored generation from its latent file (see OnLatentSaved); only the decode step runs
+    FString EnqueueDecode(const FString& ScriptPath, const FShapEDecodeParameters& Params, EShapEJobPriority Priority = EShapEJobPriority::Interactive, TSharedPtr<FShapEJobDelegates> Delegates = nullptr);
+    // Removes a queued job, or stops it if it is running. The process backend's worker gives a running job up between sampling steps and stays warm.
+    bool CancelJob(const FString& JobId);
+    void CancelAllJobs();
+
+    // When enabled, bulk batches are dispatched one slice of BatchSize items at a time so interactive jobs can run in between.
+    void SetPreemptBulkBatches(bool bEnable);
+    int32 GetQueueDepth();
+    FShapEQueueStats GetQueueStats();
+
+    // Convenience wrappers: an interactive single prompt and a bulk batch
     bool LaunchProcess(const FString& ScriptPath, const FShapEGenerationParameters& Params);
+    bool LaunchBatch(const FString& ScriptPath, const FShapEBatchGenerationParameters& Params);
+    // Cancels the most recently dispatched running job
     void RequestStopProcess();
+    // True while a generation job is in flight.
     bool IsRunning();
+    int32 GetRunningJobCount();
+
+    // Persistent worker: the backend is started once and keeps the models loaded between jobs.
+    bool StartWorker(const FString& ScriptPath);
+    // Extra arguments for the backend (e.g. --synthetic for the worker script); applied the next time it starts
+    void SetWorkerArguments(const FString& InArguments);
+    void StopWorker();
+    bool IsWorkerRunning();
+    bool IsWorkerReady();
+    // Starts the backend ahead of the first job so the model load is out of its way. Skipped when less than
+    // MinFreeMemoryBytes of physical memory is available, and when the backend is already up or busy
+    bool Prewarm(const FString& ScriptPath, uint64 MinFreeMemoryBytes = 0);
+    EShapEWarmupState GetWarmupState();
+    FString GetCurrentJobId();
+
+    // Result cache in front of single-prompt generation, under Saved/ShapECache
+    FShapEResultCache& GetResultCache();
+    FShapECacheStats GetCacheStats() { return GetResultCache().GetStats(); }
+
+    // Timing of finished jobs, oldest first; the last MaxTimingHistory jobs are kept
+    bool GetJobTiming(const FString& JobId, FShapEJobTiming& OutTiming);
+    TArray<FShapEJobTiming> GetTimingHistory();
+    // Adds a stage that ran in the editor after the job finished (e.g. the static mesh import) to its timing
+    void AddJobTimingSpan(const FString& JobId, const FString& Stage, double StartSeconds, double EndSeconds);
+    // Writes the timing history as CSV, one row per span, or as {"jobs": [...]} when the path ends in .json
+    bool ExportTimings(const FString& FilePath);
+
+    // How long worker events waited between the reader thread and their dispatch on the game thread
+    FShapEDispatchLatencyStats GetDispatchLatencyStats();
+    void ResetDispatchLatencyStats();
+    // From launching the current worker to its first message (launcher, environment and interpreter start);
+    // 0 until it has sent one
+    double GetWorkerBootSeconds();
+    // Time from cancelling a running job to the worker's next "ready"; not taken when the cancel left no worker
+    // running (e.g. ShapE.Cancel.Timeout 0 with nothing queued)
+    FShapECancelStats GetCancelStats();
+    void ResetCancelStats();
+
+    // Dispatches queued worker events; runs once per core ticker tick, callable directly when no ticker is pumped
+    void PumpEvents();
 
     FOnShapEProgressUpdated& OnProgressUpdated() { return ProgressUpdatedDelegate; }
     FOnShapEStatusMessageReceived& OnStatusMessageReceived() { return StatusMessageReceivedDelegate; }
@@ -42,27 +96,74 @@ public:
     FOnShapEErrorReceived& OnErrorReceived() { return ErrorReceivedDelegate; }
     FOnShapEInfoMessageReceived& OnInfoMessageReceived() { return InfoMessageReceivedDelegate; }
     FOnShapEProcessFinished& OnProcessFinished() { return ProcessFinishedDelegate; }
+    FOnShapEWorkerReady& OnWorkerReady() { return WorkerReadyDelegate; }
+    FOnShapEBatchItemComplete& OnBatchItemComplete() { return BatchItemCompleteDelegate; }
+    FOnShapEBatchItemError& OnBatchItemError() { return BatchItemErrorDelegate; }
+    FOnShapESharedMeshReady& OnSharedMeshReady() { return SharedMeshReadyDelegate; }
+    FOnShapELatentSaved& OnLatentSaved() { return LatentSavedDelegate; }
+    FOnShapEPreviewReceived& OnPreviewReceived() { return PreviewReceivedDelegate; }
 
 
 private:
-    friend class FShapEOutputReaderRunnable;
-
-    // Process and Pipe handles
-    FProcHandle PythonProcessHandle;
-    void* ReadPipe = nullptr;  // pipe for reading stdout of child process
-    void* WritePipe = nullptr; // handle for child process to write
-
-    // Asynch
-    FRunnableThread* ReaderThread = nullptr;
-    TSharedPtr<FShapEOutputReaderRunnable> OutputReaderRunnable;
+    TSharedRef<IShapEGenerationBackend, ESPMode::ThreadSafe> Backend;
 
     // condVar
     FCriticalSection ProcessManagementCS;
-    bool bIsProcessRunning = false;
-
-    void CleanupProcessHandles();
-    void HandlePythonOutputLine(const FString& OutputLine);
+    bool bIsWorkerReady = false;
+    EShapEWarmupState WarmupState = EShapEWarmupState::Cold;
+    FString CurrentJobId; // id of the most recently dispatched running job
+
+    // Backend events, drained once per tick
+    TArray<FShapEWorkerEvent> PendingEvents;
+    FTSTicker::FDelegateHandle EventTickerHandle;
+
+    bool TickEvents(float DeltaTime);
+    FString ResolveEventJobId(const FShapEWorkerEvent& Event);
+    void DispatchEvent(const FShapEWorkerEvent& Event);
+
+    // Timing; only touched on the game thread apart from the history, which is guarded by ProcessManagementCS
+    static constexpr int32 MaxTimingHistory = 256;
+    TArray<FShapEJobTiming> TimingHistory;
+    bool bWorkerOutputSeen = false;
+    double WorkerBootSeconds = 0.0; // guarded by ProcessManagementCS
+    // Editor clock minus worker clock; the smallest difference seen carries the least delivery latency
+    double WorkerClockOffset = 0.0;
+    bool bHasWorkerClockOffset = false;
+
+    FShapEDispatchLatencyStats DispatchLatency; // guarded by ProcessManagementCS
+    // When a running job was cancelled and the worker has not been ready since, 0 otherwise
+    double CancelRequestTime = 0.0; // guarded by ProcessManagementCS
+    FShapECancelStats CancelStats; // guarded by ProcessManagementCS
+
+    void AddTimingSpan(FShapEJob& Job, const FString& Stage, double StartSeconds, double EndSeconds);
+    void RecordStageEvent(const FShapEWorkerEvent& Event, FShapEJob* Job);
+    void FinishJobTiming(FShapEJob& Job);
+
+    TUniquePtr<FShapEResultCache> ResultCache;
+    bool TryCompleteFromCache(const TSharedRef<FShapEJob>& Job);
+
+    // Scheduling
+    FShapEJobQueue JobQueue;
+    // Submitted to the backend, in dispatch order
+    TArray<TSharedRef<FShapEJob>> RunningJobs;
+    bool bPreemptBulkBatches = true;
+    double TotalWaitSeconds = 0.0;
+    int32 DispatchedJobCount = 0;
+
+    FString EnqueueJob(const TSharedRef<FShapEJob>& Job);
+    void TryDispatchNextJob();
+    bool DispatchJob(const TSharedRef<FShapEJob>& Job);
+    // Running job lookups; call with ProcessManagementCS held
+    TSharedPtr<FShapEJob> FindRunningJob(const FString& JobId) const;
+    TSharedPtr<FShapEJob> RemoveRunningJob(const FString& JobId);
+    void HandleJobComplete(const FString& JobId, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath, const FString& RawMessage, const FShapESharedMeshLayout& SharedMesh);
+    void HandleJobError(const FString& JobId, const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage);
+    void HandleBatchItemComplete(const FString& JobId, int32 ItemIndex, int32 ItemCount, const FString& Prompt, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath, const FString& RawMessage);
+
+    // Tells the backend the editor is done with a shared-memory segment so it can be unlinked
+    void ReleaseSharedMesh(const FShapESharedMeshLayout& SharedMesh);
     void NotifyProcessFinished();
+    void NotifyWorkerExited(uint32 Generation);
 
     FOnShapEProgressUpdated ProgressUpdatedDelegate;
     FOnShapEStatusMessageReceived StatusMessageReceivedDelegate;
@@ -70,24 +171,10 @@ private:
     FOnShapEErrorReceived ErrorReceivedDelegate;
     FOnShapEInfoMessageReceived InfoMessageReceivedDelegate;
     FOnShapEProcessFinished ProcessFinishedDelegate;
+    FOnShapEWorkerReady WorkerReadyDelegate;
+    FOnShapEBatchItemComplete BatchItemCompleteDelegate;
+    FOnShapEBatchItemError BatchItemErrorDelegate;
+    FOnShapESharedMeshReady SharedMeshReadyDelegate;
+    FOnShapELatentSaved LatentSavedDelegate;
+    FOnShapEPreviewReceived PreviewReceivedDelegate;
 };
-
-// Runnable Class for Reading Async
-class FShapEOutputReaderRunnable : public FRunnable
-{
-public:
-    FShapEOutputReaderRunnable(void* InReadPipe, TSharedRef<FShapEProcessManager, ESPMode::ThreadSafe> InProcessManager);
-    virtual ~FShapEOutputReaderRunnable();
-
-    virtual bool Init() override;
-    virtual uint32 Run() override;
-    virtual void Stop() override;
-
-    bool IsFinished() const { return bFinished; }
-
-private:
-    void* ReadPipe = nullptr;
-    TWeakPtr<FShapEProcessManager> ProcessManagerPtr;
-    FThreadSafeBool bStopRequested;
-    FThreadSafeBool bFinished;
-};
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+
+struct FShapECacheEntry
+{
+    FString Key;
+    FString Prompt;
+    // File names inside the cache directory
+    FString PlyFile;
+    FString ObjFile;
+    // The sampled latent saved next to the mesh, if any; counted in SizeBytes and evicted with it
+    FString LatentFile;
+    int64 SizeBytes = 0;
+    FDateTime CreatedTime;
+    FDateTime LastAccessTime;
+};
+
+struct FShapECacheStats
+{
+    int32 Hits = 0;
+    int32 Misses = 0;
+    int32 Stores = 0;
+    int32 Evictions = 0;
+    int32 EntryCount = 0;
+    int64 TotalBytes = 0;
+    int64 MaxBytes = 0;
+};
+
+/**
+ * Generated meshes keyed by a hash of everything that determines the output (normalized prompt,
+ * guidance scale, Karras steps, FP16, seed and model version). Files are named after that hash, so
+ * different requests never overwrite each other. Unseeded requests are neither looked up nor stored. The index is kept in index.json next to the files
+ * and entries are evicted least-recently-used first once the directory exceeds its size budget.
+ * Not thread safe; used from the game thread.
+ */
+class FShapEResultCache
+{
+public:
+    explicit FShapEResultCache(const FString& InCacheDirectory, int64 InMaxBytes = 2ll * 1024 * 1024 * 1024);
+    // Writes access times of hits that were not saved yet
+    ~FShapEResultCache();
+
+    // Only seeded requests are reproducible; an unseeded one asks for a new random mesh every time
+    static bool IsCacheable(const FShapEGenerationParameters& Params) { return Params.Seed >= 0; }
+    static FString MakeKey(const FShapEGenerationParameters& Params);
+    static FString NormalizePrompt(const FString& Prompt);
+
+    // On a hit the entry becomes the most recently used one, kept in memory until the index is next written (on a
+    // store, an eviction or destruction); entries whose files vanished count as misses
+    bool Lookup(const FString& Key, FString& OutPlyPath, FString& OutObjPath);
+    // Records files the worker wrote into the cache directory, then evicts down to the budget
+    void Store(const FString& Key, const FString& Prompt, const FString& PlyPath, const FString& ObjPath, const FString& LatentPath = FString());
+    // Also deletes latents no entry accounts for
+    void Clear();
+
+    void SetMaxBytes(int64 InMaxBytes);
+    const FString& GetDirectory() const { return CacheDirectory; }
+    FShapECacheStats GetStats() const;
+
+private:
+    FString CacheDirectory;
+    int64 MaxBytes;
+    int64 TotalBytes = 0;
+    TMap<FString, FShapECacheEntry> Entries;
+    bool bIndexLoaded = false;
+    // Access times changed since index.json was written
+    bool bIndexDirty = false;
+
+    int32 Hits = 0;
+    int32 Misses = 0;
+    int32 Stores = 0;
+    int32 Evictions = 0;
+
+    FString GetIndexPath() const;
+    FString GetFilePath(const FString& FileName) const;
+    void LoadIndex();
+    void SaveIndex();
+    void RemoveEntry(const FString& Key, bool bDeleteFiles);
+    void EvictToBudget(const FString& KeepKey);
+};
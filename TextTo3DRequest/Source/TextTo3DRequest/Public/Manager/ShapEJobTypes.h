@@ -0,0 +1,294 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Delegates/DelegateCombinations.h"
+
+class FJsonObject;
+
+struct FShapEGenerationParameters
+{
+    FString Prompt;
+    FString OutputDirectory;
+    float GuidanceScale = 15.0f;
+    int32 KarrasSteps = 64;
+    // Triangle budget of each LOD of the imported mesh, LOD0 first; empty keeps one full-resolution LOD.
+    // Applied on import only, so they are neither sent to the worker nor part of the cache key
+    TArray<int32> LODTriangleBudgets;
+    // Import as a Nanite mesh instead of building the LOD chain
+    bool bEnableNanite = false;
+    bool bUseFP16 = true;
+    // Negative leaves the sampler unseeded
+    int32 Seed = -1;
+    FString ModelVersion = TEXT("text300M");
+    // Serve repeated requests from the result cache; generated files then live in the cache directory
+    bool bUseCache = true;
+    // Base name of the output files; derived from the prompt when empty
+    FString OutputName;
+    // Hand the mesh over through a named shared-memory segment instead of reading it back from disk
+    bool bUseSharedMemory = false;
+    // Write PLY/OBJ files; always done when the result goes into the cache
+    bool bExportFiles = true;
+    // Keep the sampled latent as <OutputName>.latent.npy (fp16) so the mesh can be decoded again without sampling
+    bool bSaveLatents = true;
+    // Stream a PreviewSize x PreviewSize render of the current estimate every N Karras steps; 0 disables previews.
+    // Previews are skipped while they would take more than PreviewMaxOverhead of the sampling time
+    int32 PreviewEverySteps = 0;
+    int32 PreviewSize = 64;
+    float PreviewMaxOverhead = 0.15f;
+
+    TSharedRef<FJsonObject> ToJsonObject() const;
+    FString ToJsonString() const; 
+};
+
+// Several prompts sharing one set of settings, sampled BatchSize prompts per diffusion run
+struct FShapEBatchGenerationParameters
+{
+    TArray<FString> Prompts;
+    FString OutputDirectory;
+    float GuidanceScale = 15.0f;
+    int32 KarrasSteps = 64;
+    bool bUseFP16 = true;
+    int32 BatchSize = 4;
+    bool bSaveLatents = true;
+
+    TSharedRef<FJsonObject> ToJsonObject() const;
+};
+
+// Decodes a latent saved by an earlier job again, skipping the diffusion steps
+struct FShapEDecodeParameters
+{
+    FString LatentPath;
+    // Both default to the latent's directory and base name
+    FString OutputDirectory;
+    FString OutputName;
+    bool bUseSharedMemory = false;
+    bool bExportFiles = true;
+
+    TSharedRef<FJsonObject> ToJsonObject() const;
+};
+
+// Where the worker put a mesh in shared memory. Offsets are bytes from the start of the segment;
+// positions are float32 xyz, colors uint8 rgb (ColorsOffset is INDEX_NONE without colors), indices int32 triangles.
+struct FShapESharedMeshLayout
+{
+    FString SegmentName;
+    int64 SegmentSize = 0;
+    int32 NumVertices = 0;
+    int32 NumTriangles = 0;
+    int64 PositionsOffset = 0;
+    int64 ColorsOffset = INDEX_NONE;
+    int64 IndicesOffset = 0;
+
+    bool IsValid() const { return !SegmentName.IsEmpty() && SegmentSize > 0; }
+};
+
+// Low-resolution render of the denoised estimate at Step, streamed while sampling
+struct FShapEPreviewImage
+{
+    int32 Step = 0;
+    int32 TotalSteps = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<FColor> Pixels;
+    double RenderMilliseconds = 0.0;
+
+    bool IsValid() const { return Width > 0 && Height > 0 && Pixels.Num() == Width * Height; }
+};
+
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnShapEProgressUpdated, float /*Percentage*/, int32 /*Step*/, int32 /*TotalSteps*/, const FString& /*RawMessage*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapEStatusMessageReceived, const FString& /*Message*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapEGenerationComplete, const FString& /*PlyPath*/, const FString& /*ObjPath*/, const FString& /*RawMessage*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapEErrorReceived, const FString& /*ErrorMessage*/, const FString& /*ErrorType*/, const FString& /*RawMessage*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapEInfoMessageReceived, const FString& /*Message*/);
+DECLARE_MULTICAST_DELEGATE(FOnShapEProcessFinished);
+DECLARE_MULTICAST_DELEGATE(FOnShapEWorkerReady);
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnShapEBatchItemComplete, int32 /*ItemIndex*/, const FString& /*Prompt*/, const FString& /*PlyPath*/, const FString& /*ObjPath*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapEBatchItemError, int32 /*ItemIndex*/, const FString& /*Prompt*/, const FString& /*ErrorMessage*/);
+// Fires before OnGenerationComplete; the segment is released once the broadcast returns
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapESharedMeshReady, const FShapESharedMeshLayout& /*Layout*/);
+// ItemIndex is INDEX_NONE for single-prompt jobs; fires before OnGenerationComplete / OnBatchItemComplete
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnShapELatentSaved, const FString& /*JobId*/, int32 /*ItemIndex*/, const FString& /*LatentPath*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnShapEPreviewReceived, const FShapEPreviewImage& /*Preview*/);
+
+// Interactive jobs are always dispatched before bulk jobs
+enum class EShapEJobPriority : uint8
+{
+    Interactive,
+    Bulk,
+    Count
+};
+
+enum class EShapEJobKind : uint8
+{
+    Generate,
+    Batch,
+    Decode
+};
+
+enum class EShapEJobState : uint8
+{
+    Queued,
+    Running,
+    Completed,
+    Failed,
+    Cancelled
+};
+
+// Whether the backend has its models loaded, from the editor's point of view
+enum class EShapEWarmupState : uint8
+{
+    Cold,
+    // Started (by a warm-up or a job), models still loading
+    WarmingUp,
+    Warm,
+    // A warm-up was requested but left out, e.g. for lack of free memory
+    Skipped,
+    // The backend could not be started, or exited before it was ready
+    Failed
+};
+
+// Stage names of timing spans; worker stages are named by the worker's "stage" messages
+namespace ShapEStages
+{
+    // Recorded by the editor
+    inline constexpr const TCHAR* QueueWait = TEXT("queue_wait");
+    inline constexpr const TCHAR* WorkerSpawn = TEXT("worker_spawn");
+    // From launching the worker to its first line of output: batch file, conda activation and interpreter start
+    inline constexpr const TCHAR* WorkerBoot = TEXT("worker_boot");
+    inline constexpr const TCHAR* Import = TEXT("import");
+    // Reported by the worker
+    inline constexpr const TCHAR* ModelLoad = TEXT("model_load");
+    inline constexpr const TCHAR* Sample = TEXT("sample");
+    inline constexpr const TCHAR* LatentSave = TEXT("latent_save");
+    inline constexpr const TCHAR* Decode = TEXT("decode");
+    inline constexpr const TCHAR* ExportFiles = TEXT("export_files");
+    inline constexpr const TCHAR* ExportSharedMemory = TEXT("export_shm");
+}
+
+// One stage of a job on the editor's clock (FPlatformTime::Seconds); worker stages are mapped from the worker's clock
+struct FShapETimingSpan
+{
+    FString Stage;
+    double StartSeconds = 0.0;
+    double EndSeconds = 0.0;
+
+    double GetDuration() const { return FMath::Max(0.0, EndSeconds - StartSeconds); }
+};
+
+// Where the time of one job went, from enqueue until it finished (and through the import, once the caller reports it)
+struct FShapEJobTiming
+{
+    FString JobId;
+    FString Description;
+    EShapEJobState State = EShapEJobState::Queued;
+    bool bFromCache = false;
+    double EnqueueTime = 0.0;
+    double FinishTime = 0.0;
+    // Diffusion steps sampled, summed over every sampling run of a batch
+    int32 SampledSteps = 0;
+    TArray<FShapETimingSpan> Spans;
+
+    // Sum over all spans of the stage (a batch samples and decodes several times)
+    double GetStageSeconds(const FString& Stage) const;
+    double GetTotalSeconds() const;
+    double GetSecondsPerStep() const { return SampledSteps > 0 ? GetStageSeconds(ShapEStages::Sample) / SampledSteps : 0.0; }
+    // "queue_wait 0.01s, model_load 12.30s, ..." in the order the stages first ran
+    FString Summarize() const;
+    TSharedRef<FJsonObject> ToJsonObject() const;
+
+    // One row per span plus a "total" row per job
+    static FString ToCsv(TConstArrayView<FShapEJobTiming> Timings);
+};
+
+// Delegates that only fire for one job, next to the manager-wide ones
+struct FShapEJobDelegates
+{
+    FOnShapEProgressUpdated OnProgressUpdated;
+    FOnShapEGenerationComplete OnGenerationComplete;
+    FOnShapEErrorReceived OnErrorReceived;
+    FOnShapEBatchItemComplete OnBatchItemComplete;
+    FOnShapEBatchItemError OnBatchItemError;
+    FOnShapESharedMeshReady OnSharedMeshReady;
+    FOnShapELatentSaved OnLatentSaved;
+    FOnShapEPreviewReceived OnPreviewReceived;
+};
+
+struct FShapEJob
+{
+    FString JobId;
+    EShapEJobKind Kind = EShapEJobKind::Generate;
+    EShapEJobPriority Priority = EShapEJobPriority::Interactive;
+    EShapEJobState State = EShapEJobState::Queued;
+    FString ScriptPath;
+
+    FShapEGenerationParameters Params;
+    FShapEBatchGenerationParameters BatchParams;
+    FShapEDecodeParameters DecodeParams;
+    // Latent of a finished single-prompt or decode job; empty when none was saved
+    FString LatentPath;
+    // Result cache key; empty when the job bypasses the cache
+    FString CacheKey;
+    // Batches are sent to the worker in slices so they can be suspended between items
+    int32 NextBatchItem = 0;
+    int32 FailedBatchItems = 0;
+
+    FShapEJobTiming Timing;
+    // Worker timestamps of stages that began but have not ended yet
+    TMap<FString, double> OpenStages;
+
+    // FPlatformTime::Seconds
+    double EnqueueTime = 0.0;
+    double StartTime = 0.0;
+
+    TSharedRef<FShapEJobDelegates> Delegates = MakeShared<FShapEJobDelegates>();
+
+    FString Describe() const;
+};
+
+struct FShapEQueueStats
+{
+    int32 QueueDepth = 0;
+    int32 InteractiveDepth = 0;
+    int32 BulkDepth = 0;
+    double OldestWaitSeconds = 0.0;
+    // Mean time from enqueue to first dispatch over all jobs dispatched so far
+    double AverageWaitSeconds = 0.0;
+    int32 DispatchedJobs = 0;
+};
+
+// Time from the reader thread receiving a worker line to the game thread dispatching its event
+struct FShapEDispatchLatencyStats
+{
+    static constexpr int32 MaxRecentSamples = 4096;
+
+    int64 Events = 0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+    // The last MaxRecentSamples latencies, used for the percentiles
+    TArray<float> RecentSeconds;
+    int32 NextRecentIndex = 0;
+
+    void Record(double Seconds);
+    double GetAverageSeconds() const { return Events > 0 ? TotalSeconds / Events : 0.0; }
+    // Percentile in [0, 1] over the recent samples
+    double GetPercentileSeconds(double Percentile) const;
+};
+
+// Cancels of running jobs, from the request to the worker being ready for the next job
+struct FShapECancelStats
+{
+    int32 Cancels = 0;
+    double LastSeconds = 0.0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+    // The worker's own measure of the last cancel: from reading it to abandoning the job
+    double LastWorkerMilliseconds = 0.0;
+
+    double GetAverageSeconds() const { return Cancels > 0 ? TotalSeconds / Cancels : 0.0; }
+};
+
+namespace ShapEJson
+{
+    FString ToCondensedString(const TSharedRef<FJsonObject>& JsonObject);
+}
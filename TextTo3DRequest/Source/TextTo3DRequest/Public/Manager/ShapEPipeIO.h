@@ -0,0 +1,22 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+
+namespace ShapEPipeIO
+{
+    /**
+     * Reads from a pipe created by FPlatformProcess::CreatePipe into OutBuffer (its allocation is reused),
+     * sleeping in the kernel until data arrives. Returns false once every write end is closed, i.e. the
+     * child exited. Platforms without a blocking path fall back to short polling until bStopRequested is set.
+     */
+    bool ReadBlocking(void* ReadPipe, TArray<uint8>& OutBuffer, int32 Capacity, const FThreadSafeBool& bStopRequested);
+
+    /**
+     * Writes all Length bytes to a pipe created by FPlatformProcess::CreatePipe. A large message (e.g. a batch
+     * manifest) does not fit the pipe's buffer, so this waits for the child to drain it, and fails once
+     * TimeoutSeconds pass without any progress or the child has closed its end.
+     */
+    bool WriteAll(void* WritePipe, const uint8* Data, int32 Length, double TimeoutSeconds);
+}
@@ -0,0 +1,20 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+struct FShapETimingSpan;
+
+// Generation stages in Unreal Insights; enable with -trace=default,ShapE or "Trace.Enable ShapE"
+UE_TRACE_CHANNEL_EXTERN(ShapEChannel)
+
+namespace ShapETrace
+{
+    // Timing regions opened and closed as the worker reports its stages, for the Insights timing view
+    void BeginStage(const FString& Stage);
+    void EndStage(const FString& Stage);
+    // A finished span with its exact start and end, plus the stage's duration counter
+    void OutputSpan(const FString& JobId, const FShapETimingSpan& Span);
+    void OutputJobTotal(double TotalSeconds);
+}
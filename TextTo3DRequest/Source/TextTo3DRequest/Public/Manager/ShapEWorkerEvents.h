@@ -0,0 +1,63 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Manager/ShapEJobTypes.h"
+
+enum class EShapEWorkerEventType : uint8
+{
+    Ready,
+    Status,
+    Info,
+    Progress,
+    Preview,
+    Stage,
+    ItemComplete,
+    ItemError,
+    Complete,
+    // The worker gave up a job it was asked to cancel (or found it already finished)
+    Cancelled,
+    Error,
+    WorkerExited,
+    // The backend replaced its worker process on its own; the new one loads the models again
+    Restarted
+};
+
+/**
+ * One message from the worker, produced on the reader thread and consumed on the game thread.
+ * Fields that do not apply to the event type are left empty.
+ */
+struct FShapEWorkerEvent
+{
+    EShapEWorkerEventType Type = EShapEWorkerEventType::Info;
+    uint32 WorkerGeneration = 0;
+    // Empty when the worker did not tag the message (e.g. launcher errors, tqdm output)
+    FString JobId;
+
+    FString Message;
+    FString ErrorType;
+    FString Prompt;
+    FString PlyPath;
+    FString ObjPath;
+    // Set on Complete and ItemComplete when the job saved its latent
+    FString LatentPath;
+    FString RawMessage;
+    // Set on Complete when the mesh was handed over in shared memory
+    FShapESharedMeshLayout SharedMesh;
+    // Set on Preview, already decoded on the reader thread
+    FShapEPreviewImage Preview;
+    // Set on Stage: the stage name, whether it began or ended and the worker's time.perf_counter() at that moment
+    FString Stage;
+    bool bStageBegin = false;
+    double WorkerTimestamp = 0.0;
+    // Set on Cancelled: from the worker reading the cancel to it abandoning the job
+    double CancelMilliseconds = 0.0;
+    // FPlatformTime::Seconds when the reader thread received the line
+    double ReceiveTime = 0.0;
+
+    float Percentage = 0.f;
+    int32 Step = 0;
+    int32 TotalSteps = 0;
+    int32 ItemIndex = INDEX_NONE;
+    int32 ItemCount = 0;
+};
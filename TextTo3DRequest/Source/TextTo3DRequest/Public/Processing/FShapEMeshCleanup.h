@@ -0,0 +1,71 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMeshDescription;
+
+struct FShapEMeshCleanupOptions
+{
+    // Vertices closer than this (in UE units, after import scaling) are merged
+    float WeldTolerance = 1e-3f;
+    // Triangles with a smaller area are dropped as degenerate
+    float MinTriangleArea = 1e-8f;
+    bool bRemoveDuplicateTriangles = true;
+    bool bComputeNormalsAndTangents = true;
+    // Single-threaded when false; kept switchable for profiling
+    bool bParallel = true;
+};
+
+struct FShapEMeshCleanupStats
+{
+    int32 VerticesBefore = 0;
+    int32 TrianglesBefore = 0;
+    int32 VerticesAfter = 0;
+    int32 TrianglesAfter = 0;
+    int32 DegenerateTriangles = 0;
+    int32 DuplicateTriangles = 0;
+
+    double WeldSeconds = 0.0;
+    double FilterSeconds = 0.0;
+    double NormalSeconds = 0.0;
+    double TotalSeconds = 0.0;
+};
+
+/**
+ * Vertex positions, colors and the derived tangent frame as separate float arrays, so the per-vertex
+ * and per-triangle passes can run four elements per SIMD register.
+ */
+struct FShapEMeshSoA
+{
+    TArray<float> PositionX, PositionY, PositionZ;
+    TArray<float> ColorR, ColorG, ColorB, ColorA;
+    TArray<float> NormalX, NormalY, NormalZ;
+    TArray<float> TangentX, TangentY, TangentZ;
+    // Three per triangle
+    TArray<int32> Indices;
+
+    int32 NumVertices() const { return PositionX.Num(); }
+    int32 NumTriangles() const { return Indices.Num() / 3; }
+    bool HasNormals() const { return NormalX.Num() == NumVertices(); }
+};
+
+/**
+ * Post-process for marching-cubes output: welds duplicated vertices through a spatial hash, drops
+ * degenerate and duplicate triangles and unreferenced vertices, and computes area-weighted normals
+ * with a tangent frame. Shap-E meshes have no UVs, so tangents are an orthonormal basis around the normal.
+ */
+class FShapEMeshCleanup
+{
+public:
+    // Rebuilds the mesh description in place; normals and tangents are stored on the vertex instances
+    static bool Run(FMeshDescription& InOutMesh, const FShapEMeshCleanupOptions& Options, FShapEMeshCleanupStats* OutStats = nullptr);
+
+    static void ExtractSoA(const FMeshDescription& Mesh, FShapEMeshSoA& OutSoA);
+    static void BuildMeshDescription(const FShapEMeshSoA& SoA, FMeshDescription& OutMesh, FName MaterialSlotName);
+
+    // Individual passes, in the order Run applies them
+    static void WeldVertices(FShapEMeshSoA& SoA, float Tolerance, bool bParallel);
+    static void RemoveDegenerateTriangles(FShapEMeshSoA& SoA, float MinTriangleArea, bool bRemoveDuplicates, bool bParallel, FShapEMeshCleanupStats& Stats);
+    static void ComputeNormalsAndTangents(FShapEMeshSoA& SoA, bool bParallel);
+};
@@ -0,0 +1,45 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Processing/FShapEMeshCleanup.h"
+
+struct FShapEMeshDecimationOptions
+{
+    // A full 0..1 change of vertex color costs as much as moving the surface this far (UE units)
+    float ColorDistance = 2.0f;
+    // Collapses that turn a neighbouring face further than this (cosine of the angle) are rejected
+    float MinNormalDot = 0.2f;
+    // Weight of the planes that hold open borders in place, relative to the faces next to them
+    float BoundaryWeight = 100.0f;
+    // LODs are decimated concurrently; single-threaded when false
+    bool bParallel = true;
+};
+
+struct FShapEMeshDecimationStats
+{
+    int32 TrianglesBefore = 0;
+    // Triangle count reached for each budget, in budget order
+    TArray<int32> LODTriangles;
+    double PrepareSeconds = 0.0;
+    double TotalSeconds = 0.0;
+};
+
+/**
+ * Quadric-error edge collapse (Garland-Heckbert) over a welded FShapEMeshSoA. Each vertex accumulates the
+ * area-weighted planes of its faces; an edge collapses to the point minimizing the summed quadric, and the
+ * vertex color is interpolated along the edge with the color shift added to the cost, so color borders
+ * survive longer than flat regions. Normals and tangents of the result are recomputed.
+ */
+class FShapEMeshDecimator
+{
+public:
+    // Collapses edges until at most TargetTriangles remain, or no collapse keeps the surface valid
+    static void Decimate(const FShapEMeshSoA& Source, int32 TargetTriangles, const FShapEMeshDecimationOptions& Options, FShapEMeshSoA& OutMesh);
+
+    // One mesh per budget, each decimated from Source on its own worker thread
+    static void BuildLODChain(const FShapEMeshSoA& Source, TConstArrayView<int32> TriangleBudgets, const FShapEMeshDecimationOptions& Options, TArray<FShapEMeshSoA>& OutLODs, FShapEMeshDecimationStats* OutStats = nullptr);
+
+    // Drops non-positive entries and makes the rest strictly decreasing, as a LOD chain expects
+    static TArray<int32> SanitizeBudgets(TConstArrayView<int32> TriangleBudgets);
+};
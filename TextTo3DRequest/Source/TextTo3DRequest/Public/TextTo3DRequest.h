@@ -25,8 +25,16 @@ public:
         return ShapEProcessManager;
     }
 
+    // Launcher the editor starts the worker with: ShapE.Warmup.Launcher, else the default install location
+    static FString GetDefaultLauncherPath();
+
+    // Starts the worker ahead of the first job if ShapE.Warmup asks for it at this point (1 at startup, 2 when the
+    // tab opens) and the free memory is within ShapE.Warmup.MinFreeMemoryMB
+    void WarmUpWorker(int32 WarmupMode, const FString& ScriptPath);
+
 private:
     TSharedPtr<FShapEProcessManager> ShapEProcessManager;
+    FDelegateHandle EngineInitHandle;
 
 #if WITH_EDITOR 
     void RegisterMenus();
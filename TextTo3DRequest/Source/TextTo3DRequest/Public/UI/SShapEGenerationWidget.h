@@ -7,6 +7,10 @@
 
 #include "Widgets/SCompoundWidget.h"
 #include "Manager/FShapEProcessManager.h"
+#include "UI/SShapELogPanel.h"
+#include "Import/FShapEPlyImporter.h"
+#include "Styling/SlateBrush.h"
+#include "UObject/StrongObjectPtr.h"
 
 class SEditableTextBox;
 class SButton;
@@ -14,7 +18,8 @@ template <typename NumericType> class SSpinBox;
 class SCheckBox;
 class SProgressBar;
 class STextBlock;
-class SScrollBox;
+class UStaticMesh;
+class UTexture2D;
 
 class SShapEGenerationWidget : public SCompoundWidget
 {
@@ -32,42 +37,85 @@ private:
     TSharedPtr<SSpinBox<float>> GuidanceScaleSpinBox;
     TSharedPtr<SSpinBox<int32>> KarrasStepsSpinBox;
     TSharedPtr<SCheckBox> UseFP16CheckBox;
+    TSharedPtr<SEditableTextBox> LODBudgetsTextBox;
+    TSharedPtr<SCheckBox> NaniteCheckBox;
+    TSharedPtr<SSpinBox<int32>> SeedSpinBox;
+    TSharedPtr<SSpinBox<int32>> PreviewEverySpinBox;
+    TSharedPtr<SCheckBox> UseCacheCheckBox;
+    TSharedPtr<SCheckBox> SharedMemoryCheckBox;
+    TSharedPtr<SCheckBox> ExportFilesCheckBox;
+    TSharedPtr<SCheckBox> ImportMeshCheckBox;
+    TSharedPtr<SEditableTextBox> ImportPathTextBox;
     TSharedPtr<SButton> GenerateButton;
     TSharedPtr<SButton> ActionButton;
 
     TSharedPtr<SProgressBar> ProgressBar;
     TSharedPtr<STextBlock> StatusTextBlock;
-    TSharedPtr<STextBlock> LogTextBlock;
-    TSharedPtr<SScrollBox> LogScrollBox;
+    TSharedPtr<STextBlock> PreviewStepTextBlock;
+    TSharedPtr<SShapELogPanel> LogPanel;
 
     TSharedPtr<FShapEProcessManager> ProcessManager;
 
     // Default Path
-    FString CurrentBatFilePath = TEXT("C:/AIModel/shap-e-local/run_shape.bat");
+    // Starts as FTextTo3DRequestModule::GetDefaultLauncherPath()
+    FString CurrentBatFilePath;
     FString CurrentOutputDir = TEXT("D:/UP/P/Customizing/Content/Characters");
+    FString CurrentImportPath = TEXT("/Game/ShapE");
+    // Prompt of the job in flight, used to name the imported asset
+    FString ActivePrompt;
+    // Id of the job in flight, for reporting the import into its timing
+    FString ActiveJobId;
+    // LOD and Nanite settings of the job in flight
+    FShapEPlyImportOptions ActiveImportOptions;
+    // Set once the mesh of the job in flight was imported from shared memory, so the file import is skipped
+    bool bImportedSharedMesh = false;
+    // Latent of the last finished single-prompt job, for re-decoding without sampling
+    FString LastLatentPath;
+    // Latest preview of the job in flight; the texture is reused while the preview size stays the same
+    TStrongObjectPtr<UTexture2D> PreviewTexture;
+    FSlateBrush PreviewBrush;
 
     // Cond Var
+    // Set while ActiveJobId is queued or running
+    bool bJobInFlight = false;
     bool bIsGenerationFinished = false;
     bool bWasCanceled = false;
 
     FReply OnBrowseBatFileClicked();
     FReply OnBrowseOutputDirClicked();
     FReply OnGenerateButtonClicked();
+    FReply OnRedecodeButtonClicked();
     FReply OnActionButtonClicked();
+    // Binds the handlers below to one job, so other callers' jobs never reach the widget
+    TSharedRef<FShapEJobDelegates> MakeJobDelegates();
 
     void HandleProgressUpdated(float Percentage, int32 Step, int32 TotalSteps, const FString& RawMessage);
     void HandleStatusMessageReceived(const FString& Message);
     void HandleGenerationComplete(const FString& PlyPath, const FString& ObjPath, const FString& RawMessage);
+    void HandleSharedMeshReady(const FShapESharedMeshLayout& Layout);
+    void HandleLatentSaved(const FString& JobId, int32 ItemIndex, const FString& LatentPath);
+    void HandlePreviewReceived(const FShapEPreviewImage& Preview);
     void HandleErrorReceived(const FString& ErrorMessage, const FString& ErrorType, const FString& RawMessage);
     void HandleInfoMessageReceived(const FString& Message);
     void HandleProcessFinished();
 
-    void AddLogMessage(const FString& Message, const FLinearColor& Color = FLinearColor::White);
+    void ImportGeneratedMesh(const FString& PlyPath);
+    FString MakeImportAssetName(const FString& FallbackName) const;
+    static TArray<int32> ParseLODBudgets(const FString& Text);
+    void RecordImportTiming(double ImportStartTime);
+    void LogJobTiming();
+    void LogImportResult(UStaticMesh* StaticMesh, const FShapEPlyImportStats& Stats, const FString& Error);
+    void AddLogMessage(const FString& Message, const FLinearColor& Color = FLinearColor::White, EShapELogSeverity Severity = EShapELogSeverity::Info);
     void ResetUIState();
+    void ClearPreview();
 
     bool IsGenerateButtonEnabled() const;
+    bool IsRedecodeButtonEnabled() const;
     EVisibility GetActionButtonVisibility() const;
+    EVisibility GetPreviewVisibility() const;
     FText GetActionButtonText() const;
+    FText GetWarmupText() const;
+    FSlateColor GetWarmupColor() const;
 };
 
 #endif
\ No newline at end of file
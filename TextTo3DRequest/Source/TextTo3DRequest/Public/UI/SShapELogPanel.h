@@ -0,0 +1,87 @@
+// Copyright 2025 Devhanghae All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_EDITOR
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+class ITableRow;
+class STableViewBase;
+
+enum class EShapELogSeverity : uint8
+{
+    Info,
+    Status,
+    Success,
+    Warning,
+    Error,
+    Count
+};
+
+struct FShapELogEntry
+{
+    uint64 Sequence = 0;
+    FDateTime Timestamp;
+    EShapELogSeverity Severity = EShapELogSeverity::Info;
+    FLinearColor Color = FLinearColor::White;
+    FString Message;
+};
+
+/**
+ * Log view backed by a fixed-capacity ring buffer. Adding an entry is O(1); the oldest entry is dropped
+ * once the buffer is full. Rows are shown through a virtualized list, so only visible entries get widgets.
+ */
+class SShapELogPanel : public SCompoundWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SShapELogPanel)
+        : _MaxEntries(5000)
+        {}
+        SLATE_ARGUMENT(int32, MaxEntries)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs);
+    virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+    void AddEntry(const FString& Message, EShapELogSeverity Severity, const FLinearColor& Color);
+    void Clear();
+
+    int32 Num() const { return Count; }
+    bool ExportToFile(const FString& FilePath) const;
+
+    static const TCHAR* GetSeverityName(EShapELogSeverity Severity);
+
+private:
+    using FEntryPtr = TSharedPtr<FShapELogEntry>;
+
+    // Ring storage; the oldest entry lives at Head
+    TArray<FEntryPtr> Ring;
+    int32 Head = 0;
+    int32 Count = 0;
+    uint64 NextSequence = 0;
+
+    // Entries passing the severity filter, oldest first; this is the list view's item source
+    TArray<FEntryPtr> VisibleEntries;
+    // Evicted entries still at the front of VisibleEntries, trimmed once per tick
+    bool bHasPendingEvictions = false;
+    bool bScrollToBottom = false;
+
+    bool SeverityEnabled[(int32)EShapELogSeverity::Count];
+
+    TSharedPtr<SListView<FEntryPtr>> ListView;
+
+    const FEntryPtr& GetOldest() const { return Ring[Head]; }
+    bool PassesFilter(const FShapELogEntry& Entry) const;
+    void RebuildVisibleEntries();
+    bool IsScrolledToBottom() const;
+
+    TSharedRef<ITableRow> OnGenerateRow(FEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable);
+    TSharedRef<SWidget> MakeSeverityToggle(EShapELogSeverity Severity);
+    FReply OnExportClicked();
+    FReply OnClearClicked();
+};
+
+#endif
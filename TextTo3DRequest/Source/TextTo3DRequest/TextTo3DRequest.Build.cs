@@ -26,8 +26,11 @@ public class TextTo3DRequest : ModuleRules
                 "Engine",
                 "Projects",
                 "InputCore",
+                "HTTP",
                 "Json",
                 "JsonUtilities",
+                "MeshDescription",
+                "StaticMeshDescription",
             }
         );
 
@@ -41,7 +44,9 @@ public class TextTo3DRequest : ModuleRules
                     "Slate",
                     "SlateCore",
                     "ToolMenus",
-                    "DesktopPlatform"
+                    "DesktopPlatform",
+                    "AssetTools",
+                    "AssetRegistry"
                 }
             );
         }